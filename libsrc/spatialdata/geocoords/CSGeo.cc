@@ -106,6 +106,18 @@ spatialdata::geocoords::CSGeo::computeSurfaceNormal(double* dir,
                                                     const size_t numLocs,
                                                     const size_t numDims,
                                                     const double dx) const {
+    computeSurfaceNormal(dir, coords, numLocs, numDims, _converter);
+} // computeSurfaceNormal
+
+
+// ----------------------------------------------------------------------
+// Get outward surface normal using the given converter.
+void
+spatialdata::geocoords::CSGeo::computeSurfaceNormal(double* dir,
+                                                    const double* coords,
+                                                    const size_t numLocs,
+                                                    const size_t numDims,
+                                                    Converter* converter) const {
     assert( (0 < numLocs && dir) || (0 == numLocs && !dir) );
     assert( (0 < numLocs && coords) || (0 == numLocs && !coords) );
 
@@ -119,10 +131,8 @@ spatialdata::geocoords::CSGeo::computeSurfaceNormal(double* dir,
     } // if
 
     if (numDims > 2) {
-        PJ_CONTEXT* const context = NULL;
-        PJ* const proj = proj_create(context, _string.c_str());
-        const PJ_TYPE projType = proj_get_type(proj);
-        proj_destroy(proj);
+        assert(converter);
+        const int projType = converter->getCRSType(this);
         switch (projType) {
         case PJ_TYPE_GEOGRAPHIC_2D_CRS:
         case PJ_TYPE_GEOGRAPHIC_3D_CRS:
@@ -140,8 +150,7 @@ spatialdata::geocoords::CSGeo::computeSurfaceNormal(double* dir,
             csLL.setString("EPSG:4326"); // WGS84
             double* coordsLL = (numLocs*numDims > 0) ? new double[numLocs*numDims] : NULL;
             memcpy(coordsLL, coords, numLocs*numDims*sizeof(double));
-            assert(_converter);
-            _converter->convert(coordsLL, numLocs, numDims, &csLL, this);
+            converter->convert(coordsLL, numLocs, numDims, &csLL, this);
             for (size_t i = 0; i < numLocs; ++i) {
                 const double latRad = coordsLL[i*numDims+0] * M_PI/180.0;
                 const double lonRad = coordsLL[i*numDims+1] * M_PI/180.0;
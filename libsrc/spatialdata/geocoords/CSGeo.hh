@@ -86,6 +86,25 @@ public:
                               const size_t numDims,
                               const double dx=1000.0) const;
 
+    /** Get radial outward direction using the given converter.
+     *
+     * Unlike the method above, this method does not use any state
+     * stored in the coordinate system, so it may be called concurrently
+     * from several threads as long as each thread uses its own
+     * converter.
+     *
+     * @param dir Array of direction cosines for outward radial direction.
+     * @param coords Array of coordinates for locations.
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions in coordinates.
+     * @param converter Converter for transforming coordinates to longitude/latitude.
+     */
+    void computeSurfaceNormal(double* dir,
+                              const double* coords,
+                              const size_t numLocs,
+                              const size_t numDims,
+                              Converter* converter) const;
+
     /** Pickle coordinate system to ascii stream.
      *
      * @param s Output stream
@@ -39,18 +39,26 @@ public:
 
                 std::string csDest;
                 std::string csSrc;
+                std::string csType;
+                PJ_CONTEXT* context;
                 PJ* proj;
+                PJ_TYPE type;
 
                 Cache(void) :
                     csDest(""),
                     csSrc(""),
-                    proj(NULL) {}
+                    csType(""),
+                    context(proj_context_create()),
+                    proj(NULL),
+                    type(PJ_TYPE_UNKNOWN) {}
 
 
                 ~Cache(void) {
                     csDest = "";
                     csSrc = "";
+                    csType = "";
                     proj_destroy(proj);proj = NULL;
+                    proj_context_destroy(context);context = NULL;
                 }
 
             }; // Cache
@@ -118,6 +126,24 @@ spatialdata::geocoords::Converter::convert(double* coords,
 } // convert
 
 
+// ----------------------------------------------------------------------
+// Get PROJ type of geographic coordinate system.
+int
+spatialdata::geocoords::Converter::getCRSType(const CSGeo* cs) {
+    assert(cs);
+    assert(_cache);
+
+    if ((0 == _cache->csType.length()) || (0 != strcasecmp(_cache->csType.c_str(), cs->getString()))) {
+        PJ* const proj = proj_create(_cache->context, cs->getString());
+        _cache->type = proj_get_type(proj);
+        proj_destroy(proj);
+        _cache->csType = cs->getString();
+    } // if
+
+    return _cache->type;
+} // getCRSType
+
+
 // ----------------------------------------------------------------------
 // Convert coordinates from source geographic coordinate system to
 // destination geographic coordinate system.
@@ -143,7 +169,7 @@ spatialdata::geocoords::Converter::_convert(double* coords,
     if ((0 == _cache->csDest.length()) || (0 != strcasecmp(_cache->csDest.c_str(), csDest->getString()))) { needsNewProj = true; }
     if (needsNewProj) {
         proj_destroy(_cache->proj);
-        _cache->proj = proj_create_crs_to_crs(NULL, csSrc->getString(), csDest->getString(), NULL);
+        _cache->proj = proj_create_crs_to_crs(_cache->context, csSrc->getString(), csDest->getString(), NULL);
         if (!_cache->proj) {
             std::stringstream msg;
             msg << "Error creating projection from '" << csSrc->getString() << "' to '" << csDest->getString() << "'.\n"
@@ -19,6 +19,9 @@
  * @brief C++ Converter object
  *
  * C++ object for converting between coordinate systems.
+ *
+ * Each converter uses its own PROJ context, so different converters
+ * may be used concurrently from different threads.
  */
 
 #if !defined(spatialdata_geocoords_converter_hh)
@@ -64,6 +67,16 @@ public:
                  const CoordSys* csDest,
                  const CoordSys* csSrc);
 
+    /** Get PROJ type of geographic coordinate system.
+     *
+     * The type is determined using the PROJ context of the converter
+     * and cached for the most recent coordinate system.
+     *
+     * @param[in] cs Geographic coordinate system.
+     * @returns PROJ type (PJ_TYPE) of coordinate system.
+     */
+    int getCRSType(const CSGeo* cs);
+
 private:
 
     // PRIVATE METHODS ////////////////////////////////////////////////////
@@ -18,7 +18,11 @@
 
 #include "CompositeDB.hh" // Implementation of class methods
 
+#include "QueryContext.hh" // USES QueryContext
+
 #include <stdexcept> // USES std::runtime_error
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::max()
 #include <sstream> // USES std::ostringsgream
 #include <strings.h> // USES strcasecmp()
 #include <cassert> // USES assert()
@@ -316,21 +320,7 @@ spatialdata::spatialdb::CompositeDB::query(double* vals,
 
     const size_t qsizeA = _infoA->query_size;
     const size_t qsizeB = _infoB->query_size;
-    const size_t querySize = qsizeA + qsizeB;
-    if (0 == querySize) {
-        std::ostringstream msg;
-        msg << "Values to be returned by spatial database " << getLabel()
-            << " have not been set. Please call setQueryValues() before query().\n";
-        throw std::logic_error(msg.str());
-    } // if
-    else if (numVals != querySize) {
-        std::ostringstream msg;
-        msg << "Number of values to be returned by spatial database "
-            << getLabel()
-            << "(" << querySize << ") does not match size of array provided ("
-            << numVals << ").\n";
-        throw std::logic_error(msg.str());
-    } // if
+    _checkQuery(numVals);
 
     // Query database A
     int errA = 0;
@@ -354,4 +344,104 @@ spatialdata::spatialdb::CompositeDB::query(double* vals,
 } // query
 
 
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::CompositeDB::isThreadSafe(void) const {
+    return _dbA && _dbB && _dbA->isThreadSafe() && _dbB->isThreadSafe();
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::CompositeDB::queryBatch(QueryContext* context,
+                                                double* vals,
+                                                const size_t numVals,
+                                                int* err,
+                                                const double* coords,
+                                                const size_t numLocs,
+                                                const size_t numDims,
+                                                const spatialdata::geocoords::CoordSys* pCSQuery) {
+    assert(_dbA);
+    assert(_infoA);
+    assert(_dbB);
+    assert(_infoB);
+
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+
+    const size_t qsizeA = _infoA->query_size;
+    const size_t qsizeB = _infoB->query_size;
+    _checkQuery(numVals);
+
+    // Intermediate values and error flags are held in the context and
+    // the nested databases are queried with the nested context, so the
+    // buffers are reused across batches.
+    QueryContext* contextNested = context->getNested();
+    std::vector<double>& batchValues = context->batchValues;
+    std::vector<int>& batchFlags = context->batchFlags;
+    if (batchValues.size() < numLocs*std::max(qsizeA, qsizeB)) {
+        batchValues.resize(numLocs*std::max(qsizeA, qsizeB));
+    } // if
+    if (batchFlags.size() < numLocs) {
+        batchFlags.resize(numLocs);
+    } // if
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        err[iLoc] = 0;
+    } // for
+
+    // Query database A
+    if (qsizeA > 0) {
+        _dbA->queryBatch(contextNested, &batchValues[0], qsizeA, &batchFlags[0], coords, numLocs, numDims, pCSQuery);
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            for (size_t i = 0; i < qsizeA; ++i) {
+                vals[iLoc*numVals+_infoA->query_indices[i]] = batchValues[iLoc*qsizeA+i];
+            } // for
+            err[iLoc] = err[iLoc] || batchFlags[iLoc];
+        } // for
+    } // if
+
+    // Query database B
+    if (qsizeB > 0) {
+        _dbB->queryBatch(contextNested, &batchValues[0], qsizeB, &batchFlags[0], coords, numLocs, numDims, pCSQuery);
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            for (size_t i = 0; i < qsizeB; ++i) {
+                vals[iLoc*numVals+_infoB->query_indices[i]] = batchValues[iLoc*qsizeB+i];
+            } // for
+            err[iLoc] = err[iLoc] || batchFlags[iLoc];
+        } // for
+    } // if
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Check number of values to be returned by query.
+void
+spatialdata::spatialdb::CompositeDB::_checkQuery(const size_t numVals) const {
+    assert(_infoA);
+    assert(_infoB);
+
+    const size_t querySize = _infoA->query_size + _infoB->query_size;
+    if (0 == querySize) {
+        std::ostringstream msg;
+        msg << "Values to be returned by spatial database " << getLabel()
+            << " have not been set. Please call setQueryValues() before query().\n";
+        throw std::logic_error(msg.str());
+    } // if
+    else if (numVals != querySize) {
+        std::ostringstream msg;
+        msg << "Number of values to be returned by spatial database "
+            << getLabel()
+            << "(" << querySize << ") does not match size of array provided ("
+            << numVals << ").\n";
+        throw std::logic_error(msg.str());
+    } // if
+} // _checkQuery
+
+
 // End of file
@@ -110,8 +110,48 @@ public:
               const size_t numDims,
               const spatialdata::geocoords::CoordSys* pCSQuery);
 
+    /** Can the database be queried concurrently?
+     *
+     * The composite database is thread safe if both databases are thread safe.
+     *
+     * @returns True if queryBatch() may be called concurrently using
+     *   separate query contexts, false otherwise.
+     */
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
 private:
 
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Check number of values to be returned by query.
+     *
+     * @param numVals Number of values expected.
+     */
+    void _checkQuery(const size_t numVals) const;
+
     // NOT IMPLEMENTED ////////////////////////////////////////////////////
 
     CompositeDB(const CompositeDB& data); ///< Not implemented
@@ -21,12 +21,20 @@
 #include "spatialdata/utils/LineParser.hh" // USES LineParser
 
 #include <fstream> // USES std::ifstream
+#include <algorithm> // USES std::min(), std::max()
 #include <math.h> // USES round()
 
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringsgream
-#include <cstring> // USES memcpy() and strcmp()
+#include <iomanip> // USES std::setw(), std::setfill()
+#include <cstring> // USES memcpy(), strlen(), and strcmp()
+#include <cstdio> // USES rename(), remove()
+#include <stdlib.h> // USES realpath(), free()
 #include <assert.h> // USES assert()
+#include <fcntl.h> // USES open()
+#include <unistd.h> // USES close(), getpid()
+#include <sys/stat.h> // USES stat(), fstat()
+#include <sys/mman.h> // USES mmap(), munmap()
 
 #if defined(WORDS_BIGENDIAN)
 #define NATIVE_BIG_ENDIAN
@@ -34,103 +42,290 @@
 #define NATIVE_LITTLE_ENDIAN
 #endif
 
+// ----------------------------------------------------------------------
+const char* spatialdata::spatialdb::GocadVoxet::CACHEHEADER = "#GOCAD_VOXET.native";
+const uint64_t spatialdata::spatialdb::GocadVoxet::_byteOrder = 0x0102030405060708ULL;
+
 // ----------------------------------------------------------------------
 // Constructor
 spatialdata::spatialdb::GocadVoxet::GocadVoxet(void) :
-    _data(NULL)
-{}
+    _hasRegion(false) {
+    _region[0] = 0.0;
+    _region[1] = 0.0;
+    _region[2] = 0.0;
+    _region[3] = 0.0;
+    _resetData();
+}
 
 
 // ----------------------------------------------------------------------
 // Destructor
 spatialdata::spatialdb::GocadVoxet::~GocadVoxet(void) {
-    delete[] _data;_data = NULL;
+    _resetData();
 } // destructor
 
 
 // ----------------------------------------------------------------------
-// Read data files.
+// Set directory for cache files holding property values in native byte order.
+void
+spatialdata::spatialdb::GocadVoxet::setCacheDir(const char* dir) {
+    _cacheDir = dir;
+} // setCacheDir
+
+
+// ----------------------------------------------------------------------
+// Set region of voxet to read.
+void
+spatialdata::spatialdb::GocadVoxet::setRegion(const double xMin,
+                                              const double yMin,
+                                              const double xMax,
+                                              const double yMax) {
+    if (( xMin > xMax) || ( yMin > yMax) ) {
+        std::ostringstream msg;
+        msg << "Minimum coordinates (" << xMin << ", " << yMin << ") of region of Gocad Voxet must not exceed "
+            << "maximum coordinates (" << xMax << ", " << yMax << ").";
+        throw std::invalid_argument(msg.str());
+    } // if
+    _region[0] = xMin;
+    _region[1] = yMin;
+    _region[2] = xMax;
+    _region[3] = yMax;
+    _hasRegion = true;
+} // setRegion
+
+
+// ----------------------------------------------------------------------
+// Clear region of voxet to read.
+void
+spatialdata::spatialdb::GocadVoxet::clearRegion(void) {
+    _hasRegion = false;
+} // clearRegion
+
+
+// ----------------------------------------------------------------------
+// Read voxet file and data for one property.
 void
 spatialdata::spatialdb::GocadVoxet::read(const char* dir,
                                          const char* filename,
                                          const char* property) {
+    read(dir, filename, &property, 1);
+} // read
+
+
+// ----------------------------------------------------------------------
+// Read voxet file and data for several properties.
+void
+spatialdata::spatialdb::GocadVoxet::read(const char* dir,
+                                         const char* filename,
+                                         const char* const* properties,
+                                         const size_t numProperties) {
     std::string fullname;
     fullname = std::string(dir) + std::string("/") + std::string(filename);
-    _readVoxetFile(fullname.c_str(), property);
+    _readVoxetFile(fullname.c_str(), properties, numProperties);
+    if (_hasRegion && _cacheDir.empty()) {
+        _cropToRegion();
+    } // if
 
-    fullname = std::string(dir) + std::string("/")
-               + std::string(_property.filename);
-    _readPropertyFile(fullname.c_str());
+    for (size_t iProperty = 0; iProperty < numProperties; ++iProperty) {
+        fullname = std::string(dir) + std::string("/")
+                   + std::string(_properties[iProperty].filename);
+        _readPropertyFile(fullname.c_str(), iProperty);
+    } // for
 } // read
 
 
+// ----------------------------------------------------------------------
+// Get number of properties read.
+size_t
+spatialdata::spatialdb::GocadVoxet::getNumProperties(void) const {
+    return _properties.size();
+} // getNumProperties
+
+
 // ----------------------------------------------------------------------
 // Query voxet for value.
 int
 spatialdata::spatialdb::GocadVoxet::query(double* value,
-                                          const double pt[3]) const {
+                                          const double pt[3],
+                                          const size_t iProperty) const {
+    assert(iProperty < _data.size());
+    const int indexV = _findSample(pt, iProperty);
+    if (indexV < 0) {
+        *value = _properties[iProperty].noDataValue;
+        return 1;
+    } // if
+
+    *value = _data[iProperty][indexV];
+    return 0;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Query voxet for single precision value.
+int
+spatialdata::spatialdb::GocadVoxet::query(float* value,
+                                          const double pt[3],
+                                          const size_t iProperty) const {
+    assert(iProperty < _data.size());
+    const int indexV = _findSample(pt, iProperty);
+    if (indexV < 0) {
+        *value = _properties[iProperty].noDataValue;
+        return 1;
+    } // if
+
+    *value = _data[iProperty][indexV];
+    return 0;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Query voxet for value at nearest location.
+int
+spatialdata::spatialdb::GocadVoxet::queryNearest(double* value,
+                                                 const double pt[3],
+                                                 const size_t iProperty) const {
+    assert(iProperty < _data.size());
+    *value = _data[iProperty][_findNearestSample(pt)];
+    return 0;
+} // queryNearest
+
+
+// ----------------------------------------------------------------------
+// Query voxet for single precision value at nearest location.
+int
+spatialdata::spatialdb::GocadVoxet::queryNearest(float* value,
+                                                 const double pt[3],
+                                                 const size_t iProperty) const {
+    assert(iProperty < _data.size());
+    *value = _data[iProperty][_findNearestSample(pt)];
+    return 0;
+} // queryNearest
+
+
+// ----------------------------------------------------------------------
+// Query voxet for values at multiple locations.
+void
+spatialdata::spatialdb::GocadVoxet::queryBatch(double* values,
+                                               int* err,
+                                               const double* pts,
+                                               const size_t numPts,
+                                               const size_t iProperty) const {
+    assert(iProperty < _data.size());
+    assert(values);
+    assert(err);
+    assert(pts);
+
+    const float* data = _data[iProperty];
+    const double noDataValue = _properties[iProperty].noDataValue;
+    for (size_t iPt = 0; iPt < numPts; ++iPt) {
+        const int indexV = _findSample(&pts[iPt*3], iProperty);
+        err[iPt] = (indexV < 0) ? 1 : 0;
+        values[iPt] = (indexV < 0) ? noDataValue : data[indexV];
+    } // for
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Query voxet for values at nearest location for multiple locations.
+void
+spatialdata::spatialdb::GocadVoxet::queryNearestBatch(double* values,
+                                                      const double* pts,
+                                                      const size_t numPts,
+                                                      const size_t iProperty) const {
+    assert(iProperty < _data.size());
+    assert(values);
+    assert(pts);
+
+    const float* data = _data[iProperty];
+    for (size_t iPt = 0; iPt < numPts; ++iPt) {
+        values[iPt] = data[_findNearestSample(&pts[iPt*3])];
+    } // for
+} // queryNearestBatch
+
+
+// ----------------------------------------------------------------------
+// Find sample for location.
+int
+spatialdata::spatialdb::GocadVoxet::_findSample(const double pt[3],
+                                                const size_t iProperty) const {
     // Compute indices of voxet containing pt
     const int numX = _geometry.n[0];
     const int numY = _geometry.n[1];
     const int numZ = _geometry.n[2];
     const int indexX =
-        round( (pt[0] - (_geometry.o[0]+_geometry.min[0]))*_geometry.scale[0]);
+        round( (pt[0] - (_geometry.o[0]+_geometry.min[0]))*_geometry.scale[0]) - _geometry.start[0];
     const int indexY =
-        round( (pt[1] - (_geometry.o[1]+_geometry.min[1]))*_geometry.scale[1]);
+        round( (pt[1] - (_geometry.o[1]+_geometry.min[1]))*_geometry.scale[1]) - _geometry.start[1];
     const int indexZ =
         round( (pt[2] - (_geometry.o[2]+_geometry.min[2]))*_geometry.scale[2]);
 
     // Check if voxet is in range
-    int flag = 0;
-    if (( indexX >= 0) && ( indexX < numX) &&
-        ( indexY >= 0) && ( indexY < numY) &&
-        ( indexZ >= 0) && ( indexZ < numZ) ) {
-        int indexV = indexZ*numY*numX + indexY*numX + indexX;
-        *value = _data[indexV];
-
-        // If voxet value is "no data value"
-        if (fabs(1.0 - *value / _property.noDataValue) < 1.0e-6) {
-            // If near indexZ=0, retry with indexZ+1, otherwise if near
-            // indexZ=numZ, retry with indexZ-1.
-            const int dz = (indexZ < numZ/2) ? +1 : -1;
-            const int maxRetries = 32;
-            for (int iTry = 0; iTry < maxRetries; ++iTry) {
-                const int indexZNew = indexZ + dz*iTry;
-                assert(indexZNew >= 0 && indexZNew < numZ);
-                indexV = indexZNew*numY*numX + indexY*numX + indexX;
-                *value = _data[indexV];
-                if (fabs(1.0 - *value / _property.noDataValue) > 1.0e-6) {
-                    break;
-                }
-            } // for
+    if (( indexX < 0) || ( indexX >= numX) ||
+        ( indexY < 0) || ( indexY >= numY) ||
+        ( indexZ < 0) || ( indexZ >= numZ) ) {
+        return -1;
+    } // if
+
+    int indexV = indexZ*numY*numX + indexY*numX + indexX;
+
+    // If voxet value is "no data value"
+    const float* data = _data[iProperty];
+    const double noDataValue = _properties[iProperty].noDataValue;
+    const double value = data[indexV];
+    if (fabs(1.0 - value / noDataValue) < 1.0e-6) {
+        // If near indexZ=0, retry with indexZ+1, otherwise if near
+        // indexZ=numZ, retry with indexZ-1.
+        const int dz = (indexZ < numZ/2) ? +1 : -1;
+        const int maxRetries = 32;
+
+        // Use first or last valid sample in column if "no data" samples
+        // are only below and above valid samples. If no valid sample is
+        // within the number of retries, use the last sample tried.
+        const int* validRange = &_validRanges[iProperty][2*(indexY*numX + indexX)];
+        if (validRange[0] >= 0) {
+            const bool haveValid = validRange[0] <= validRange[1];
+            int indexZNew = indexZ + dz*(maxRetries-1);
+            if (( dz > 0) && haveValid && ( indexZ < validRange[0]) && ( validRange[0] - indexZ < maxRetries) ) {
+                indexZNew = validRange[0];
+            } else if (( dz < 0) && haveValid && ( indexZ > validRange[1]) && ( indexZ - validRange[1] < maxRetries) ) {
+                indexZNew = validRange[1];
+            } // if/else
+            if (( indexZNew >= 0) && ( indexZNew < numZ) ) {
+                return indexZNew*numY*numX + indexY*numX + indexX;
+            } // if
         } // if
-    } else {
-        *value = _property.noDataValue;
-        flag = 1;
-    } // if/else
 
-    return flag;
-} // query
+        for (int iTry = 0; iTry < maxRetries; ++iTry) {
+            const int indexZNew = indexZ + dz*iTry;
+            assert(indexZNew >= 0 && indexZNew < numZ);
+            indexV = indexZNew*numY*numX + indexY*numX + indexX;
+            const double valueNew = data[indexV];
+            if (fabs(1.0 - valueNew / noDataValue) > 1.0e-6) {
+                break;
+            }
+        } // for
+    } // if
+
+    return indexV;
+} // _findSample
 
 
 // ----------------------------------------------------------------------
-// Query voxet for value at nearest location.
+// Find sample nearest location.
 int
-spatialdata::spatialdb::GocadVoxet::queryNearest(double* value,
-                                                 const double pt[3]) const { // queryNearest
-                                                                             // Compute indices of voxet containing pt
+spatialdata::spatialdb::GocadVoxet::_findNearestSample(const double pt[3]) const {
+    // Compute indices of voxet containing pt
     const int numX = _geometry.n[0];
     const int numY = _geometry.n[1];
     const int numZ = _geometry.n[2];
     int indexX =
-        round( (pt[0] - (_geometry.o[0]+_geometry.min[0]))*_geometry.scale[0]);
+        round( (pt[0] - (_geometry.o[0]+_geometry.min[0]))*_geometry.scale[0]) - _geometry.start[0];
     int indexY =
-        round( (pt[1] - (_geometry.o[1]+_geometry.min[1]))*_geometry.scale[1]);
+        round( (pt[1] - (_geometry.o[1]+_geometry.min[1]))*_geometry.scale[1]) - _geometry.start[1];
     int indexZ =
         round( (pt[2] - (_geometry.o[2]+_geometry.min[2]))*_geometry.scale[2]);
 
     // Correct to range of voxet, if necessary.
-    int flag = 0;
     if (indexX < 0) {
         indexX = 0;
     } else if (indexX >= numX) {
@@ -152,37 +347,16 @@ spatialdata::spatialdb::GocadVoxet::queryNearest(double* value,
     assert(indexY >= 0 && indexY < numY);
     assert(indexZ >= 0 && indexZ < numZ);
 
-    int indexV = indexZ*numY*numX + indexY*numX + indexX;
-    *value = _data[indexV];
-
-#if 0
-    // If voxet value is "no data value"
-    if (fabs(1.0 - *value / _property.noDataValue) < 1.0e-6) {
-        // If near indexZ=0, retry with indexZ+1, otherwise if near
-        // indexZ=numZ, retry with indexZ-1.
-        const int dz = (indexZ < numZ/2) ? +1 : -1;
-        const int maxRetries = 32;
-        for (int iTry = 0; iTry < maxRetries; ++iTry) {
-            const int indexZNew = indexZ + dz*iTry;
-            assert(indexZNew >= 0 && indexZNew < numZ);
-            indexV = indexZNew*numY*numX + indexY*numX + indexX;
-            *value = _data[indexV];
-            if (fabs(1.0 - *value / _property.noDataValue) > 1.0e-6) {
-                break;
-            }
-        } // for
-    } // if
-#endif
-
-    return flag;
-} // queryNearest
+    return indexZ*numY*numX + indexY*numX + indexX;
+} // _findNearestSample
 
 
 // ----------------------------------------------------------------------
 // Read voxet file.
 void
 spatialdata::spatialdb::GocadVoxet::_readVoxetFile(const char* filename,
-                                                   const char* propertyName) {
+                                                   const char* const* properties,
+                                                   const size_t numProperties) {
     try {
         std::ifstream vfile(filename);
         if (!vfile.is_open() || !vfile.good()) {
@@ -214,9 +388,11 @@ spatialdata::spatialdb::GocadVoxet::_readVoxetFile(const char* filename,
 
         std::string token;
 
-        _resetData();
+        _resetData(numProperties);
         int propertyId = 0;
-        int propertyIdTarget = -1;
+
+        // Ids of requested properties in voxet file (-1 if not found).
+        std::vector<int> propertyIds(numProperties, -1);
 
         buffer.str(parser.next());
         buffer.clear();
@@ -262,35 +438,57 @@ spatialdata::spatialdb::GocadVoxet::_readVoxetFile(const char* filename,
                 std::string name;
                 buffer >> propertyId;
                 buffer >> name;
-                if (0 == strcmp(name.c_str(), propertyName)) {
-                    propertyIdTarget = propertyId;
-                    _property.name = name;
-                } // if
+                for (size_t i = 0; i < numProperties; ++i) {
+                    if (0 == strcmp(name.c_str(), properties[i])) {
+                        propertyIds[i] = propertyId;
+                        _properties[i].name = name;
+                    } // if
+                } // for
             } else if (0 == strcmp(token.c_str(), "PROP_NO_DATA_VALUE")) {
                 buffer >> propertyId;
-                if (propertyIdTarget == propertyId) {
-                    buffer >> _property.noDataValue;
-                }
+                float noDataValue = 0.0;
+                buffer >> noDataValue;
+                for (size_t i = 0; i < numProperties; ++i) {
+                    if (propertyIds[i] == propertyId) {
+                        _properties[i].noDataValue = noDataValue;
+                    } // if
+                } // for
             } else if (0 == strcmp(token.c_str(), "PROP_ESIZE")) {
                 buffer >> propertyId;
-                if (propertyIdTarget == propertyId) {
-                    buffer >> _property.esize;
-                }
+                int esize = 0;
+                buffer >> esize;
+                for (size_t i = 0; i < numProperties; ++i) {
+                    if (propertyIds[i] == propertyId) {
+                        _properties[i].esize = esize;
+                    } // if
+                } // for
             } else if (0 == strcmp(token.c_str(), "PROP_ETYPE")) {
                 buffer >> propertyId;
-                if (propertyIdTarget == propertyId) {
-                    buffer >> _property.etype;
-                }
+                std::string etype;
+                buffer >> etype;
+                for (size_t i = 0; i < numProperties; ++i) {
+                    if (propertyIds[i] == propertyId) {
+                        _properties[i].etype = etype;
+                    } // if
+                } // for
             } else if (0 == strcmp(token.c_str(), "PROP_OFFSET")) {
                 buffer >> propertyId;
-                if (propertyIdTarget == propertyId) {
-                    buffer >> _property.offset;
-                }
+                int offset = 0;
+                buffer >> offset;
+                for (size_t i = 0; i < numProperties; ++i) {
+                    if (propertyIds[i] == propertyId) {
+                        _properties[i].offset = offset;
+                    } // if
+                } // for
             } else if (0 == strcmp(token.c_str(), "PROP_FILE")) {
                 buffer >> propertyId;
-                if (propertyIdTarget == propertyId) {
-                    buffer >> _property.filename;
-                }
+                std::string propertyFilename;
+                buffer >> propertyFilename;
+                for (size_t i = 0; i < numProperties; ++i) {
+                    if (propertyIds[i] == propertyId) {
+                        _properties[i].filename = propertyFilename;
+                    } // if
+                } // for
             } else if (0 == strcmp(token.c_str(), "END")) {
                 break;
             }
@@ -302,6 +500,13 @@ spatialdata::spatialdb::GocadVoxet::_readVoxetFile(const char* filename,
         if (( token != "END") || !vfile.good()) {
             throw std::runtime_error("I/O error while parsing Gocad Voxet tokens.");
         }
+        for (size_t i = 0; i < numProperties; ++i) {
+            if (propertyIds[i] < 0) {
+                std::ostringstream msg;
+                msg << "Could not find property " << properties[i] << " in Gocad Voxet file.";
+                throw std::runtime_error(msg.str());
+            } // if
+        } // for
     } catch (const std::exception& err) {
         std::ostringstream msg;
         msg << "Error occurred while reading Gocad Voxet file '"
@@ -325,16 +530,67 @@ spatialdata::spatialdb::GocadVoxet::_readVoxetFile(const char* filename,
     _geometry.scale[0] = (lenX != 0.0) ? (_geometry.n[0]-1) / lenX : 1.0e+30;
     _geometry.scale[1] = (lenY != 0.0) ? (_geometry.n[1]-1) / lenY : 1.0e+30;
     _geometry.scale[2] = (lenZ != 0.0) ? (_geometry.n[2]-1) / lenZ : 1.0e+30;
+    _geometry.nFile[0] = _geometry.n[0];
+    _geometry.nFile[1] = _geometry.n[1];
 } // _readVoxetFile
 
 
+// ----------------------------------------------------------------------
+// Restrict samples along x and y to those needed for the region.
+void
+spatialdata::spatialdb::GocadVoxet::_cropToRegion(void) {
+    assert(_hasRegion);
+
+    // Queries round to the nearest sample, so the samples bracketing
+    // the region cover all queries inside it. Regions outside the voxet
+    // keep the edge sample, which is the nearest sample for queries in
+    // the region.
+    for (int i = 0; i < 2; ++i) {
+        const double origin = _geometry.o[i] + _geometry.min[i];
+        const int numFile = _geometry.nFile[i];
+        const double indexLower = floor( (_region[i] - origin)*_geometry.scale[i]);
+        const double indexUpper = ceil( (_region[2+i] - origin)*_geometry.scale[i]);
+        const int indexMin = std::min(std::max(indexLower, 0.0), double(numFile-1));
+        const int indexMax = std::min(std::max(indexUpper, 0.0), double(numFile-1));
+        assert(indexMin <= indexMax);
+
+        _geometry.start[i] = indexMin;
+        _geometry.n[i] = indexMax - indexMin + 1;
+    } // for
+} // _cropToRegion
+
+
 // ----------------------------------------------------------------------
 // Read property data.
 void
-spatialdata::spatialdb::GocadVoxet::_readPropertyFile(const char* filename) {
-    assert(sizeof(float) == _property.esize);
+spatialdata::spatialdb::GocadVoxet::_readPropertyFile(const char* filename,
+                                                      const size_t iProperty) {
+    assert(iProperty < _properties.size());
+    assert(sizeof(float) == _properties[iProperty].esize);
     const int nvals = _geometry.n[0] * _geometry.n[1] * _geometry.n[2];
-    delete[] _data;_data = new float[nvals];
+
+    // Use cache file if it is up to date with the property file.
+    std::string cacheFilename;
+    CacheHeader cacheHeader;
+    struct stat sourceInfo;
+    const bool useCache = !_cacheDir.empty() && (0 == stat(filename, &sourceInfo));
+    if (useCache) {
+        memset(&cacheHeader, 0, sizeof(cacheHeader));
+        cacheFilename = _cacheFilename(filename, iProperty, &cacheHeader.sourceHash);
+        assert(strlen(CACHEHEADER) < sizeof(cacheHeader.magic));
+        memcpy(cacheHeader.magic, CACHEHEADER, strlen(CACHEHEADER));
+        cacheHeader.byteOrder = _byteOrder;
+        cacheHeader.numValues = nvals;
+        cacheHeader.numColumns = _geometry.n[0] * _geometry.n[1];
+        cacheHeader.sourceSize = sourceInfo.st_size;
+        cacheHeader.sourceTime = sourceInfo.st_mtime;
+        if (_mapCacheFile(cacheFilename.c_str(), cacheHeader, iProperty)) {
+            return;
+        } // if
+    } // if
+
+    float* data = new float[nvals];
+    _data[iProperty] = data;
 
     try {
         std::ifstream pfile(filename);
@@ -345,8 +601,31 @@ spatialdata::spatialdb::GocadVoxet::_readPropertyFile(const char* filename) {
             throw std::runtime_error(msg.str());
         } // if
 
-        pfile.read((char*) _data, sizeof(float)*nvals);
-        _endianBigToNative(_data, nvals);
+        const int numX = _geometry.n[0];
+        const int numY = _geometry.n[1];
+        const int numZ = _geometry.n[2];
+        const int numXFile = _geometry.nFile[0];
+        const int numYFile = _geometry.nFile[1];
+        if (( numX == numXFile) && ( numY == numYFile) ) {
+            pfile.read((char*) data, sizeof(float)*nvals);
+        } else {
+            // Read rows of samples inside the region.
+            for (int indexZ = 0; indexZ < numZ; ++indexZ) {
+                for (int indexY = 0; indexY < numY; ++indexY) {
+                    const int indexYFile = _geometry.start[1] + indexY;
+                    const int indexFile = (indexZ*numYFile + indexYFile)*numXFile + _geometry.start[0];
+                    pfile.seekg(std::streamoff(indexFile)*sizeof(float));
+                    pfile.read((char*) &data[(indexZ*numY + indexY)*numX], sizeof(float)*numX);
+                } // for
+            } // for
+        } // if/else
+        _endianBigToNative(data, nvals);
+        _findValidRanges(iProperty);
+
+        // Replace values in memory with mapped cache file.
+        if (useCache && pfile.good() && _writeCacheFile(cacheFilename.c_str(), cacheHeader, iProperty)) {
+            _mapCacheFile(cacheFilename.c_str(), cacheHeader, iProperty);
+        } // if
     } catch (const std::exception& err) {
         std::ostringstream msg;
         msg << "Error occurred while reading Gocad Voxet property file '"
@@ -362,6 +641,169 @@ spatialdata::spatialdb::GocadVoxet::_readPropertyFile(const char* filename) {
 } // _readPropertyFile
 
 
+// ----------------------------------------------------------------------
+// Get name of cache file for property file.
+std::string
+spatialdata::spatialdb::GocadVoxet::_cacheFilename(const char* filename,
+                                                   const size_t iProperty,
+                                                   uint64_t* pathHash) const {
+    assert(filename);
+    assert(iProperty < _properties.size());
+    assert(pathHash);
+
+    std::string path(filename);
+    char* absPath = realpath(filename, NULL);
+    if (absPath) {
+        path = absPath;
+        free(absPath);
+    } // if
+
+    // 64-bit FNV-1a hash of absolute path.
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < path.length(); ++i) {
+        hash ^= (unsigned char)path[i];
+        hash *= 0x100000001b3ULL;
+    } // for
+    *pathHash = hash;
+
+    std::ostringstream cacheFilename;
+    cacheFilename << _cacheDir << "/" << _properties[iProperty].filename << "."
+                  << std::hex << std::setw(16) << std::setfill('0') << hash << ".native";
+    return cacheFilename.str();
+} // _cacheFilename
+
+
+// ----------------------------------------------------------------------
+// Map cache file for property into memory.
+bool
+spatialdata::spatialdb::GocadVoxet::_mapCacheFile(const char* filename,
+                                                  const CacheHeader& header,
+                                                  const size_t iProperty) {
+    assert(iProperty < _data.size());
+
+    const int fd = ::open(filename, O_RDONLY);
+    if (fd < 0) {
+        return false;
+    } // if
+    struct stat fileInfo;
+    const size_t fileSize = sizeof(CacheHeader) + header.numValues*sizeof(float) + header.numColumns*2*sizeof(int);
+    if (( fstat(fd, &fileInfo) != 0) || ( size_t(fileInfo.st_size) != fileSize) ) {
+        ::close(fd);
+        return false;
+    } // if
+
+    // Shared read-only mapping lets processes share pages of the file.
+    void* mapping = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+    if (MAP_FAILED == mapping) {
+        return false;
+    } // if
+
+    // Cache file is stale if it does not match property file.
+    CacheHeader headerFile;
+    memcpy(&headerFile, mapping, sizeof(CacheHeader));
+    if (( 0 != strncmp(headerFile.magic, header.magic, sizeof(header.magic))) ||
+        ( headerFile.byteOrder != header.byteOrder) ||
+        ( headerFile.numValues != header.numValues) ||
+        ( headerFile.numColumns != header.numColumns) ||
+        ( headerFile.sourceSize != header.sourceSize) ||
+        ( headerFile.sourceTime != header.sourceTime) ||
+        ( headerFile.sourceHash != header.sourceHash) ) {
+        munmap(mapping, fileSize);
+        return false;
+    } // if
+
+    if (_mappings[iProperty]) {
+        munmap(_mappings[iProperty], _mappingSizes[iProperty]);
+    } else {
+        delete[] _data[iProperty];
+    } // if/else
+    _mappings[iProperty] = mapping;
+    _mappingSizes[iProperty] = fileSize;
+    _data[iProperty] = (const float*)((const char*)mapping + sizeof(CacheHeader));
+    const int* validRanges = (const int*)(_data[iProperty] + header.numValues);
+    _validRanges[iProperty].assign(validRanges, validRanges + header.numColumns*2);
+
+    return true;
+} // _mapCacheFile
+
+
+// ----------------------------------------------------------------------
+// Write cache file for property.
+bool
+spatialdata::spatialdb::GocadVoxet::_writeCacheFile(const char* filename,
+                                                    const CacheHeader& header,
+                                                    const size_t iProperty) const {
+    assert(iProperty < _data.size());
+    assert(_data[iProperty]);
+    assert(_validRanges[iProperty].size() == header.numColumns*2);
+
+    // Write to temporary file and rename so that other processes never
+    // map a partially written cache file.
+    std::ostringstream tmpFilename;
+    tmpFilename << filename << ".tmp" << getpid();
+    std::ofstream fileout(tmpFilename.str().c_str(), std::ios::binary);
+    if (!fileout.is_open() || !fileout.good()) {
+        return false;
+    } // if
+    fileout.write((const char*)&header, sizeof(CacheHeader));
+    fileout.write((const char*)_data[iProperty], header.numValues*sizeof(float));
+    fileout.write((const char*)&_validRanges[iProperty][0], header.numColumns*2*sizeof(int));
+    fileout.close();
+    if (!fileout.good() || ( 0 != rename(tmpFilename.str().c_str(), filename)) ) {
+        remove(tmpFilename.str().c_str());
+        return false;
+    } // if
+
+    return true;
+} // _writeCacheFile
+
+
+// ----------------------------------------------------------------------
+// Find first and last valid samples along z in each column.
+void
+spatialdata::spatialdb::GocadVoxet::_findValidRanges(const size_t iProperty) {
+    assert(iProperty < _data.size());
+    assert(_data[iProperty]);
+
+    const int numX = _geometry.n[0];
+    const int numY = _geometry.n[1];
+    const int numZ = _geometry.n[2];
+    const float* data = _data[iProperty];
+    const double noDataValue = _properties[iProperty].noDataValue;
+
+    // Valid samples satisfy the same test that ends retries in
+    // _findSample(). Samples are visited in storage order.
+    const int numColumns = numX*numY;
+    std::vector<int> numValid(numColumns, 0);
+    std::vector<int>& validRanges = _validRanges[iProperty];
+    validRanges.resize(2*numColumns);
+    for (int iColumn = 0; iColumn < numColumns; ++iColumn) {
+        validRanges[2*iColumn+0] = numZ;
+        validRanges[2*iColumn+1] = -1;
+    } // for
+    for (int indexZ = 0; indexZ < numZ; ++indexZ) {
+        const float* layer = &data[indexZ*numColumns];
+        for (int iColumn = 0; iColumn < numColumns; ++iColumn) {
+            if (fabs(1.0 - layer[iColumn] / noDataValue) > 1.0e-6) {
+                validRanges[2*iColumn+0] = std::min(validRanges[2*iColumn+0], indexZ);
+                validRanges[2*iColumn+1] = indexZ;
+                ++numValid[iColumn];
+            } // if
+        } // for
+    } // for
+
+    // Columns with "no data" samples between valid samples.
+    for (int iColumn = 0; iColumn < numColumns; ++iColumn) {
+        const int first = validRanges[2*iColumn+0];
+        const int last = validRanges[2*iColumn+1];
+        if (( numValid[iColumn] > 0) && ( last - first + 1 != numValid[iColumn]) ) {
+            validRanges[2*iColumn+0] = -1;
+        } // if
+    } // for
+} // _findValidRanges
+
+
 // ----------------------------------------------------------------------
 // Convert array of float values from big endian to native float type.
 void
@@ -385,7 +827,7 @@ spatialdata::spatialdb::GocadVoxet::_endianBigToNative(float* vals,
 // ----------------------------------------------------------------------
 // Reset class data.
 void
-spatialdata::spatialdb::GocadVoxet::_resetData(void) {
+spatialdata::spatialdb::GocadVoxet::_resetData(const size_t numProperties) {
     const float zero[] = { 0.0, 0.0, 0.0 };
     const float one[] = { 1.0, 1.0, 1.0 };
 
@@ -395,6 +837,8 @@ spatialdata::spatialdb::GocadVoxet::_resetData(void) {
     memcpy(_geometry.w, zero, 3*sizeof(float));
     memcpy(_geometry.min, zero, 3*sizeof(float));
     memcpy(_geometry.max, one, 3*sizeof(float));
+    _geometry.start[0] = 0;
+    _geometry.start[1] = 0;
     _geometry.name[0] = "";
     _geometry.name[1] = "";
     _geometry.name[2] = "";
@@ -402,15 +846,29 @@ spatialdata::spatialdb::GocadVoxet::_resetData(void) {
     _geometry.type[1] = "";
     _geometry.type[2] = "";
 
-    _property.name = "";
-    _property.noDataValue = -99999;
-    _property.esize = 4;
-    _property.isSigned = 1;
-    _property.etype = "IEEE";
-    _property.offset = 0;
-    _property.filename = "";
+    Property property;
+    property.name = "";
+    property.noDataValue = -99999;
+    property.esize = 4;
+    property.isSigned = 1;
+    property.etype = "IEEE";
+    property.offset = 0;
+    property.filename = "";
+    _properties.assign(numProperties, property);
+
+    for (size_t i = 0; i < _data.size(); ++i) {
+        if (_mappings[i]) {
+            munmap(_mappings[i], _mappingSizes[i]);
+        } else {
+            delete[] _data[i];
+        } // if/else
+        _data[i] = NULL;
+    } // for
+    _data.assign(numProperties, NULL);
+    _mappings.assign(numProperties, NULL);
+    _validRanges.assign(numProperties, std::vector<int>());
+    _mappingSizes.assign(numProperties, 0);
 
-    delete[] _data;_data = 0;
 } // _resetData
 
 
@@ -26,10 +26,12 @@
 #include "spatialdbfwd.hh" // forward declarations
 
 #include <string> // USES std::string
+#include <vector> // HASA std::vector
+#include <stdint.h> // USES uint64_t
 
 class spatialdata::spatialdb::GocadVoxet
 { // GocadVoxet
-  friend class TestGocadVOxet; // unit testing
+  friend class TestGocadVoxet; // unit testing
 
 // PUBLIC MEMBERS ///////////////////////////////////////////////////////
 public :
@@ -40,7 +42,42 @@ public :
   /// Destructor
   ~GocadVoxet(void);
 
-  /** Read voxet file and property data.
+  /** Set directory for cache files holding property values in native
+   * byte order.
+   *
+   * When set, the values of each property are converted from big
+   * endian once and written to a cache file, which is mapped into
+   * memory when the voxet is read. Processes reading the same voxet
+   * share the pages of the cache file. If the cache file cannot be
+   * written, values are read into memory as usual.
+   *
+   * @param dir Directory for cache files (empty for no cache files).
+   */
+  void setCacheDir(const char* dir);
+
+  /** Set region of voxet to read.
+   *
+   * Only samples along x and y needed for queries inside the region
+   * are read from the property files; all samples along z are read so
+   * that "no data" samples are skipped as for the full voxet. Queries
+   * outside the region are treated as outside the voxet. The region
+   * is ignored if a cache directory is set, because cache files hold
+   * the full voxet and only pages that are queried are loaded.
+   *
+   * @param xMin Minimum x coordinate of region.
+   * @param yMin Minimum y coordinate of region.
+   * @param xMax Maximum x coordinate of region.
+   * @param yMax Maximum y coordinate of region.
+   */
+  void setRegion(const double xMin,
+		 const double yMin,
+		 const double xMax,
+		 const double yMax);
+
+  /// Clear region of voxet to read, so that the full voxet is read.
+  void clearRegion(void);
+
+  /** Read voxet file and data for one property.
    *
    * @param dir Directory containing voxet data files.
    * @param filename Name of voxet file.
@@ -50,23 +87,96 @@ public :
 	    const char* filename,
 	    const char* property);
 
+  /** Read voxet file and data for several properties.
+   *
+   * The voxet file is parsed once and all properties share the same
+   * geometry.
+   *
+   * @param dir Directory containing voxet data files.
+   * @param filename Name of voxet file.
+   * @param properties Names of properties in voxet file to read.
+   * @param numProperties Number of properties to read.
+   */
+  void read(const char* dir,
+	    const char* filename,
+	    const char* const* properties,
+	    const size_t numProperties);
+
+  /** Get number of properties read.
+   *
+   * @returns Number of properties.
+   */
+  size_t getNumProperties(void) const;
+
   /** Query voxet for value.
    *
    * @param value Value for result.
    * @param pt Location of query.
+   * @param iProperty Index of property in order read.
    * @returns 0 if pt is inside voxet, 1 if outside voxet.
    */
   int query(double* value,
-	    const double pt[3]) const;
+	    const double pt[3],
+	    const size_t iProperty=0) const;
 
   /** Query voxet for value at nearest location.
    *
    * @param value Value for result.
    * @param pt Location of query.
+   * @param iProperty Index of property in order read.
    * @returns 0 if pt is inside voxet, 1 if outside voxet.
    */
   int queryNearest(double* value,
-		   const double pt[3]) const;
+		   const double pt[3],
+		   const size_t iProperty=0) const;
+
+  /** Query voxet for single precision value.
+   *
+   * @param value Value for result.
+   * @param pt Location of query.
+   * @param iProperty Index of property in order read.
+   * @returns 0 if pt is inside voxet, 1 if outside voxet.
+   */
+  int query(float* value,
+	    const double pt[3],
+	    const size_t iProperty=0) const;
+
+  /** Query voxet for single precision value at nearest location.
+   *
+   * @param value Value for result.
+   * @param pt Location of query.
+   * @param iProperty Index of property in order read.
+   * @returns 0 if pt is inside voxet, 1 if outside voxet.
+   */
+  int queryNearest(float* value,
+		   const double pt[3],
+		   const size_t iProperty=0) const;
+
+  /** Query voxet for values at multiple locations.
+   *
+   * @param values Array for values [numPts].
+   * @param err Array for error flags, 0 if inside voxet, 1 if outside [numPts].
+   * @param pts Locations of queries [numPts*3].
+   * @param numPts Number of locations.
+   * @param iProperty Index of property in order read.
+   */
+  void queryBatch(double* values,
+		  int* err,
+		  const double* pts,
+		  const size_t numPts,
+		  const size_t iProperty=0) const;
+
+  /** Query voxet for values at nearest location for multiple locations.
+   *
+   * @param values Array for values [numPts].
+   * @param pts Locations of queries [numPts*3].
+   * @param numPts Number of locations.
+   * @param iProperty Index of property in order read.
+   */
+  void queryNearestBatch(double* values,
+			 const double* pts,
+			 const size_t numPts,
+			 const size_t iProperty=0) const;
 
 // NOT IMPLEMENTED //////////////////////////////////////////////////////
 private :
@@ -84,7 +194,9 @@ private :
     float w[3];
     float min[3];
     float max[3];
-    int n[3];
+    int n[3]; ///< Number of samples in memory.
+    int nFile[2]; ///< Number of samples along x and y in property files.
+    int start[2]; ///< Indices along x and y of first sample in memory.
     std::string name[3];
     std::string type[3];
     float scale[3];
@@ -100,22 +212,101 @@ private :
     std::string filename;
   }; // property
 
+  /// Header at start of cache file with values in native byte order.
+  struct CacheHeader {
+    char magic[24]; ///< Magic header (NUL padded).
+    uint64_t byteOrder; ///< Byte order mark.
+    uint64_t numValues; ///< Number of values.
+    uint64_t numColumns; ///< Number of columns (samples along x times samples along y).
+    uint64_t sourceSize; ///< Size of property file.
+    int64_t sourceTime; ///< Modification time of property file.
+    uint64_t sourceHash; ///< Hash of absolute path of property file.
+  }; // CacheHeader
+
 // PRIVATE METHODS //////////////////////////////////////////////////////
 private :
 
   /** Read voxet file.
    *
    * @param filename Name of Gocad voxet file.
-   * @param propertyName Name of property to read.
+   * @param properties Names of properties to read.
+   * @param numProperties Number of properties to read.
    */
   void _readVoxetFile(const char* filename,
-		      const char* propertyName);
+		      const char* const* properties,
+		      const size_t numProperties);
+
+  /// Restrict samples along x and y to those needed for the region.
+  void _cropToRegion(void);
 
   /** Read property file.
    *
    * @param filename Name of voxet data file.
+   * @param iProperty Index of property.
+   */
+  void _readPropertyFile(const char* filename,
+			 const size_t iProperty);
+
+  /** Get name of cache file for property file.
+   *
+   * The name includes a hash of the absolute path of the property
+   * file, so property files with the same name in different
+   * directories use different cache files.
+   *
+   * @param filename Name of property file.
+   * @param iProperty Index of property.
+   * @param pathHash Hash of absolute path of property file (output).
+   * @returns Name of cache file.
+   */
+  std::string _cacheFilename(const char* filename,
+			     const size_t iProperty,
+			     uint64_t* pathHash) const;
+
+  /** Map cache file for property into memory.
+   *
+   * @param filename Name of cache file.
+   * @param header Expected header of cache file.
+   * @param iProperty Index of property.
+   * @returns True if cache file matches header and was mapped, false otherwise.
+   */
+  bool _mapCacheFile(const char* filename,
+		     const CacheHeader& header,
+		     const size_t iProperty);
+
+  /** Write values and valid ranges of property to cache file.
+   *
+   * @param filename Name of cache file.
+   * @param header Header of cache file.
+   * @param iProperty Index of property.
+   * @returns True if cache file was written, false otherwise.
    */
-  void _readPropertyFile(const char* filename);
+  bool _writeCacheFile(const char* filename,
+		       const CacheHeader& header,
+		       const size_t iProperty) const;
+
+  /** Find first and last samples along z in each column that are not
+   * "no data" values.
+   *
+   * @param iProperty Index of property.
+   */
+  void _findValidRanges(const size_t iProperty);
+
+  /** Find sample for location, skipping "no data" samples near the
+   * top and bottom of the voxet.
+   *
+   * @param pt Location of query.
+   * @param iProperty Index of property.
+   * @returns Index of sample or -1 if pt is outside voxet.
+   */
+  int _findSample(const double pt[3],
+		  const size_t iProperty) const;
+
+  /** Find sample nearest location.
+   *
+   * @param pt Location of query.
+   * @returns Index of sample.
+   */
+  int _findNearestSample(const double pt[3]) const;
 
   /** Convert array of float values from big endian to native float type.
    *
@@ -126,15 +317,34 @@ private :
   _endianBigToNative(float* vals,
 		     const int nvals) const;
 
-  /// Reset class data.
-  void _resetData(void);
+  /** Reset class data.
+   *
+   * @param numProperties Number of properties.
+   */
+  void _resetData(const size_t numProperties=0);
 
 // PRIVATE MEMBERS //////////////////////////////////////////////////////
 private :
 
-  Geometry _geometry; ///< Geometry of voxet data.
-  Property _property; ///< Voxet properties.
-  float* _data; ///< Array with data values
+  Geometry _geometry; ///< Geometry of voxet data shared by all properties.
+  std::vector<Property> _properties; ///< Voxet properties.
+  std::vector<const float*> _data; ///< Arrays with data values for each property.
+
+  /** First and last valid samples along z in each column for each
+   * property [numX*numY*2]. Columns with "no data" samples between
+   * valid samples have a first valid sample of -1. Columns without
+   * valid samples have a first valid sample of numZ and a last valid
+   * sample of -1.
+   */
+  std::vector<std::vector<int> > _validRanges;
+  std::vector<void*> _mappings; ///< Mapped cache file for each property (NULL if allocated).
+  std::vector<size_t> _mappingSizes; ///< Size of mapped cache file for each property.
+  std::string _cacheDir; ///< Directory for cache files (empty for no cache files).
+  double _region[4]; ///< Region to read (xMin, yMin, xMax, yMax).
+  bool _hasRegion; ///< True if only region is read.
+
+  static const char* CACHEHEADER; ///< Magic header in cache files.
+  static const uint64_t _byteOrder; ///< Byte order mark.
 
 }; // GocadVoxet
 
@@ -17,11 +17,13 @@
 #include <portinfo>
 
 #include "GravityField.hh" // Implementation of class methods
+#include "QueryContext.hh" // USES QueryContext
 
 #include "spatialdata/geocoords/CoordSys.hh" // USES CoordSys
 #include "spatialdata/geocoords/CSGeo.hh" // USES CSGeo
 
 #include <cmath> // USES sqrt()
+#include <vector> // USES std::vector
 #include <strings.h> // USES strcasecmp()
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringsgream
@@ -166,8 +168,70 @@ spatialdata::spatialdb::GravityField::query(double* vals,
                                             const double* coords,
                                             const size_t numDims,
                                             const spatialdata::geocoords::CoordSys* cs) {
+    int err = 0;
+    queryBatch(_getQueryContext(), vals, numVals, &err, coords, 1, numDims, cs);
+
+    return err;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::GravityField::isThreadSafe(void) const {
+    return true;
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::GravityField::queryBatch(QueryContext* context,
+                                                 double* vals,
+                                                 const size_t numVals,
+                                                 int* err,
+                                                 const double* coords,
+                                                 const size_t numLocs,
+                                                 const size_t numDims,
+                                                 const spatialdata::geocoords::CoordSys* cs) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+    assert(coords);
     assert(cs);
 
+    _checkQuery(numVals);
+
+    if (geocoords::CoordSys::CARTESIAN == cs->getCSType()) {
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            for (size_t i = 0; i < _querySize; ++i) {
+                vals[iLoc*numVals+i] = _acceleration*_gravityDir[_queryValues[i]];
+            } // for
+        } // for
+    } else {
+        const geocoords::CSGeo* csGeo = dynamic_cast<const geocoords::CSGeo*>(cs);
+        std::vector<double> surfaceNormal(numLocs*numDims);
+        csGeo->computeSurfaceNormal(&surfaceNormal[0], coords, numLocs, numDims, context->getConverter(this));
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            for (size_t i = 0; i < _querySize; ++i) {
+                vals[iLoc*numVals+i] = -_acceleration * surfaceNormal[iLoc*numDims+_queryValues[i]];
+            } // for
+        } // for
+    } // if/else
+
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        err[iLoc] = 0;
+    } // for
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Check number of values to be returned by query.
+void
+spatialdata::spatialdb::GravityField::_checkQuery(const size_t numVals) const {
     if (0 == _querySize) {
         std::ostringstream msg;
         msg << "Values to be returned by spatial database " << getLabel() << "\n"
@@ -181,23 +245,7 @@ spatialdata::spatialdb::GravityField::query(double* vals,
             << numVals << ").\n";
         throw std::logic_error(msg.str());
     } // if
-
-    if (geocoords::CoordSys::CARTESIAN == cs->getCSType()) {
-        for (size_t i = 0; i < _querySize; ++i) {
-            vals[i] = _acceleration*_gravityDir[_queryValues[i]];
-        } // for
-    } else {
-        const geocoords::CSGeo* csGeo = dynamic_cast<const geocoords::CSGeo*>(cs);
-        double surfaceNormal[3];
-        const int numLocs = 1;
-        csGeo->computeSurfaceNormal(surfaceNormal, coords, numLocs, numDims);
-        for (size_t i = 0; i < _querySize; ++i) {
-            vals[i] = -_acceleration * surfaceNormal[_queryValues[i]];
-        } // for
-    } // if/else
-
-    return 0;
-} // query
+} // _checkQuery
 
 
 // End of file
@@ -101,10 +101,48 @@ public:
               const size_t numDims,
               const spatialdata::geocoords::CoordSys* cs);
 
+    /** Can the database be queried concurrently?
+     *
+     * The gravity field is not modified by queries.
+     *
+     * @returns True if queryBatch() may be called concurrently using
+     *   separate query contexts, false otherwise.
+     */
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param cs Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* cs);
+
 private:
 
     // PRIVATE METHODS ////////////////////////////////////////////////////
 
+    /** Check number of values to be returned by query.
+     *
+     * @param numVals Number of values expected.
+     */
+    void _checkQuery(const size_t numVals) const;
+
     GravityField(const GravityField& data); ///< Not implemented
     const GravityField& operator=(const GravityField& data); ///< Not implemented
 
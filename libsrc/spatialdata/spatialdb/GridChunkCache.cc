@@ -0,0 +1,192 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "GridChunkCache.hh" // implementation of class methods
+
+#include "GridCompressedBlocks.hh" // USES GridCompressedBlocks
+
+#include <algorithm> // USES std::max(), std::min()
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <cstring> // USES strerror()
+#include <cerrno> // USES errno
+#include <fcntl.h> // USES open()
+#include <unistd.h> // USES pread(), close()
+
+// ----------------------------------------------------------------------
+const size_t spatialdata::spatialdb::GridChunkCache::_minSlots = 8;
+
+// ----------------------------------------------------------------------
+// Constructor.
+spatialdata::spatialdb::GridChunkCache::GridChunkCache(const char* filename,
+                                                       const size_t dataOffset,
+                                                       const size_t chunkSize,
+                                                       const size_t numChunks,
+                                                       const size_t valueSize,
+                                                       const size_t maxSize) :
+    _filename(filename),
+    _fd(-1),
+    _blocks(NULL),
+    _dataOffset(dataOffset),
+    _chunkSize(chunkSize),
+    _numChunks(numChunks),
+    _valueSize(valueSize),
+    _numSlots(0),
+    _buffer(),
+    _slotChunks(),
+    _chunkSlots(),
+    _lru(),
+    _lruSlots(),
+    _lastChunk(numChunks),
+    _lastValues(NULL),
+    _numHits(0),
+    _numMisses(0),
+    _numEvictions(0) {
+    assert(chunkSize > 0);
+    assert(numChunks > 0);
+
+    _fd = ::open(filename, O_RDONLY);
+    if (_fd < 0) {
+        std::ostringstream msg;
+        msg << "Could not open file '" << filename << "' for reading chunks of values.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    _numSlots = std::min(numChunks, std::max(_minSlots, maxSize / chunkSize));
+    _buffer.resize(_numSlots*chunkSize);
+    _slotChunks.resize(_numSlots, numChunks);
+    _chunkSlots.resize(numChunks, _numSlots);
+    _lruSlots.resize(_numSlots, _lru.end());
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Constructor with chunks decompressed from compressed blocks.
+spatialdata::spatialdb::GridChunkCache::GridChunkCache(const GridCompressedBlocks* blocks,
+                                                       const size_t maxSize) :
+    _filename(),
+    _fd(-1),
+    _blocks(blocks),
+    _dataOffset(0),
+    _chunkSize(blocks->getBlockSize()),
+    _numChunks(blocks->getNumBlocks()),
+    _valueSize(blocks->getValueSize()),
+    _numSlots(0),
+    _buffer(),
+    _slotChunks(),
+    _chunkSlots(),
+    _lru(),
+    _lruSlots(),
+    _lastChunk(_numChunks),
+    _lastValues(NULL),
+    _numHits(0),
+    _numMisses(0),
+    _numEvictions(0) {
+    assert(_chunkSize > 0);
+    assert(_numChunks > 0);
+
+    _numSlots = std::min(_numChunks, std::max(_minSlots, maxSize / _chunkSize));
+    _buffer.resize(_numSlots*_chunkSize);
+    _slotChunks.resize(_numSlots, _numChunks);
+    _chunkSlots.resize(_numChunks, _numSlots);
+    _lruSlots.resize(_numSlots, _lru.end());
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Destructor.
+spatialdata::spatialdb::GridChunkCache::~GridChunkCache(void) {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    } // if
+} // destructor
+
+
+// ----------------------------------------------------------------------
+// Reset number of hits, misses, and evictions.
+void
+spatialdata::spatialdb::GridChunkCache::resetStats(void) {
+    _numHits = 0;
+    _numMisses = 0;
+    _numEvictions = 0;
+} // resetStats
+
+
+// ----------------------------------------------------------------------
+// Read or decompress chunk into cache, evicting least recently used
+// chunk if cache is full.
+const char*
+spatialdata::spatialdb::GridChunkCache::_loadChunk(const size_t index) {
+    assert(index < _numChunks);
+    assert(_chunkSlots[index] == _numSlots);
+
+    size_t slot = _numSlots;
+    if (_lru.size() < _numSlots) {
+        slot = _lru.size();
+        _lru.push_front(slot);
+        _lruSlots[slot] = _lru.begin();
+    } else {
+        slot = _lru.back();
+        _lru.splice(_lru.begin(), _lru, _lruSlots[slot]);
+        if (_slotChunks[slot] < _numChunks) {
+            _chunkSlots[_slotChunks[slot]] = _numSlots;
+            ++_numEvictions;
+        } // if
+    } // if/else
+    _slotChunks[slot] = _numChunks;
+    ++_numMisses;
+
+    char* values = &_buffer[slot*_chunkSize];
+    if (_blocks) {
+        _blocks->decompress(index, values);
+        _slotChunks[slot] = index;
+        _chunkSlots[index] = slot;
+        _lastChunk = index;
+        _lastValues = values;
+        return values;
+    } // if
+
+    const off_t offset = _dataOffset + index*_chunkSize;
+    for (size_t numRead = 0; numRead < _chunkSize;) {
+        const ssize_t count = pread(_fd, values+numRead, _chunkSize-numRead, offset+numRead);
+        if (count <= 0) {
+            if (( count < 0) && ( EINTR == errno) ) {
+                continue;
+            } // if
+            std::ostringstream msg;
+            msg << "Could not read chunk " << index << " of values from file '" << _filename << "'";
+            if (count < 0) {
+                msg << " (" << strerror(errno) << ")";
+            } // if
+            msg << ".";
+            _lastChunk = _numChunks;
+            throw std::runtime_error(msg.str());
+        } // if
+        numRead += count;
+    } // for
+
+    _slotChunks[slot] = index;
+    _chunkSlots[index] = slot;
+    _lastChunk = index;
+    _lastValues = values;
+    return values;
+} // _loadChunk
+
+
+// End of file
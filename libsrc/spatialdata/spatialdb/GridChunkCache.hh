@@ -0,0 +1,176 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/GridChunkCache.hh
+ *
+ * @brief C++ least-recently-used cache of fixed-size chunks of values
+ * read from a file or decompressed from compressed blocks.
+ *
+ * The values are divided into chunks of equal size that are read or
+ * decompressed independently when they are requested. The cache holds at
+ * most a fixed number of chunks; when it is full, the chunk that was
+ * used least recently is evicted. The cache counts hits, misses, and
+ * evictions, so the memory budget can be sized for the order of
+ * requests.
+ *
+ * The cache always holds at least eight chunks, so the chunks holding
+ * the corners of a grid cell remain loaded while a point is
+ * interpolated.
+ */
+
+#if !defined(spatialdata_spatialdb_gridchunkcache_hh)
+#define spatialdata_spatialdb_gridchunkcache_hh
+
+#include "spatialdbfwd.hh" // forward declarations
+
+#include <vector> // HASA std::vector
+#include <list> // HASA std::list
+#include <string> // HASA std::string
+#include <cstddef> // USES size_t
+
+class spatialdata::spatialdb::GridChunkCache { // class GridChunkCache
+    friend class TestGridChunkCache; // unit testing
+
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /** Constructor.
+     *
+     * @param filename Name of file holding values.
+     * @param dataOffset Offset in bytes of first chunk in file.
+     * @param chunkSize Size in bytes of each chunk.
+     * @param numChunks Number of chunks in file.
+     * @param valueSize Size in bytes of each value.
+     * @param maxSize Maximum size in bytes of chunks held in cache.
+     */
+    GridChunkCache(const char* filename,
+                   const size_t dataOffset,
+                   const size_t chunkSize,
+                   const size_t numChunks,
+                   const size_t valueSize,
+                   const size_t maxSize);
+
+    /** Constructor with chunks decompressed from compressed blocks.
+     *
+     * @param blocks Compressed blocks of values (must outlive cache).
+     * @param maxSize Maximum size in bytes of chunks held in cache.
+     */
+    GridChunkCache(const GridCompressedBlocks* blocks,
+                   const size_t maxSize);
+
+    /// Destructor.
+    ~GridChunkCache(void);
+
+    /** Get chunk, reading or decompressing it if it is not in the cache.
+     *
+     * The chunk remains valid until eight other chunks are requested.
+     *
+     * @param index Index of chunk.
+     * @returns Contents of chunk.
+     */
+    const char* getChunk(const size_t index);
+
+    /** Get size of each value.
+     *
+     * @returns Size in bytes of each value.
+     */
+    size_t getValueSize(void) const;
+
+    /** Get size of each chunk.
+     *
+     * @returns Size in bytes of each chunk.
+     */
+    size_t getChunkSize(void) const;
+
+    /** Get maximum number of chunks held in cache.
+     *
+     * @returns Maximum number of chunks.
+     */
+    size_t getNumSlots(void) const;
+
+    /** Get number of requests for chunks in the cache.
+     *
+     * @returns Number of hits.
+     */
+    size_t getNumHits(void) const;
+
+    /** Get number of requests for chunks that were read or decompressed.
+     *
+     * @returns Number of misses.
+     */
+    size_t getNumMisses(void) const;
+
+    /** Get number of chunks evicted to make room for other chunks.
+     *
+     * @returns Number of evictions.
+     */
+    size_t getNumEvictions(void) const;
+
+    /// Reset number of hits, misses, and evictions.
+    void resetStats(void);
+
+private:
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Read or decompress chunk into cache, evicting least recently
+     * used chunk if cache is full.
+     *
+     * @param index Index of chunk.
+     * @returns Contents of chunk.
+     */
+    const char* _loadChunk(const size_t index);
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////
+
+    GridChunkCache(const GridChunkCache&); ///< Not implemented
+    const GridChunkCache& operator=(const GridChunkCache&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    static const size_t _minSlots; ///< Minimum number of chunks held in cache.
+
+    std::string _filename; ///< Name of file holding values.
+    int _fd; ///< File descriptor of file holding values (-1 if values are compressed).
+    const GridCompressedBlocks* _blocks; ///< Compressed blocks of values (NULL if values are in file).
+    const size_t _dataOffset; ///< Offset in bytes of first chunk in file.
+    const size_t _chunkSize; ///< Size in bytes of each chunk.
+    const size_t _numChunks; ///< Number of chunks in file.
+    const size_t _valueSize; ///< Size in bytes of each value.
+    size_t _numSlots; ///< Maximum number of chunks held in cache.
+
+    std::vector<char> _buffer; ///< Contents of chunks in cache [numSlots*chunkSize].
+    std::vector<size_t> _slotChunks; ///< Index of chunk held in each slot (numChunks if empty).
+    std::vector<size_t> _chunkSlots; ///< Slot holding each chunk (numSlots if not in cache).
+    std::list<size_t> _lru; ///< Slots in order of use, most recently used first.
+    std::vector<std::list<size_t>::iterator> _lruSlots; ///< Position of each slot in list of slots.
+    size_t _lastChunk; ///< Index of chunk requested most recently (numChunks if none).
+    const char* _lastValues; ///< Contents of chunk requested most recently.
+
+    size_t _numHits; ///< Number of requests for chunks in the cache.
+    size_t _numMisses; ///< Number of requests for chunks read from file or decompressed.
+    size_t _numEvictions; ///< Number of chunks evicted.
+
+}; // class GridChunkCache
+
+#include "GridChunkCache.icc" // inline methods
+
+#endif // spatialdata_spatialdb_gridchunkcache_hh
+
+// End of file
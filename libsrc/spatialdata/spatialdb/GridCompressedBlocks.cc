@@ -0,0 +1,320 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "GridCompressedBlocks.hh" // implementation of class methods
+
+#include <algorithm> // USES std::min()
+#include <cmath> // USES fabs(), llround()
+#include <cstring> // USES memcpy(), memcmp()
+#include <cassert> // USES assert()
+
+// ----------------------------------------------------------------------
+// Constructor.
+spatialdata::spatialdb::GridCompressedBlocks::GridCompressedBlocks(const size_t blockSize,
+                                                                   const size_t numValues) :
+    _blockSize(blockSize),
+    _numValues(numValues),
+    _numPoints(0),
+    _valueSize(0),
+    _bytes(),
+    _offsets(1, 0) {
+    assert(blockSize > 0);
+    assert(numValues > 0);
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Destructor.
+spatialdata::spatialdb::GridCompressedBlocks::~GridCompressedBlocks(void) {}
+
+
+// ----------------------------------------------------------------------
+// Compress values in double precision.
+void
+spatialdata::spatialdb::GridCompressedBlocks::compress(const double* data,
+                                                       const size_t numPoints,
+                                                       const double* tolerances) {
+    _compress<double, uint64_t>(data, numPoints, tolerances);
+} // compress
+
+
+// ----------------------------------------------------------------------
+// Compress values in single precision.
+void
+spatialdata::spatialdb::GridCompressedBlocks::compress(const float* data,
+                                                       const size_t numPoints,
+                                                       const double* tolerances) {
+    _compress<float, uint32_t>(data, numPoints, tolerances);
+} // compress
+
+
+// ----------------------------------------------------------------------
+// Decompress block.
+void
+spatialdata::spatialdb::GridCompressedBlocks::decompress(const size_t index,
+                                                         char* values) const {
+    assert(index < getNumBlocks());
+    assert(values);
+
+    if (sizeof(float) == _valueSize) {
+        _decompress<float, uint32_t>(index, (float*)values);
+    } else {
+        _decompress<double, uint64_t>(index, (double*)values);
+    } // if/else
+} // decompress
+
+
+// ----------------------------------------------------------------------
+// Get number of blocks.
+size_t
+spatialdata::spatialdb::GridCompressedBlocks::getNumBlocks(void) const {
+    return _offsets.size() - 1;
+} // getNumBlocks
+
+
+// ----------------------------------------------------------------------
+// Get size of each decompressed block.
+size_t
+spatialdata::spatialdb::GridCompressedBlocks::getBlockSize(void) const {
+    return _blockSize*_numValues*_valueSize;
+} // getBlockSize
+
+
+// ----------------------------------------------------------------------
+// Get size of each value.
+size_t
+spatialdata::spatialdb::GridCompressedBlocks::getValueSize(void) const {
+    return _valueSize;
+} // getValueSize
+
+
+// ----------------------------------------------------------------------
+// Get size of compressed blocks.
+size_t
+spatialdata::spatialdb::GridCompressedBlocks::getCompressedSize(void) const {
+    return _bytes.size() + _offsets.size()*sizeof(size_t);
+} // getCompressedSize
+
+
+// ----------------------------------------------------------------------
+// Compress values.
+template<typename D, typename U>
+void
+spatialdata::spatialdb::GridCompressedBlocks::_compress(const D* data,
+                                                        const size_t numPoints,
+                                                        const double* tolerances) {
+    assert(sizeof(D) == sizeof(U));
+    assert(data || !numPoints);
+    assert(tolerances);
+
+    const size_t numValues = _numValues;
+    const size_t numBlocks = (numPoints + _blockSize - 1) / _blockSize;
+    _numPoints = numPoints;
+    _valueSize = sizeof(D);
+    _bytes.clear();
+    _offsets.resize(numBlocks+1);
+
+    std::vector<int64_t> quantized;
+    for (size_t iBlock = 0; iBlock < numBlocks; ++iBlock) {
+        _offsets[iBlock] = _bytes.size();
+        const size_t numBlockPoints = std::min(_blockSize, numPoints - iBlock*_blockSize);
+        const D* block = data + iBlock*_blockSize*numValues;
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            const D* values = block + iVal;
+
+            bool isConstant = true;
+            for (size_t iPoint = 1; iPoint < numBlockPoints && isConstant; ++iPoint) {
+                isConstant = 0 == memcmp(&values[iPoint*numValues], &values[0], sizeof(D));
+            } // for
+            if (isConstant) {
+                _bytes.push_back(CONSTANT);
+                _bytes.insert(_bytes.end(), (const unsigned char*)&values[0], (const unsigned char*)&values[0] + sizeof(D));
+                continue;
+            } // if
+
+            const double step = 2.0*tolerances[iVal];
+            if (( step > 0.0) && _quantize(&quantized, values, numBlockPoints, step) ) {
+                _bytes.push_back(QUANTIZED);
+                _bytes.insert(_bytes.end(), (const unsigned char*)&step, (const unsigned char*)&step + sizeof(step));
+                int64_t previous = 0;
+                for (size_t iPoint = 0; iPoint < numBlockPoints; ++iPoint) {
+                    _appendVarint(quantized[iPoint] - previous);
+                    previous = quantized[iPoint];
+                } // for
+                continue;
+            } // if
+
+            // Pairs of points share a byte holding the number of
+            // significant bytes of each difference.
+            _bytes.push_back(XOR);
+            U previous = 0;
+            for (size_t iPoint = 0; iPoint < numBlockPoints; iPoint += 2) {
+                U diffs[2] = { 0, 0 };
+                size_t numBytes[2] = { 0, 0 };
+                for (size_t j = 0; j < 2 && iPoint+j < numBlockPoints; ++j) {
+                    U bits;
+                    memcpy(&bits, &values[(iPoint+j)*numValues], sizeof(U));
+                    diffs[j] = bits ^ previous;
+                    previous = bits;
+                    while (numBytes[j] < sizeof(U) && (diffs[j] >> (8*numBytes[j]))) {
+                        ++numBytes[j];
+                    } // while
+                } // for
+                _bytes.push_back((unsigned char)(numBytes[0] | (numBytes[1] << 4)));
+                for (size_t j = 0; j < 2; ++j) {
+                    for (size_t iByte = 0; iByte < numBytes[j]; ++iByte) {
+                        _bytes.push_back((unsigned char)(diffs[j] >> (8*iByte)));
+                    } // for
+                } // for
+            } // for
+        } // for
+    } // for
+    _offsets[numBlocks] = _bytes.size();
+
+    // Release capacity left over from growing the compressed blocks.
+    std::vector<unsigned char>(_bytes).swap(_bytes);
+} // _compress
+
+
+// ----------------------------------------------------------------------
+// Decompress block.
+template<typename D, typename U>
+void
+spatialdata::spatialdb::GridCompressedBlocks::_decompress(const size_t index,
+                                                          D* values) const {
+    assert(sizeof(D) == _valueSize);
+
+    const size_t numValues = _numValues;
+    const size_t numBlockPoints = std::min(_blockSize, _numPoints - index*_blockSize);
+    const unsigned char* pos = &_bytes[0] + _offsets[index];
+    for (size_t iVal = 0; iVal < numValues; ++iVal) {
+        D* blockValues = values + iVal;
+        const unsigned char encoding = *pos++;
+        switch (encoding) {
+        case CONSTANT: {
+            D value;
+            memcpy(&value, pos, sizeof(D));
+            pos += sizeof(D);
+            for (size_t iPoint = 0; iPoint < numBlockPoints; ++iPoint) {
+                blockValues[iPoint*numValues] = value;
+            } // for
+            break;
+        } // CONSTANT
+        case QUANTIZED: {
+            double step;
+            memcpy(&step, pos, sizeof(step));
+            pos += sizeof(step);
+            int64_t quantized = 0;
+            for (size_t iPoint = 0; iPoint < numBlockPoints; ++iPoint) {
+                quantized += _readVarint(&pos);
+                blockValues[iPoint*numValues] = D(double(quantized)*step);
+            } // for
+            break;
+        } // QUANTIZED
+        case XOR: {
+            U previous = 0;
+            for (size_t iPoint = 0; iPoint < numBlockPoints; iPoint += 2) {
+                const unsigned char counts = *pos++;
+                const size_t numBytes[2] = { size_t(counts & 0x0f), size_t(counts >> 4) };
+                for (size_t j = 0; j < 2 && iPoint+j < numBlockPoints; ++j) {
+                    U diff = 0;
+                    for (size_t iByte = 0; iByte < numBytes[j]; ++iByte) {
+                        diff |= U(*pos++) << (8*iByte);
+                    } // for
+                    previous ^= diff;
+                    memcpy(&blockValues[(iPoint+j)*numValues], &previous, sizeof(U));
+                } // for
+            } // for
+            break;
+        } // XOR
+        default:
+            assert(false);
+        } // switch
+    } // for
+    assert(pos == &_bytes[0] + _offsets[index+1]);
+} // _decompress
+
+
+// ----------------------------------------------------------------------
+// Quantize values of a block.
+template<typename D>
+bool
+spatialdata::spatialdb::GridCompressedBlocks::_quantize(std::vector<int64_t>* quantized,
+                                                        const D* values,
+                                                        const size_t numPoints,
+                                                        const double step) const {
+    assert(quantized);
+    assert(step > 0.0);
+
+    // Multiples must be exact in double precision.
+    const double maxMultiple = 4503599627370496.0; // 2**52
+    const double tolerance = 0.5*step;
+    quantized->resize(numPoints);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        const double value = values[iPoint*_numValues];
+        const double multiple = value / step;
+        if (!(fabs(multiple) < maxMultiple)) {
+            return false;
+        } // if
+        const int64_t q = llround(multiple);
+        const D reconstructed = D(double(q)*step);
+        if (!(fabs(double(reconstructed) - value) <= tolerance)) {
+            return false;
+        } // if
+        (*quantized)[iPoint] = q;
+    } // for
+
+    return true;
+} // _quantize
+
+
+// ----------------------------------------------------------------------
+// Append integer as variable-length integer.
+void
+spatialdata::spatialdb::GridCompressedBlocks::_appendVarint(const int64_t value) {
+    // Zigzag encoding keeps small negative differences small.
+    uint64_t bits = (uint64_t(value) << 1) ^ uint64_t(value >> 63);
+    while (bits >= 0x80) {
+        _bytes.push_back((unsigned char)(bits | 0x80));
+        bits >>= 7;
+    } // while
+    _bytes.push_back((unsigned char)bits);
+} // _appendVarint
+
+
+// ----------------------------------------------------------------------
+// Read variable-length integer.
+int64_t
+spatialdata::spatialdb::GridCompressedBlocks::_readVarint(const unsigned char** pos) {
+    assert(pos && *pos);
+
+    const unsigned char* p = *pos;
+    uint64_t bits = 0;
+    size_t shift = 0;
+    while (*p & 0x80) {
+        bits |= uint64_t(*p++ & 0x7f) << shift;
+        shift += 7;
+    } // while
+    bits |= uint64_t(*p++) << shift;
+    *pos = p;
+
+    return int64_t(bits >> 1) ^ -int64_t(bits & 1);
+} // _readVarint
+
+
+// End of file
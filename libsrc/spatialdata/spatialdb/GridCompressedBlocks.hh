@@ -0,0 +1,200 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/GridCompressedBlocks.hh
+ *
+ * @brief C++ values at grid points compressed in fixed-size blocks of
+ * points.
+ *
+ * Each block is compressed independently, so a block can be
+ * decompressed without the others. Within a block, each value is
+ * compressed separately as a sequence over the points in the block:
+ *
+ * - A value that is the same at all points is stored once.
+ * - Lossless compression stores the bits that differ from the value
+ *   at the previous point (XOR), so smoothly varying values only
+ *   store the low-order bytes of their mantissas.
+ * - Lossy compression rounds values to multiples of twice the
+ *   tolerance and stores the differences between consecutive
+ *   multiples as variable-length integers. Values that cannot be
+ *   reconstructed within the tolerance are stored losslessly.
+ */
+
+#if !defined(spatialdata_spatialdb_gridcompressedblocks_hh)
+#define spatialdata_spatialdb_gridcompressedblocks_hh
+
+#include "spatialdbfwd.hh" // forward declarations
+
+#include <vector> // HASA std::vector
+#include <stdint.h> // USES int64_t
+#include <cstddef> // USES size_t
+
+class spatialdata::spatialdb::GridCompressedBlocks { // class GridCompressedBlocks
+    friend class TestGridCompressedBlocks; // unit testing
+
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /** Constructor.
+     *
+     * @param blockSize Number of points in each block.
+     * @param numValues Number of values at each point.
+     */
+    GridCompressedBlocks(const size_t blockSize,
+                         const size_t numValues);
+
+    /// Destructor.
+    ~GridCompressedBlocks(void);
+
+    /** Compress values in double precision.
+     *
+     * @param data Array of values with values interleaved [numPoints*numValues].
+     * @param numPoints Number of points.
+     * @param tolerances Maximum absolute error of each value (0 for lossless) [numValues].
+     */
+    void compress(const double* data,
+                  const size_t numPoints,
+                  const double* tolerances);
+
+    /** Compress values in single precision.
+     *
+     * @param data Array of values with values interleaved [numPoints*numValues].
+     * @param numPoints Number of points.
+     * @param tolerances Maximum absolute error of each value (0 for lossless) [numValues].
+     */
+    void compress(const float* data,
+                  const size_t numPoints,
+                  const double* tolerances);
+
+    /** Decompress block.
+     *
+     * The last block may hold fewer points than the others; the
+     * values after its last point are not set.
+     *
+     * @param index Index of block.
+     * @param values Array for values in block [blockSize*numValues].
+     */
+    void decompress(const size_t index,
+                    char* values) const;
+
+    /** Get number of blocks.
+     *
+     * @returns Number of blocks.
+     */
+    size_t getNumBlocks(void) const;
+
+    /** Get size of each decompressed block.
+     *
+     * @returns Size in bytes of each block.
+     */
+    size_t getBlockSize(void) const;
+
+    /** Get size of each value.
+     *
+     * @returns Size in bytes of each value (0 if no values are compressed).
+     */
+    size_t getValueSize(void) const;
+
+    /** Get size of compressed blocks.
+     *
+     * @returns Size in bytes of compressed blocks, including their offsets.
+     */
+    size_t getCompressedSize(void) const;
+
+private:
+
+    // PRIVATE ENUMS //////////////////////////////////////////////////////
+
+    /// Encoding of a value in a block.
+    enum EncodingEnum {
+        CONSTANT=0, ///< Same value at all points.
+        XOR=1, ///< Bits that differ from previous point.
+        QUANTIZED=2, ///< Differences between consecutive multiples of step.
+    }; // EncodingEnum
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Compress values.
+     *
+     * @param data Array of values with values interleaved [numPoints*numValues].
+     * @param numPoints Number of points.
+     * @param tolerances Maximum absolute error of each value [numValues].
+     */
+    template<typename D, typename U>
+    void _compress(const D* data,
+                   const size_t numPoints,
+                   const double* tolerances);
+
+    /** Decompress block.
+     *
+     * @param index Index of block.
+     * @param values Array for values in block [blockSize*numValues].
+     */
+    template<typename D, typename U>
+    void _decompress(const size_t index,
+                     D* values) const;
+
+    /** Quantize values of a block.
+     *
+     * @param quantized Multiples of step for values.
+     * @param values Array of values at points in block with stride numValues.
+     * @param numPoints Number of points in block.
+     * @param step Distance between quantized values.
+     * @returns True if all values are reconstructed within half the step.
+     */
+    template<typename D>
+    bool _quantize(std::vector<int64_t>* quantized,
+                   const D* values,
+                   const size_t numPoints,
+                   const double step) const;
+
+    /** Append integer as variable-length integer.
+     *
+     * @param value Integer.
+     */
+    void _appendVarint(const int64_t value);
+
+    /** Read variable-length integer.
+     *
+     * @param pos Position of integer, updated to position after integer.
+     * @returns Integer.
+     */
+    static
+    int64_t _readVarint(const unsigned char** pos);
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////
+
+    GridCompressedBlocks(const GridCompressedBlocks&); ///< Not implemented
+    const GridCompressedBlocks& operator=(const GridCompressedBlocks&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    const size_t _blockSize; ///< Number of points in each block.
+    const size_t _numValues; ///< Number of values at each point.
+    size_t _numPoints; ///< Number of points.
+    size_t _valueSize; ///< Size in bytes of each value.
+
+    std::vector<unsigned char> _bytes; ///< Compressed blocks.
+    std::vector<size_t> _offsets; ///< Offset of each block in compressed blocks [numBlocks+1].
+
+}; // class GridCompressedBlocks
+
+#endif // spatialdata_spatialdb_gridcompressedblocks_hh
+
+// End of file
@@ -0,0 +1,344 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "GridInterpolator.hh" // implementation of class methods
+
+#include <stdexcept> // USES std::invalid_argument
+#include <cassert> // USES assert()
+
+// AVX2 and AVX-512 kernels are compiled for the target instruction set
+// using function attributes and selected at runtime, so the library
+// does not require compiler flags for a specific processor.
+#if defined(__x86_64__) && defined(__GNUC__)
+#define SPATIALDATA_X86_SIMD
+#include <immintrin.h> // USES AVX2 and AVX-512 intrinsics
+#endif
+
+// Contracting a multiply and add into a fused multiply-add changes the
+// rounding, and the compiler only does so for instruction sets that
+// provide it. This file is compiled with -ffp-contract=off (see
+// Makefile.am) so the scalar, AVX2, and AVX-512 kernels give identical
+// results.
+
+// ----------------------------------------------------------------------
+const size_t spatialdata::spatialdb::GridInterpolator::_maxPoints;
+const size_t spatialdata::spatialdb::GridInterpolator::_maxCorners;
+
+// ----------------------------------------------------------------------
+// Constructor.
+spatialdata::spatialdb::GridInterpolator::GridInterpolator(const double* data,
+                                                           const size_t* queryValues,
+                                                           const size_t querySize,
+                                                           const size_t dim) :
+    _data(data),
+    _dataF(NULL),
+    _queryValues(queryValues),
+    _querySize(querySize),
+    _dim(dim),
+    _numCorners(size_t(1) << dim),
+    _simd(getSimdSupported()),
+    _numPoints(0) {
+    assert(dim >= 1 && dim <= 3);
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Constructor with values stored in single precision.
+spatialdata::spatialdb::GridInterpolator::GridInterpolator(const float* data,
+                                                           const size_t* queryValues,
+                                                           const size_t querySize,
+                                                           const size_t dim) :
+    _data(NULL),
+    _dataF(data),
+    _queryValues(queryValues),
+    _querySize(querySize),
+    _dim(dim),
+    _numCorners(size_t(1) << dim),
+    _simd(getSimdSupported()),
+    _numPoints(0) {
+    assert(dim >= 1 && dim <= 3);
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Destructor.
+spatialdata::spatialdb::GridInterpolator::~GridInterpolator(void) {}
+
+
+// ----------------------------------------------------------------------
+// Set instruction set used to gather and sum values.
+void
+spatialdata::spatialdb::GridInterpolator::setSimd(const SimdEnum value) {
+    if (value > getSimdSupported()) {
+        throw std::invalid_argument("Instruction set for grid interpolation is not supported by processor.");
+    } // if
+    _simd = value;
+} // setSimd
+
+
+// ----------------------------------------------------------------------
+// Get best instruction set supported by processor.
+spatialdata::spatialdb::GridInterpolator::SimdEnum
+spatialdata::spatialdb::GridInterpolator::getSimdSupported(void) {
+#if defined(SPATIALDATA_X86_SIMD)
+    static const SimdEnum simd = __builtin_cpu_supports("avx512f") ? AVX512 :
+                                 __builtin_cpu_supports("avx2") ? AVX2 : SCALAR;
+    return simd;
+#else
+    return SCALAR;
+#endif
+} // getSimdSupported
+
+
+// ----------------------------------------------------------------------
+// Interpolate values at points in block and clear block.
+void
+spatialdata::spatialdb::GridInterpolator::interpolate(double* vals,
+                                                      const size_t numVals) {
+    if (_dataF) {
+        _interpolate(vals, numVals, _dataF);
+    } else {
+        _interpolate(vals, numVals, _data);
+    } // if/else
+} // interpolate
+
+
+// ----------------------------------------------------------------------
+// Interpolate single precision values at points in block and clear block.
+void
+spatialdata::spatialdb::GridInterpolator::interpolate(float* vals,
+                                                      const size_t numVals) {
+    if (_dataF) {
+        _interpolate(vals, numVals, _dataF);
+    } else {
+        _interpolate(vals, numVals, _data);
+    } // if/else
+} // interpolate
+
+
+// ----------------------------------------------------------------------
+// Interpolate values at points in block and clear block.
+template<typename T, typename D>
+void
+spatialdata::spatialdb::GridInterpolator::_interpolate(T* vals,
+                                                       const size_t numVals,
+                                                       const D* data) {
+    assert(vals);
+    assert(data);
+
+    _computeWeights();
+
+    const size_t numPoints = _numPoints;
+    for (size_t iVal = 0; iVal < _querySize; ++iVal) {
+        const size_t qVal = _queryValues[iVal];
+        size_t iStart = 0;
+        switch (_simd) {
+        case AVX512:
+            iStart = _sumAVX512(data, qVal);
+            break;
+        case AVX2:
+            iStart = _sumAVX2(data, qVal);
+            break;
+        case SCALAR:
+            break;
+        default:
+            assert(0);
+            throw std::logic_error("Unknown instruction set in GridInterpolator::interpolate().");
+        } // switch
+        _sumScalar(data, iStart, qVal);
+
+        for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+            vals[_locs[iPoint]*numVals+iVal] = _results[iPoint];
+        } // for
+    } // for
+
+    _numPoints = 0;
+} // _interpolate
+
+
+// ----------------------------------------------------------------------
+// Compute weights of corners from weights along each dimension.
+void
+spatialdata::spatialdb::GridInterpolator::_computeWeights(void) {
+    // Corner i uses the upper point along dimension iDim if bit
+    // (dim-1-iDim) of i is set, so the corners are ordered with the
+    // last dimension varying fastest. Each loop over points is
+    // independent and vectorizes.
+    const size_t numPoints = _numPoints;
+    for (size_t iCorner = 0; iCorner < _numCorners; ++iCorner) {
+        double* weights = &_weights[iCorner*_maxPoints];
+        for (size_t iDim = 0; iDim < _dim; ++iDim) {
+            const double* wtsLower = &_wtsLower[iDim*_maxPoints];
+            const bool isUpper = (iCorner >> (_dim-1-iDim)) & 1;
+            if (0 == iDim) {
+                for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+                    weights[iPoint] = isUpper ? 1.0 - wtsLower[iPoint] : wtsLower[iPoint];
+                } // for
+            } else {
+                for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+                    weights[iPoint] *= isUpper ? 1.0 - wtsLower[iPoint] : wtsLower[iPoint];
+                } // for
+            } // if/else
+        } // for
+    } // for
+} // _computeWeights
+
+
+// ----------------------------------------------------------------------
+// Sum weighted values at corners using scalar code.
+template<typename D>
+void
+spatialdata::spatialdb::GridInterpolator::_sumScalar(const D* data,
+                                                     const size_t iStart,
+                                                     const size_t qVal) {
+    const size_t numPoints = _numPoints;
+    for (size_t iPoint = iStart; iPoint < numPoints; ++iPoint) {
+        double sum = _weights[iPoint] * double(data[_offsets[iPoint]+qVal]);
+        for (size_t iCorner = 1; iCorner < _numCorners; ++iCorner) {
+            const size_t index = iCorner*_maxPoints+iPoint;
+            sum += _weights[index] * double(data[_offsets[index]+qVal]);
+        } // for
+        _results[iPoint] = sum;
+    } // for
+} // _sumScalar
+
+
+// ----------------------------------------------------------------------
+// Sum weighted values at corners using AVX2 instructions.
+#if defined(SPATIALDATA_X86_SIMD)
+__attribute__((target("avx2")))
+#endif
+size_t
+spatialdata::spatialdb::GridInterpolator::_sumAVX2(const double* data,
+                                                   const size_t qVal) {
+#if defined(SPATIALDATA_X86_SIMD)
+    const size_t width = 4;
+    const size_t numPoints = _numPoints - _numPoints % width;
+    const __m256i offsetVal = _mm256_set1_epi64x(qVal);
+    for (size_t iPoint = 0; iPoint < numPoints; iPoint += width) {
+        __m256i index = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&_offsets[iPoint]), offsetVal);
+        __m256d sum = _mm256_mul_pd(_mm256_loadu_pd(&_weights[iPoint]), _mm256_i64gather_pd(data, index, sizeof(double)));
+        for (size_t iCorner = 1; iCorner < _numCorners; ++iCorner) {
+            const size_t iOffset = iCorner*_maxPoints+iPoint;
+            index = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&_offsets[iOffset]), offsetVal);
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(&_weights[iOffset]), _mm256_i64gather_pd(data, index, sizeof(double))));
+        } // for
+        _mm256_storeu_pd(&_results[iPoint], sum);
+    } // for
+    return numPoints;
+#else
+    return 0;
+#endif
+} // _sumAVX2
+
+
+// ----------------------------------------------------------------------
+// Sum weighted single precision values at corners using AVX2 instructions.
+#if defined(SPATIALDATA_X86_SIMD)
+__attribute__((target("avx2")))
+#endif
+size_t
+spatialdata::spatialdb::GridInterpolator::_sumAVX2(const float* data,
+                                                   const size_t qVal) {
+#if defined(SPATIALDATA_X86_SIMD)
+    const size_t width = 4;
+    const size_t numPoints = _numPoints - _numPoints % width;
+    const __m256i offsetVal = _mm256_set1_epi64x(qVal);
+    for (size_t iPoint = 0; iPoint < numPoints; iPoint += width) {
+        __m256i index = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&_offsets[iPoint]), offsetVal);
+        __m256d sum = _mm256_mul_pd(_mm256_loadu_pd(&_weights[iPoint]), _mm256_cvtps_pd(_mm256_i64gather_ps(data, index, sizeof(float))));
+        for (size_t iCorner = 1; iCorner < _numCorners; ++iCorner) {
+            const size_t iOffset = iCorner*_maxPoints+iPoint;
+            index = _mm256_add_epi64(_mm256_loadu_si256((const __m256i*)&_offsets[iOffset]), offsetVal);
+            sum = _mm256_add_pd(sum, _mm256_mul_pd(_mm256_loadu_pd(&_weights[iOffset]), _mm256_cvtps_pd(_mm256_i64gather_ps(data, index, sizeof(float)))));
+        } // for
+        _mm256_storeu_pd(&_results[iPoint], sum);
+    } // for
+    return numPoints;
+#else
+    return 0;
+#endif
+} // _sumAVX2
+
+
+// ----------------------------------------------------------------------
+// Sum weighted values at corners using AVX-512 instructions.
+#if defined(SPATIALDATA_X86_SIMD)
+__attribute__((target("avx512f")))
+#endif
+size_t
+spatialdata::spatialdb::GridInterpolator::_sumAVX512(const double* data,
+                                                     const size_t qVal) {
+#if defined(SPATIALDATA_X86_SIMD)
+    const size_t width = 8;
+    const size_t numPoints = _numPoints - _numPoints % width;
+    const __m512i offsetVal = _mm512_set1_epi64(qVal);
+    // Masked gather with explicit source avoids an uninitialized source register.
+    const __m512d zero = _mm512_setzero_pd();
+    const __mmask8 allLanes = 0xFF;
+    for (size_t iPoint = 0; iPoint < numPoints; iPoint += width) {
+        __m512i index = _mm512_add_epi64(_mm512_loadu_si512(&_offsets[iPoint]), offsetVal);
+        __m512d sum = _mm512_mul_pd(_mm512_loadu_pd(&_weights[iPoint]), _mm512_mask_i64gather_pd(zero, allLanes, index, data, sizeof(double)));
+        for (size_t iCorner = 1; iCorner < _numCorners; ++iCorner) {
+            const size_t iOffset = iCorner*_maxPoints+iPoint;
+            index = _mm512_add_epi64(_mm512_loadu_si512(&_offsets[iOffset]), offsetVal);
+            sum = _mm512_add_pd(sum, _mm512_mul_pd(_mm512_loadu_pd(&_weights[iOffset]), _mm512_mask_i64gather_pd(zero, allLanes, index, data, sizeof(double))));
+        } // for
+        _mm512_storeu_pd(&_results[iPoint], sum);
+    } // for
+    return numPoints;
+#else
+    return 0;
+#endif
+} // _sumAVX512
+
+
+// ----------------------------------------------------------------------
+// Sum weighted single precision values at corners using AVX-512 instructions.
+#if defined(SPATIALDATA_X86_SIMD)
+__attribute__((target("avx512f")))
+#endif
+size_t
+spatialdata::spatialdb::GridInterpolator::_sumAVX512(const float* data,
+                                                     const size_t qVal) {
+#if defined(SPATIALDATA_X86_SIMD)
+    const size_t width = 8;
+    const size_t numPoints = _numPoints - _numPoints % width;
+    const __m512i offsetVal = _mm512_set1_epi64(qVal);
+    // Masked operations with explicit source avoid an uninitialized source register.
+    const __m256 zero = _mm256_setzero_ps();
+    const __m512d zeroD = _mm512_setzero_pd();
+    const __mmask8 allLanes = 0xFF;
+    for (size_t iPoint = 0; iPoint < numPoints; iPoint += width) {
+        __m512i index = _mm512_add_epi64(_mm512_loadu_si512(&_offsets[iPoint]), offsetVal);
+        __m512d sum = _mm512_mul_pd(_mm512_loadu_pd(&_weights[iPoint]), _mm512_mask_cvtps_pd(zeroD, allLanes, _mm512_mask_i64gather_ps(zero, allLanes, index, data, sizeof(float))));
+        for (size_t iCorner = 1; iCorner < _numCorners; ++iCorner) {
+            const size_t iOffset = iCorner*_maxPoints+iPoint;
+            index = _mm512_add_epi64(_mm512_loadu_si512(&_offsets[iOffset]), offsetVal);
+            sum = _mm512_add_pd(sum, _mm512_mul_pd(_mm512_loadu_pd(&_weights[iOffset]), _mm512_mask_cvtps_pd(zeroD, allLanes, _mm512_mask_i64gather_ps(zero, allLanes, index, data, sizeof(float)))));
+        } // for
+        _mm512_storeu_pd(&_results[iPoint], sum);
+    } // for
+    return numPoints;
+#else
+    return 0;
+#endif
+} // _sumAVX512
+
+
+// End of file
@@ -0,0 +1,231 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/GridInterpolator.hh
+ *
+ * @brief C++ kernel for linear interpolation of gridded values at a
+ * block of points.
+ *
+ * The caller adds points to the block, each with the offsets of the
+ * 2^dim grid points (corners) of the cell containing it and the
+ * weights of the lower corner along each dimension. interpolate()
+ * computes the corner weights for all points in the block and then
+ * gathers and sums the values at the corners for one value at a time
+ * over all points. On x86-64 processors the gather and sum uses
+ * AVX-512 or AVX2 instructions if the processor supports them
+ * (detected at runtime), otherwise scalar code is used. Values at
+ * grid points may be stored in double or single precision; sums are
+ * always computed in double precision.
+ *
+ * The corner values are summed in the same order for all instruction
+ * sets without fused multiply-add operations, so the results are
+ * identical regardless of which instruction set is used.
+ */
+
+#if !defined(spatialdata_spatialdb_gridinterpolator_hh)
+#define spatialdata_spatialdb_gridinterpolator_hh
+
+#include "spatialdbfwd.hh" // forward declarations
+
+#include <cstddef> // USES size_t
+
+class spatialdata::spatialdb::GridInterpolator { // class GridInterpolator
+    friend class TestGridInterpolator; // unit testing
+
+public:
+
+    // PUBLIC ENUMS ///////////////////////////////////////////////////////
+
+    /// Instruction set used to gather and sum values.
+    enum SimdEnum {
+        SCALAR=0, ///< Scalar code.
+        AVX2=1, ///< AVX2 (4 points at a time).
+        AVX512=2, ///< AVX-512 (8 points at a time).
+    }; // SimdEnum
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /** Constructor.
+     *
+     * @param data Array of values at grid points.
+     * @param queryValues Offsets of values to interpolate relative to grid points [querySize].
+     * @param querySize Number of values to interpolate.
+     * @param dim Dimension of grid cells (1, 2, or 3).
+     */
+    GridInterpolator(const double* data,
+                     const size_t* queryValues,
+                     const size_t querySize,
+                     const size_t dim);
+
+    /** Constructor with values stored in single precision.
+     *
+     * @param data Array of values at grid points.
+     * @param queryValues Offsets of values to interpolate relative to grid points [querySize].
+     * @param querySize Number of values to interpolate.
+     * @param dim Dimension of grid cells (1, 2, or 3).
+     */
+    GridInterpolator(const float* data,
+                     const size_t* queryValues,
+                     const size_t querySize,
+                     const size_t dim);
+
+    /// Destructor.
+    ~GridInterpolator(void);
+
+    /** Set instruction set used to gather and sum values.
+     *
+     * @param value Instruction set (must be supported by processor).
+     */
+    void setSimd(const SimdEnum value);
+
+    /** Get best instruction set supported by processor.
+     *
+     * @returns Instruction set.
+     */
+    static SimdEnum getSimdSupported(void);
+
+    /** Is block full?
+     *
+     * @returns True if no more points can be added, false otherwise.
+     */
+    bool isFull(void) const;
+
+    /** Add point to block.
+     *
+     * @param loc Index of location for values in output array.
+     * @param offsets Offsets into data array of corners [2^dim].
+     * @param wtsLower Weights of lower corner along each dimension [dim].
+     */
+    void addPoint(const size_t loc,
+                  const size_t* offsets,
+                  const double* wtsLower);
+
+    /** Interpolate values at points in block and clear block.
+     *
+     * @param vals Array of values at locations (output) [numLocs*numVals].
+     * @param numVals Number of values at each location.
+     */
+    void interpolate(double* vals,
+                     const size_t numVals);
+
+    /** Interpolate single precision values at points in block and
+     * clear block.
+     *
+     * @param vals Array of values at locations (output) [numLocs*numVals].
+     * @param numVals Number of values at each location.
+     */
+    void interpolate(float* vals,
+                     const size_t numVals);
+
+private:
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Interpolate values at points in block and clear block.
+     *
+     * @param vals Array of values at locations (output) [numLocs*numVals].
+     * @param numVals Number of values at each location.
+     * @param data Array of values at grid points.
+     */
+    template<typename T, typename D>
+    void _interpolate(T* vals,
+                      const size_t numVals,
+                      const D* data);
+
+    /// Compute weights of corners from weights along each dimension.
+    void _computeWeights(void);
+
+    /** Sum weighted values at corners using scalar code.
+     *
+     * @param data Array of values at grid points.
+     * @param iStart Index of first point.
+     * @param qVal Index of value at grid points.
+     */
+    template<typename D>
+    void _sumScalar(const D* data,
+                    const size_t iStart,
+                    const size_t qVal);
+
+    /** Sum weighted values at corners using AVX2 instructions.
+     *
+     * @param data Array of values at grid points.
+     * @param qVal Index of value at grid points.
+     * @returns Number of points summed (multiple of 4).
+     */
+    size_t _sumAVX2(const double* data,
+                    const size_t qVal);
+
+    /** Sum weighted single precision values at corners using AVX2
+     * instructions.
+     *
+     * @param data Array of values at grid points.
+     * @param qVal Index of value at grid points.
+     * @returns Number of points summed (multiple of 4).
+     */
+    size_t _sumAVX2(const float* data,
+                    const size_t qVal);
+
+    /** Sum weighted values at corners using AVX-512 instructions.
+     *
+     * @param data Array of values at grid points.
+     * @param qVal Index of value at grid points.
+     * @returns Number of points summed (multiple of 8).
+     */
+    size_t _sumAVX512(const double* data,
+                      const size_t qVal);
+
+    /** Sum weighted single precision values at corners using AVX-512
+     * instructions.
+     *
+     * @param data Array of values at grid points.
+     * @param qVal Index of value at grid points.
+     * @returns Number of points summed (multiple of 8).
+     */
+    size_t _sumAVX512(const float* data,
+                      const size_t qVal);
+
+    GridInterpolator(const GridInterpolator&); ///< Not implemented
+    const GridInterpolator& operator=(const GridInterpolator&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    static const size_t _maxPoints = 64; ///< Maximum number of points in block.
+    static const size_t _maxCorners = 8; ///< Maximum number of corners of cell.
+
+    const double* _data; ///< Array of values at grid points (NULL if single precision).
+    const float* _dataF; ///< Array of single precision values at grid points (NULL if double precision).
+    const size_t* _queryValues; ///< Offsets of values to interpolate relative to grid points.
+    const size_t _querySize; ///< Number of values to interpolate.
+    const size_t _dim; ///< Dimension of grid cells.
+    const size_t _numCorners; ///< Number of corners of cell.
+    SimdEnum _simd; ///< Instruction set used to gather and sum values.
+    size_t _numPoints; ///< Number of points in block.
+
+    size_t _locs[_maxPoints]; ///< Index of location of points.
+    size_t _offsets[_maxCorners*_maxPoints]; ///< Offsets of corners of points (corner-major).
+    double _wtsLower[3*_maxPoints]; ///< Weights of lower corner along each dimension (dimension-major).
+    double _weights[_maxCorners*_maxPoints]; ///< Weights of corners of points (corner-major).
+    double _results[_maxPoints]; ///< Interpolated value at points.
+
+}; // class GridInterpolator
+
+#include "GridInterpolator.icc" // inline methods
+
+#endif // spatialdata_spatialdb_gridinterpolator_hh
+
+// End of file
@@ -0,0 +1,397 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "GridSharedMemory.hh" // implementation of class methods
+
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream
+#include <iomanip> // USES std::hex, std::setw(), std::setfill()
+#include <cstring> // USES strerror()
+#include <cerrno> // USES errno
+#include <climits> // USES PATH_MAX
+#include <cstdlib> // USES realpath()
+#include <fcntl.h> // USES O_RDWR, O_CREAT, O_EXCL
+#include <unistd.h> // USES ftruncate(), close(), sysconf(), usleep(), getuid(), getpid()
+#include <signal.h> // USES kill()
+#include <sys/file.h> // USES flock()
+#include <sys/mman.h> // USES shm_open(), shm_unlink(), mmap(), mprotect()
+#include <sys/stat.h> // USES stat(), fstat()
+#include <assert.h> // USES assert()
+
+// ----------------------------------------------------------------------
+const uint64_t spatialdata::spatialdb::GridSharedMemory::_magic = 0x5350444253484d32ULL;
+
+// ----------------------------------------------------------------------
+// Constructor.
+spatialdata::spatialdb::GridSharedMemory::GridSharedMemory(const char* filename,
+                                                           const char* key) :
+    _name(),
+    _fd(-1),
+    _controlSize(0),
+    _control(NULL),
+    _contents(NULL),
+    _size(0),
+    _filling(false) {
+    assert(filename);
+    assert(key);
+
+    const size_t pageSize = sysconf(_SC_PAGESIZE);
+    _controlSize = ((sizeof(Control) + pageSize - 1) / pageSize) * pageSize;
+
+    // Identify file by its path and modification, so a changed file
+    // gets a new segment.
+    char path[PATH_MAX];
+    std::ostringstream id;
+    id << (realpath(filename, path) ? path : filename);
+    struct stat fileInfo;
+    if (0 == stat(filename, &fileInfo)) {
+        id << ":" << fileInfo.st_dev << ":" << fileInfo.st_ino << ":" << fileInfo.st_size << ":" << fileInfo.st_mtime;
+    } // if
+    id << ":" << key;
+
+    // 64-bit FNV-1a hash gives the same name in every process.
+    const std::string& idStr = id.str();
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < idStr.length(); ++i) {
+        hash = (hash ^ (unsigned char)idStr[i]) * 0x100000001b3ULL;
+    } // for
+
+    std::ostringstream name;
+    name << "/spatialdata-" << getuid() << "-" << std::hex << std::setw(16) << std::setfill('0') << hash;
+    _name = name.str();
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Destructor.
+spatialdata::spatialdb::GridSharedMemory::~GridSharedMemory(void) {
+    try {
+        detach();
+    } catch (...) {
+        _release();
+    } // try/catch
+} // destructor
+
+
+// ----------------------------------------------------------------------
+// Attach to segment, creating it if it does not exist.
+bool
+spatialdata::spatialdb::GridSharedMemory::attach(void) {
+    assert(_fd < 0);
+
+    // The creator locks the segment right after creating it and sets
+    // the size of the control block while holding the lock, so a
+    // segment that stays smaller than the control block was left by a
+    // creator that exited in between.
+    const size_t maxWaits = 1000; // 1 ms each
+    size_t numWaits = 0;
+    while (true) {
+        _fd = shm_open(_name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+        if (_fd >= 0) {
+            // Hold lock until contents are published.
+            _lock(LOCK_EX);
+            if (ftruncate(_fd, _controlSize) != 0) {
+                const int ftruncateErrno = errno;
+                shm_unlink(_name.c_str());
+                _release();
+                std::ostringstream msg;
+                msg << "Could not set size of shared memory segment '" << _name << "' (" << strerror(ftruncateErrno) << ").";
+                throw std::runtime_error(msg.str());
+            } // if
+            _filling = true;
+            _mapControl();
+            _control->magic = _magic;
+            _control->state = FILLING;
+            _control->numAttached = 1;
+            _control->pids[0] = getpid();
+            _control->size = 0;
+            return true;
+        } // if
+        if (errno != EEXIST) {
+            std::ostringstream msg;
+            msg << "Could not create shared memory segment '" << _name << "' (" << strerror(errno) << ").";
+            throw std::runtime_error(msg.str());
+        } // if
+
+        _fd = shm_open(_name.c_str(), O_RDWR, 0);
+        if (_fd < 0) {
+            if (ENOENT == errno) {
+                // Segment was removed after we tried to create it.
+                continue;
+            } // if
+            std::ostringstream msg;
+            msg << "Could not open shared memory segment '" << _name << "' (" << strerror(errno) << ").";
+            throw std::runtime_error(msg.str());
+        } // if
+
+        // Block until creator publishes contents.
+        _lock(LOCK_EX);
+        struct stat info;
+        if (fstat(_fd, &info) != 0) {
+            const int fstatErrno = errno;
+            _lock(LOCK_UN);
+            _release();
+            std::ostringstream msg;
+            msg << "Could not get size of shared memory segment '" << _name << "' (" << strerror(fstatErrno) << ").";
+            throw std::runtime_error(msg.str());
+        } // if
+        if (size_t(info.st_size) < _controlSize) {
+            if (++numWaits < maxWaits) {
+                // Creator has not set up control block yet.
+                _lock(LOCK_UN);
+                _release();
+                usleep(1000);
+                continue;
+            } // if
+
+            // Remove stale segment, unless it has already been replaced.
+            numWaits = 0;
+            const int fdCurrent = shm_open(_name.c_str(), O_RDONLY, 0);
+            if (fdCurrent >= 0) {
+                struct stat infoCurrent;
+                if (( 0 == fstat(fdCurrent, &infoCurrent)) && ( infoCurrent.st_dev == info.st_dev) && ( infoCurrent.st_ino == info.st_ino) ) {
+                    shm_unlink(_name.c_str());
+                } // if
+                ::close(fdCurrent);
+            } // if
+            _lock(LOCK_UN);
+            _release();
+            continue;
+        } // if
+        _mapControl();
+        if (_control->magic != _magic) {
+            _lock(LOCK_UN);
+            _release();
+            std::ostringstream msg;
+            msg << "Shared memory segment '" << _name << "' was not created by spatialdata.";
+            throw std::runtime_error(msg.str());
+        } // if
+
+        if (READY == _control->state) {
+            // Processes that exited without detaching no longer count.
+            _removeStaleProcesses();
+            if (_control->numAttached >= Control::MAX_ATTACHED) {
+                _lock(LOCK_UN);
+                _release();
+                std::ostringstream msg;
+                msg << "Could not attach to shared memory segment '" << _name << "'. Maximum number of processes ("
+                    << Control::MAX_ATTACHED << ") already attached.";
+                throw std::runtime_error(msg.str());
+            } // if
+            void* contents = mmap(NULL, _control->size, PROT_READ, MAP_SHARED, _fd, _controlSize);
+            if (MAP_FAILED == contents) {
+                const int mmapErrno = errno;
+                _lock(LOCK_UN);
+                _release();
+                std::ostringstream msg;
+                msg << "Could not map shared memory segment '" << _name << "' (" << strerror(mmapErrno) << ").";
+                throw std::runtime_error(msg.str());
+            } // if
+            _contents = (char*)contents;
+            _size = _control->size;
+            _control->pids[_control->numAttached++] = getpid();
+            _lock(LOCK_UN);
+            return false;
+        } // if
+
+        // Creator exited while filling contents (it holds the lock while
+        // filling), or the segment was removed while we waited.
+        if (FILLING == _control->state) {
+            _control->state = REMOVED;
+            shm_unlink(_name.c_str());
+        } // if
+        _lock(LOCK_UN);
+        _release();
+    } // while
+} // attach
+
+
+// ----------------------------------------------------------------------
+// Allocate memory for contents of segment created by this process.
+char*
+spatialdata::spatialdb::GridSharedMemory::allocate(const size_t size) {
+    assert(_filling);
+    assert(!_contents);
+    assert(size > 0);
+
+    if (ftruncate(_fd, _controlSize + size) != 0) {
+        std::ostringstream msg;
+        msg << "Could not allocate " << size << " bytes in shared memory segment '" << _name << "' ("
+            << strerror(errno) << ").";
+        throw std::runtime_error(msg.str());
+    } // if
+    void* contents = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, _controlSize);
+    if (MAP_FAILED == contents) {
+        std::ostringstream msg;
+        msg << "Could not map shared memory segment '" << _name << "' (" << strerror(errno) << ").";
+        throw std::runtime_error(msg.str());
+    } // if
+    _contents = (char*)contents;
+    _size = size;
+    _control->size = size;
+
+    return _contents;
+} // allocate
+
+
+// ----------------------------------------------------------------------
+// Make filled contents read-only and available to other processes.
+void
+spatialdata::spatialdb::GridSharedMemory::publish(void) {
+    assert(_filling);
+    assert(_contents);
+
+    mprotect(_contents, _size, PROT_READ);
+    _control->state = READY;
+    _filling = false;
+    _lock(LOCK_UN);
+} // publish
+
+
+// ----------------------------------------------------------------------
+// Detach from segment, removing it if no other running processes are
+// attached.
+void
+spatialdata::spatialdb::GridSharedMemory::detach(void) {
+    if (_fd < 0) {
+        return;
+    } // if
+
+    if (!_filling) {
+        _lock(LOCK_EX);
+    } // if
+    assert(_control->numAttached > 0);
+    const int32_t pid = getpid();
+    for (uint64_t i = 0; i < _control->numAttached; ++i) {
+        if (pid == _control->pids[i]) {
+            _control->pids[i] = _control->pids[--_control->numAttached];
+            break;
+        } // if
+    } // for
+    _removeStaleProcesses();
+    if (_filling || !_control->numAttached) {
+        _control->state = REMOVED;
+        shm_unlink(_name.c_str());
+    } // if
+    _filling = false;
+    _lock(LOCK_UN);
+    _release();
+} // detach
+
+
+// ----------------------------------------------------------------------
+// Get name of segment.
+const char*
+spatialdata::spatialdb::GridSharedMemory::getName(void) const {
+    return _name.c_str();
+} // getName
+
+
+// ----------------------------------------------------------------------
+// Get contents of segment.
+const char*
+spatialdata::spatialdb::GridSharedMemory::getContents(void) const {
+    return _contents;
+} // getContents
+
+
+// ----------------------------------------------------------------------
+// Get size of contents of segment.
+size_t
+spatialdata::spatialdb::GridSharedMemory::getSize(void) const {
+    return _size;
+} // getSize
+
+
+// ----------------------------------------------------------------------
+// Lock or unlock segment.
+void
+spatialdata::spatialdb::GridSharedMemory::_lock(const int operation) {
+    assert(_fd >= 0);
+
+    while (flock(_fd, operation) != 0) {
+        if (EINTR != errno) {
+            std::ostringstream msg;
+            msg << "Could not lock shared memory segment '" << _name << "' (" << strerror(errno) << ").";
+            throw std::runtime_error(msg.str());
+        } // if
+    } // while
+} // _lock
+
+
+// ----------------------------------------------------------------------
+// Map control block at start of segment.
+void
+spatialdata::spatialdb::GridSharedMemory::_mapControl(void) {
+    assert(!_control);
+
+    void* control = mmap(NULL, _controlSize, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0);
+    if (MAP_FAILED == control) {
+        const int mmapErrno = errno;
+        std::ostringstream msg;
+        msg << "Could not map shared memory segment '" << _name << "' (" << strerror(mmapErrno) << ").";
+        if (_filling) {
+            shm_unlink(_name.c_str());
+        } // if
+        _lock(LOCK_UN);
+        _release();
+        throw std::runtime_error(msg.str());
+    } // if
+    _control = (Control*)control;
+} // _mapControl
+
+
+// ----------------------------------------------------------------------
+// Drop processes that no longer exist from control block.
+void
+spatialdata::spatialdb::GridSharedMemory::_removeStaleProcesses(void) {
+    assert(_control);
+
+    uint64_t i = 0;
+    while (i < _control->numAttached) {
+        if (( kill(_control->pids[i], 0) != 0) && ( ESRCH == errno) ) {
+            _control->pids[i] = _control->pids[--_control->numAttached];
+        } else {
+            ++i;
+        } // if/else
+    } // while
+} // _removeStaleProcesses
+
+
+// ----------------------------------------------------------------------
+// Unmap contents and control block and close segment.
+void
+spatialdata::spatialdb::GridSharedMemory::_release(void) {
+    if (_contents) {
+        munmap(_contents, _size);
+        _contents = NULL;
+    } // if
+    _size = 0;
+    if (_control) {
+        munmap(_control, _controlSize);
+        _control = NULL;
+    } // if
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    } // if
+    _filling = false;
+} // _release
+
+
+// End of file
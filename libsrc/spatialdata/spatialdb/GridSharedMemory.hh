@@ -0,0 +1,177 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/GridSharedMemory.hh
+ *
+ * @brief C++ POSIX shared-memory segment holding a spatial database
+ * loaded from a file, shared by the processes on a node.
+ *
+ * The segment is named after the file (path, size, modification time)
+ * and a key describing how the values are stored, so processes opening
+ * the same file with the same settings use the same segment. The first
+ * process creates the segment and fills it while holding an exclusive
+ * lock on it; the other processes block on the lock and then map the
+ * contents read-only. The segment records the process ids of the
+ * processes attached to it, and the last process to detach removes it.
+ *
+ * Processes that exited without detaching, for example because they
+ * crashed or were killed, are dropped from the record whenever a
+ * process attaches or detaches, so they do not keep the segment alive.
+ * If every process attached to a segment exits without detaching, the
+ * segment remains in /dev/shm until the next process using the same
+ * file attaches to it and then detaches, or until it is removed by hand
+ * (rm /dev/shm/spatialdata-<uid>-*). Processes are identified by
+ * process id, so all processes sharing a segment must be in the same
+ * PID namespace.
+ */
+
+#if !defined(spatialdata_spatialdb_gridsharedmemory_hh)
+#define spatialdata_spatialdb_gridsharedmemory_hh
+
+#include "spatialdbfwd.hh" // forward declarations
+
+#include <string> // HASA std::string
+#include <stdint.h> // USES uint64_t
+#include <cstddef> // USES size_t
+
+class spatialdata::spatialdb::GridSharedMemory { // class GridSharedMemory
+    friend class TestGridSharedMemory; // unit testing
+
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /** Constructor.
+     *
+     * @param filename Name of file with contents of segment.
+     * @param key Description of how contents are stored.
+     */
+    GridSharedMemory(const char* filename,
+                     const char* key);
+
+    /// Destructor.
+    ~GridSharedMemory(void);
+
+    /** Attach to segment, creating it if it does not exist.
+     *
+     * If another process is filling the segment, wait until it is
+     * done. A segment whose creator exited before setting it up is
+     * removed after waiting about one second and then created again.
+     *
+     * @returns True if this process created the segment and must fill
+     * it using allocate() and publish(), false if the contents are
+     * available from getContents().
+     */
+    bool attach(void);
+
+    /** Allocate memory for contents of segment created by this process.
+     *
+     * @param size Size in bytes of contents.
+     * @returns Writable memory for contents.
+     */
+    char* allocate(const size_t size);
+
+    /// Make filled contents read-only and available to other processes.
+    void publish(void);
+
+    /** Detach from segment, removing it if no other running processes
+     * are attached.
+     *
+     * A segment that was created but not published is removed, so
+     * waiting processes create it again.
+     */
+    void detach(void);
+
+    /** Get name of segment.
+     *
+     * @returns Name of segment.
+     */
+    const char* getName(void) const;
+
+    /** Get contents of segment.
+     *
+     * @returns Contents of segment (NULL if not attached).
+     */
+    const char* getContents(void) const;
+
+    /** Get size of contents of segment.
+     *
+     * @returns Size in bytes of contents.
+     */
+    size_t getSize(void) const;
+
+private:
+
+    // PRIVATE STRUCTS ////////////////////////////////////////////////////
+
+    /// State shared by processes at start of segment.
+    struct Control {
+        enum { MAX_ATTACHED=4096 }; ///< Maximum number of processes attached.
+
+        uint64_t magic; ///< Marker identifying segment.
+        uint64_t state; ///< State of contents (StateEnum).
+        uint64_t numAttached; ///< Number of processes attached.
+        uint64_t size; ///< Size in bytes of contents.
+        int32_t pids[MAX_ATTACHED]; ///< Process ids of processes attached [numAttached].
+    }; // Control
+
+    enum StateEnum {
+        FILLING=0, ///< Creator is filling contents.
+        READY=1, ///< Contents are available.
+        REMOVED=2, ///< Segment has been removed.
+    }; // StateEnum
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Lock or unlock segment.
+     *
+     * @param operation Lock operation (LOCK_EX or LOCK_UN).
+     */
+    void _lock(const int operation);
+
+    /// Map control block at start of segment.
+    void _mapControl(void);
+
+    /// Drop processes that no longer exist from control block.
+    void _removeStaleProcesses(void);
+
+    /// Unmap contents and control block and close segment.
+    void _release(void);
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////
+
+    GridSharedMemory(const GridSharedMemory&); ///< Not implemented
+    const GridSharedMemory& operator=(const GridSharedMemory&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    static const uint64_t _magic; ///< Marker identifying segment.
+
+    std::string _name; ///< Name of segment.
+    int _fd; ///< File descriptor of segment.
+    size_t _controlSize; ///< Size in bytes of control block (whole pages).
+    Control* _control; ///< Control block.
+    char* _contents; ///< Contents of segment.
+    size_t _size; ///< Size in bytes of contents.
+    bool _filling; ///< True if this process created segment and has not published it.
+
+}; // class GridSharedMemory
+
+#endif // spatialdata_spatialdb_gridsharedmemory_hh
+
+// End of file
@@ -0,0 +1,301 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "KDTree.hh" // implementation of class methods
+
+#include <algorithm> // USES std::nth_element(), std::push_heap(), std::pop_heap(), std::sort_heap()
+#include <cassert> // USES assert()
+
+// ----------------------------------------------------------------------
+const size_t spatialdata::spatialdb::KDTree::_leafSize = 8;
+
+// ----------------------------------------------------------------------
+// Default constructor.
+spatialdata::spatialdb::KDTree::KDTree(void) {}
+
+
+// ----------------------------------------------------------------------
+// Default destructor.
+spatialdata::spatialdb::KDTree::~KDTree(void) {
+    deallocate();
+} // destructor
+
+
+// ----------------------------------------------------------------------
+// Deallocate data structures.
+void
+spatialdata::spatialdb::KDTree::deallocate(void) {
+    std::vector<Node>().swap(_nodes);
+    std::vector<double>().swap(_points);
+    std::vector<size_t>().swap(_indices);
+} // deallocate
+
+
+// ----------------------------------------------------------------------
+// Build tree over points.
+void
+spatialdata::spatialdb::KDTree::build(const double* coordinates,
+                                      const size_t numLocs,
+                                      const size_t spaceDim) {
+    assert( (0 < numLocs && coordinates) || (0 == numLocs) );
+    assert(0 < spaceDim && spaceDim <= 3);
+
+    deallocate();
+    if (0 == numLocs) {
+        return;
+    } // if
+
+    // Copy coordinates, padding to 3-D space.
+    _points.resize(3*numLocs, 0.0);
+    _indices.resize(numLocs);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            _points[3*iLoc+iDim] = coordinates[iLoc*spaceDim+iDim];
+        } // for
+        _indices[iLoc] = iLoc;
+    } // for
+
+    // Partition indices; _points remains in original ordering while building.
+    _nodes.reserve(2*numLocs/_leafSize + 1);
+    _buildNode(0, numLocs);
+
+    // Reorder coordinates to match tree ordering for locality in searches.
+    std::vector<double> points(3*numLocs);
+    for (size_t i = 0; i < numLocs; ++i) {
+        const size_t iLoc = _indices[i];
+        points[3*i+0] = _points[3*iLoc+0];
+        points[3*i+1] = _points[3*iLoc+1];
+        points[3*i+2] = _points[3*iLoc+2];
+    } // for
+    _points.swap(points);
+} // build
+
+
+// ----------------------------------------------------------------------
+// Get number of points in tree.
+size_t
+spatialdata::spatialdb::KDTree::getNumLocs(void) const {
+    return _indices.size();
+} // getNumLocs
+
+
+// ----------------------------------------------------------------------
+// Find point nearest location.
+size_t
+spatialdata::spatialdb::KDTree::findNearest(const double pt[3]) const {
+    assert(_nodes.size() > 0);
+
+    DistIndex best(_distSquared(pt, 0), _indices[0]);
+    _searchNearest(&best, 0, pt);
+
+    return best.second;
+} // findNearest
+
+
+// ----------------------------------------------------------------------
+// Find points nearest location.
+void
+spatialdata::spatialdb::KDTree::findNearest(std::vector<size_t>* nearest,
+                                            const double pt[3],
+                                            const size_t numNear) const {
+    std::vector<DistIndex> heap;
+    findNearest(nearest, &heap, pt, numNear);
+} // findNearest
+
+
+// ----------------------------------------------------------------------
+// Find points nearest location using caller-owned scratch space.
+void
+spatialdata::spatialdb::KDTree::findNearest(std::vector<size_t>* nearest,
+                                            std::vector<DistIndex>* heap,
+                                            const double pt[3],
+                                            const size_t numNear) const {
+    assert(nearest);
+    assert(heap);
+
+    const size_t numLocs = _indices.size();
+    const size_t nearSize = (numLocs < numNear) ? numLocs : numNear;
+    nearest->resize(nearSize);
+    if (0 == nearSize) {
+        return;
+    } // if
+
+    heap->clear();
+    heap->reserve(nearSize);
+    _searchNearest(heap, 0, pt, nearSize);
+    assert(heap->size() == nearSize);
+
+    std::sort_heap(heap->begin(), heap->end(), _closer);
+    for (size_t i = 0; i < nearSize; ++i) {
+        (*nearest)[i] = (*heap)[i].second;
+    } // for
+} // findNearest
+
+
+// ----------------------------------------------------------------------
+// Build subtree for points in range [begin, end).
+size_t
+spatialdata::spatialdb::KDTree::_buildNode(const size_t begin,
+                                           const size_t end) {
+    assert(begin < end);
+
+    const size_t iNode = _nodes.size();
+    _nodes.push_back(Node());
+    _nodes[iNode].split = 0.0;
+    _nodes[iNode].begin = begin;
+    _nodes[iNode].end = end;
+    _nodes[iNode].left = 0;
+    _nodes[iNode].right = 0;
+    _nodes[iNode].axis = 0;
+    if (end - begin <= _leafSize) {
+        return iNode;
+    } // if
+
+    // Split along coordinate direction with largest extent.
+    double xyzMin[3];
+    double xyzMax[3];
+    for (int iDim = 0; iDim < 3; ++iDim) {
+        xyzMin[iDim] = xyzMax[iDim] = _points[3*_indices[begin]+iDim];
+    } // for
+    for (size_t i = begin+1; i < end; ++i) {
+        const double* xyz = &_points[3*_indices[i]];
+        for (int iDim = 0; iDim < 3; ++iDim) {
+            if (xyz[iDim] < xyzMin[iDim]) {
+                xyzMin[iDim] = xyz[iDim];
+            } else if (xyz[iDim] > xyzMax[iDim]) {
+                xyzMax[iDim] = xyz[iDim];
+            } // if/else
+        } // for
+    } // for
+    int axis = 0;
+    for (int iDim = 1; iDim < 3; ++iDim) {
+        if (xyzMax[iDim] - xyzMin[iDim] > xyzMax[axis] - xyzMin[axis]) {
+            axis = iDim;
+        } // if
+    } // for
+
+    // Points in [begin, mid) are on or below the splitting plane and
+    // points in [mid, end) are on or above the splitting plane.
+    const size_t mid = begin + (end - begin) / 2;
+    const std::vector<double>& points = _points;
+    std::nth_element(_indices.begin()+begin, _indices.begin()+mid, _indices.begin()+end,
+                     [&points, axis](const size_t a,
+                                     const size_t b) {
+        return points[3*a+axis] < points[3*b+axis];
+    });
+
+    _nodes[iNode].axis = axis;
+    _nodes[iNode].split = _points[3*_indices[mid]+axis];
+    const size_t left = _buildNode(begin, mid);
+    const size_t right = _buildNode(mid, end);
+    _nodes[iNode].left = left;
+    _nodes[iNode].right = right;
+
+    return iNode;
+} // _buildNode
+
+
+// ----------------------------------------------------------------------
+// Search subtree for nearest point.
+void
+spatialdata::spatialdb::KDTree::_searchNearest(DistIndex* best,
+                                               const size_t iNode,
+                                               const double pt[3]) const {
+    assert(best);
+
+    const Node& node = _nodes[iNode];
+    if (!node.left) {
+        for (size_t i = node.begin; i < node.end; ++i) {
+            const double dist2 = _distSquared(pt, i);
+            if (( dist2 < best->first) ||
+                (( dist2 == best->first) && ( _indices[i] < best->second) )) {
+                best->first = dist2;
+                best->second = _indices[i];
+            } // if
+        } // for
+        return;
+    } // if
+
+    const double diff = pt[node.axis] - node.split;
+    const size_t nearChild = (diff < 0.0) ? node.left : node.right;
+    const size_t farChild = (diff < 0.0) ? node.right : node.left;
+    _searchNearest(best, nearChild, pt);
+    if (diff*diff <= best->first) {
+        _searchNearest(best, farChild, pt);
+    } // if
+} // _searchNearest
+
+
+// ----------------------------------------------------------------------
+// Search subtree for nearest points.
+void
+spatialdata::spatialdb::KDTree::_searchNearest(std::vector<DistIndex>* heap,
+                                               const size_t iNode,
+                                               const double pt[3],
+                                               const size_t numNear) const {
+    assert(heap);
+
+    const Node& node = _nodes[iNode];
+    if (!node.left) {
+        for (size_t i = node.begin; i < node.end; ++i) {
+            const DistIndex candidate(_distSquared(pt, i), _indices[i]);
+            if (heap->size() < numNear) {
+                heap->push_back(candidate);
+                std::push_heap(heap->begin(), heap->end(), _closer);
+            } else if (_closer(candidate, heap->front())) {
+                std::pop_heap(heap->begin(), heap->end(), _closer);
+                heap->back() = candidate;
+                std::push_heap(heap->begin(), heap->end(), _closer);
+            } // if/else
+        } // for
+        return;
+    } // if
+
+    const double diff = pt[node.axis] - node.split;
+    const size_t nearChild = (diff < 0.0) ? node.left : node.right;
+    const size_t farChild = (diff < 0.0) ? node.right : node.left;
+    _searchNearest(heap, nearChild, pt, numNear);
+    if (( heap->size() < numNear) || ( diff*diff <= heap->front().first) ) {
+        _searchNearest(heap, farChild, pt, numNear);
+    } // if
+} // _searchNearest
+
+
+// ----------------------------------------------------------------------
+// Compute square of distance between location and point in tree.
+double
+spatialdata::spatialdb::KDTree::_distSquared(const double pt[3],
+                                             const size_t iPoint) const {
+    const double* xyz = &_points[3*iPoint];
+    const double abX = xyz[0]-pt[0];
+    const double abY = xyz[1]-pt[1];
+    const double abZ = xyz[2]-pt[2];
+    return abX*abX + abY*abY + abZ*abZ;
+} // _distSquared
+
+
+// ----------------------------------------------------------------------
+// Ordering for k-nearest searches.
+bool
+spatialdata::spatialdb::KDTree::_closer(const DistIndex& a,
+                                        const DistIndex& b) {
+    return (a.first < b.first) || (( a.first == b.first) && ( a.second > b.second) );
+} // _closer
+
+
+// End of file
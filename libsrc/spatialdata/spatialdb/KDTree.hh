@@ -0,0 +1,197 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/KDTree.hh
+ *
+ * @brief C++ k-d tree for nearest neighbor searches over scattered
+ * points.
+ *
+ * Points with a spatial dimension less than 3 are padded with zeros,
+ * consistent with SimpleDBQuery, so that squared distances computed
+ * by the tree are identical to those computed by a brute force search.
+ */
+
+#if !defined(spatialdata_spatialdb_kdtree_hh)
+#define spatialdata_spatialdb_kdtree_hh
+
+#include "spatialdbfwd.hh" // forward declarations
+
+#include <vector> // USES std::vector
+#include <utility> // USES std::pair
+#include <cstddef> // USES size_t
+
+class spatialdata::spatialdb::KDTree { // class KDTree
+    friend class TestKDTree; // unit testing
+
+public:
+
+    // PUBLIC TYPEDEFS ////////////////////////////////////////////////////
+
+    typedef std::pair<double, size_t> DistIndex; ///< Squared distance and index of point.
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /// Default constructor.
+    KDTree(void);
+
+    /// Default destructor.
+    ~KDTree(void);
+
+    /// Deallocate data structures.
+    void deallocate(void);
+
+    /** Build tree over points.
+     *
+     * @param coordinates Array of coordinates of points [numLocs*spaceDim].
+     * @param numLocs Number of points.
+     * @param spaceDim Spatial dimension of points.
+     */
+    void build(const double* coordinates,
+               const size_t numLocs,
+               const size_t spaceDim);
+
+    /** Get number of points in tree.
+     *
+     * @returns Number of points.
+     */
+    size_t getNumLocs(void) const;
+
+    /** Find point nearest location.
+     *
+     * If several points are equidistant from the location, the point
+     * with the smallest index is returned.
+     *
+     * @pre Tree must contain at least one point.
+     *
+     * @param pt Coordinates of location in 3-D space.
+     * @returns Index of nearest point.
+     */
+    size_t findNearest(const double pt[3]) const;
+
+    /** Find points nearest location.
+     *
+     * Points are sorted by increasing distance from the location. If
+     * several points are equidistant from the location, points with
+     * larger indices come first.
+     *
+     * @param nearest Array of indices of nearest points [output].
+     * @param pt Coordinates of location in 3-D space.
+     * @param numNear Number of points to find (truncated to number of points in tree).
+     */
+    void findNearest(std::vector<size_t>* nearest,
+                     const double pt[3],
+                     const size_t numNear) const;
+
+    /** Find points nearest location using caller-owned scratch space.
+     *
+     * Same as above, but the heap of candidate points is stored in
+     * scratch space provided by the caller, so repeated searches do
+     * not allocate memory.
+     *
+     * @param nearest Array of indices of nearest points [output].
+     * @param heap Scratch space for candidate points.
+     * @param pt Coordinates of location in 3-D space.
+     * @param numNear Number of points to find (truncated to number of points in tree).
+     */
+    void findNearest(std::vector<size_t>* nearest,
+                     std::vector<DistIndex>* heap,
+                     const double pt[3],
+                     const size_t numNear) const;
+
+private:
+
+    // PRIVATE STRUCTS ////////////////////////////////////////////////////
+
+    /// Node in tree.
+    struct Node {
+        double split; ///< Coordinate of splitting plane.
+        size_t begin; ///< Index of first point in node.
+        size_t end; ///< Index one past last point in node.
+        size_t left; ///< Index of left child (0 if leaf).
+        size_t right; ///< Index of right child (0 if leaf).
+        int axis; ///< Coordinate direction normal to splitting plane.
+    }; // Node
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Build subtree for points in range [begin, end).
+     *
+     * @param begin Index of first point.
+     * @param end Index one past last point.
+     * @returns Index of node.
+     */
+    size_t _buildNode(const size_t begin,
+                      const size_t end);
+
+    /** Search subtree for nearest point.
+     *
+     * @param best Squared distance and index of nearest point found so far.
+     * @param iNode Index of node.
+     * @param pt Coordinates of location in 3-D space.
+     */
+    void _searchNearest(DistIndex* best,
+                        const size_t iNode,
+                        const double pt[3]) const;
+
+    /** Search subtree for nearest points.
+     *
+     * @param heap Heap of nearest points found so far (farthest at front).
+     * @param iNode Index of node.
+     * @param pt Coordinates of location in 3-D space.
+     * @param numNear Number of points to find.
+     */
+    void _searchNearest(std::vector<DistIndex>* heap,
+                        const size_t iNode,
+                        const double pt[3],
+                        const size_t numNear) const;
+
+    /** Compute square of distance between location and point in tree.
+     *
+     * @param pt Coordinates of location in 3-D space.
+     * @param iPoint Index of point in tree ordering.
+     * @returns Square of distance.
+     */
+    double _distSquared(const double pt[3],
+                        const size_t iPoint) const;
+
+    /** Ordering for k-nearest searches: closer points first, with
+     * larger indices first for equidistant points.
+     *
+     * @param a Squared distance and index of point A.
+     * @param b Squared distance and index of point B.
+     * @returns True if A precedes B.
+     */
+    static bool _closer(const DistIndex& a,
+                        const DistIndex& b);
+
+    KDTree(const KDTree&); ///< Not implemented
+    const KDTree& operator=(const KDTree&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    std::vector<Node> _nodes; ///< Nodes in tree (root is first).
+    std::vector<double> _points; ///< Coordinates of points in tree ordering [numLocs*3].
+    std::vector<size_t> _indices; ///< Original indices of points in tree ordering.
+
+    static const size_t _leafSize; ///< Maximum number of points in leaf node.
+
+}; // class KDTree
+
+#endif // spatialdata_spatialdb_kdtree_hh
+
+// End of file
@@ -0,0 +1,344 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "OctreeGridBinary.hh" // implementation of class methods
+
+#include "spatialdata/geocoords/CoordSys.hh" // USES CoordSys
+#include "spatialdata/geocoords/CSPicklerAscii.hh" // USES CSPicklerAscii
+
+#include <fstream> // USES std::ofstream, std::ifstream
+#include <algorithm> // USES std::max()
+#include <vector> // USES std::vector
+
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream, std::istringstream
+#include <strings.h> // USES strcasecmp()
+#include <cstring> // USES strncmp(), strlen(), memcpy(), memset()
+#include <assert.h> // USES assert()
+
+// ----------------------------------------------------------------------
+const char* spatialdata::spatialdb::OctreeGridBinary::FILEHEADER = "#SPATIAL_OCTREE.binary";
+const uint64_t spatialdata::spatialdb::OctreeGridBinary::_byteOrder = 0x0102030405060708ULL;
+const uint64_t spatialdata::spatialdb::OctreeGridBinary::_version = 1;
+
+// ----------------------------------------------------------------------
+// Check whether file is a binary OctreeGridDB file.
+bool
+spatialdata::spatialdb::OctreeGridBinary::isBinary(const char* filename) {
+    assert(filename);
+
+    std::ifstream filein(filename, std::ios::binary);
+    if (!filein.is_open() || !filein.good()) {
+        return false;
+    } // if
+
+    FileHeader header;
+    filein.read((char*)&header, sizeof(header));
+    return filein.good() && 0 == strncmp(header.magic, FILEHEADER, sizeof(header.magic));
+} // isBinary
+
+
+// ----------------------------------------------------------------------
+// Read binary database file.
+void
+spatialdata::spatialdb::OctreeGridBinary::read(OctreeGridDB* db) { // read
+    assert(db);
+
+    try {
+        db->_deallocate();
+
+        std::ifstream filein(db->_filename.c_str(), std::ios::binary);
+        if (!filein.is_open() || !filein.good()) {
+            std::ostringstream msg;
+            msg << "Could not open spatial database file '" << db->_filename
+                << "' for reading.\n";
+            throw std::runtime_error(msg.str());
+        } // if
+        filein.seekg(0, std::ios::end);
+        const uint64_t fileSize = filein.tellg();
+        filein.seekg(0, std::ios::beg);
+
+        FileHeader header;
+        filein.read((char*)&header, sizeof(header));
+        if (!filein.good()) {
+            throw std::runtime_error("File is too small for binary OctreeGridDB header.");
+        } // if
+        if (0 != strncmp(header.magic, FILEHEADER, sizeof(header.magic))) {
+            std::ostringstream msg;
+            msg << "Magic header does not match expected header '" << FILEHEADER << "'.";
+            throw std::runtime_error(msg.str());
+        } // if
+        if (header.byteOrder != _byteOrder) {
+            throw std::runtime_error("Byte order of binary OctreeGridDB file does not match byte order of machine.");
+        } // if
+        if (header.version != _version) {
+            std::ostringstream msg;
+            msg << "Unknown version " << header.version << " of binary OctreeGridDB file format.";
+            throw std::runtime_error(msg.str());
+        } // if
+        if (( header.numX < 2) || ( header.numY < 2) || ( header.numZ < 2) || ( header.numValues <= 0) ||
+            ( header.numNodes <= 0) || ( header.numLeaves <= 0) || ( header.numCorners <= 0) ) {
+            throw std::runtime_error("OctreeGridDB settings must include at least two points along each axis, "
+                                     "positive number of values, and at least one leaf.");
+        } // if
+
+        // Check sizes against size of file before allocating memory.
+        const uint64_t numCoords = header.numX + header.numY + header.numZ;
+        const uint64_t sizeData = header.textSize + numCoords*sizeof(double) +
+                                  (header.numNodes + 8*header.numLeaves)*sizeof(uint32_t) +
+                                  header.numCorners*header.numValues*sizeof(double);
+        if (( numCoords > fileSize) || ( header.numNodes > fileSize) || ( header.numLeaves > fileSize) ||
+            ( header.numCorners > fileSize) || ( header.numValues > fileSize) || ( header.textSize > fileSize) ||
+            ( sizeof(header) + sizeData != fileSize) ) {
+            throw std::runtime_error("Binary OctreeGridDB file is truncated or has inconsistent sizes.");
+        } // if
+
+        std::string text(header.textSize, ' ');
+        filein.read(&text[0], header.textSize);
+        db->_numValues = header.numValues;
+        _parseText(text, db);
+
+        db->_x.resize(header.numX);
+        db->_y.resize(header.numY);
+        db->_z.resize(header.numZ);
+        filein.read((char*)&db->_x[0], header.numX*sizeof(double));
+        filein.read((char*)&db->_y[0], header.numY*sizeof(double));
+        filein.read((char*)&db->_z[0], header.numZ*sizeof(double));
+        db->_nodes.resize(header.numNodes);
+        db->_leaves.resize(8*header.numLeaves);
+        db->_values.resize(header.numCorners*header.numValues);
+        filein.read((char*)&db->_nodes[0], db->_nodes.size()*sizeof(uint32_t));
+        filein.read((char*)&db->_leaves[0], db->_leaves.size()*sizeof(uint32_t));
+        filein.read((char*)&db->_values[0], db->_values.size()*sizeof(double));
+        if (!filein.good()) {
+            throw std::runtime_error("Unknown error while reading.");
+        } // if
+        db->_rootSize = header.rootSize;
+        db->_depth = header.depth;
+
+        const std::vector<double>* axes[3] = { &db->_x, &db->_y, &db->_z };
+        const char* axisNames[3] = { "x", "y", "z" };
+        for (size_t iDim = 0; iDim < 3; ++iDim) {
+            const std::vector<double>& axis = *axes[iDim];
+            for (size_t i = 1; i < axis.size(); ++i) {
+                if (!(axis[i] > axis[i-1])) {
+                    std::ostringstream msg;
+                    msg << "Coordinates along " << axisNames[iDim] << " axis are not in increasing order.";
+                    throw std::runtime_error(msg.str());
+                } // if
+            } // for
+        } // for
+        _checkOctree(*db);
+    } catch (const std::exception& err) {
+        db->_deallocate();
+        std::ostringstream msg;
+        msg << "Error occurred while reading spatial database file '" << db->_filename << "'.\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } catch (...) {
+        db->_deallocate();
+        std::ostringstream msg;
+        msg << "Unknown error occurred while reading spatial database file '" << db->_filename << "'.\n";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // read
+
+
+// ----------------------------------------------------------------------
+// Write binary database file.
+void
+spatialdata::spatialdb::OctreeGridBinary::write(const OctreeGridDB& db) { // write
+    try {
+        if (db._nodes.empty()) {
+            throw std::logic_error("Octree must be built or read before it is written.");
+        } // if
+
+        std::ofstream fileout(db._filename.c_str(), std::ios::binary);
+        if (!fileout.is_open() || !fileout.good()) {
+            std::ostringstream msg;
+            msg << "Could not open spatial database file '" << db._filename
+                << "' for writing.\n";
+            throw std::runtime_error(msg.str());
+        } // if
+
+        const size_t numValues = db._numValues;
+        assert(db._names);
+        assert(db._units);
+        assert(db._cs);
+        std::ostringstream text;
+        text << "value-names =";
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            text << " " << db._names[iVal];
+        } // for
+        text << "\nvalue-units =";
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            text << " " << db._units[iVal];
+        } // for
+        text << "\ncs-data = ";
+        spatialdata::geocoords::CSPicklerAscii::pickle(text, db._cs);
+        text << "\n";
+        const std::string textStr = text.str();
+
+        FileHeader header;
+        memset(&header, 0, sizeof(header));
+        assert(strlen(FILEHEADER) < sizeof(header.magic));
+        memcpy(header.magic, FILEHEADER, strlen(FILEHEADER));
+        header.byteOrder = _byteOrder;
+        header.version = _version;
+        header.numX = db._x.size();
+        header.numY = db._y.size();
+        header.numZ = db._z.size();
+        header.numValues = numValues;
+        header.rootSize = db._rootSize;
+        header.depth = db._depth;
+        header.numNodes = db._nodes.size();
+        header.numLeaves = db._leaves.size() / 8;
+        header.numCorners = db._values.size() / numValues;
+        header.textSize = textStr.length();
+
+        fileout.write((const char*)&header, sizeof(header));
+        fileout.write(textStr.c_str(), header.textSize);
+        fileout.write((const char*)&db._x[0], db._x.size()*sizeof(double));
+        fileout.write((const char*)&db._y[0], db._y.size()*sizeof(double));
+        fileout.write((const char*)&db._z[0], db._z.size()*sizeof(double));
+        fileout.write((const char*)&db._nodes[0], db._nodes.size()*sizeof(uint32_t));
+        fileout.write((const char*)&db._leaves[0], db._leaves.size()*sizeof(uint32_t));
+        fileout.write((const char*)&db._values[0], db._values.size()*sizeof(double));
+
+        if (!fileout.good()) {
+            throw std::runtime_error("Unknown error while writing.");
+        } // if
+
+        fileout.close();
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while writing spatial database file '" << db._filename << "'.\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } catch (...) {
+        std::ostringstream msg;
+        msg << "Unknown error occurred while writing spatial database file '" << db._filename << "'.\n";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // write
+
+
+// ----------------------------------------------------------------------
+// Parse names, units, and coordinate system from file header.
+void
+spatialdata::spatialdb::OctreeGridBinary::_parseText(const std::string& text,
+                                                     OctreeGridDB* const db) {
+    assert(db);
+
+    delete[] db->_names;db->_names = new std::string[db->_numValues];
+    delete[] db->_units;db->_units = new std::string[db->_numValues];
+
+    const int maxIgnore = 256;
+    std::istringstream buffer(text);
+    std::string token;
+
+    buffer >> token;
+    if (0 != strcasecmp(token.c_str(), "value-names")) {
+        std::ostringstream msg;
+        msg << "Could not parse '" << token << "' into 'value-names'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    buffer.ignore(maxIgnore, '=');
+    for (size_t iVal = 0; iVal < db->_numValues; ++iVal) {
+        buffer >> db->_names[iVal];
+    } // for
+
+    buffer >> token;
+    if (0 != strcasecmp(token.c_str(), "value-units")) {
+        std::ostringstream msg;
+        msg << "Could not parse '" << token << "' into 'value-units'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    buffer.ignore(maxIgnore, '=');
+    for (size_t iVal = 0; iVal < db->_numValues; ++iVal) {
+        buffer >> db->_units[iVal];
+    } // for
+
+    buffer >> token;
+    if (0 != strcasecmp(token.c_str(), "cs-data")) {
+        std::ostringstream msg;
+        msg << "Could not parse '" << token << "' into 'cs-data'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    spatialdata::geocoords::CSPicklerAscii::unpickle(buffer, &db->_cs);
+
+    if (!buffer.good()) {
+        throw std::runtime_error("I/O error while parsing OctreeGridDB settings.");
+    } // if
+    if (3 != db->_cs->getSpaceDim()) {
+        throw std::runtime_error("OctreeGridDB requires coordinate system with spatial dimension 3.");
+    } // if
+} // _parseText
+
+
+// ----------------------------------------------------------------------
+// Check that nodes refer to children, leaves, and corners in the
+// octree.
+void
+spatialdata::spatialdb::OctreeGridBinary::_checkOctree(const OctreeGridDB& db) {
+    const size_t numNodes = db._nodes.size();
+    const size_t numLeaves = db._leaves.size() / 8;
+    const size_t numCorners = db._values.size() / db._numValues;
+
+    size_t maxDepth = 0;
+    while ((size_t(1) << maxDepth) < db._rootSize) {
+        ++maxDepth;
+    } // while
+    const size_t maxCells = std::max(db._x.size(), std::max(db._y.size(), db._z.size())) - 1;
+    if (( db._rootSize != (size_t(1) << maxDepth)) || ( db._rootSize < maxCells) || ( db._depth > maxDepth) ) {
+        throw std::runtime_error("Size of root of octree is inconsistent with grid.");
+    } // if
+    if (OctreeGridDB::EMPTY == db._nodes[0]) {
+        throw std::runtime_error("Root of octree is empty.");
+    } // if
+
+    // Children follow their parents, so levels are set before they
+    // are checked.
+    std::vector<size_t> levels(numNodes, 0);
+    for (size_t iNode = 0; iNode < numNodes; ++iNode) {
+        const uint32_t node = db._nodes[iNode];
+        if (OctreeGridDB::EMPTY == node) {
+            continue;
+        } else if (node & OctreeGridDB::LEAF) {
+            if ((node & ~OctreeGridDB::LEAF) >= numLeaves) {
+                throw std::runtime_error("Node of octree refers to leaf that does not exist.");
+            } // if
+        } else {
+            if (( node <= iNode) || ( node + 8 > numNodes) || ( levels[iNode] >= db._depth) ) {
+                throw std::runtime_error("Node of octree refers to children that do not exist.");
+            } // if
+            for (size_t iChild = 0; iChild < 8; ++iChild) {
+                levels[node+iChild] = levels[iNode] + 1;
+            } // for
+        } // if/else
+    } // for
+
+    for (size_t i = 0; i < db._leaves.size(); ++i) {
+        if (db._leaves[i] >= numCorners) {
+            throw std::runtime_error("Leaf of octree refers to corner that does not exist.");
+        } // if
+    } // for
+} // _checkOctree
+
+
+// End of file
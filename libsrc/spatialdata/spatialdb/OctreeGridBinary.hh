@@ -0,0 +1,127 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/OctreeGridBinary.hh
+ *
+ * @brief C++ object for reading/writing OctreeGridDB info as binary
+ * files.
+ *
+ * The binary file holds a fixed-size header, the names and units of
+ * the values and the coordinate system as text (as in
+ * SimpleGridBinary), the coordinates of the fine grid along each axis,
+ * the nodes of the octree, the corners of the leaves, and the values
+ * at the corners. Data are stored in the byte order of the machine
+ * that wrote the file, and values are stored in SI units.
+ */
+
+#if !defined(spatialdata_spatialdb_octreegridbinary_hh)
+#define spatialdata_spatialdb_octreegridbinary_hh
+
+#include "OctreeGridDB.hh" // USES OctreeGridDB
+
+#include <stdint.h> // USES uint64_t
+#include <string> // USES std::string
+
+// ----------------------------------------------------------------------
+class spatialdata::spatialdb::OctreeGridBinary { // OctreeGridBinary
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    // Using default constructor.
+
+    // Using default destructor.
+
+    // Using default copy constructor
+
+    /** Check whether file is a binary OctreeGridDB file.
+     *
+     * @param filename Name of file.
+     * @returns True if file starts with binary file header, false otherwise.
+     */
+    static
+    bool isBinary(const char* filename);
+
+    /** Read the database.
+     *
+     * @param db Spatial database.
+     */
+    static
+    void read(OctreeGridDB* db);
+
+    /** Write the database.
+     *
+     * @param db Spatial database.
+     */
+    static
+    void write(const OctreeGridDB& db);
+
+private:
+
+    // PRIVATE STRUCTS ////////////////////////////////////////////////////
+
+    /// Fixed-size header at start of binary file.
+    struct FileHeader {
+        char magic[32]; ///< Magic header (NUL padded).
+        uint64_t byteOrder; ///< Byte order mark.
+        uint64_t version; ///< Version of file format.
+        uint64_t numX; ///< Number of points along x dimension.
+        uint64_t numY; ///< Number of points along y dimension.
+        uint64_t numZ; ///< Number of points along z dimension.
+        uint64_t numValues; ///< Number of values at each point.
+        uint64_t rootSize; ///< Number of grid cells along each edge of root.
+        uint64_t depth; ///< Number of levels below root.
+        uint64_t numNodes; ///< Number of nodes.
+        uint64_t numLeaves; ///< Number of leaves.
+        uint64_t numCorners; ///< Number of stored corners.
+        uint64_t textSize; ///< Size of text following header.
+    }; // FileHeader
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Parse names, units, and coordinate system from file header.
+     *
+     * @param text Text in header.
+     * @param db Spatial database.
+     */
+    static
+    void _parseText(const std::string& text,
+                    OctreeGridDB* const db);
+
+    /** Check that nodes refer to children, leaves, and corners in the
+     * octree, and that the octree is no deeper than the size of the root
+     * allows.
+     *
+     * @param db Spatial database.
+     */
+    static
+    void _checkOctree(const OctreeGridDB& db);
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    /** Magic header in binary files */
+    static const char* FILEHEADER;
+
+    static const uint64_t _byteOrder; ///< Byte order mark.
+    static const uint64_t _version; ///< Version of file format.
+
+}; // class OctreeGridBinary
+
+#endif // spatialdata_spatialdb_octreegridbinary_hh
+
+// End of file
@@ -0,0 +1,731 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "OctreeGridDB.hh" // Implementation of class methods
+
+#include "OctreeGridBinary.hh" // USES OctreeGridBinary
+#include "SimpleGridDB.hh" // USES SimpleGridDB
+#include "QueryContext.hh" // USES QueryContext
+
+#include "spatialdata/geocoords/CoordSys.hh" // HASA CoordSys
+#include "spatialdata/geocoords/Converter.hh" // USES Converter
+
+#include <cmath> // USES std::floor(), std::fabs()
+#include <algorithm> // USES std::min(), std::max(), std::upper_bound()
+
+#include <sstream> // USES std::ostringstream
+#include <stdexcept> // USES std::logic_error
+#include <strings.h> // USES strcasecmp()
+#include <assert.h> // USES assert()
+
+// ----------------------------------------------------------------------
+const uint32_t spatialdata::spatialdb::OctreeGridDB::LEAF = 0x80000000;
+const uint32_t spatialdata::spatialdb::OctreeGridDB::EMPTY = 0xffffffff;
+
+// ----------------------------------------------------------------------
+// Constructor
+spatialdata::spatialdb::OctreeGridDB::OctreeGridDB(void) :
+    _x(),
+    _y(),
+    _z(),
+    _nodes(),
+    _leaves(),
+    _values(),
+    _rootSize(0),
+    _depth(0),
+    _queryValues(NULL),
+    _querySize(0),
+    _numValues(0),
+    _names(NULL),
+    _units(NULL),
+    _filename(""),
+    _cs(NULL),
+    _queryType(NEAREST),
+    _exactValues() {}
+
+
+// ----------------------------------------------------------------------
+// Destructor
+spatialdata::spatialdb::OctreeGridDB::~OctreeGridDB(void) {
+    _deallocate();
+    delete[] _queryValues;_queryValues = NULL;
+    _querySize = 0;
+
+    delete _cs;_cs = NULL;
+} // destructor
+
+
+// ----------------------------------------------------------------------
+// Set filename containing data.
+void
+spatialdata::spatialdb::OctreeGridDB::setFilename(const char* value) {
+    _filename = value;
+} // setFilename
+
+
+// ----------------------------------------------------------------------
+// Set query type.
+void
+spatialdata::spatialdb::OctreeGridDB::setQueryType(const QueryEnum value) {
+    _queryType = value;
+} // setQueryType
+
+
+// ----------------------------------------------------------------------
+// Set values that build() reproduces exactly.
+void
+spatialdata::spatialdb::OctreeGridDB::setExactValues(const char* const* names,
+                                                     const size_t numNames) {
+    assert(names || 0 == numNames);
+    _exactValues.resize(numNames);
+    for (size_t i = 0; i < numNames; ++i) {
+        _exactValues[i] = names[i];
+    } // for
+} // setExactValues
+
+
+// ----------------------------------------------------------------------
+// Open the database and prepare for querying.
+void
+spatialdata::spatialdb::OctreeGridDB::open(void) {
+    OctreeGridBinary::read(this);
+    _resetQueryValues();
+} // open
+
+
+// ----------------------------------------------------------------------
+// Close the database.
+void
+spatialdata::spatialdb::OctreeGridDB::close(void) {
+    _deallocate();
+
+    _querySize = 0;
+    delete[] _queryValues;_queryValues = NULL;
+} // close
+
+
+// ----------------------------------------------------------------------
+// Build octree from values on fine grid.
+void
+spatialdata::spatialdb::OctreeGridDB::build(SimpleGridDB* fine,
+                                            const double tolerance) {
+    assert(fine);
+
+    if (!fine->_data && !fine->_dataF && !fine->_cache) {
+        std::ostringstream msg;
+        msg << "Spatial database '" << fine->getLabel() << "' must be opened before building octree.";
+        throw std::logic_error(msg.str());
+    } // if
+    if (( 3 != fine->_spaceDim) || ( 3 != fine->_dataDim) ) {
+        std::ostringstream msg;
+        msg << "Octree requires 3-D data in 3-D space, but spatial database '" << fine->getLabel()
+            << "' has " << fine->_dataDim << "-D data in " << fine->_spaceDim << "-D space.";
+        throw std::domain_error(msg.str());
+    } // if
+
+    // Values reproduced exactly.
+    std::vector<bool> isExact(fine->_numValues, false);
+    for (size_t iExact = 0; iExact < _exactValues.size(); ++iExact) {
+        size_t iName = 0;
+        const size_t numNames = fine->_numValues;
+        while (iName < numNames) {
+            if (0 == strcasecmp(_exactValues[iExact].c_str(), fine->_names[iName].c_str())) {
+                break;
+            } // if
+            ++iName;
+        } // while
+        if (iName >= numNames) {
+            std::ostringstream msg;
+            msg << "Could not find value '" << _exactValues[iExact] << "' to reproduce exactly in spatial database '"
+                << fine->getLabel() << "'. Available values are:";
+            for (size_t iName = 0; iName < numNames; ++iName) {
+                msg << "\n  " << fine->_names[iName];
+            } // for
+            msg << "\n";
+            throw std::out_of_range(msg.str());
+        } // if
+        isExact[iName] = true;
+    } // for
+
+    _deallocate();
+    const size_t numX = fine->_numX;
+    const size_t numY = fine->_numY;
+    const size_t numZ = fine->_numZ;
+    const size_t numValues = fine->_numValues;
+    _x.assign(fine->_x, fine->_x + numX);
+    _y.assign(fine->_y, fine->_y + numY);
+    _z.assign(fine->_z, fine->_z + numZ);
+    _numValues = numValues;
+    _names = new std::string[numValues];
+    _units = new std::string[numValues];
+    for (size_t iVal = 0; iVal < numValues; ++iVal) {
+        _names[iVal] = fine->_names[iVal];
+        _units[iVal] = fine->_units[iVal];
+    } // for
+    delete _cs;_cs = fine->_cs->clone();assert(_cs);
+
+    std::vector<double> values;
+    _getFineValues(&values, fine);
+
+    // Tolerance is relative to the range of each value.
+    const size_t numPoints = numX*numY*numZ;
+    std::vector<double> tolerances(numValues, 0.0);
+    for (size_t iVal = 0; iVal < numValues; ++iVal) {
+        if (isExact[iVal]) {
+            continue;
+        } // if
+        double valueMin = values[iVal];
+        double valueMax = values[iVal];
+        for (size_t iPoint = 1; iPoint < numPoints; ++iPoint) {
+            valueMin = std::min(valueMin, values[iPoint*numValues+iVal]);
+            valueMax = std::max(valueMax, values[iPoint*numValues+iVal]);
+        } // for
+        tolerances[iVal] = tolerance * (valueMax - valueMin);
+    } // for
+
+    _rootSize = 1;
+    const size_t numCells = std::max(numX, std::max(numY, numZ)) - 1;
+    while (_rootSize < numCells) {
+        _rootSize *= 2;
+    } // while
+
+    std::vector<uint32_t> slots(numPoints, EMPTY);
+    const size_t origin[3] = { 0, 0, 0 };
+    _nodes.resize(1);
+    _addNode(0, origin, _rootSize, 0, values, tolerances, &slots);
+
+    // Release capacity left over from growing the octree.
+    std::vector<uint32_t>(_nodes).swap(_nodes);
+    std::vector<uint32_t>(_leaves).swap(_leaves);
+    std::vector<double>(_values).swap(_values);
+
+    _resetQueryValues();
+} // build
+
+
+// ----------------------------------------------------------------------
+// Get number of leaves in octree.
+size_t
+spatialdata::spatialdb::OctreeGridDB::getNumLeaves(void) const {
+    return _leaves.size() / 8;
+} // getNumLeaves
+
+
+// ----------------------------------------------------------------------
+// Get depth of octree.
+size_t
+spatialdata::spatialdb::OctreeGridDB::getDepth(void) const {
+    return _depth;
+} // getDepth
+
+
+// ----------------------------------------------------------------------
+// Get size of octree and values.
+size_t
+spatialdata::spatialdb::OctreeGridDB::getStorageSize(void) const {
+    return (_nodes.size() + _leaves.size())*sizeof(uint32_t) + _values.size()*sizeof(double);
+} // getStorageSize
+
+
+// ----------------------------------------------------------------------
+// Get names of values in spatial database.
+void
+spatialdata::spatialdb::OctreeGridDB::getNamesDBValues(const char*** valueNames,
+                                                       size_t* numValues) const {
+    if (valueNames) {
+        *valueNames = (_numValues > 0) ? new const char*[_numValues] : NULL;
+        for (size_t i = 0; i < _numValues; ++i) {
+            (*valueNames)[i] = _names[i].c_str();
+        } // for
+    }
+    if (numValues) {
+        *numValues = _numValues;
+    } // if
+} // getNamesDBValues
+
+
+// ----------------------------------------------------------------------
+// Set values to be returned by queries.
+void
+spatialdata::spatialdb::OctreeGridDB::setQueryValues(const char* const* names,
+                                                     const size_t numVals) {
+    assert(_nodes.size() > 0);
+    if (0 == numVals) {
+        std::ostringstream msg;
+        msg
+            << "Number of values for query in spatial database " << getLabel()
+            << "\n must be positive.\n";
+        throw std::invalid_argument(msg.str());
+    } // if
+    assert(names && 0 < numVals);
+
+    _querySize = numVals;
+    delete[] _queryValues;_queryValues = new size_t[numVals];
+    for (size_t iVal = 0; iVal < numVals; ++iVal) {
+        size_t iName = 0;
+        const size_t numNames = _numValues;
+        while (iName < numNames) {
+            if (0 == strcasecmp(names[iVal], _names[iName].c_str())) {
+                break;
+            } // if
+            ++iName;
+        } // while
+        if (iName >= numNames) {
+            std::ostringstream msg;
+            msg << "Could not find value '" << names[iVal] << "' in spatial database '"
+                << getLabel() << "'. Available values are:";
+            for (size_t iName = 0; iName < numNames; ++iName) {
+                msg << "\n  " << _names[iName];
+            } // for
+            msg << "\n";
+            throw std::out_of_range(msg.str());
+        } // if
+        _queryValues[iVal] = iName;
+    } // for
+} // setQueryValues
+
+
+// ----------------------------------------------------------------------
+// Query the database.
+int
+spatialdata::spatialdb::OctreeGridDB::query(double* vals,
+                                            const size_t numVals,
+                                            const double* coords,
+                                            const size_t numDims,
+                                            const spatialdata::geocoords::CoordSys* csQuery) {
+    int err = 0;
+    queryBatch(_getQueryContext(), vals, numVals, &err, coords, 1, numDims, csQuery);
+
+    return err;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::OctreeGridDB::isThreadSafe(void) const {
+    return true;
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::OctreeGridDB::queryBatch(QueryContext* context,
+                                                 double* vals,
+                                                 const size_t numVals,
+                                                 int* err,
+                                                 const double* coords,
+                                                 const size_t numLocs,
+                                                 const size_t numDims,
+                                                 const spatialdata::geocoords::CoordSys* csQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+    assert(coords);
+
+    if (0 == _querySize) {
+        std::ostringstream msg;
+        msg << "Values to be returned by spatial database " << getLabel() << "\n"
+            << "have not been set. Please call setQueryValues() before query().\n";
+        throw std::logic_error(msg.str());
+    } else if (numVals != _querySize) {
+        std::ostringstream msg;
+        msg << "Number of values to be returned by spatial database "
+            << getLabel() << "\n"
+            << "(" << _querySize << ") does not match size of array provided ("
+            << numVals << ").\n";
+        throw std::invalid_argument(msg.str());
+    } else if (numDims != 3) {
+        std::ostringstream msg;
+        msg << "Spatial dimension (" << numDims
+            << ") does not match spatial dimension of spatial database (3).";
+        throw std::invalid_argument(msg.str());
+    } // if
+
+    // Convert coordinates of all locations at once.
+    std::vector<double>& xyz = context->coords;
+    xyz.assign(coords, coords+numLocs*numDims);
+    spatialdata::geocoords::Converter* converter = context->getConverter(this);
+    assert(converter);
+    converter->convert(&xyz[0], numLocs, numDims, _cs, csQuery);
+
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        err[iLoc] = _queryPoint(&vals[iLoc*numVals], &xyz[iLoc*numDims]);
+    } // for
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Deallocate octree, coordinates, and values.
+void
+spatialdata::spatialdb::OctreeGridDB::_deallocate(void) {
+    _x.clear();
+    _y.clear();
+    _z.clear();
+    _nodes.clear();
+    _leaves.clear();
+    _values.clear();
+    _rootSize = 0;
+    _depth = 0;
+
+    _numValues = 0;
+    delete[] _names;_names = NULL;
+    delete[] _units;_units = NULL;
+} // _deallocate
+
+
+// ----------------------------------------------------------------------
+// Set default query values to all values.
+void
+spatialdata::spatialdb::OctreeGridDB::_resetQueryValues(void) {
+    _querySize = _numValues;
+    delete[] _queryValues;_queryValues = (_querySize > 0) ? new size_t[_querySize] : NULL;
+    for (size_t i = 0; i < _querySize; ++i) {
+        _queryValues[i] = i;
+    } // for
+} // _resetQueryValues
+
+
+// ----------------------------------------------------------------------
+// Get values at all points of fine grid.
+void
+spatialdata::spatialdb::OctreeGridDB::_getFineValues(std::vector<double>* values,
+                                                     SimpleGridDB* fine) const {
+    assert(values);
+    assert(fine);
+
+    const size_t numX = fine->_numX;
+    const size_t numY = fine->_numY;
+    const size_t numZ = fine->_numZ;
+    const size_t numValues = fine->_numValues;
+
+    // Querying the grid points works with any storage of the values
+    // (layout, precision, cache, or compression).
+    const SimpleGridDB::QueryEnum queryType = fine->_queryType;
+    std::vector<std::string> queryNames(fine->_querySize);
+    for (size_t iVal = 0; iVal < fine->_querySize; ++iVal) {
+        queryNames[iVal] = fine->_names[fine->_queryValues[iVal]];
+    } // for
+    std::vector<const char*> names(numValues);
+    auto restoreQuery = [&] () {
+        fine->setQueryType(queryType);
+        for (size_t iVal = 0; iVal < queryNames.size(); ++iVal) {
+            names[iVal] = queryNames[iVal].c_str();
+        } // for
+        if (queryNames.size() > 0) {
+            fine->setQueryValues(&names[0], queryNames.size());
+        } // if
+    };
+
+    try {
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            names[iVal] = fine->_names[iVal].c_str();
+        } // for
+        fine->setQueryType(SimpleGridDB::NEAREST);
+        fine->setQueryValues(&names[0], numValues);
+
+        // Query one layer of points at a time.
+        const size_t spaceDim = 3;
+        const size_t numLayer = numX*numY;
+        values->resize(numLayer*numZ*numValues);
+        std::vector<double> coords(numLayer*spaceDim);
+        std::vector<int> err(numLayer);
+        for (size_t iZ = 0; iZ < numZ; ++iZ) {
+            for (size_t iY = 0, i = 0; iY < numY; ++iY) {
+                for (size_t iX = 0; iX < numX; ++iX, i += spaceDim) {
+                    coords[i+0] = _x[iX];
+                    coords[i+1] = _y[iY];
+                    coords[i+2] = _z[iZ];
+                } // for
+            } // for
+            fine->multiquery(&(*values)[iZ*numLayer*numValues], numLayer, numValues, &err[0], numLayer,
+                             &coords[0], numLayer, spaceDim, fine->_cs);
+        } // for
+    } catch (...) {
+        // Leave the caller's database configured as it was.
+        restoreQuery();
+        throw;
+    } // try/catch
+
+    restoreQuery();
+} // _getFineValues
+
+
+// ----------------------------------------------------------------------
+// Add node covering cube of grid cells and its descendants.
+void
+spatialdata::spatialdb::OctreeGridDB::_addNode(const size_t index,
+                                               const size_t origin[3],
+                                               const size_t size,
+                                               const size_t depth,
+                                               const std::vector<double>& values,
+                                               const std::vector<double>& tolerances,
+                                               std::vector<uint32_t>* slots) {
+    assert(index < _nodes.size());
+    assert(slots);
+
+    const size_t numPoints[3] = { _x.size(), _y.size(), _z.size() };
+    bool isInside = true;
+    for (size_t iDim = 0; iDim < 3; ++iDim) {
+        if (origin[iDim] >= numPoints[iDim]-1) {
+            _nodes[index] = EMPTY;
+            return;
+        } // if
+        isInside = isInside && origin[iDim] + size <= numPoints[iDim]-1;
+    } // for
+    _depth = std::max(_depth, depth);
+
+    if (isInside && (( 1 == size) || _isLeaf(origin, size, values, tolerances) )) {
+        const size_t leaf = _leaves.size() / 8;
+        if (leaf >= LEAF) {
+            throw std::length_error("Number of leaves exceeds maximum number of leaves in octree.");
+        } // if
+        _nodes[index] = LEAF | uint32_t(leaf);
+
+        // Corners shared with neighboring leaves are stored once.
+        const size_t numValues = _numValues;
+        for (size_t iCorner = 0; iCorner < 8; ++iCorner) {
+            const size_t iX = origin[0] + ((iCorner & 1) ? size : 0);
+            const size_t iY = origin[1] + ((iCorner & 2) ? size : 0);
+            const size_t iZ = origin[2] + ((iCorner & 4) ? size : 0);
+            const size_t point = (iZ*numPoints[1] + iY)*numPoints[0] + iX;
+            uint32_t& slot = (*slots)[point];
+            if (EMPTY == slot) {
+                slot = uint32_t(_values.size() / numValues);
+                _values.insert(_values.end(), &values[point*numValues], &values[point*numValues] + numValues);
+            } // if
+            _leaves.push_back(slot);
+        } // for
+        return;
+    } // if
+
+    const size_t firstChild = _nodes.size();
+    if (firstChild + 8 >= LEAF) {
+        throw std::length_error("Number of nodes exceeds maximum number of nodes in octree.");
+    } // if
+    _nodes.resize(firstChild + 8);
+    _nodes[index] = uint32_t(firstChild);
+    const size_t half = size / 2;
+    for (size_t iChild = 0; iChild < 8; ++iChild) {
+        const size_t originChild[3] = {
+            origin[0] + ((iChild & 1) ? half : 0),
+            origin[1] + ((iChild & 2) ? half : 0),
+            origin[2] + ((iChild & 4) ? half : 0),
+        };
+        _addNode(firstChild + iChild, originChild, half, depth+1, values, tolerances, slots);
+    } // for
+} // _addNode
+
+
+// ----------------------------------------------------------------------
+// Check whether trilinear interpolation from corners of cube reproduces
+// values at all fine grid points in cube.
+bool
+spatialdata::spatialdb::OctreeGridDB::_isLeaf(const size_t origin[3],
+                                              const size_t size,
+                                              const std::vector<double>& values,
+                                              const std::vector<double>& tolerances) const {
+    const size_t numValues = _numValues;
+    const size_t numX = _x.size();
+    const size_t numY = _y.size();
+
+    const double* corners[8];
+    for (size_t iCorner = 0; iCorner < 8; ++iCorner) {
+        const size_t iX = origin[0] + ((iCorner & 1) ? size : 0);
+        const size_t iY = origin[1] + ((iCorner & 2) ? size : 0);
+        const size_t iZ = origin[2] + ((iCorner & 4) ? size : 0);
+        corners[iCorner] = &values[((iZ*numY + iY)*numX + iX)*numValues];
+    } // for
+
+    // Use the same weights and sum as queries, so values with zero
+    // tolerance are reproduced exactly.
+    double wts[8];
+    for (size_t k = 0; k <= size; ++k) {
+        for (size_t j = 0; j <= size; ++j) {
+            for (size_t i = 0; i <= size; ++i) {
+                const double t[3] = { double(i) / size, double(j) / size, double(k) / size };
+                _computeWeights(wts, t);
+                const double* valuesPoint = &values[(((origin[2]+k)*numY + origin[1]+j)*numX + origin[0]+i)*numValues];
+                for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                    const double value = _sumCorners(wts, corners, iVal);
+                    if (!(std::fabs(value - valuesPoint[iVal]) <= tolerances[iVal])) {
+                        return false;
+                    } // if
+                } // for
+            } // for
+        } // for
+    } // for
+
+    return true;
+} // _isLeaf
+
+
+// ----------------------------------------------------------------------
+// Query the database at location in coordinate system of database.
+int
+spatialdata::spatialdb::OctreeGridDB::_queryPoint(double* vals,
+                                                  const double* xyz) const {
+    assert(_nodes.size() > 0);
+
+    double index[3] = {
+        _search(xyz[0], _x),
+        _search(xyz[1], _y),
+        _search(xyz[2], _z),
+    };
+    switch (_queryType) {
+    case LINEAR:
+        if (( index[0] < 0.0) || ( index[1] < 0.0) || ( index[2] < 0.0) ) {
+            return 1;
+        } // if
+        break;
+    case NEAREST:
+        for (size_t iDim = 0; iDim < 3; ++iDim) {
+            index[iDim] = std::floor(index[iDim]+0.5);
+        } // for
+        break;
+    default:
+        assert(false);
+        throw std::logic_error("Unsupported query type in OctreeGridDB::query().");
+    } // switch
+
+    _interpolate(vals, index);
+    return 0;
+} // _queryPoint
+
+
+// ----------------------------------------------------------------------
+// Interpolate values in leaf containing fractional indices.
+void
+spatialdata::spatialdb::OctreeGridDB::_interpolate(double* vals,
+                                                   const double index[3]) const {
+    const double indexMax[3] = { _x.size()-1.0, _y.size()-1.0, _z.size()-1.0 };
+    double indexClamped[3];
+    for (size_t iDim = 0; iDim < 3; ++iDim) {
+        indexClamped[iDim] = std::max(0.0, std::min(index[iDim], indexMax[iDim]));
+    } // for
+
+    // Descend into the upper child only if the location is strictly
+    // above its start, so the child is never outside the grid.
+    size_t origin[3] = { 0, 0, 0 };
+    size_t size = _rootSize;
+    uint32_t node = _nodes[0];
+    while (!(node & LEAF)) {
+        size /= 2;
+        size_t iChild = 0;
+        for (size_t iDim = 0; iDim < 3; ++iDim) {
+            if (indexClamped[iDim] > double(origin[iDim] + size)) {
+                iChild |= size_t(1) << iDim;
+                origin[iDim] += size;
+            } // if
+        } // for
+        node = _nodes[node + iChild];
+    } // while
+    assert(EMPTY != node);
+
+    const size_t numValues = _numValues;
+    const uint32_t* slots = &_leaves[(node & ~LEAF)*8];
+    const double* corners[8];
+    for (size_t iCorner = 0; iCorner < 8; ++iCorner) {
+        corners[iCorner] = &_values[slots[iCorner]*numValues];
+    } // for
+    const double t[3] = {
+        (indexClamped[0] - origin[0]) / size,
+        (indexClamped[1] - origin[1]) / size,
+        (indexClamped[2] - origin[2]) / size,
+    };
+    double wts[8];
+    _computeWeights(wts, t);
+
+    const size_t querySize = _querySize;
+    for (size_t iVal = 0; iVal < querySize; ++iVal) {
+        vals[iVal] = _sumCorners(wts, corners, _queryValues[iVal]);
+    } // for
+} // _interpolate
+
+
+// ----------------------------------------------------------------------
+// Compute weights of corners of cube for trilinear interpolation.
+void
+spatialdata::spatialdb::OctreeGridDB::_computeWeights(double wts[8],
+                                                      const double t[3]) {
+    const double tX = t[0];
+    const double tY = t[1];
+    const double tZ = t[2];
+    wts[0] = (1.0-tX)*(1.0-tY)*(1.0-tZ);
+    wts[1] = tX*(1.0-tY)*(1.0-tZ);
+    wts[2] = (1.0-tX)*tY*(1.0-tZ);
+    wts[3] = tX*tY*(1.0-tZ);
+    wts[4] = (1.0-tX)*(1.0-tY)*tZ;
+    wts[5] = tX*(1.0-tY)*tZ;
+    wts[6] = (1.0-tX)*tY*tZ;
+    wts[7] = tX*tY*tZ;
+} // _computeWeights
+
+
+// ----------------------------------------------------------------------
+// Compute weighted sum of value at corners of cube.
+double
+spatialdata::spatialdb::OctreeGridDB::_sumCorners(const double wts[8],
+                                                  const double* const corners[8],
+                                                  const size_t iVal) {
+    // The weights sum to one, but the rounded sum of a constant value
+    // often differs from it in the last bit.
+    const double value0 = corners[0][iVal];
+    bool isConstant = true;
+    for (size_t iCorner = 1; iCorner < 8; ++iCorner) {
+        isConstant = isConstant && corners[iCorner][iVal] == value0;
+    } // for
+    if (isConstant) {
+        return value0;
+    } // if
+
+    double value = 0.0;
+    for (size_t iCorner = 0; iCorner < 8; ++iCorner) {
+        value += wts[iCorner] * corners[iCorner][iVal];
+    } // for
+    return value;
+} // _sumCorners
+
+
+// ----------------------------------------------------------------------
+// Search for coordinate along axis.
+double
+spatialdata::spatialdb::OctreeGridDB::_search(const double target,
+                                              const std::vector<double>& vals) const {
+    const size_t nvals = vals.size();
+    assert(nvals > 1);
+
+    double index = -1.0;
+    const double tolerance = 1.0e-6;
+    if (( target >= vals[0]-tolerance) && ( target <= vals[nvals-1]+tolerance) ) {
+        const size_t indexUpper = std::upper_bound(vals.begin(), vals.end(), target) - vals.begin();
+        const size_t indexL = std::min(nvals-2, (indexUpper > 0) ? indexUpper-1 : 0);
+        index = double(indexL) + (target - vals[indexL]) / (vals[indexL+1] - vals[indexL]);
+    } else if (_queryType == NEAREST) {
+        index = (target <= vals[0]) ? 0.0 : double(nvals-1);
+    } // if/else
+
+    return index;
+} // _search
+
+
+// End of file
@@ -0,0 +1,368 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/OctreeGridDB.hh
+ *
+ * @brief C++ object for querying data on an adaptive octree over a
+ * nonuniform (or uniform) 3-D grid.
+ *
+ * The octree refines the points of a fine rectilinear grid (as in
+ * SimpleGridDB) only where the values vary. Each leaf of the octree is
+ * a cube of grid cells in index space that stores the values at its
+ * eight corners; values inside the leaf are interpolated trilinearly
+ * from the corners. Corners shared by neighboring leaves are stored
+ * once. A model with a small region of fine detail in a large region
+ * of smoothly varying values uses a few large leaves outside the
+ * region of detail.
+ *
+ * The octree is built from a fine SimpleGridDB with build(), so that
+ * interpolation in every leaf reproduces the values at all of the fine
+ * grid points in the leaf within a tolerance. Because both
+ * interpolations are trilinear within each cell of the fine grid,
+ * linear queries anywhere in the grid are also within the tolerance of
+ * linear queries of the fine SimpleGridDB. Octrees are written to and
+ * read from binary files with OctreeGridBinary.
+ */
+
+#if !defined(spatialdata_spatialdb_octreegriddb_hh)
+#define spatialdata_spatialdb_octreegriddb_hh
+
+#include "SpatialDB.hh" // ISA SpatialDB
+
+#include <string> // HASA std::string
+#include <vector> // HASA std::vector
+#include <stdint.h> // USES uint32_t
+
+class spatialdata::spatialdb::OctreeGridDB : public SpatialDB { // OctreeGridDB
+    friend class TestOctreeGridDB; // unit testing
+    friend class OctreeGridBinary; // reader/writer
+
+public:
+
+    // PUBLIC ENUM ////////////////////////////////////////////////////////
+
+    /** Type of query */
+    enum QueryEnum {
+        NEAREST=0, ///< Value at nearest point of fine grid.
+        LINEAR=1, ///< Linear interpolation.
+    };
+
+    // PUBLIC MEMBERS ///////////////////////////////////////////////////////
+public:
+
+    /// Constructor
+    OctreeGridDB(void);
+
+    /// Destructor
+    ~OctreeGridDB(void);
+
+    /** Set filename containing data.
+     *
+     * @param value Name of data file.
+     */
+    void setFilename(const char* value);
+
+    /** Set query type.
+     *
+     * Nearest queries return the values interpolated in the octree at
+     * the nearest point of the fine grid, so they are within the
+     * tolerance of nearest queries of the fine SimpleGridDB and are
+     * exact for values set with setExactValues().
+     *
+     * @param queryType Set type of query
+     */
+    void setQueryType(const QueryEnum queryType);
+
+    /** Set values that build() reproduces exactly.
+     *
+     * Use this for categorical values, such as tags or material ids,
+     * that must never be blended. These values get a tolerance of zero
+     * regardless of the tolerance passed to build(). Leaves span a
+     * power of two cells, so interpolation at a fine grid point is
+     * exact for these values, and nearest queries return the value at
+     * the nearest fine grid point rather than a blend of values at the
+     * leaf corners. Linear queries still interpolate between grid
+     * points. Refinement stops only where interpolation reproduces
+     * these values exactly, which is always the case where they are
+     * constant over a leaf, so listing smoothly varying values limits
+     * coarsening.
+     *
+     * @pre Must call before build().
+     *
+     * @param names Names of values to reproduce exactly.
+     * @param numNames Number of names.
+     */
+    void setExactValues(const char* const* names,
+                        const size_t numNames);
+
+    /** Build octree from values on fine grid.
+     *
+     * The fine database must be opened and hold 3-D data in 3-D
+     * space. Its query type and query values are restored after the
+     * values at the grid points are retrieved, including when
+     * retrieving them throws an exception. Values are stored in SI
+     * units.
+     *
+     * @param fine Spatial database with values on fine grid.
+     * @param tolerance Maximum error of each value relative to the range
+     *   of the value over the grid (0 to reproduce values exactly);
+     *   values set with setExactValues() use 0.
+     */
+    void build(SimpleGridDB* fine,
+               const double tolerance);
+
+    /** Get number of leaves in octree.
+     *
+     * @returns Number of leaves.
+     */
+    size_t getNumLeaves(void) const;
+
+    /** Get depth of octree.
+     *
+     * @returns Number of levels below root.
+     */
+    size_t getDepth(void) const;
+
+    /** Get size of octree and values.
+     *
+     * @returns Size in bytes of nodes, leaves, and values.
+     */
+    size_t getStorageSize(void) const;
+
+    /// Open the database and prepare for querying.
+    void open(void);
+
+    /// Close the database.
+    void close(void);
+
+    /** Get names of values in spatial database.
+     *
+     * @param[out] valueNames Array of names of values.
+     * @param[out] numValues Size of array.
+     */
+    void getNamesDBValues(const char*** valueNames,
+                          size_t* numValues) const;
+
+    /** Set values to be returned by queries.
+     *
+     * @pre Must call open() or build() before setQueryValues()
+     *
+     * @param names Names of values to be returned in queries
+     * @param numVals Number of values to be returned in queries
+     */
+    void setQueryValues(const char* const* names,
+                        const size_t numVals);
+
+    /** Query the database.
+     *
+     * @note pVals should be preallocated to accommodate numVals values.
+     *
+     * @pre Must call open() before query()
+     *
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling query().
+     * @param numVals Number of values expected (size of pVals array)
+     * @param coords Coordinates of point for query
+     * @param numDims Number of dimensions for coordinates
+     * @param pCSQuery Coordinate system of coordinates
+     *
+     * @returns 0 on success, 1 on failure (i.e., could not interpolate)
+     */
+    int query(double* vals,
+              const size_t numVals,
+              const double* coords,
+              const size_t numDims,
+              const spatialdata::geocoords::CoordSys* pCSQuery);
+
+    /** Can the database be queried concurrently?
+     *
+     * @returns True (queries do not modify the octree).
+     */
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
+    // PRIVATE METHODS //////////////////////////////////////////////////////
+private:
+
+    /// Deallocate octree, coordinates, and values.
+    void _deallocate(void);
+
+    /// Set default query values to all values.
+    void _resetQueryValues(void);
+
+    /** Get values at all points of fine grid.
+     *
+     * @param values Values at points ordered with x fastest, then y,
+     *   then z [numX*numY*numZ*numValues].
+     * @param fine Spatial database with values on fine grid.
+     */
+    void _getFineValues(std::vector<double>* values,
+                        SimpleGridDB* fine) const;
+
+    /** Add node covering cube of grid cells and its descendants.
+     *
+     * @param index Index of node.
+     * @param origin Index of first grid point of cube along each axis.
+     * @param size Number of grid cells along each edge of cube.
+     * @param depth Number of levels below root.
+     * @param values Values at all points of fine grid.
+     * @param tolerances Maximum error of each value.
+     * @param slots Map from index of fine grid point to index of stored corner.
+     */
+    void _addNode(const size_t index,
+                  const size_t origin[3],
+                  const size_t size,
+                  const size_t depth,
+                  const std::vector<double>& values,
+                  const std::vector<double>& tolerances,
+                  std::vector<uint32_t>* slots);
+
+    /** Check whether trilinear interpolation from corners of cube
+     * reproduces values at all fine grid points in cube.
+     *
+     * @param origin Index of first grid point of cube along each axis.
+     * @param size Number of grid cells along each edge of cube.
+     * @param values Values at all points of fine grid.
+     * @param tolerances Maximum error of each value.
+     * @returns True if all values are within tolerances, false otherwise.
+     */
+    bool _isLeaf(const size_t origin[3],
+                 const size_t size,
+                 const std::vector<double>& values,
+                 const std::vector<double>& tolerances) const;
+
+    /** Query the database at location in coordinate system of database.
+     *
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling query().
+     * @param xyz Coordinates of location in coordinate system of database.
+     *
+     * @returns 0 on success, 1 on failure (i.e., could not interpolate)
+     */
+    int _queryPoint(double* vals,
+                    const double* xyz) const;
+
+    /** Interpolate values in leaf containing fractional indices.
+     *
+     * Descends from the root to the leaf, so the cost is proportional
+     * to the depth of the octree.
+     *
+     * @param vals Array for computed values (output from query).
+     * @param index Fractional index along each axis (inside grid).
+     */
+    void _interpolate(double* vals,
+                      const double index[3]) const;
+
+    /** Compute weights of corners of cube for trilinear interpolation.
+     *
+     * Corners are ordered with x varying fastest, then y, then z.
+     *
+     * @param wts Array of weights of corners (output).
+     * @param t Fractional position in cube along each axis.
+     */
+    static void _computeWeights(double wts[8],
+                                const double t[3]);
+
+    /** Compute weighted sum of value at corners of cube.
+     *
+     * Used both to check leaves and to query them, so values with zero
+     * tolerance are reproduced exactly at grid points. A value that is
+     * the same at all corners is returned as is.
+     *
+     * @param wts Weights of corners.
+     * @param corners Values at each corner.
+     * @param iVal Index of value.
+     * @returns Interpolated value.
+     */
+    static double _sumCorners(const double wts[8],
+                              const double* const corners[8],
+                              const size_t iVal);
+
+    /** Search for coordinate along axis.
+     *
+     * @param target Coordinate of target.
+     * @param vals Array of ordered coordinates along axis.
+     * @returns Fractional index of target (-1 if outside for linear queries).
+     */
+    double _search(const double target,
+                   const std::vector<double>& vals) const;
+
+    // PRIVATE MEMBERS //////////////////////////////////////////////////////
+private:
+
+    std::vector<double> _x; ///< Coordinates of fine grid along x axis.
+    std::vector<double> _y; ///< Coordinates of fine grid along y axis.
+    std::vector<double> _z; ///< Coordinates of fine grid along z axis.
+
+    /** Nodes of octree; the children of a node are consecutive. Each
+     * node holds the index of its first child, LEAF plus the index of
+     * a leaf, or EMPTY for nodes outside the grid.
+     */
+    std::vector<uint32_t> _nodes;
+    std::vector<uint32_t> _leaves; ///< Index of stored corner for corners of each leaf [numLeaves*8].
+    std::vector<double> _values; ///< Values at stored corners [numCorners*numValues].
+    size_t _rootSize; ///< Number of grid cells along each edge of root (power of 2).
+    size_t _depth; ///< Number of levels below root.
+
+    size_t* _queryValues; ///< Indices of values to be returned in queries.
+    size_t _querySize; ///< Number of values requested to be returned in queries.
+
+    size_t _numValues; ///< Number of values in database.
+    std::string* _names; ///< Names of data values.
+    std::string* _units; ///< Units of values.
+
+    std::string _filename; ///< Filename of data file
+    geocoords::CoordSys* _cs; ///< Coordinate system
+
+    QueryEnum _queryType; ///< Query type
+    std::vector<std::string> _exactValues; ///< Names of values build() reproduces exactly.
+
+    static const uint32_t LEAF; ///< Flag for leaf nodes.
+    static const uint32_t EMPTY; ///< Node outside grid.
+
+    // NOT IMPLEMENTED //////////////////////////////////////////////////////
+private:
+
+    OctreeGridDB(const OctreeGridDB&); ///< Not implemented
+    const OctreeGridDB& operator=(const OctreeGridDB&); ///< Not implemented
+
+}; // OctreeGridDB
+
+#endif // spatialdata_spatialdb_octreegriddb_hh
+
+// End of file
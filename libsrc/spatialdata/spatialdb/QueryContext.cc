@@ -0,0 +1,74 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "QueryContext.hh" // implementation of class methods
+
+#include "spatialdata/geocoords/Converter.hh" // USES Converter
+
+#include <cassert> // USES assert()
+
+// ----------------------------------------------------------------------
+// Default constructor.
+spatialdata::spatialdb::QueryContext::QueryContext(void) :
+    _nested(NULL) {
+    xyz[0] = 0.0;
+    xyz[1] = 0.0;
+    xyz[2] = 0.0;
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Default destructor.
+spatialdata::spatialdb::QueryContext::~QueryContext(void) {
+    for (converter_map_type::iterator iter = _converters.begin(); iter != _converters.end(); ++iter) {
+        delete iter->second;iter->second = NULL;
+    } // for
+    _converters.clear();
+
+    delete _nested;_nested = NULL;
+} // destructor
+
+
+// ----------------------------------------------------------------------
+// Get converter for transforming query locations to the coordinate
+// system of a database.
+spatialdata::geocoords::Converter*
+spatialdata::spatialdb::QueryContext::getConverter(const SpatialDB* db) {
+    assert(db);
+
+    converter_map_type::iterator iter = _converters.find(db);
+    if (iter == _converters.end()) {
+        iter = _converters.insert(std::make_pair(db, new spatialdata::geocoords::Converter)).first;
+    } // if
+    assert(iter->second);
+    return iter->second;
+} // getConverter
+
+
+// ----------------------------------------------------------------------
+// Get context for querying databases nested within a database.
+spatialdata::spatialdb::QueryContext*
+spatialdata::spatialdb::QueryContext::getNested(void) {
+    if (!_nested) {
+        _nested = new QueryContext;
+    } // if
+    return _nested;
+} // getNested
+
+
+// End of file
@@ -0,0 +1,105 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/QueryContext.hh
+ *
+ * @brief C++ object holding scratch state for spatial database queries.
+ *
+ * Spatial databases do not modify their data when performing queries
+ * with SpatialDB::queryBatch(). Instead, all state that changes from
+ * one query to the next is held in a QueryContext. An opened database
+ * can be queried concurrently from several threads provided each
+ * thread uses its own QueryContext.
+ */
+
+#if !defined(spatialdata_spatialdb_querycontext_hh)
+#define spatialdata_spatialdb_querycontext_hh
+
+#include "spatialdbfwd.hh" // forward declarations
+#include "spatialdata/geocoords/geocoordsfwd.hh" // HOLDSA Converter
+
+#include <vector> // HASA std::vector
+#include <map> // HASA std::map
+#include <utility> // USES std::pair
+#include <cstddef> // USES size_t
+
+class spatialdata::spatialdb::QueryContext { // class QueryContext
+    friend class TestQueryContext; // unit testing
+
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /// Default constructor.
+    QueryContext(void);
+
+    /// Default destructor.
+    ~QueryContext(void);
+
+    /** Get converter for transforming query locations to the coordinate
+     * system of a database.
+     *
+     * Each database has its own converter, so databases queried in
+     * alternation (e.g., by CompositeDB) do not discard each other's
+     * cached projections.
+     *
+     * @param db Spatial database.
+     * @returns Converter for database.
+     */
+    spatialdata::geocoords::Converter* getConverter(const SpatialDB* db);
+
+    /** Get context for querying databases nested within a database.
+     *
+     * A database that keeps intermediate values in this context while
+     * it queries other databases (e.g., CompositeDB) passes them the
+     * nested context, so they do not resize the buffers holding its
+     * intermediate values.
+     *
+     * @returns Nested context.
+     */
+    QueryContext* getNested(void);
+
+    // PUBLIC MEMBERS /////////////////////////////////////////////////////
+
+    double xyz[3]; ///< Coordinates of current query location.
+    std::vector<double> coords; ///< Coordinates of locations in current batch.
+    std::vector<size_t> nearest; ///< Indices of points nearest current query location.
+    std::vector<std::pair<double, size_t> > nearestHeap; ///< Scratch space for nearest point search.
+    std::vector<double> coordsD; ///< Coordinates of locations as double for single precision queries.
+    std::vector<double> valsD; ///< Values at locations as double for single precision queries.
+    std::vector<double> batchValues; ///< Intermediate values at locations in current batch.
+    std::vector<int> batchFlags; ///< Intermediate error flags at locations in current batch.
+
+private:
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    QueryContext(const QueryContext&); ///< Not implemented
+    const QueryContext& operator=(const QueryContext&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    typedef std::map<const SpatialDB*, spatialdata::geocoords::Converter*> converter_map_type;
+    converter_map_type _converters; ///< Converters for databases.
+    QueryContext* _nested; ///< Context for querying nested databases.
+
+}; // class QueryContext
+
+#endif // spatialdata_spatialdb_querycontext_hh
+
+// End of file
@@ -19,14 +19,15 @@
 #include "SCECCVMH.hh" // Implementation of class methods
 
 #include "GocadVoxet.hh" // USES GocadVoxet
+#include "QueryContext.hh" // USES QueryContext
 
 #include "spatialdata/geocoords/CSGeo.hh" // USES CSGeo
 #include "spatialdata/geocoords/Converter.hh" // USES Converter
 
-#include <math.h> // USES pow()
 #include <sstream> // USES std::ostringstream
 #include <stdexcept> // USES std::logic_error
-#include <cstring> // USES memcpy()
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::min(), std::max()
 #include <strings.h> // USES strcasecmp()
 #include <cassert> // USES assert()
 
@@ -35,25 +36,28 @@
 spatialdata::spatialdb::SCECCVMH::SCECCVMH(void) :
     SpatialDB("SCEC CVM-H"),
     _dataDir("."),
-    _laLowResVp(NULL),
-    _laLowResTag(NULL),
-    _laHighResVp(NULL),
-    _laHighResTag(NULL),
-    _crustMantleVp(NULL),
-    _crustMantleVs(NULL),
-    _crustMantleTag(NULL),
+    _cacheDir(""),
+    _laLowRes(NULL),
+    _laHighRes(NULL),
+    _crustMantle(NULL),
     _topoElev(NULL),
     _baseDepth(NULL),
     _mohoDepth(NULL),
     _csUTM(new geocoords::CSGeo),
-    _converter(new spatialdata::geocoords::Converter),
     _squashLimit(-2000.0),
     _minVs(0.0),
     _queryValues(NULL),
     _querySize(7),
-    _squashTopo(false) {
+    _squashTopo(false),
+    _hasRegion(false),
+    _isCropped(false),
+    _regionExceeded(false) {
     assert(_csUTM);
     _csUTM->setString("+proj=utm +zone=11 +datum=NAD27 +units=m +type=crs");
+    _regionUTM[0] = 0.0;
+    _regionUTM[1] = 0.0;
+    _regionUTM[2] = 0.0;
+    _regionUTM[3] = 0.0;
 
     _queryValues = (_querySize > 0) ? new size_t[_querySize] : NULL;
     for (size_t i = 0; i < _querySize; ++i) {
@@ -65,13 +69,9 @@ spatialdata::spatialdb::SCECCVMH::SCECCVMH(void) :
 // ----------------------------------------------------------------------
 // Destructor
 spatialdata::spatialdb::SCECCVMH::~SCECCVMH(void) {
-    delete _laLowResVp;_laLowResVp = NULL;
-    delete _laLowResTag;_laLowResTag = NULL;
-    delete _laHighResVp;_laHighResVp = NULL;
-    delete _laHighResTag;_laHighResTag = NULL;
-    delete _crustMantleVp;_crustMantleVp = NULL;
-    delete _crustMantleVs;_crustMantleVs = NULL;
-    delete _crustMantleTag;_crustMantleTag = NULL;
+    delete _laLowRes;_laLowRes = NULL;
+    delete _laHighRes;_laHighRes = NULL;
+    delete _crustMantle;_crustMantle = NULL;
     delete _topoElev;_topoElev = NULL;
     delete _baseDepth;_baseDepth = NULL;
     delete _mohoDepth;_mohoDepth = NULL;
@@ -82,8 +82,9 @@ spatialdata::spatialdb::SCECCVMH::~SCECCVMH(void) {
     delete[] _queryValues;_queryValues = NULL;
     _querySize = 0;
     _squashTopo = 0;
-
-    delete _converter;_converter = NULL;
+    _hasRegion = false;
+    _isCropped = false;
+    _regionExceeded = false;
 } // destructor
 
 
@@ -101,55 +102,67 @@ spatialdata::spatialdb::SCECCVMH::setMinVs(const double value) {
 
 
 // ----------------------------------------------------------------------
-// Open the database and prepare for querying.
+// Set region of interest.
 void
-spatialdata::spatialdb::SCECCVMH::open(void) {
-    if (0 == _laLowResVp) {
-        _laLowResVp = new GocadVoxet;
-    }
-    _laLowResVp->read(_dataDir.c_str(), "LA_LR.vo", "\"VINT1D\"");
-
-    if (0 == _laLowResTag) {
-        _laLowResTag = new GocadVoxet;
-    }
-    _laLowResTag->read(_dataDir.c_str(), "LA_LR.vo", "\"flag\"");
-
-    if (0 == _laHighResVp) {
-        _laHighResVp = new GocadVoxet;
-    }
-    _laHighResVp->read(_dataDir.c_str(), "LA_HR.vo", "\"vp\"");
-    if (0 == _laHighResTag) {
-        _laHighResTag = new GocadVoxet;
-    }
-    _laHighResTag->read(_dataDir.c_str(), "LA_HR.vo", "\"tag\"");
-
-    if (0 == _crustMantleVp) {
-        _crustMantleVp = new GocadVoxet;
-    }
-    _crustMantleVp->read(_dataDir.c_str(), "CM.vo", "\"cvp\"");
-    if (0 == _crustMantleVs) {
-        _crustMantleVs = new GocadVoxet;
-    }
-    _crustMantleVs->read(_dataDir.c_str(), "CM.vo", "\"cvs\"");
-    if (0 == _crustMantleTag) {
-        _crustMantleTag = new GocadVoxet;
-    }
-    _crustMantleTag->read(_dataDir.c_str(), "CM.vo", "\"tag\"");
-
-    if (0 == _topoElev) {
-        _topoElev = new GocadVoxet;
-    }
-    _topoElev->read(_dataDir.c_str(), "topo.vo", "\"topo\"");
+spatialdata::spatialdb::SCECCVMH::setRegion(const double xMin,
+                                            const double yMin,
+                                            const double xMax,
+                                            const double yMax,
+                                            const spatialdata::geocoords::CoordSys* cs) {
+    if (( xMin > xMax) || ( yMin > yMax) ) {
+        std::ostringstream msg;
+        msg << "Minimum coordinates (" << xMin << ", " << yMin << ") of region of interest in spatial database "
+            << getLabel() << " must not exceed maximum coordinates (" << xMax << ", " << yMax << ").";
+        throw std::invalid_argument(msg.str());
+    } // if
+    assert(cs);
+
+    // Edges of region are not straight in UTM coordinates, so use the
+    // bounding box of points along the edges.
+    const size_t numEdgePts = 32;
+    const size_t numLocs = 4*numEdgePts;
+    const size_t numDims = cs->getSpaceDim();
+    assert(numDims >= 2);
+    std::vector<double> xyz(numLocs*numDims, 0.0);
+    for (size_t iPt = 0; iPt < numEdgePts; ++iPt) {
+        const double t = double(iPt) / double(numEdgePts);
+        const double x = xMin + t*(xMax-xMin);
+        const double y = yMin + t*(yMax-yMin);
+        const double edges[4][2] = {
+            { x, yMin },
+            { xMax, y },
+            { xMax + xMin - x, yMax },
+            { xMin, yMax + yMin - y },
+        };
+        for (size_t iEdge = 0; iEdge < 4; ++iEdge) {
+            xyz[(iEdge*numEdgePts+iPt)*numDims+0] = edges[iEdge][0];
+            xyz[(iEdge*numEdgePts+iPt)*numDims+1] = edges[iEdge][1];
+        } // for
+    } // for
+    spatialdata::geocoords::CoordSys* csUTM = _csUTM->clone();assert(csUTM);
+    csUTM->setSpaceDim(numDims);
+    spatialdata::geocoords::Converter converter;
+    converter.convert(&xyz[0], numLocs, numDims, csUTM, cs);
+    delete csUTM;csUTM = NULL;
+
+    _regionUTM[0] = _regionUTM[2] = xyz[0];
+    _regionUTM[1] = _regionUTM[3] = xyz[1];
+    for (size_t iLoc = 1; iLoc < numLocs; ++iLoc) {
+        _regionUTM[0] = std::min(_regionUTM[0], xyz[iLoc*numDims+0]);
+        _regionUTM[1] = std::min(_regionUTM[1], xyz[iLoc*numDims+1]);
+        _regionUTM[2] = std::max(_regionUTM[2], xyz[iLoc*numDims+0]);
+        _regionUTM[3] = std::max(_regionUTM[3], xyz[iLoc*numDims+1]);
+    } // for
+    _hasRegion = true;
+} // setRegion
 
-    if (0 == _baseDepth) {
-        _baseDepth = new GocadVoxet;
-    }
-    _baseDepth->read(_dataDir.c_str(), "base.vo", "\"base\"");
 
-    if (0 == _mohoDepth) {
-        _mohoDepth = new GocadVoxet;
-    }
-    _mohoDepth->read(_dataDir.c_str(), "moho.vo", "\"moho\"");
+// ----------------------------------------------------------------------
+// Open the database and prepare for querying.
+void
+spatialdata::spatialdb::SCECCVMH::open(void) {
+    _regionExceeded = false;
+    _readVoxets(_hasRegion);
 } // open
 
 
@@ -157,13 +170,9 @@ spatialdata::spatialdb::SCECCVMH::open(void) {
 // Close the database.
 void
 spatialdata::spatialdb::SCECCVMH::close(void) {
-    delete _laLowResVp;_laLowResVp = NULL;
-    delete _laLowResTag;_laLowResTag = NULL;
-    delete _laHighResVp;_laHighResVp = NULL;
-    delete _laHighResTag;_laHighResTag = NULL;
-    delete _crustMantleVp;_crustMantleVp = NULL;
-    delete _crustMantleVs;_crustMantleVs = NULL;
-    delete _crustMantleTag;_crustMantleTag = NULL;
+    delete _laLowRes;_laLowRes = NULL;
+    delete _laHighRes;_laHighRes = NULL;
+    delete _crustMantle;_crustMantle = NULL;
     delete _topoElev;_topoElev = NULL;
     delete _baseDepth;_baseDepth = NULL;
     delete _mohoDepth;_mohoDepth = NULL;
@@ -246,6 +255,102 @@ spatialdata::spatialdb::SCECCVMH::query(double* vals,
                                         const double* coords,
                                         const size_t numDims,
                                         const spatialdata::geocoords::CoordSys* csQuery) {
+    int err = 0;
+    queryBatch(_getQueryContext(), vals, numVals, &err, coords, 1, numDims, csQuery);
+
+    return err;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::SCECCVMH::isThreadSafe(void) const {
+    return !_hasRegion || !_cacheDir.empty();
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::SCECCVMH::queryBatch(QueryContext* context,
+                                             double* vals,
+                                             const size_t numVals,
+                                             int* err,
+                                             const double* coords,
+                                             const size_t numLocs,
+                                             const size_t numDims,
+                                             const spatialdata::geocoords::CoordSys* csQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+    assert(coords);
+
+    _checkQuery(numVals, numDims);
+
+    // Convert coordinates of all locations to UTM at once.
+    std::vector<double>& xyzUTM = context->coords;
+    xyzUTM.assign(coords, coords+numLocs*numDims);
+    spatialdata::geocoords::Converter* converter = context->getConverter(this);
+    assert(converter);
+    converter->convert(&xyzUTM[0], numLocs, numDims, _csUTM, csQuery);
+
+    // Fall back to full voxets for locations outside region of interest.
+    if (_isCropped && !_inRegion(&xyzUTM[0], numLocs)) {
+        _readFullVoxets();
+    } // if
+
+    _queryBatch(context, vals, numVals, err, &xyzUTM[0], numLocs);
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations with single precision values
+// and coordinates.
+void
+spatialdata::spatialdb::SCECCVMH::queryBatch(QueryContext* context,
+                                             float* vals,
+                                             const size_t numVals,
+                                             int* err,
+                                             const float* coords,
+                                             const size_t numLocs,
+                                             const size_t numDims,
+                                             const spatialdata::geocoords::CoordSys* csQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+    assert(coords);
+
+    _checkQuery(numVals, numDims);
+
+    // Coordinates are converted to UTM in double precision; values are
+    // written directly into the single precision array.
+    std::vector<double>& xyzUTM = context->coords;
+    xyzUTM.assign(coords, coords+numLocs*numDims);
+    spatialdata::geocoords::Converter* converter = context->getConverter(this);
+    assert(converter);
+    converter->convert(&xyzUTM[0], numLocs, numDims, _csUTM, csQuery);
+
+    // Fall back to full voxets for locations outside region of interest.
+    if (_isCropped && !_inRegion(&xyzUTM[0], numLocs)) {
+        _readFullVoxets();
+    } // if
+
+    _queryBatch(context, vals, numVals, err, &xyzUTM[0], numLocs);
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Check number of values and spatial dimension of query.
+void
+spatialdata::spatialdb::SCECCVMH::_checkQuery(const size_t numVals,
+                                              const size_t numDims) const {
     if (0 == _querySize) {
         std::ostringstream msg;
         msg << "Values to be returned by spatial database " << getLabel() << "\n"
@@ -263,146 +368,262 @@ spatialdata::spatialdb::SCECCVMH::query(double* vals,
         msg << "Spatial dimension (" << numDims << ") when querying SCEC CVM-H must be 3.";
         throw std::invalid_argument(msg.str());
     } // if
+} // _checkQuery
+
 
-    // Convert coordinates to UTM
-    memcpy(_xyzUTM, coords, numDims*sizeof(double));
-    assert(_converter);
-    _converter->convert(_xyzUTM, 1, numDims, _csUTM, csQuery);
-
-    bool haveTopo = false;
-    double topoElev = 0;
-    if (_squashTopo && ( _xyzUTM[2] > _squashLimit) ) {
-        _topoElev->queryNearest(&topoElev, _xyzUTM);
-        haveTopo = true;
-        _xyzUTM[2] += topoElev;
+// ----------------------------------------------------------------------
+// Read voxets.
+void
+spatialdata::spatialdb::SCECCVMH::_readVoxets(const bool useRegion) {
+    if (0 == _laLowRes) {
+        _laLowRes = new GocadVoxet;
+    }
+    if (0 == _laHighRes) {
+        _laHighRes = new GocadVoxet;
+    }
+    if (0 == _crustMantle) {
+        _crustMantle = new GocadVoxet;
+    }
+    if (0 == _topoElev) {
+        _topoElev = new GocadVoxet;
+    }
+    if (0 == _baseDepth) {
+        _baseDepth = new GocadVoxet;
+    }
+    if (0 == _mohoDepth) {
+        _mohoDepth = new GocadVoxet;
+    }
+
+    const size_t numVoxets = 6;
+    GocadVoxet* voxets[numVoxets] = {
+        _laLowRes, _laHighRes, _crustMantle, _topoElev, _baseDepth, _mohoDepth,
+    };
+    for (size_t i = 0; i < numVoxets; ++i) {
+        voxets[i]->setCacheDir(_cacheDir.c_str());
+        if (useRegion) {
+            voxets[i]->setRegion(_regionUTM[0], _regionUTM[1], _regionUTM[2], _regionUTM[3]);
+        } else {
+            voxets[i]->clearRegion();
+        } // if/else
+    } // for
+
+    // Each voxet file is parsed once for all of its properties, in the
+    // order of VoxetPropertyEnum.
+    const char* laLowResProperties[2] = { "\"VINT1D\"", "\"flag\"" };
+    _laLowRes->read(_dataDir.c_str(), "LA_LR.vo", laLowResProperties, 2);
+    const char* laHighResProperties[2] = { "\"vp\"", "\"tag\"" };
+    _laHighRes->read(_dataDir.c_str(), "LA_HR.vo", laHighResProperties, 2);
+    const char* crustMantleProperties[3] = { "\"cvp\"", "\"tag\"", "\"cvs\"" };
+    _crustMantle->read(_dataDir.c_str(), "CM.vo", crustMantleProperties, 3);
+    _topoElev->read(_dataDir.c_str(), "topo.vo", "\"topo\"");
+    _baseDepth->read(_dataDir.c_str(), "base.vo", "\"base\"");
+    _mohoDepth->read(_dataDir.c_str(), "moho.vo", "\"moho\"");
+
+    // Voxets ignore the region if values are mapped from cache files.
+    _isCropped = useRegion && _cacheDir.empty();
+} // _readVoxets
+
+
+// ----------------------------------------------------------------------
+// Read full voxets after a query outside the region of interest.
+void
+spatialdata::spatialdb::SCECCVMH::_readFullVoxets(void) {
+    _regionExceeded = true;
+    _readVoxets(false);
+} // _readFullVoxets
+
+
+// ----------------------------------------------------------------------
+// Check whether locations are inside region of interest.
+bool
+spatialdata::spatialdb::SCECCVMH::_inRegion(const double* xyzUTM,
+                                            const size_t numLocs) const {
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const double x = xyzUTM[iLoc*3+0];
+        const double y = xyzUTM[iLoc*3+1];
+        if (( x < _regionUTM[0]) || ( x > _regionUTM[2]) ||
+            ( y < _regionUTM[1]) || ( y > _regionUTM[3]) ) {
+            return false;
+        } // if
+    } // for
+
+    return true;
+} // _inRegion
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations in UTM coordinates.
+template<typename T>
+void
+spatialdata::spatialdb::SCECCVMH::_queryBatch(QueryContext* context,
+                                              T* vals,
+                                              const size_t numVals,
+                                              int* err,
+                                              double* xyzUTM,
+                                              const size_t numLocs) const {
+    assert(context);
+
+    bool needVp = false;
+    bool needTag = false;
+    bool needTopo = _squashTopo;
+    for (size_t iVal = 0; iVal < numVals; ++iVal) {
+        switch (_queryValues[iVal]) {
+        case QUERY_VP:
+        case QUERY_VS:
+        case QUERY_DENSITY:
+            needVp = true;
+            break;
+        case QUERY_VPTAG:
+            needTag = true;
+            break;
+        case QUERY_TOPOELEV:
+            needTopo = true;
+            break;
+        default:
+            break;
+        } // switch
+    } // for
+
+    // Intermediate values: vp, tag, topography, and high-resolution
+    // scratch space.
+    std::vector<double>& batchValues = context->batchValues;
+    std::vector<int>& batchFlags = context->batchFlags;
+    batchValues.resize(4*numLocs);
+    batchFlags.resize(3*numLocs);
+    double* vp = &batchValues[0];
+    double* tag = &batchValues[numLocs];
+    double* topoElev = &batchValues[2*numLocs];
+    double* valuesHR = &batchValues[3*numLocs];
+    int* flagsVp = &batchFlags[0];
+    int* flagsTag = &batchFlags[numLocs];
+    int* flagsHR = &batchFlags[2*numLocs];
+
+    // Topography is queried at the elevation before squashing.
+    if (needTopo) {
+        assert(_topoElev);
+        _topoElev->queryNearestBatch(topoElev, xyzUTM, numLocs);
+    } // if
+    if (_squashTopo) {
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            if (xyzUTM[iLoc*3+2] > _squashLimit) {
+                xyzUTM[iLoc*3+2] += topoElev[iLoc];
+            } // if
+        } // for
+    } // if
+
+    if (needVp) {
+        _queryVp(vp, flagsVp, valuesHR, flagsHR, xyzUTM, numLocs);
+    } // if
+    if (needTag) {
+        _queryTag(tag, flagsTag, valuesHR, flagsHR, xyzUTM, numLocs);
     } // if
 
-    int outsideVoxet = 0;
-    int queryFlag = 0;
-    bool haveVp = false;
-    double vp = 0.0;
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        err[iLoc] = (needVp ? flagsVp[iLoc] : 0) | (needTag ? flagsTag[iLoc] : 0);
+    } // for
+
     for (size_t iVal = 0; iVal < numVals; ++iVal) {
+        T* valsLoc = &vals[iVal];
         switch (_queryValues[iVal]) {
         case QUERY_VP:
-            outsideVoxet = _queryVp(&vals[iVal]);
-            if (outsideVoxet) {
-                queryFlag |= outsideVoxet;
-            }
-            haveVp = true;
-            vp = vals[iVal];
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                valsLoc[iLoc*numVals] = vp[iLoc];
+            } // for
             break;
         case QUERY_DENSITY:
-            if (!haveVp) {
-                outsideVoxet = _queryVp(&vp);
-                haveVp = true;
-                if (outsideVoxet) {
-                    queryFlag |= outsideVoxet;
-                }
-            } // if
-            vals[iVal] = _calcDensity(vp);
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                valsLoc[iLoc*numVals] = _calcDensity(vp[iLoc]);
+            } // for
             break;
         case QUERY_VS:
-            if (!haveVp) {
-                outsideVoxet = _queryVp(&vp);
-                haveVp = true;
-                if (outsideVoxet) {
-                    queryFlag |= outsideVoxet;
-                }
-            } // if
-            vals[iVal] = _calcVs(vp);
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                valsLoc[iLoc*numVals] = _calcVs(vp[iLoc]);
+            } // for
             break;
         case QUERY_TOPOELEV:
-            if (!haveTopo) {
-                assert(0 != _topoElev);
-                outsideVoxet = _topoElev->queryNearest(&vals[iVal], _xyzUTM);
-                if (outsideVoxet) {
-                    queryFlag |= outsideVoxet;
-                }
-            } else {
-                vals[iVal] = topoElev;
-            }
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                valsLoc[iLoc*numVals] = topoElev[iLoc];
+            } // for
             break;
         case QUERY_BASEDEPTH:
             assert(0 != _baseDepth);
-            outsideVoxet = _baseDepth->queryNearest(&vals[iVal], _xyzUTM);
-            if (outsideVoxet) {
-                queryFlag |= outsideVoxet;
-            }
+            _baseDepth->queryNearestBatch(valuesHR, xyzUTM, numLocs);
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                valsLoc[iLoc*numVals] = valuesHR[iLoc];
+            } // for
             break;
         case QUERY_MOHODEPTH:
             assert(0 != _mohoDepth);
-            outsideVoxet = _mohoDepth->queryNearest(&vals[iVal], _xyzUTM);
-            if (outsideVoxet) {
-                queryFlag |= outsideVoxet;
-            }
+            _mohoDepth->queryNearestBatch(valuesHR, xyzUTM, numLocs);
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                valsLoc[iLoc*numVals] = valuesHR[iLoc];
+            } // for
             break;
         case QUERY_VPTAG:
-            outsideVoxet = _queryTag(&vals[iVal]);
-            if (outsideVoxet) {
-                queryFlag |= outsideVoxet;
-            }
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                valsLoc[iLoc*numVals] = tag[iLoc];
+            } // for
             break;
         default:
             assert(0);
         } // switch
-
-    }
-    return queryFlag;
-} // query
+    } // for
+} // _queryBatch
 
 
 // ----------------------------------------------------------------------
-// Perform query for Vp.
-int
-spatialdata::spatialdb::SCECCVMH::_queryVp(double* vp) {
-    int outsideVoxet = 0;
-
-    // Try first querying low-res model
-    outsideVoxet = _laLowResVp->query(vp, _xyzUTM);
-    if (!outsideVoxet) {
-        // if inside low-res, try high-res model
-        double vpHR = 0.0;
-        outsideVoxet = _laHighResVp->query(&vpHR, _xyzUTM);
-        if (!outsideVoxet) { // if inside high-res model, use it
-            *vp = vpHR;
-        } else { // not in high-res model, so use low-res value
-            outsideVoxet = 0;
-        }
-    } else {
-        outsideVoxet = _crustMantleVp->queryNearest(vp, _xyzUTM);
-    }
+// Perform query for Vp at multiple locations.
+void
+spatialdata::spatialdb::SCECCVMH::_queryVp(double* vp,
+                                           int* flags,
+                                           double* vpHR,
+                                           int* flagsHR,
+                                           const double* xyzUTM,
+                                           const size_t numLocs) const {
+    // Query low-res and high-res models for all locations, using
+    // high-res values inside the high-res model, low-res values inside
+    // the low-res model, and the crust/mantle model elsewhere.
+    _laLowRes->queryBatch(vp, flags, xyzUTM, numLocs, VOXET_VP);
+    _laHighRes->queryBatch(vpHR, flagsHR, xyzUTM, numLocs, VOXET_VP);
 
-    if (!outsideVoxet) {
-        const double minVp = _minVp();
-        if (*vp < minVp) {
-            *vp = minVp;
-        }
-    } // if
+    const double minVp = _minVp();
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        if (!flags[iLoc]) {
+            if (!flagsHR[iLoc]) {
+                vp[iLoc] = vpHR[iLoc];
+            } // if
+        } else {
+            flags[iLoc] = _crustMantle->queryNearest(&vp[iLoc], &xyzUTM[iLoc*3], VOXET_VP);
+        } // if/else
 
-    return outsideVoxet;
+        if (!flags[iLoc] && ( vp[iLoc] < minVp) ) {
+            vp[iLoc] = minVp;
+        } // if
+    } // for
 } // _queryVp
 
 
 // ----------------------------------------------------------------------
-// Perform query for tag.
-int
-spatialdata::spatialdb::SCECCVMH::_queryTag(double* tag) {
-    int outsideVoxet = 0;
-    double tagHR = 0.0;
-
-    outsideVoxet = _laLowResTag->query(tag, _xyzUTM);
-    if (!outsideVoxet) {
-        outsideVoxet = _laHighResTag->query(&tagHR, _xyzUTM);
-        if (!outsideVoxet) {
-            *tag = tagHR;
+// Perform query for tag at multiple locations.
+void
+spatialdata::spatialdb::SCECCVMH::_queryTag(double* tag,
+                                            int* flags,
+                                            double* tagHR,
+                                            int* flagsHR,
+                                            const double* xyzUTM,
+                                            const size_t numLocs) const {
+    _laLowRes->queryBatch(tag, flags, xyzUTM, numLocs, VOXET_TAG);
+    _laHighRes->queryBatch(tagHR, flagsHR, xyzUTM, numLocs, VOXET_TAG);
+
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        if (!flags[iLoc]) {
+            if (!flagsHR[iLoc]) {
+                tag[iLoc] = tagHR[iLoc];
+            } // if
         } else {
-            outsideVoxet = 0; // use low-res value
-        }
-    } else {
-        outsideVoxet = _crustMantleTag->queryNearest(tag, _xyzUTM);
-    }
-
-    return outsideVoxet;
+            flags[iLoc] = _crustMantle->queryNearest(&tag[iLoc], &xyzUTM[iLoc*3], VOXET_TAG);
+        } // if/else
+    } // for
 } // _queryTag
 
 
@@ -430,10 +651,11 @@ spatialdata::spatialdb::SCECCVMH::_calcDensity(const double vp) const {
 // Compute density from Vp.
 double
 spatialdata::spatialdb::SCECCVMH::_calcVs(const double vp) const {
+    // Polynomial in vp/1000 in Horner form.
+    const double vpKm = vp / 1000.0;
     double vs = (vp < 4250.0) ?
                 (vp - 1360.0) / 1.16 :
-                785.8 - 1.2344*vp + 794.9 * pow(vp/1000.0,2)
-                - 123.8 * pow(vp/1000.0,3) + 6.4 * pow(vp/1000.0,4);
+                785.8 + vpKm*(-1234.4 + vpKm*(794.9 + vpKm*(-123.8 + vpKm*6.4)));
     if (vp < 1500.0) {
         if (vp != 1480.0) { // if not water
             vs = (1500.0-1360.0)/1.16;
@@ -45,6 +45,46 @@ public:
      */
     void setDataDir(const char* dir);
 
+    /** Set directory for cache files holding voxet values in native
+     * byte order.
+     *
+     * The cache files are written the first time the database is
+     * opened and mapped into memory afterwards.
+     *
+     * @param dir Directory for cache files (empty for no cache files).
+     */
+    void setCacheDir(const char* dir);
+
+    /** Set region of interest, so that only the part of the voxets
+     * needed for queries inside the region is read.
+     *
+     * The region is converted to the UTM coordinate system of the
+     * voxets. The first query outside the region reloads the full
+     * voxets, which are used for all later queries, and sets the flag
+     * returned by isRegionExceeded(). The region has no effect if a
+     * cache directory is set.
+     *
+     * @param xMin Minimum x coordinate of region.
+     * @param yMin Minimum y coordinate of region.
+     * @param xMax Maximum x coordinate of region.
+     * @param yMax Maximum y coordinate of region.
+     * @param cs Coordinate system of region.
+     */
+    void setRegion(const double xMin,
+                   const double yMin,
+                   const double xMax,
+                   const double yMax,
+                   const spatialdata::geocoords::CoordSys* cs);
+
+    /** Did a query outside the region of interest read the full voxets?
+     *
+     * The flag is cleared when the database is opened.
+     *
+     * @returns True if the full voxets were read after a query outside
+     *   the region of interest, false otherwise.
+     */
+    bool isRegionExceeded(void) const;
+
     /** Set minimum shear wave speed. Corresponding minima for Vp and
      * density are enforced using nominal Vp->Vs relation and
      * Vp->density relations.
@@ -107,6 +147,63 @@ public:
               const size_t numDims,
               const spatialdata::geocoords::CoordSys* pCSQuery);
 
+    /** Can the database be queried concurrently?
+     *
+     * The voxets are not modified by queries, unless a query outside
+     * the region of interest reloads the full voxets.
+     *
+     * @returns True if queryBatch() may be called concurrently using
+     *   separate query contexts, false otherwise.
+     */
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
+    /** Query the database at multiple locations with single precision
+     * values and coordinates.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    float* vals,
+                    const size_t numVals,
+                    int* err,
+                    const float* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
     // NOT IMPLEMENTED //////////////////////////////////////////////////////
 private:
 
@@ -126,22 +223,94 @@ private:
         QUERY_VPTAG=6 // Tag for Vp
     }; // ValsEnum
 
+    /// Indices of properties in voxets with several properties.
+    enum VoxetPropertyEnum {
+        VOXET_VP=0, // Vp
+        VOXET_TAG=1, // Tag for Vp
+        VOXET_VS=2 // Vs (crust/mantle voxet only)
+    }; // VoxetPropertyEnum
+
     // PRIVATE METHODS //////////////////////////////////////////////////////
 private:
 
-    /** Perform query for Vp.
+    /** Check number of values and spatial dimension of query.
+     *
+     * @param numVals Number of values expected.
+     * @param numDims Number of dimensions for coordinates.
+     */
+    void _checkQuery(const size_t numVals,
+                     const size_t numDims) const;
+
+    /** Read voxets.
      *
-     * @param vp Result of query
-     * @returns 0 if found location, 1 otherwise.
+     * @param useRegion True if only region of interest is read, false otherwise.
      */
-    int _queryVp(double* vp);
+    void _readVoxets(const bool useRegion);
 
-    /** Perform query for tag.
+    /// Read full voxets after a query outside the region of interest.
+    void _readFullVoxets(void);
+
+    /** Check whether locations are inside region of interest.
+     *
+     * @param xyzUTM Locations in UTM coordinates [numLocs*3].
+     * @param numLocs Number of locations.
+     * @returns True if all locations are inside region, false otherwise.
+     */
+    bool _inRegion(const double* xyzUTM,
+                   const size_t numLocs) const;
+
+    /** Query the database at multiple locations in UTM coordinates.
+     *
+     * Each voxet is queried for all locations in the batch before
+     * values are assembled for each location.
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query) [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param xyzUTM Locations in UTM coordinates (elevation is adjusted
+     *   if topography is squashed) [numLocs*3].
+     * @param numLocs Number of locations.
+     */
+    template<typename T>
+    void _queryBatch(QueryContext* context,
+                     T* vals,
+                     const size_t numVals,
+                     int* err,
+                     double* xyzUTM,
+                     const size_t numLocs) const;
+
+    /** Perform query for Vp at multiple locations.
+     *
+     * @param vp Result of query [numLocs].
+     * @param flags 0 if found location, 1 otherwise [numLocs].
+     * @param vpHR Scratch space for high-resolution values [numLocs].
+     * @param flagsHR Scratch space for high-resolution flags [numLocs].
+     * @param xyzUTM Locations in UTM coordinates [numLocs*3].
+     * @param numLocs Number of locations.
+     */
+    void _queryVp(double* vp,
+                  int* flags,
+                  double* vpHR,
+                  int* flagsHR,
+                  const double* xyzUTM,
+                  const size_t numLocs) const;
+
+    /** Perform query for tag at multiple locations.
      *
-     * @param tag Result of query
-     * @returns 0 if found location, 1 otherwise.
+     * @param tag Result of query [numLocs].
+     * @param flags 0 if found location, 1 otherwise [numLocs].
+     * @param tagHR Scratch space for high-resolution values [numLocs].
+     * @param flagsHR Scratch space for high-resolution flags [numLocs].
+     * @param xyzUTM Locations in UTM coordinates [numLocs*3].
+     * @param numLocs Number of locations.
      */
-    int _queryTag(double* tag);
+    void _queryTag(double* tag,
+                   int* flags,
+                   double* tagHR,
+                   int* flagsHR,
+                   const double* xyzUTM,
+                   const size_t numLocs) const;
 
     /** Compute density from Vp.
      *
@@ -166,26 +335,25 @@ private:
     // PRIVATE MEMBERS //////////////////////////////////////////////////////
 private:
 
-    double _xyzUTM[3];
     std::string _dataDir;
-    GocadVoxet* _laLowResVp;
-    GocadVoxet* _laLowResTag;
-    GocadVoxet* _laHighResVp;
-    GocadVoxet* _laHighResTag;
-    GocadVoxet* _crustMantleVp;
-    GocadVoxet* _crustMantleVs;
-    GocadVoxet* _crustMantleTag;
+    std::string _cacheDir; ///< Directory for cache files of voxet values.
+    GocadVoxet* _laLowRes; ///< LA low resolution voxet (Vp and tag).
+    GocadVoxet* _laHighRes; ///< LA high resolution voxet (Vp and tag).
+    GocadVoxet* _crustMantle; ///< Crust/mantle voxet (Vp, tag, and Vs).
     GocadVoxet* _topoElev;
     GocadVoxet* _baseDepth;
     GocadVoxet* _mohoDepth;
     geocoords::CSGeo* _csUTM; ///< Local coordinate system.
-    spatialdata::geocoords::Converter* _converter; ///< Convert query points to local coordinate system.
+    double _regionUTM[4]; ///< Region of interest in UTM coordinates (xMin, yMin, xMax, yMax).
 
     double _squashLimit; ///< Elevation above which topography is squashed.
     double _minVs; ///< Minimum Vs to use.
     size_t* _queryValues; ///< Indices of values to be returned in queries.
     size_t _querySize; ///< Number of values requested to be returned in queries.
     bool _squashTopo; ///< Squash topography/bathymetry to sea level.
+    bool _hasRegion; ///< True if region of interest is set.
+    bool _isCropped; ///< True if voxets hold only region of interest.
+    bool _regionExceeded; ///< True if full voxets were read after a query outside region of interest.
 
 }; // SCECCVMH
 
@@ -28,7 +28,7 @@
 #include <sstream> // USES std::ostringsgream
 #include <cassert> // USES assert()
 #include <stdexcept> // USES std::runtime_error
-#include "Exception.hh" // USES OutOfBounds
+#include <algorithm> // USES std::fill()
 
 // ----------------------------------------------------------------------
 /// Default constructor
@@ -97,6 +97,7 @@ spatialdata::spatialdb::SimpleDB::open(void) {
     if (!_query) {
         _query = new SimpleDBQuery(*this);
     } // if
+    _query->buildIndex();
 
     // Set default query values to all values in database
     const size_t numValues = _data->getNumValues();
@@ -162,30 +163,52 @@ spatialdata::spatialdb::SimpleDB::query(double* vals,
                                         const double* coords,
                                         const size_t numDims,
                                         const spatialdata::geocoords::CoordSys* pCSQuery) {
-    try {
-        if (!_query) {
-            std::ostringstream msg;
-            msg << "Spatial database " << getLabel() << " has not been opened.\n"
-                << "Please call open() before calling query().";
-            throw std::logic_error(msg.str());
-        } // if
-        else if (!_data) {
-            std::ostringstream msg;
-            msg << "Spatial database " << getLabel() << " does not contain any data.\n"
-                << "Database query aborted.";
-            throw std::domain_error(msg.str());
-        } // if
-        _query->query(vals, numVals, coords, numDims, pCSQuery);
-    } catch (const OutOfBounds& err) {
-        std::fill(vals, vals+numVals, 0);
-        return 1;
-    } catch (const std::exception& err) {
-        throw;
-    } catch (...) {
-        throw std::runtime_error("Unknown error in SpatialDB query");
-    } // catch
-    return 0;
+    int err = 0;
+    queryBatch(_getQueryContext(), vals, numVals, &err, coords, 1, numDims, pCSQuery);
+
+    return err;
 } // query
 
 
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::SimpleDB::isThreadSafe(void) const {
+    return true;
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::SimpleDB::queryBatch(QueryContext* context,
+                                             double* vals,
+                                             const size_t numVals,
+                                             int* err,
+                                             const double* coords,
+                                             const size_t numLocs,
+                                             const size_t numDims,
+                                             const spatialdata::geocoords::CoordSys* pCSQuery) {
+    if (!_query) {
+        std::ostringstream msg;
+        msg << "Spatial database " << getLabel() << " has not been opened.\n"
+            << "Please call open() before calling query().";
+        throw std::logic_error(msg.str());
+    } // if
+    else if (!_data) {
+        std::ostringstream msg;
+        msg << "Spatial database " << getLabel() << " does not contain any data.\n"
+            << "Database query aborted.";
+        throw std::domain_error(msg.str());
+    } // if
+
+    _query->queryBatch(context, vals, numVals, err, coords, numLocs, numDims, pCSQuery);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        if (err[iLoc]) {
+            std::fill(&vals[iLoc*numVals], &vals[(iLoc+1)*numVals], 0);
+        } // if
+    } // for
+} // queryBatch
+
+
 // End of file
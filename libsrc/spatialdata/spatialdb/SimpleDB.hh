@@ -42,10 +42,19 @@ public:
         VOLUME=3
     };
 
-    /** Type of query */
+    /** Type of query
+     *
+     * DELAUNAY uses linear interpolation within a Delaunay
+     * triangulation (2-D) or tetrahedralization (3-D) of the points
+     * constructed when the database is opened. It applies to data
+     * with the same dimension as the coordinate system; otherwise, and
+     * for locations outside the triangulation, it is equivalent to
+     * LINEAR.
+     */
     enum QueryEnum {
         NEAREST=0,
-        LINEAR=1
+        LINEAR=1,
+        DELAUNAY=2
     };
 
 public:
@@ -122,6 +131,39 @@ public:
               const size_t numDims,
               const spatialdata::geocoords::CoordSys* pCSQuery);
 
+    /** Can the database be queried concurrently?
+     *
+     * The data and spatial index are not modified by queries.
+     *
+     * @returns True if queryBatch() may be called concurrently using
+     *   separate query contexts, false otherwise.
+     */
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), vals
+     *   must be allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs];
+     *   values at locations where interpolation fails are set to 0.
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
 private:
 
     // PRIVATE METHODS ////////////////////////////////////////////////////
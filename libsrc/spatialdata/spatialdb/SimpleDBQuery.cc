@@ -19,30 +19,31 @@
 #include "SpatialDB.hh" // USES SimpleDB
 #include "SimpleDB.hh" // USES SimpleDB
 #include "SimpleDBQuery.hh" // implementation of class methods
+#include "QueryContext.hh" // USES QueryContext
 
 #include "SimpleDBData.hh" // USEs SimpleDBData
+#include "KDTree.hh" // USES KDTree
+#include "Triangulation.hh" // USES Triangulation
 
 #include "spatialdata/geocoords/Converter.hh" // USES Converter
 
-#include "Exception.hh" // USES OutOfBounds
-
-#include <math.h> // USES MAXFLOAT
-#if !defined(MAXFLOAT)
-#define MAXFLOAT 1e+30
-#endif
+#include <math.h> // USES sqrt(), fabs()
 
 #include <cstring> // USES memcpy()
 #include <strings.h> // USES strcasecmp()
 #include <cassert> // USES assert()
 #include <sstream> // USES std::ostringsgream
-#include <algorithm> // USES std::fill(), std::lower_bound(), std::distance()
+
+// ----------------------------------------------------------------------
+const size_t spatialdata::spatialdb::SimpleDBQuery::_maxWeights = 4;
 
 // ----------------------------------------------------------------------
 // Default constructor.
 spatialdata::spatialdb::SimpleDBQuery::SimpleDBQuery(const SimpleDB& db) :
     _queryType(SimpleDB::LINEAR),
     _db(db),
-    _converter(new spatialdata::geocoords::Converter),
+    _tree(NULL),
+    _triangulation(NULL),
     _queryValues(NULL),
     _querySize(0) {}
 
@@ -51,7 +52,6 @@ spatialdata::spatialdb::SimpleDBQuery::SimpleDBQuery(const SimpleDB& db) :
 // Default destructor.
 spatialdata::spatialdb::SimpleDBQuery::~SimpleDBQuery(void) {
     deallocate();
-    delete _converter;_converter = NULL;
 } // destructor
 
 
@@ -61,15 +61,42 @@ void
 spatialdata::spatialdb::SimpleDBQuery::deallocate(void) {
     delete[] _queryValues;_queryValues = NULL;
     _querySize = 0;
-    _nearest.resize(0);
+    delete _tree;_tree = NULL;
+    delete _triangulation;_triangulation = NULL;
 } // deallocate
 
 
+// ----------------------------------------------------------------------
+// Build spatial index over locations in database.
+void
+spatialdata::spatialdb::SimpleDBQuery::buildIndex(void) {
+    assert(_db._data);
+
+    const size_t numLocs = _db._data->getNumLocs();
+    const size_t spaceDim = _db._data->getSpaceDim();
+    const double* coordinates = (numLocs > 0) ? _db._data->getCoordinates(0) : NULL;
+    if (!_tree) {
+        _tree = new KDTree;
+        _tree->build(coordinates, numLocs, spaceDim);
+    } // if
+
+    if (( SimpleDB::DELAUNAY == _queryType) && !_triangulation) {
+        _triangulation = new Triangulation;
+        if (_db._data->getDataDim() == spaceDim) {
+            _triangulation->build(coordinates, numLocs, spaceDim);
+        } // if
+    } // if
+} // buildIndex
+
+
 // ----------------------------------------------------------------------
 // Set query type.
 void
 spatialdata::spatialdb::SimpleDBQuery::setQueryType(const SimpleDB::QueryEnum value) {
     _queryType = value;
+    if (_db._data) {
+        buildIndex();
+    } // if
 } // setQueryType
 
 
@@ -110,19 +137,51 @@ spatialdata::spatialdb::SimpleDBQuery::setQueryValues(const char* const* names,
         } // if
         _queryValues[iVal] = iName;
     } // for
+
+    // Index is normally built in SimpleDB::open(); build it here if data was set directly.
+    buildIndex();
 } // setQueryVals
 
 
 // ----------------------------------------------------------------------
-// Query the database.
+// Query the database at multiple locations.
 void
-spatialdata::spatialdb::SimpleDBQuery::query(double* vals,
-                                             const size_t numVals,
-                                             const double* coords,
-                                             const size_t numDims,
-                                             const spatialdata::geocoords::CoordSys* pCSQuery) {
+spatialdata::spatialdb::SimpleDBQuery::queryBatch(QueryContext* context,
+                                                  double* vals,
+                                                  const size_t numVals,
+                                                  int* err,
+                                                  const double* coords,
+                                                  const size_t numLocs,
+                                                  const size_t numDims,
+                                                  const spatialdata::geocoords::CoordSys* pCSQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(0 != context);
     assert(0 != coords);
+    assert(0 != vals);
+    assert(0 != err);
+    assert(numDims <= 3);
+
+    _checkQuery(numVals);
+
+    std::vector<double>& xyz = context->coords;
+    xyz.assign(coords, coords+numLocs*numDims);
+    spatialdata::geocoords::Converter* converter = context->getConverter(&_db);
+    assert(converter);
+    converter->convert(&xyz[0], numLocs, numDims, _db._cs, pCSQuery);
 
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        _setPoint3(context->xyz, &xyz[iLoc*numDims], numDims);
+        err[iLoc] = _queryPoint(context, &vals[iLoc*numVals], numVals);
+    } // for
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Check number of values to be returned by query.
+void
+spatialdata::spatialdb::SimpleDBQuery::_checkQuery(const size_t numVals) const {
     if (0 == _querySize) {
         std::ostringstream msg;
         msg << "Values to be returned by spatial database " << _db.getLabel() << "\n"
@@ -137,55 +196,47 @@ spatialdata::spatialdb::SimpleDBQuery::query(double* vals,
             << numVals << ").\n";
         throw std::invalid_argument(msg.str());
     } // if
+    assert(_tree);
+    assert(( SimpleDB::DELAUNAY != _queryType) || _triangulation);
+} // _checkQuery
 
-    const size_t numLocs = 1;
-    _q[0] = 0.0;
-    _q[1] = 0.0;
-    _q[2] = 0.0;
-    for (size_t i = 0; i < numDims; ++i) {
-        _q[i] = coords[i];
-    } // for
-    assert(_converter);
-    _converter->convert(_q, numLocs, numDims, _db._cs, pCSQuery);
 
+// ----------------------------------------------------------------------
+// Query database at location in database coordinate system.
+int
+spatialdata::spatialdb::SimpleDBQuery::_queryPoint(QueryContext* context,
+                                                   double* vals,
+                                                   const size_t numVals) const {
+    int err = 0;
     switch (_queryType) {
     case SimpleDB::LINEAR:
-        _queryLinear(vals, numVals);
+    case SimpleDB::DELAUNAY:
+        err = _queryLinear(context, vals, numVals);
         break;
     case SimpleDB::NEAREST:
-        _queryNearest(vals, numVals);
+        _queryNearest(context, vals, numVals);
         break;
     default:
         throw std::logic_error("Could not find requested query type.");
     } // switch
-} // query
+
+    return err;
+} // _queryPoint
 
 
 // ----------------------------------------------------------------------
 // Query database using nearest neighbor algorithm.
 void
-spatialdata::spatialdb::SimpleDBQuery::_queryNearest(double* vals,
-                                                     const size_t numVals) {
+spatialdata::spatialdb::SimpleDBQuery::_queryNearest(QueryContext* context,
+                                                     double* vals,
+                                                     const size_t numVals) const {
     assert( (0 < numVals && vals) ||
             (0 == numVals && !vals) );
     assert(_db._data);
     assert(numVals == _querySize);
 
-    size_t iNear = 0;
-    const size_t spaceDim = _db._data->getSpaceDim();
-    double pt[3];
-    _setPoint3(pt, _db._data->getCoordinates(iNear), spaceDim);
-    double nearDist = _distSquared(_q, pt);
-
-    const size_t numLocs = _db._data->getNumLocs();
-    for (size_t iLoc = 1; iLoc < numLocs; ++iLoc) {
-        _setPoint3(pt, _db._data->getCoordinates(iLoc), spaceDim);
-        const double dist = _distSquared(_q, pt);
-        if (dist < nearDist) {
-            nearDist = dist;
-            iNear = iLoc;
-        } // if
-    } // for
+    assert(_tree);
+    const size_t iNear = _tree->findNearest(context->xyz);
 
     const double* nearVals = _db._data->getData(iNear);
     const size_t querySize = _querySize;
@@ -197,9 +248,10 @@ spatialdata::spatialdb::SimpleDBQuery::_queryNearest(double* vals,
 
 // ----------------------------------------------------------------------
 // Query database using linear interpolation algorithm.
-void
-spatialdata::spatialdb::SimpleDBQuery::_queryLinear(double* vals,
-                                                    const size_t numVals) {
+int
+spatialdata::spatialdb::SimpleDBQuery::_queryLinear(QueryContext* context,
+                                                    double* vals,
+                                                    const size_t numVals) const {
     assert( (0 < numVals && vals) ||
             (0 == numVals && !vals) );
     assert(_db._data);
@@ -213,141 +265,148 @@ spatialdata::spatialdb::SimpleDBQuery::_queryLinear(double* vals,
             vals[iVal] = nearVals[_queryValues[iVal]];
         }
     } else { // else
-        // Find nearest locations in database
-        _findNearest();
-
-        // Get interpolation weights
-        std::vector<WtStruct> weights;
-        _getWeights(&weights);
+        WtStruct weights[_maxWeights];
+        size_t numWts = 0;
+        if (( SimpleDB::DELAUNAY != _queryType) || !_findSimplex(context, weights, &numWts)) {
+            // Find nearest locations in database
+            _findNearest(context);
+
+            // Get interpolation weights
+            if (!_getWeights(context, weights, &numWts)) {
+                return 1;
+            } // if
+        } // if
 
         // Interpolate values
-        const size_t numWts = weights.size();
         const size_t querySize = _querySize;
         for (size_t iVal = 0; iVal < querySize; ++iVal) {
             double val = 0;
             for (size_t iWt = 0; iWt < numWts; ++iWt) {
-                const size_t iLoc = _nearest[weights[iWt].nearIndex];
+                const size_t iLoc = context->nearest[weights[iWt].nearIndex];
                 const double* locVals = _db._data->getData(iLoc);
                 val += weights[iWt].wt * locVals[_queryValues[iVal]];
             } // for
             vals[iVal] = val;
         } // for
     } // else
+
+    return 0;
 } // _queryLinear
 
 
 // ----------------------------------------------------------------------
+// Find locations in database nearest query location.
 void
-spatialdata::spatialdb::SimpleDBQuery::_findNearest(void) {
+spatialdata::spatialdb::SimpleDBQuery::_findNearest(QueryContext* context) const {
     assert(_db._data);
 
+    assert(_tree);
+
     const size_t maxnear = 100;
-    const size_t numLocs = _db._data->getNumLocs();
-    const size_t nearSize = (numLocs < maxnear) ? numLocs : maxnear;
-    _nearest.resize(nearSize);
-    std::fill(_nearest.begin(), _nearest.end(), -1);
+    _tree->findNearest(&context->nearest, &context->nearestHeap, context->xyz, maxnear);
+} // _findNearest
 
-    std::vector<double> nearestDist(nearSize);
-    std::fill(nearestDist.begin(), nearestDist.end(), MAXFLOAT);
 
-    // find closest nearSize points
-    double pt[3];
-    const size_t spaceDim = _db._data->getSpaceDim();
-    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
-        // use square of distance to find closest
-        _setPoint3(pt, _db._data->getCoordinates(iLoc), spaceDim);
-        const double dist2 = _distSquared(_q, pt);
-
-        // find place in nearest list if it exists
-        const std::vector<double>::iterator pNearDist =
-            std::lower_bound(nearestDist.begin(), nearestDist.end(), dist2);
-        if (dist2 <= *pNearDist) { // if found place in nearest list
-#if !defined(_RWSTD_NO_CLASS_PARTIAL_SPEC)
-            size_t index = std::distance(nearestDist.begin(), pNearDist);
-#else
-            size_t index = 0;
-            std::distance(nearestDist.begin(), pNearDist, index);
-#endif
+// ----------------------------------------------------------------------
+// Find simplex in triangulation containing query location and get
+// interpolation weights.
+bool
+spatialdata::spatialdb::SimpleDBQuery::_findSimplex(QueryContext* context,
+                                                    WtStruct* weights,
+                                                    size_t* numWts) const {
+    assert(_tree);
+    assert(_triangulation);
+    assert(weights);
+    assert(numWts);
+
+    if (0 == _triangulation->getNumCells()) {
+        return false;
+    } // if
 
-            // move values to allow insertion of current
-            for (size_t moveIndex = nearSize-1; moveIndex > index; --moveIndex) {
-                nearestDist[moveIndex] = nearestDist[moveIndex-1];
-                _nearest[moveIndex] = _nearest[moveIndex-1];
-            } // for
-            if (index < nearSize) {
-                // insert current
-                nearestDist[index] = dist2;
-                _nearest[index] = iLoc;
-            } // if
-        } // if
+    size_t vertices[4];
+    double wts[4];
+    if (!_triangulation->findSimplex(vertices, wts, context->xyz, _tree->findNearest(context->xyz))) {
+        return false;
+    } // if
+
+    *numWts = _triangulation->getDimension() + 1;
+    assert(*numWts <= _maxWeights);
+    context->nearest.resize(*numWts);
+    for (size_t iWt = 0; iWt < *numWts; ++iWt) {
+        context->nearest[iWt] = vertices[iWt];
+        weights[iWt].wt = wts[iWt];
+        weights[iWt].nearIndex = iWt;
     } // for
-} // _findNearest
+
+    return true;
+} // _findSimplex
 
 
 // ----------------------------------------------------------------------
-void
-spatialdata::spatialdb::SimpleDBQuery::_getWeights(std::vector<WtStruct>* pWeights) {
+bool
+spatialdata::spatialdb::SimpleDBQuery::_getWeights(QueryContext* context,
+                                                   WtStruct* weights,
+                                                   size_t* numWts) const {
     assert(_db._data);
-    assert(pWeights);
+    assert(weights);
+    assert(numWts);
 
     /* Start with nearest point. Add next nearest points as necessary
      * to obtain appropriate interpolation. For example, adding 1 point
      * results in linear interpolation, adding 2 results in areal
      * interpolation, etc.
      */
+    bool found = true;
     const size_t dataDim = _db._data->getDataDim();
     if (0 == dataDim) {
-        const int numWts = 1;
-        pWeights->resize(numWts);
-        _findPointPt(pWeights);
+        *numWts = 1;
+        _findPointPt(weights);
     } else if (1 == dataDim) {
-        const int numWts = 2;
-        pWeights->resize(numWts);
-        _findPointPt(pWeights);
-        _findLinePt(pWeights);
+        *numWts = 2;
+        _findPointPt(weights);
+        found = _findLinePt(context, weights);
     } else if (2 == dataDim) {
-        const int numWts = 3;
-        pWeights->resize(numWts);
-        _findPointPt(pWeights);
-        _findLinePt(pWeights);
-        _findAreaPt(pWeights);
+        *numWts = 3;
+        _findPointPt(weights);
+        found = _findLinePt(context, weights) && _findAreaPt(context, weights);
     } else if (3 == dataDim) {
-        const int numWts = 4;
-        pWeights->resize(numWts);
-        _findPointPt(pWeights);
-        _findLinePt(pWeights);
-        _findAreaPt(pWeights);
-        _findVolumePt(pWeights);
+        *numWts = 4;
+        _findPointPt(weights);
+        found = _findLinePt(context, weights) && _findAreaPt(context, weights) && _findVolumePt(context, weights);
     } else {
         throw std::logic_error("Could not set weights for unknown data dimension.");
     } // if/else
+
+    return found;
 } // _getWeights
 
 
 // ----------------------------------------------------------------------
 void
-spatialdata::spatialdb::SimpleDBQuery::_findPointPt(std::vector<WtStruct>* pWeights) {
+spatialdata::spatialdb::SimpleDBQuery::_findPointPt(WtStruct* weights) const {
     assert(_db._data);
-    assert(pWeights);
+    assert(weights);
 
-    (*pWeights)[0].wt = 1.0;
-    (*pWeights)[0].nearIndex = 0;
+    weights[0].wt = 1.0;
+    weights[0].nearIndex = 0;
 } // _findPointPt
 
 
 // ----------------------------------------------------------------------
-void
-spatialdata::spatialdb::SimpleDBQuery::_findLinePt(std::vector<WtStruct>* pWeights) {
+bool
+spatialdata::spatialdb::SimpleDBQuery::_findLinePt(QueryContext* context,
+                                                   WtStruct* weights) const {
     assert(_db._data);
-    assert(pWeights);
+    assert(weights);
+    const double* q = context->xyz;
 
     const size_t spaceDim = _db._data->getSpaceDim();
 
     // best case is to use next nearest pt
-    const size_t nearIndexA = (*pWeights)[0].nearIndex;
+    const size_t nearIndexA = weights[0].nearIndex;
     size_t nearIndexB = nearIndexA + 1;
 
-    const size_t locIndexA = _nearest[nearIndexA];
+    const size_t locIndexA = context->nearest[nearIndexA];
     double ptA[3];
     assert(locIndexA >= 0);
     _setPoint3(ptA, _db._data->getCoordinates(locIndexA), spaceDim);
@@ -357,9 +416,9 @@ spatialdata::spatialdb::SimpleDBQuery::_findLinePt(std::vector<WtStruct>* pWeigh
     double ptB[3];
 
     // find nearest pt where we can interpolate
-    const size_t nearSize = _nearest.size();
+    const size_t nearSize = context->nearest.size();
     while (nearIndexB < nearSize) {
-        const size_t locIndexB = _nearest[nearIndexB];
+        const size_t locIndexB = context->nearest[nearIndexB];
         _setPoint3(ptB, _db._data->getCoordinates(locIndexB), spaceDim);
 
         // wtA = DotProduct(pb, ab) / DotProduct(ab, ab)
@@ -368,8 +427,8 @@ spatialdata::spatialdb::SimpleDBQuery::_findLinePt(std::vector<WtStruct>* pWeigh
         const double abY = ptB[1] - ptA[1];
         const double abZ = ptB[2] - ptA[2];
         const double abdotab = abX*abX + abY*abY + abZ*abZ;
-        const double pbdotab = (ptB[0]-_q[0])*abX + (ptB[1]-_q[1])*abY + (ptB[2]-_q[2])*abZ;
-        const double apdotab = (_q[0]-ptA[0])*abX + (_q[1]-ptA[1])*abY + (_q[2]-ptA[2])*abZ;
+        const double pbdotab = (ptB[0]-q[0])*abX + (ptB[1]-q[1])*abY + (ptB[2]-q[2])*abZ;
+        const double apdotab = (q[0]-ptA[0])*abX + (q[1]-ptA[1])*abY + (q[2]-ptA[2])*abZ;
         wtA = pbdotab / abdotab;
         wtB = apdotab / abdotab;
 
@@ -383,30 +442,34 @@ spatialdata::spatialdb::SimpleDBQuery::_findLinePt(std::vector<WtStruct>* pWeigh
         ++nearIndexB;
     } // while
     if (nearIndexB >= nearSize) {
-        throw OutOfBounds("Could not find points for linear interpolation.");
-    }
-    (*pWeights)[0].wt = wtA;
-    (*pWeights)[1].wt = wtB;
-    (*pWeights)[1].nearIndex = nearIndexB;
+        return false; // Could not find points for linear interpolation.
+    } // if
+    weights[0].wt = wtA;
+    weights[1].wt = wtB;
+    weights[1].nearIndex = nearIndexB;
+
+    return true;
 } // _findLinePt
 
 
 // ----------------------------------------------------------------------
-void
-spatialdata::spatialdb::SimpleDBQuery::_findAreaPt(std::vector<WtStruct>* pWeights) { // _findAreaPt
+bool
+spatialdata::spatialdb::SimpleDBQuery::_findAreaPt(QueryContext* context,
+                                                   WtStruct* weights) const { // _findAreaPt
     assert(_db._data);
-    assert(pWeights);
+    assert(weights);
+    const double* q = context->xyz;
 
     const size_t spaceDim = _db._data->getSpaceDim();
 
     // best case is to use next nearest pt
-    const size_t nearIndexA = (*pWeights)[0].nearIndex;
-    const size_t locIndexA = _nearest[nearIndexA];
+    const size_t nearIndexA = weights[0].nearIndex;
+    const size_t locIndexA = context->nearest[nearIndexA];
     double ptA[3];
     _setPoint3(ptA, _db._data->getCoordinates(locIndexA), spaceDim);
 
-    const size_t nearIndexB = (*pWeights)[1].nearIndex;
-    const size_t locIndexB = _nearest[nearIndexB];
+    const size_t nearIndexB = weights[1].nearIndex;
+    const size_t locIndexB = context->nearest[nearIndexB];
     double ptB[3];
     _setPoint3(ptB, _db._data->getCoordinates(locIndexB), spaceDim);
 
@@ -416,10 +479,10 @@ spatialdata::spatialdb::SimpleDBQuery::_findAreaPt(std::vector<WtStruct>* pWeigh
     double ptC[3];
 
     // find nearest pt where we can interpolate
-    const size_t nearSize = _nearest.size();
+    const size_t nearSize = context->nearest.size();
     size_t nearIndexC = nearIndexB + 1;
     while (nearIndexC < nearSize) {
-        const size_t locIndexC = _nearest[nearIndexC];
+        const size_t locIndexC = context->nearest[nearIndexC];
         _setPoint3(ptC, _db._data->getCoordinates(locIndexC), spaceDim);
 
         double areaABC = 0;
@@ -465,10 +528,10 @@ spatialdata::spatialdb::SimpleDBQuery::_findAreaPt(std::vector<WtStruct>* pWeigh
 #endif
             // project P onto abc plane
             double qProj[3];
-            const double qmod = dirABC[0]*_q[0] + dirABC[1]*_q[1] + dirABC[2]*_q[2];
-            qProj[0] = _q[0] - dirABC[0]*qmod;
-            qProj[1] = _q[1] - dirABC[1]*qmod;
-            qProj[2] = _q[2] - dirABC[2]*qmod;
+            const double qmod = dirABC[0]*q[0] + dirABC[1]*q[1] + dirABC[2]*q[2];
+            qProj[0] = q[0] - dirABC[0]*qmod;
+            qProj[1] = q[1] - dirABC[1]*qmod;
+            qProj[2] = q[2] - dirABC[2]*qmod;
 
             // wtA = areaBCQ / areaABC * DotProduct(dirBCQ, dirABC);
             double areaBCQ = 0;
@@ -506,37 +569,41 @@ spatialdata::spatialdb::SimpleDBQuery::_findAreaPt(std::vector<WtStruct>* pWeigh
         ++nearIndexC;
     } // while
     if (nearIndexC >= nearSize) {
-        throw OutOfBounds("Could not find points for areal interpolation.");
-    }
-    (*pWeights)[0].wt = wtA;
-    (*pWeights)[1].wt = wtB;
-    (*pWeights)[2].wt = wtC;
-    (*pWeights)[2].nearIndex = nearIndexC;
+        return false; // Could not find points for areal interpolation.
+    } // if
+    weights[0].wt = wtA;
+    weights[1].wt = wtB;
+    weights[2].wt = wtC;
+    weights[2].nearIndex = nearIndexC;
+
+    return true;
 } // _findAreaPt
 
 
 // ----------------------------------------------------------------------
-void
-spatialdata::spatialdb::SimpleDBQuery::_findVolumePt(std::vector<WtStruct>* pWeights) {
+bool
+spatialdata::spatialdb::SimpleDBQuery::_findVolumePt(QueryContext* context,
+                                                     WtStruct* weights) const {
     assert(_db._data);
-    assert(pWeights);
+    assert(weights);
+    const double* q = context->xyz;
 
     // best case is to use next nearest pt
 
     const size_t spaceDim = _db._data->getSpaceDim();
 
-    const size_t nearIndexA = (*pWeights)[0].nearIndex;
-    const size_t locIndexA = _nearest[nearIndexA];
+    const size_t nearIndexA = weights[0].nearIndex;
+    const size_t locIndexA = context->nearest[nearIndexA];
     double ptA[3];
     _setPoint3(ptA, _db._data->getCoordinates(locIndexA), spaceDim);
 
-    const size_t nearIndexB = (*pWeights)[1].nearIndex;
-    const size_t locIndexB = _nearest[nearIndexB];
+    const size_t nearIndexB = weights[1].nearIndex;
+    const size_t locIndexB = context->nearest[nearIndexB];
     double ptB[3];
     _setPoint3(ptB, _db._data->getCoordinates(locIndexB), spaceDim);
 
-    const size_t nearIndexC = (*pWeights)[2].nearIndex;
-    const size_t locIndexC = _nearest[nearIndexC];
+    const size_t nearIndexC = weights[2].nearIndex;
+    const size_t locIndexC = context->nearest[nearIndexC];
     double ptC[3];
     _setPoint3(ptC, _db._data->getCoordinates(locIndexC), spaceDim);
 
@@ -547,10 +614,10 @@ spatialdata::spatialdb::SimpleDBQuery::_findVolumePt(std::vector<WtStruct>* pWei
     double ptD[3];
 
     // find nearest pt where we can interpolate
-    const size_t nearSize = _nearest.size();
+    const size_t nearSize = context->nearest.size();
     size_t nearIndexD = nearIndexC + 1;
     while (nearIndexD < nearSize) {
-        const size_t locIndexD = _nearest[nearIndexD];
+        const size_t locIndexD = context->nearest[nearIndexD];
         _setPoint3(ptD, _db._data->getCoordinates(locIndexD), spaceDim);
 
         // make sure A,B,C,D are not coplanar by checking if volume of
@@ -568,22 +635,22 @@ spatialdata::spatialdb::SimpleDBQuery::_findVolumePt(std::vector<WtStruct>* pWei
         const double tolerance = 1.0e-06;
         if (fabs(abcd) > tolerance*ab3) {
             // volume pbcd
-            const double pbcd = _volume(_q, ptB, ptC, ptD);
+            const double pbcd = _volume(q, ptB, ptC, ptD);
             // wtA = vol(pbcd)/vol(abcd)
             wtA = pbcd / abcd;
 
             // volume apcd
-            const double apcd = _volume(ptA, _q, ptC, ptD);
+            const double apcd = _volume(ptA, q, ptC, ptD);
             // wtB = vol(apcd)/vol(abcd)
             wtB = apcd / abcd;
 
             // volume abpd
-            const double abpd = _volume(ptA, ptB, _q, ptD);
+            const double abpd = _volume(ptA, ptB, q, ptD);
             // wtC = vol(abpd)/vol(abcd)
             wtC = abpd / abcd;
 
             // volume abcp
-            const double abcp = _volume(ptA, ptB, ptC, _q);
+            const double abcp = _volume(ptA, ptB, ptC, q);
             // wtD = vol(abcp)/vol(abcd)
             wtD = abcp / abcd;
 
@@ -600,13 +667,15 @@ spatialdata::spatialdb::SimpleDBQuery::_findVolumePt(std::vector<WtStruct>* pWei
         ++nearIndexD;
     } // while
     if (nearIndexD >= nearSize) {
-        throw OutOfBounds("Could not find points for volumetric interpolation.");
-    }
-    (*pWeights)[0].wt = wtA;
-    (*pWeights)[1].wt = wtB;
-    (*pWeights)[2].wt = wtC;
-    (*pWeights)[3].wt = wtD;
-    (*pWeights)[3].nearIndex = nearIndexD;
+        return false; // Could not find points for volumetric interpolation.
+    } // if
+    weights[0].wt = wtA;
+    weights[1].wt = wtB;
+    weights[2].wt = wtC;
+    weights[3].wt = wtD;
+    weights[3].nearIndex = nearIndexD;
+
+    return true;
 } // _findVolumePt
 
 
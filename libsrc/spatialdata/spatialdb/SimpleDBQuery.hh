@@ -25,7 +25,7 @@
 #include "spatialdbfwd.hh" // forward declarations
 #include "SimpleDB.hh" // USES SimpleDB
 
-#include "spatialdata/geocoords/geocoordsfwd.hh" // HOLDSA Converter
+#include "spatialdata/geocoords/geocoordsfwd.hh" // USES CoordSys
 
 #include <vector> // USES std::vector
 
@@ -49,6 +49,15 @@ public:
     /// Dellocate data structures.
     void deallocate(void);
 
+    /** Build spatial index over locations in database and, for
+     * DELAUNAY queries, triangulation of locations.
+     *
+     * Only structures that have not already been built are created.
+     *
+     * @pre Database must contain data.
+     */
+    void buildIndex(void);
+
     /** Set query type.
      *
      * @param value Set type of query
@@ -63,19 +72,28 @@ public:
     void setQueryValues(const char* const* names,
                         const size_t numVals);
 
-    /** Query the database.
+    /** Query the database at multiple locations.
      *
-     * @param vals Array for computed values (output from query)
-     * @param numVals Number of values expected (size of pVals array)
-     * @param coords Coordinates of point to query
-     * @param numDims Number of dimensions for coordinates
-     * @param pCSQuery Coordinate system of coordinates
+     * The coordinates of all of the locations are converted to the
+     * coordinate system of the database in a single call.
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query) [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of locations to query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
      */
-    void query(double* vals,
-               const size_t numVals,
-               const double* coords,
-               const size_t numDims,
-               const spatialdata::geocoords::CoordSys* pCSQuery);
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
 
 private:
 
@@ -87,39 +105,85 @@ private:
         size_t nearIndex; ///< Index into nearest
     }; // struct WtStruct
 
+    static const size_t _maxWeights; ///< Maximum number of interpolation weights (volumetric interpolation).
+
 private:
 
     // PRIVATE METHODS ////////////////////////////////////////////////////
 
+    /** Check number of values to be returned by query.
+     *
+     * @param numVals Number of values expected.
+     */
+    void _checkQuery(const size_t numVals) const;
+
+    /** Query database at location in coordinate system of database.
+     *
+     * @param context Scratch state with location of query.
+     * @param vals Array for computed values (output from query)
+     * @param numVals Number of values expected (size of pVals array)
+     *
+     * @returns 0 on success, 1 on failure (i.e., could not interpolate)
+     */
+    int _queryPoint(QueryContext* context,
+                    double* vals,
+                    const size_t numVals) const;
+
     /** Query database using nearest neighbor algorithm.
      *
      * Values at location are equal to values at nearest location in
      * database.
      *
+     * @param context Scratch state with location of query.
      * @param values Array for computed values (output from query)
      * @param numVals Number of values expected (size of pVals array)
      */
-    void _queryNearest(double* vals,
-                       const size_t numVals);
+    void _queryNearest(QueryContext* context,
+                       double* vals,
+                       const size_t numVals) const;
 
     /** Query database using linear interpolation algorithm.
      *
      * Values at location are interpolation from locations in database.
      *
+     * @param context Scratch state with location of query.
      * @param vals Array for computed values (output from query)
      * @param numVals Number of values expected (size of pVals array)
+     *
+     * @returns 0 on success, 1 on failure (i.e., could not interpolate)
      */
-    void _queryLinear(double* vals,
-                      const size_t numVals);
+    int _queryLinear(QueryContext* context,
+                     double* vals,
+                     const size_t numVals) const;
 
-    /// Find locations in database nearest query location.
-    void _findNearest(void);
+    /** Find locations in database nearest query location.
+     *
+     * @param context Scratch state with location of query.
+     */
+    void _findNearest(QueryContext* context) const;
+
+    /** Find simplex in triangulation containing query location and
+     * get interpolation weights.
+     *
+     * @param context Scratch state with location of query.
+     * @param weights Array of interpolation weights [_maxWeights] (output).
+     * @param numWts Number of interpolation weights (output).
+     * @returns True if simplex was found, false otherwise.
+     */
+    bool _findSimplex(QueryContext* context,
+                      WtStruct* weights,
+                      size_t* numWts) const;
 
     /** Get interpolation weighting functions for query.
      *
-     * @param pWeights Pointer to array of interpolation weights
+     * @param context Scratch state with location of query.
+     * @param weights Array of interpolation weights [_maxWeights] (output).
+     * @param numWts Number of interpolation weights (output).
+     * @returns True if weights were found, false otherwise.
      */
-    void _getWeights(std::vector<WtStruct>* pWeights);
+    bool _getWeights(QueryContext* context,
+                     WtStruct* weights,
+                     size_t* numWts) const;
 
     /** Get interpolation weighting functions for point interpolation.
      *
@@ -127,27 +191,36 @@ private:
      * trivial. Instead it is used with the other topologies to build up
      * interpolation to the higher dimensions.
      *
-     * @param pWeights Pointer to array of interpolation weights
+     * @param weights Array of interpolation weights
      */
-    void _findPointPt(std::vector<WtStruct>* pWeights);
+    void _findPointPt(WtStruct* weights) const;
 
     /** Get interpolation weighting functions for linear interpolation.
      *
-     * @param pWeights Pointer to array of interpolation weights
+     * @param context Scratch state with location of query.
+     * @param weights Array of interpolation weights
+     * @returns True if points were found, false otherwise.
      */
-    void _findLinePt(std::vector<WtStruct>* pWeights);
+    bool _findLinePt(QueryContext* context,
+                     WtStruct* weights) const;
 
     /** Get interpolation weighting functions for areal interpolation.
      *
-     * @param pWeights Pointer to array of interpolation weights
+     * @param context Scratch state with location of query.
+     * @param weights Array of interpolation weights
+     * @returns True if points were found, false otherwise.
      */
-    void _findAreaPt(std::vector<WtStruct>* pWeights);
+    bool _findAreaPt(QueryContext* context,
+                     WtStruct* weights) const;
 
     /** Get interpolation weighting functions for volumetric interpolation.
      *
-     * @param pWeights Pointer to array of interpolation weights
+     * @param context Scratch state with location of query.
+     * @param weights Array of interpolation weights
+     * @returns True if points were found, false otherwise.
      */
-    void _findVolumePt(std::vector<WtStruct>* pWeights);
+    bool _findVolumePt(QueryContext* context,
+                       WtStruct* weights) const;
 
     /** Set coordiantes of point in 3-D space using coordinates in
      * current coordinate system.
@@ -198,11 +271,10 @@ private:
 
     // PRIVATE MEMBERS ////////////////////////////////////////////////////
 
-    double _q[3]; ///< Location of query.
     SimpleDB::QueryEnum _queryType; ///< Query type.
-    std::vector<size_t> _nearest; ///< Index of nearest points in database to location.
     const SimpleDB& _db; ///< Reference to simple database.
-    spatialdata::geocoords::Converter* _converter; ///< Covert query points to local coordinate system.
+    KDTree* _tree; ///< Spatial index over locations in database.
+    Triangulation* _triangulation; ///< Triangulation of locations in database.
 
     size_t* _queryValues; ///< Indices of values to be returned in queries.
     size_t _querySize; ///< Nmber of values to be returned in queries.
@@ -27,6 +27,7 @@
 #include "spatialdata/geocoords/CSPicklerAscii.hh" // USES CSPicklerAscii
 
 #include "spatialdata/utils/LineParser.hh" // USES LineParser
+#include "spatialdata/utils/DataParser.hh" // USES DataParser
 
 #include <fstream> // USES std::ofstream, std::ifstream
 #include <iomanip> // USES setw(), setiosflags(), resetiosflags()
@@ -62,7 +63,7 @@ spatialdata::spatialdb::SimpleGridAscii::read(SimpleGridDB* db) { // read
         _readHeader(filein, db);
         _readData(filein, db);
 
-        if (!filein.good()) {
+        if (filein.bad()) {
             throw std::runtime_error("Unknown error while reading.");
         }
 
@@ -390,37 +391,32 @@ spatialdata::spatialdb::SimpleGridAscii::_readData(std::istream& filein,
     assert(numValues > 0);
     db->_data = new double[numLocs*db->_numValues];
     assert(spaceDim > 0);
-    double* coords = new double[spaceDim];
+    // Lines are read in large blocks and parsed concurrently.
+    const size_t numFields = spaceDim + numValues;
+    utils::DataParser dataParser(filein, "//", numFields, numLocs, db->_numReaderThreads);
     int count = 0;
-    for (int iLoc = 0; iLoc < numLocs; ++iLoc, ++count) {
-        buffer.str(parser.next());
-        buffer.clear();
-        for (int iDim = 0; iDim < spaceDim; ++iDim) {
-            if (!buffer.good()) {
-                std::ostringstream msg;
-                msg << "Read data for " << count << " out of " << numLocs << " points.\n"
-                    << "Error reading coordinates from buffer '" << buffer.str() << "'.";
-                throw std::runtime_error(msg.str());
-            } // if
-            buffer >> coords[iDim];
-        } // for
-
-        const int indexData = db->_getDataIndex(coords, spaceDim);
-        for (size_t iVal = 0; iVal < db->_numValues; ++iVal) {
-            if (!buffer.good()) {
-                std::ostringstream msg;
-                msg << "Read data for " << count << " out of " << numLocs << " points.\n"
-                    << "Error reading data from buffer '" << buffer.str() << "'.";
-                throw std::runtime_error(msg.str());
-            } // if
-            buffer >> db->_data[indexData+iVal];
+    while (count < numLocs) {
+        const size_t numLines = dataParser.parse();
+        const double* fields = dataParser.getValues();
+        for (size_t iLine = 0; iLine < numLines; ++iLine, ++count) {
+            const double* coords = &fields[iLine*numFields];
+            const size_t indexData = db->_getDataIndex(coords, spaceDim);
+            for (int iVal = 0; iVal < numValues; ++iVal) {
+                db->_data[indexData+iVal] = coords[spaceDim+iVal];
+            } // for
         } // for
-    } // for
-    delete[] coords;coords = 0;
+        if (dataParser.hasError()) {
+            const char* field = (dataParser.getErrorNumValues() < size_t(spaceDim)) ? "coordinates" : "data";
+            std::ostringstream msg;
+            msg << "Read data for " << count << " out of " << numLocs << " points.\n"
+                << "Error reading " << field << " from buffer '" << dataParser.getErrorLine() << "'.";
+            throw std::runtime_error(msg.str());
+        } // if
+    } // while
     if (_verbose) {
         std::cout << "Read " << count << " lines of data.\n";
     } // if
-    if (!filein.good()) {
+    if (!dataParser.hasEndOfLine() || filein.bad()) {
         std::ostringstream msg;
         msg << "I/O error while reading SimpleGridDB data. ";
         if (count < numLocs) {
@@ -495,6 +491,10 @@ spatialdata::spatialdb::SimpleGridAscii::_writeHeader(std::ostream& fileout,
 void
 spatialdata::spatialdb::SimpleGridAscii::_writeData(std::ostream& fileout,
                                                     const SimpleGridDB& db) { // _writeData
+    if (!db._data) {
+        throw std::logic_error("Writing SimpleGridDB ASCII files requires values stored in double precision.");
+    } // if
+
     fileout
         << std::resetiosflags(std::ios::fixed)
         << std::setiosflags(std::ios::scientific)
@@ -534,7 +534,7 @@ spatialdata::spatialdb::SimpleGridAscii::_writeData(std::ostream& fileout,
                         << std::setw(14) << db._y[iY]
                         << std::setw(14) << db._z[iZ];
                     for (int iV = 0; iV < numValues; ++iV) {
-                        fileout << std::setw(14) << db._data[iD+iV];
+                        fileout << std::setw(14) << db._data[iD+iV*db._valueStride];
                     } // for
                     fileout << "\n";
                 } // for
@@ -549,7 +549,7 @@ spatialdata::spatialdb::SimpleGridAscii::_writeData(std::ostream& fileout,
                     << std::setw(14) << db._x[iX]
                     << std::setw(14) << db._y[iY];
                 for (int iV = 0; iV < numValues; ++iV) {
-                    fileout << std::setw(14) << db._data[iD+iV];
+                    fileout << std::setw(14) << db._data[iD+iV*db._valueStride];
                 } // for
                 fileout << "\n";
             } // for
@@ -562,7 +562,7 @@ spatialdata::spatialdb::SimpleGridAscii::_writeData(std::ostream& fileout,
             fileout
                 << std::setw(14) << db._x[iX];
             for (int iV = 0; iV < numValues; ++iV) {
-                fileout << std::setw(14) << db._data[iD+iV];
+                fileout << std::setw(14) << db._data[iD+iV*db._valueStride];
             } // for
             fileout << "\n";
         } // for
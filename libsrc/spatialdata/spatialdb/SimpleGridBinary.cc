@@ -0,0 +1,587 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "SimpleGridBinary.hh" // implementation of class methods
+
+#include "GridChunkCache.hh" // USES GridChunkCache
+#include "GridSharedMemory.hh" // USES GridSharedMemory
+
+#include "spatialdata/geocoords/CoordSys.hh" // USES CoordSys
+#include "spatialdata/geocoords/CSPicklerAscii.hh" // USES CSPicklerAscii
+
+#include <fstream> // USES std::ofstream, std::ifstream
+#include <ostream> // USES std::ostream
+#include <algorithm> // USES std::min()
+#include <vector> // USES std::vector
+
+#include <stdexcept> // USES std::runtime_error
+#include <sstream> // USES std::ostringstream, std::istringstream
+#include <strings.h> // USES strcasecmp()
+#include <cstring> // USES strncmp(), strlen(), memcpy(), memset()
+#include <cerrno> // USES errno
+#include <fcntl.h> // USES open()
+#include <unistd.h> // USES close()
+#include <sys/stat.h> // USES fstat()
+#include <sys/mman.h> // USES mmap()
+#include <assert.h> // USES assert()
+
+// ----------------------------------------------------------------------
+const char* spatialdata::spatialdb::SimpleGridBinary::FILEHEADER = "#SPATIAL_GRID.binary";
+const uint64_t spatialdata::spatialdb::SimpleGridBinary::_byteOrder = 0x0102030405060708ULL;
+const uint64_t spatialdata::spatialdb::SimpleGridBinary::_version = 2;
+const size_t spatialdata::spatialdb::SimpleGridBinary::_dataAlignment = 4096;
+
+// ----------------------------------------------------------------------
+// Check whether file is a binary SimpleGridDB file.
+bool
+spatialdata::spatialdb::SimpleGridBinary::isBinary(const char* filename) {
+    assert(filename);
+
+    std::ifstream filein(filename, std::ios::binary);
+    if (!filein.is_open() || !filein.good()) {
+        return false;
+    } // if
+
+    FileHeader header;
+    filein.read((char*)&header, sizeof(header));
+    return filein.good() && 0 == strncmp(header.magic, FILEHEADER, sizeof(header.magic));
+} // isBinary
+
+
+// ----------------------------------------------------------------------
+// Read binary database file.
+void
+spatialdata::spatialdb::SimpleGridBinary::read(SimpleGridDB* db) { // read
+    assert(db);
+
+    try {
+        db->_deallocate();
+
+        const int fd = ::open(db->_filename.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::ostringstream msg;
+            msg << "Could not open spatial database file '" << db->_filename
+                << "' for reading.\n";
+            throw std::runtime_error(msg.str());
+        } // if
+        struct stat fileInfo;
+        if (fstat(fd, &fileInfo) != 0) {
+            ::close(fd);
+            throw std::runtime_error("Could not get size of file.");
+        } // if
+        const size_t fileSize = fileInfo.st_size;
+        if (fileSize < sizeof(FileHeader)) {
+            ::close(fd);
+            throw std::runtime_error("File is too small for binary SimpleGridDB header.");
+        } // if
+
+        // Private writable mapping lets the database modify values
+        // without changing the file; unmodified pages remain shared.
+        void* mapping = mmap(NULL, fileSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        const int mmapErrno = errno;
+        ::close(fd);
+        if (MAP_FAILED == mapping) {
+            std::ostringstream msg;
+            msg << "Could not map file into memory (" << strerror(mmapErrno) << ").";
+            throw std::runtime_error(msg.str());
+        } // if
+        db->_mapping = mapping;
+        db->_mappingSize = fileSize;
+        char* base = (char*)mapping;
+
+        const FileHeader header = _readContents(db, base, fileSize);
+        const SimpleGridDB::LayoutEnum layout = SimpleGridDB::LayoutEnum(header.layout);
+        const size_t numPoints = _getNumPoints(header.numX, header.numY, header.numZ, header.spaceDim, layout);
+
+        // Compressed values are loaded and compressed when the
+        // database is opened.
+        if (( db->_cacheSize > 0) && ( SimpleGridDB::UNCOMPRESSED == db->_compression) ) {
+            if (SimpleGridDB::BRICK != layout) {
+                throw std::runtime_error("Cache for out-of-core queries requires binary file with brick layout.");
+            } // if
+
+            // Chunks of values in cache are bricks.
+            const size_t brickVolume = SimpleGridDB::_brickSize*SimpleGridDB::_brickSize*SimpleGridDB::_brickSize;
+            const size_t chunkSize = brickVolume*header.numValues*header.valueSize;
+            db->_cache = new GridChunkCache(db->_filename.c_str(), header.dataOffset, chunkSize, numPoints / brickVolume,
+                                            header.valueSize, db->_cacheSize);
+
+            db->_releaseMapping();
+            db->_data = NULL;
+            db->_dataF = NULL;
+        } // if
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while reading spatial database file '" << db->_filename << "'.\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } catch (...) {
+        std::ostringstream msg;
+        msg << "Unknown error occurred while reading spatial database file '" << db->_filename << "'.\n";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // read
+
+
+// ----------------------------------------------------------------------
+// Write binary database file.
+void
+spatialdata::spatialdb::SimpleGridBinary::write(const SimpleGridDB& db) { // write
+    try {
+        std::ofstream fileout(db._filename.c_str(), std::ios::binary);
+        if (!fileout.is_open() || !fileout.good()) {
+            std::ostringstream msg;
+            msg << "Could not open spatial database file '" << db._filename
+                << "' for writing.\n";
+            throw std::runtime_error(msg.str());
+        } // if
+
+        FileHeader header;
+        std::string text;
+        _makeHeader(db, &header, &text);
+        _writeContents(db, header, text, fileout, true);
+
+        if (!fileout.good()) {
+            throw std::runtime_error("Unknown error while writing.");
+        } // if
+
+        fileout.close();
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while writing spatial database file '" << db._filename << "'.\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } catch (...) {
+        std::ostringstream msg;
+        msg << "Unknown error occurred while writing spatial database file '" << db._filename << "'.\n";
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // write
+
+
+// ----------------------------------------------------------------------
+// Copy coordinates and values into shared memory segment.
+void
+spatialdata::spatialdb::SimpleGridBinary::writeShared(SimpleGridDB* db,
+                                                      GridSharedMemory* segment) {
+    assert(db);
+    assert(segment);
+
+    try {
+        FileHeader header;
+        std::string text;
+        _makeHeader(*db, &header, &text);
+        const size_t numPoints = _getNumPoints(header.numX, header.numY, header.numZ, header.spaceDim,
+                                               SimpleGridDB::LayoutEnum(header.layout));
+        const size_t size = header.dataOffset + numPoints*header.numValues*header.valueSize;
+
+        // Values were converted to SI units when the file was read.
+        char* contents = segment->allocate(size);
+        MemoryBuffer buffer(contents, size);
+        std::ostream out(&buffer);
+        _writeContents(*db, header, text, out, false);
+        if (!out.good()) {
+            throw std::runtime_error("Unknown error while writing.");
+        } // if
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while writing spatial database file '" << db->_filename << "' to shared memory segment '"
+            << segment->getName() << "'.\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // writeShared
+
+
+// ----------------------------------------------------------------------
+// Use coordinates and values in shared memory segment.
+void
+spatialdata::spatialdb::SimpleGridBinary::readShared(SimpleGridDB* db,
+                                                     const GridSharedMemory& segment) {
+    assert(db);
+    assert(segment.getContents());
+
+    try {
+        db->_deallocate();
+        _readContents(db, segment.getContents(), segment.getSize());
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error occurred while reading spatial database file '" << db->_filename << "' from shared memory segment '"
+            << segment.getName() << "'.\n"
+            << err.what();
+        throw std::runtime_error(msg.str());
+    } // try/catch
+} // readShared
+
+
+// ----------------------------------------------------------------------
+// Check header and set coordinates and values from contents of file.
+spatialdata::spatialdb::SimpleGridBinary::FileHeader
+spatialdata::spatialdb::SimpleGridBinary::_readContents(SimpleGridDB* db,
+                                                        const char* base,
+                                                        const size_t size) {
+    assert(db);
+    assert(base);
+
+    FileHeader header;
+    memcpy(&header, base, sizeof(header));
+    if (0 != strncmp(header.magic, FILEHEADER, sizeof(header.magic))) {
+        std::ostringstream msg;
+        msg << "Magic header does not match expected header '" << FILEHEADER << "'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    if (header.byteOrder != _byteOrder) {
+        throw std::runtime_error("Byte order of binary SimpleGridDB file does not match byte order of machine.");
+    } // if
+    if (header.version != _version) {
+        std::ostringstream msg;
+        msg << "Unknown version " << header.version << " of binary SimpleGridDB file format.";
+        throw std::runtime_error(msg.str());
+    } // if
+
+    bool ok = true;
+    std::ostringstream msg;
+    if (header.numValues <= 0) {
+        ok = false;
+        msg << "SimpleGridDB settings must include positive number of values.\n";
+    } // if
+    if (( header.spaceDim < 1) || ( header.spaceDim > 3) ) {
+        ok = false;
+        msg << "SimpleGridDB settings must include spatial dimension of 1, 2, or 3.\n";
+    } // if
+    if (( header.spaceDim > 0) && ( header.numX <= 0) ) {
+        ok = false;
+        msg << "SimpleGridDB settings must include positive number of points along x axis.\n";
+    } // if
+    if (( header.spaceDim > 1) && ( header.numY <= 0) ) {
+        ok = false;
+        msg << "SimpleGridDB settings must include positive number of points along y axis with 2-D and 3-D data.\n";
+    } // if
+    if (( header.spaceDim > 2) && ( header.numZ <= 0) ) {
+        ok = false;
+        msg << "SimpleGridDB settings must include positive number of points along z axis with 3-D data.\n";
+    } // if
+    if (( header.layout != SimpleGridDB::FLAT) && ( header.layout != SimpleGridDB::BRICK) ) {
+        ok = false;
+        msg << "Unknown layout " << header.layout << " of values in binary SimpleGridDB file.\n";
+    } // if
+    if (( header.layout == SimpleGridDB::BRICK) && ( header.spaceDim != 3) ) {
+        ok = false;
+        msg << "Brick layout of values requires 3-D data.\n";
+    } // if
+    if (!ok) {
+        throw std::runtime_error(msg.str());
+    } // if
+
+    const SimpleGridDB::LayoutEnum layout = SimpleGridDB::LayoutEnum(header.layout);
+    const size_t numPoints = _getNumPoints(header.numX, header.numY, header.numZ, header.spaceDim, layout);
+    const size_t numCoords = header.numX + header.numY + header.numZ;
+    if (( header.valueSize != sizeof(double)) && ( header.valueSize != sizeof(float)) ) {
+        std::ostringstream msg;
+        msg << "Unknown size " << header.valueSize << " of values in binary SimpleGridDB file.";
+        throw std::runtime_error(msg.str());
+    } // if
+    if (( header.textSize > size - sizeof(header)) ||
+        ( header.coordsOffset < sizeof(header) + header.textSize) ||
+        ( header.coordsOffset % sizeof(double)) ||
+        ( header.dataOffset % header.valueSize) ||
+        ( header.dataOffset < header.coordsOffset + numCoords*sizeof(double)) ||
+        ( header.dataOffset > size) ||
+        ( numPoints*header.numValues > (size - header.dataOffset) / header.valueSize) ) {
+        throw std::runtime_error("Binary SimpleGridDB file is truncated or has inconsistent sizes.");
+    } // if
+
+    db->_numX = header.numX;
+    db->_numY = header.numY;
+    db->_numZ = header.numZ;
+    db->_spaceDim = header.spaceDim;
+    db->_numValues = header.numValues;
+    _parseText(std::string(base+sizeof(header), header.textSize), db);
+
+    double* coords = (double*)(base + header.coordsOffset);
+    db->_x = (db->_numX > 0) ? coords : NULL;
+    db->_y = (db->_numY > 0) ? coords + db->_numX : NULL;
+    db->_z = (db->_numZ > 0) ? coords + db->_numX + db->_numY : NULL;
+    if (sizeof(float) == header.valueSize) {
+        db->_dataF = (float*)(base + header.dataOffset);
+    } else {
+        db->_data = (double*)(base + header.dataOffset);
+    } // if/else
+    _checkOrder(db->_x, db->_numX, "x");
+    _checkOrder(db->_y, db->_numY, "y");
+    _checkOrder(db->_z, db->_numZ, "z");
+
+    // Set data dimension based on dimensions of data.
+    db->_dataDim = 0;
+    if (db->_numX > 1) {
+        db->_dataDim += 1;
+    } // if
+    if (db->_numY > 1) {
+        db->_dataDim += 1;
+    } // if
+    if (db->_numZ > 1) {
+        db->_dataDim += 1;
+    } // if
+
+    db->_checkCompatibility();
+
+    if (SimpleGridDB::BRICK == layout) {
+        if (3 != db->_dataDim) {
+            throw std::runtime_error("Brick layout of values requires 3-D grid.");
+        } // if
+        db->_buildBricks();
+    } // if
+
+    return header;
+} // _readContents
+
+
+// ----------------------------------------------------------------------
+// Create header and text with names, units, and coordinate system.
+void
+spatialdata::spatialdb::SimpleGridBinary::_makeHeader(const SimpleGridDB& db,
+                                                      FileHeader* pHeader,
+                                                      std::string* textStr) {
+    assert(pHeader);
+    assert(textStr);
+
+    const size_t numValues = db._numValues;
+    assert(db._names);
+    assert(db._units);
+    assert(db._cs);
+    std::ostringstream text;
+    text << "value-names =";
+    for (size_t iVal = 0; iVal < numValues; ++iVal) {
+        text << " " << db._names[iVal];
+    } // for
+    text << "\nvalue-units =";
+    for (size_t iVal = 0; iVal < numValues; ++iVal) {
+        text << " " << db._units[iVal];
+    } // for
+    text << "\ncs-data = ";
+    spatialdata::geocoords::CSPicklerAscii::pickle(text, db._cs);
+    text << "\n";
+    *textStr = text.str();
+
+    const size_t numCoords = db._numX + db._numY + db._numZ;
+    const SimpleGridDB::LayoutEnum layout = (SimpleGridDB::BRICK == db._layout) && (3 == db._dataDim) ?
+                                            SimpleGridDB::BRICK : SimpleGridDB::FLAT;
+
+    FileHeader& header = *pHeader;
+    memset(&header, 0, sizeof(header));
+    assert(strlen(FILEHEADER) < sizeof(header.magic));
+    memcpy(header.magic, FILEHEADER, strlen(FILEHEADER));
+    header.byteOrder = _byteOrder;
+    header.version = _version;
+    header.numX = db._numX;
+    header.numY = db._numY;
+    header.numZ = db._numZ;
+    header.spaceDim = db._spaceDim;
+    header.numValues = numValues;
+    header.valueSize = (SimpleGridDB::SINGLE == db._precision) ? sizeof(float) : sizeof(double);
+    header.layout = layout;
+    header.textSize = textStr->length();
+    header.coordsOffset = sizeof(header) + header.textSize;
+    header.coordsOffset += (sizeof(double) - header.coordsOffset % sizeof(double)) % sizeof(double);
+    header.dataOffset = header.coordsOffset + numCoords*sizeof(double);
+    header.dataOffset += (_dataAlignment - header.dataOffset % _dataAlignment) % _dataAlignment;
+} // _makeHeader
+
+
+// ----------------------------------------------------------------------
+// Write header, text, coordinates, and values.
+void
+spatialdata::spatialdb::SimpleGridBinary::_writeContents(const SimpleGridDB& db,
+                                                         const FileHeader& header,
+                                                         const std::string& text,
+                                                         std::ostream& out,
+                                                         const bool convertToSI) {
+    const size_t numValues = header.numValues;
+    const size_t numCoords = header.numX + header.numY + header.numZ;
+    const SimpleGridDB::LayoutEnum layout = SimpleGridDB::LayoutEnum(header.layout);
+    const size_t numPoints = _getNumPoints(header.numX, header.numY, header.numZ, header.spaceDim, layout);
+
+    const std::vector<char> padding(_dataAlignment, 0);
+    out.write((const char*)&header, sizeof(header));
+    out.write(text.c_str(), header.textSize);
+    out.write(&padding[0], header.coordsOffset - sizeof(header) - header.textSize);
+    if (db._numX > 0) {
+        assert(db._x);
+        out.write((const char*)db._x, db._numX*sizeof(double));
+    } // if
+    if (db._numY > 0) {
+        assert(db._y);
+        out.write((const char*)db._y, db._numY*sizeof(double));
+    } // if
+    if (db._numZ > 0) {
+        assert(db._z);
+        out.write((const char*)db._z, db._numZ*sizeof(double));
+    } // if
+    out.write(&padding[0], header.dataOffset - header.coordsOffset - numCoords*sizeof(double));
+
+    // Convert values to SI units in chunks to limit memory use.
+    std::vector<double> scales(numValues, 1.0);
+    if (convertToSI) {
+        SimpleGridDB::_convertToSI(&scales[0], db._units, 1, numValues);
+    } // if
+    const size_t chunkSize = 4096;
+    std::vector<double> buffer(chunkSize*numValues);
+    std::vector<float> bufferF(sizeof(float) == header.valueSize ? chunkSize*numValues : 0);
+    assert(db._data || db._dataF);
+    for (size_t iPoint = 0; iPoint < numPoints; iPoint += chunkSize) {
+        const size_t chunkPoints = std::min(chunkSize, numPoints-iPoint);
+        for (size_t iChunk = 0, i = 0; iChunk < chunkPoints; ++iChunk) {
+            // Values are written with interleaved values regardless of order in memory.
+            size_t indexLoc = iPoint + iChunk;
+            const bool isPoint = (SimpleGridDB::BRICK == layout) ? _getLocIndex(db, iPoint+iChunk, &indexLoc) : true;
+            const size_t offset = isPoint ? db._getDataIndex(indexLoc) : 0;
+            for (size_t iVal = 0; iVal < numValues; ++iVal, ++i) {
+                const size_t index = offset + iVal*db._valueStride;
+                const double value = isPoint ? (db._data ? db._data[index] : db._dataF[index]) : 0.0;
+                buffer[i] = value * scales[iVal];
+            } // for
+        } // for
+        if (bufferF.size() > 0) {
+            for (size_t i = 0; i < chunkPoints*numValues; ++i) {
+                bufferF[i] = buffer[i];
+            } // for
+            out.write((const char*)&bufferF[0], chunkPoints*numValues*sizeof(float));
+        } else {
+            out.write((const char*)&buffer[0], chunkPoints*numValues*sizeof(double));
+        } // if/else
+    } // for
+} // _writeContents
+
+
+// ----------------------------------------------------------------------
+// Parse names, units, and coordinate system from file header.
+void
+spatialdata::spatialdb::SimpleGridBinary::_parseText(const std::string& text,
+                                                     SimpleGridDB* const db) {
+    assert(db);
+
+    delete[] db->_names;db->_names = new std::string[db->_numValues];
+    delete[] db->_units;db->_units = new std::string[db->_numValues];
+
+    const int maxIgnore = 256;
+    std::istringstream buffer(text);
+    std::string token;
+
+    buffer >> token;
+    if (0 != strcasecmp(token.c_str(), "value-names")) {
+        std::ostringstream msg;
+        msg << "Could not parse '" << token << "' into 'value-names'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    buffer.ignore(maxIgnore, '=');
+    for (size_t iVal = 0; iVal < db->_numValues; ++iVal) {
+        buffer >> db->_names[iVal];
+    } // for
+
+    buffer >> token;
+    if (0 != strcasecmp(token.c_str(), "value-units")) {
+        std::ostringstream msg;
+        msg << "Could not parse '" << token << "' into 'value-units'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    buffer.ignore(maxIgnore, '=');
+    for (size_t iVal = 0; iVal < db->_numValues; ++iVal) {
+        buffer >> db->_units[iVal];
+    } // for
+
+    buffer >> token;
+    if (0 != strcasecmp(token.c_str(), "cs-data")) {
+        std::ostringstream msg;
+        msg << "Could not parse '" << token << "' into 'cs-data'.";
+        throw std::runtime_error(msg.str());
+    } // if
+    spatialdata::geocoords::CSPicklerAscii::unpickle(buffer, &db->_cs);
+
+    if (!buffer.good()) {
+        throw std::runtime_error("I/O error while parsing SimpleGridDB settings.");
+    } // if
+} // _parseText
+
+
+// ----------------------------------------------------------------------
+// Check that coordinates along axis are in increasing order.
+void
+spatialdata::spatialdb::SimpleGridBinary::_checkOrder(const double* values,
+                                                      const size_t size,
+                                                      const char* axis) {
+    for (size_t i = 1; i < size; ++i) {
+        if (values[i] < values[i-1]) {
+            std::ostringstream msg;
+            msg << "Coordinates along " << axis << " axis are not in increasing order.";
+            throw std::runtime_error(msg.str());
+        } // if
+    } // for
+} // _checkOrder
+
+
+// ----------------------------------------------------------------------
+// Get number of points in block of values.
+size_t
+spatialdata::spatialdb::SimpleGridBinary::_getNumPoints(const size_t numX,
+                                                        const size_t numY,
+                                                        const size_t numZ,
+                                                        const size_t spaceDim,
+                                                        const SimpleGridDB::LayoutEnum layout) {
+    if (SimpleGridDB::BRICK == layout) {
+        const size_t brickSize = SimpleGridDB::_brickSize;
+        const size_t numBricks = ((numX + brickSize - 1) / brickSize) *
+                                 ((numY + brickSize - 1) / brickSize) *
+                                 ((numZ + brickSize - 1) / brickSize);
+        return numBricks*brickSize*brickSize*brickSize;
+    } // if
+
+    return (3 == spaceDim) ? numX * numY * numZ : (2 == spaceDim) ? numX * numY : numX;
+} // _getNumPoints
+
+
+// ----------------------------------------------------------------------
+// Get index of point in flat layout from index of point in block of
+// values in brick layout.
+bool
+spatialdata::spatialdb::SimpleGridBinary::_getLocIndex(const SimpleGridDB& db,
+                                                       const size_t indexPoint,
+                                                       size_t* indexLoc) {
+    assert(indexLoc);
+
+    const size_t brickSize = SimpleGridDB::_brickSize;
+    const size_t brickVolume = brickSize*brickSize*brickSize;
+    const size_t numBricksX = (db._numX + brickSize - 1) / brickSize;
+    const size_t numBricksY = (db._numY + brickSize - 1) / brickSize;
+
+    // Bricks are ordered with x fastest; points within a brick are in
+    // Morton order.
+    const size_t indexBrick = indexPoint / brickVolume;
+    const size_t indexMorton = indexPoint % brickVolume;
+    const size_t indexX = (indexBrick % numBricksX)*brickSize + SimpleGridDB::_compactBits(indexMorton);
+    const size_t indexY = ((indexBrick / numBricksX) % numBricksY)*brickSize + SimpleGridDB::_compactBits(indexMorton >> 1);
+    const size_t indexZ = (indexBrick / (numBricksX*numBricksY))*brickSize + SimpleGridDB::_compactBits(indexMorton >> 2);
+    if (( indexX >= db._numX) || ( indexY >= db._numY) || ( indexZ >= db._numZ) ) {
+        return false;
+    } // if
+
+    *indexLoc = (indexZ*db._numY + indexY)*db._numX + indexX;
+    return true;
+} // _getLocIndex
+
+
+// End of file
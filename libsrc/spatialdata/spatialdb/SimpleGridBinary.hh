@@ -0,0 +1,267 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/SimpleGridBinary.hh
+ *
+ * @brief C++ object for reading/writing SimpleGridDB info as binary
+ * files.
+ *
+ * The binary file holds a fixed-size header, the names and units of
+ * the values and the coordinate system as text, the coordinates along
+ * each axis, and the block of values with points ordered with x
+ * fastest, then y, then z. Coordinates are stored as doubles and
+ * values are stored as doubles or floats (following the precision of
+ * the database) in the byte order of the machine that wrote the file,
+ * and values are stored in SI units.
+ *
+ * Reading the file memory-maps it, so the coordinates and values are
+ * used in place without copying and pages of values are loaded from
+ * disk only when they are queried. Processes reading the same file
+ * share the pages in the operating system's file cache.
+ *
+ * Values in 3-D grids may be written in the brick layout of
+ * SimpleGridDB (bricks of 8x8x8 points, padded at the ends of each
+ * axis). Files with the brick layout are used in place with either
+ * layout selected in SimpleGridDB. Databases with a cache size read
+ * the bricks from files with the brick layout as they are queried
+ * instead of mapping the file. Databases using the brick layout copy
+ * values from files with the flat layout when they are opened.
+ */
+
+#if !defined(spatialdata_spatialdb_simplegridbinary_hh)
+#define spatialdata_spatialdb_simplegridbinary_hh
+
+#include "SimpleGridDB.hh" // ISA SimpleGridDB
+
+#include <stdint.h> // USES uint64_t
+#include <string> // USES std::string
+#include <streambuf> // USES std::streambuf
+#include <iosfwd> // USES std::ostream
+
+// ----------------------------------------------------------------------
+class spatialdata::spatialdb::SimpleGridBinary { // SimpleGridBinary
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    // Using default constructor.
+
+    // Using default destructor.
+
+    // Using default copy constructor
+
+    /** Check whether file is a binary SimpleGridDB file.
+     *
+     * @param filename Name of file.
+     * @returns True if file starts with binary file header, false otherwise.
+     */
+    static
+    bool isBinary(const char* filename);
+
+    /** Read the database.
+     *
+     * The coordinates and values in the database refer to memory
+     * mapped from the file until the database is closed. If the
+     * database has a cache size and the file has the brick layout, the
+     * coordinates are copied and the values are read into the cache
+     * as they are queried.
+     *
+     * @param db Spatial database.
+     */
+    static
+    void read(SimpleGridDB* db);
+
+    /** Write the database.
+     *
+     * Values in the database are in the units given by setUnits() (as
+     * for SimpleGridAscii::write()) and are converted to SI units when
+     * they are written. Values are written in the precision set by
+     * SimpleGridDB::setPrecision() and the layout set by
+     * SimpleGridDB::setLayout() (brick layout only for 3-D grids).
+     *
+     * @param db Spatial database.
+     */
+    static
+    void write(const SimpleGridDB& db);
+
+    /** Copy coordinates and values of database into shared memory
+     * segment created by this process.
+     *
+     * The segment holds the contents of a binary file with values in
+     * SI units (already converted when the database was read).
+     *
+     * @param db Spatial database.
+     * @param segment Shared memory segment.
+     */
+    static
+    void writeShared(SimpleGridDB* db,
+                     GridSharedMemory* segment);
+
+    /** Use coordinates and values in shared memory segment.
+     *
+     * The coordinates and values in the database refer to the read-only
+     * contents of the segment.
+     *
+     * @param db Spatial database.
+     * @param segment Shared memory segment.
+     */
+    static
+    void readShared(SimpleGridDB* db,
+                    const GridSharedMemory& segment);
+
+private:
+
+    // PRIVATE STRUCTS ////////////////////////////////////////////////////
+
+    /// Fixed-size header at start of binary file.
+    struct FileHeader {
+        char magic[32]; ///< Magic header (NUL padded).
+        uint64_t byteOrder; ///< Byte order mark.
+        uint64_t version; ///< Version of file format.
+        uint64_t numX; ///< Number of points along x dimension.
+        uint64_t numY; ///< Number of points along y dimension.
+        uint64_t numZ; ///< Number of points along z dimension.
+        uint64_t spaceDim; ///< Spatial dimension of data.
+        uint64_t numValues; ///< Number of values at each point.
+        uint64_t valueSize; ///< Size in bytes of each value (4 or 8).
+        uint64_t layout; ///< Layout of values (SimpleGridDB::LayoutEnum).
+        uint64_t textSize; ///< Size of text following header.
+        uint64_t coordsOffset; ///< Offset in bytes of coordinates.
+        uint64_t dataOffset; ///< Offset in bytes of values.
+    }; // FileHeader
+
+    /// Stream buffer that writes into a fixed block of memory.
+    class MemoryBuffer : public std::streambuf {
+    public:
+
+        /** Constructor.
+         *
+         * @param begin Start of memory.
+         * @param size Size in bytes of memory.
+         */
+        MemoryBuffer(char* begin,
+                     const size_t size) {
+            setp(begin, begin + size);
+        } // constructor
+
+    }; // MemoryBuffer
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Check header and set coordinates and values from contents of
+     * file.
+     *
+     * @param db Spatial database.
+     * @param base Contents of file.
+     * @param size Size in bytes of contents.
+     * @returns Header of file.
+     */
+    static
+    FileHeader _readContents(SimpleGridDB* db,
+                             const char* base,
+                             const size_t size);
+
+    /** Create header and text with names, units, and coordinate system.
+     *
+     * @param db Spatial database.
+     * @param header Header of file.
+     * @param text Text following header.
+     */
+    static
+    void _makeHeader(const SimpleGridDB& db,
+                     FileHeader* header,
+                     std::string* text);
+
+    /** Write header, text, coordinates, and values.
+     *
+     * @param db Spatial database.
+     * @param header Header of file.
+     * @param text Text following header.
+     * @param out Output stream.
+     * @param convertToSI True if values must be converted to SI units.
+     */
+    static
+    void _writeContents(const SimpleGridDB& db,
+                        const FileHeader& header,
+                        const std::string& text,
+                        std::ostream& out,
+                        const bool convertToSI);
+
+    /** Parse names, units, and coordinate system from file header.
+     *
+     * @param text Text in header.
+     * @param db Spatial database.
+     */
+    static
+    void _parseText(const std::string& text,
+                    SimpleGridDB* const db);
+
+    /** Check that coordinates along axis are in increasing order.
+     *
+     * @param values Coordinates along axis.
+     * @param size Number of coordinates.
+     * @param axis Name of axis.
+     */
+    static
+    void _checkOrder(const double* values,
+                     const size_t size,
+                     const char* axis);
+
+    /** Get number of points in block of values.
+     *
+     * @param numX Number of points along x dimension.
+     * @param numY Number of points along y dimension.
+     * @param numZ Number of points along z dimension.
+     * @param spaceDim Spatial dimension of data.
+     * @param layout Layout of values.
+     * @returns Number of points, including points padding bricks.
+     */
+    static
+    size_t _getNumPoints(const size_t numX,
+                         const size_t numY,
+                         const size_t numZ,
+                         const size_t spaceDim,
+                         const SimpleGridDB::LayoutEnum layout);
+
+    /** Get index of point in flat layout from index of point in block
+     * of values in brick layout.
+     *
+     * @param db Spatial database.
+     * @param indexPoint Index of point in brick layout.
+     * @param indexLoc Index of point in flat layout [output].
+     * @returns True if point is in grid, false if point pads brick.
+     */
+    static
+    bool _getLocIndex(const SimpleGridDB& db,
+                      const size_t indexPoint,
+                      size_t* indexLoc);
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    /** Magic header in binary files */
+    static const char* FILEHEADER;
+
+    static const uint64_t _byteOrder; ///< Byte order mark.
+    static const uint64_t _version; ///< Version of file format.
+    static const size_t _dataAlignment; ///< Alignment in bytes of values in file.
+
+}; // class SimpleGridBinary
+
+#endif // spatialdata_spatialdb_simplegridbinary_hh
+
+// End of file
@@ -19,28 +19,58 @@
 #include "SimpleGridDB.hh" // Implementation of class methods
 
 #include "SimpleGridAscii.hh" // USES SimpleGridAscii
+#include "SimpleGridBinary.hh" // USES SimpleGridBinary
+#include "QueryContext.hh" // USES QueryContext
+#include "GridInterpolator.hh" // USES GridInterpolator
+#include "GridChunkCache.hh" // USES GridChunkCache
+#include "GridSharedMemory.hh" // USES GridSharedMemory
+#include "GridCompressedBlocks.hh" // USES GridCompressedBlocks
 
 #include "spatialdata/geocoords/CoordSys.hh" // HASA CoordSys
 #include "spatialdata/geocoords/Converter.hh" // USES Converter
 #include "spatialdata/utils/LineParser.hh" // USES LineParser
 
-#include <cmath> // USES std::floor()
+#include <cmath> // USES std::floor(), std::fabs()
+#include <algorithm> // USES std::min(), std::copy(), std::fill()
+#include <vector> // USES std::vector
 
 #include <fstream> // USES std::ifstream
 #include <sstream> // USES std::ostringstream
 #include <stdexcept> // USES std::logic_error
-#include <cstring> // USES memcpy()
 #include <strings.h> // USES strcasecmp()
+#include <sys/mman.h> // USES munmap()
 #include <assert.h> // USES assert()
 
+// ----------------------------------------------------------------------
+const size_t spatialdata::spatialdb::SimpleGridDB::_brickSize = 8;
+
 // ----------------------------------------------------------------------
 // Constructor
 spatialdata::spatialdb::SimpleGridDB::SimpleGridDB(void) :
     _data(NULL),
+    _dataF(NULL),
     _x(NULL),
     _y(NULL),
     _z(NULL),
+    _lookupX(),
+    _lookupY(),
+    _lookupZ(),
+    _mapping(NULL),
+    _mappingSize(0),
+    _brickX(),
+    _brickY(),
+    _brickZ(),
+    _valueMajor(false),
+    _valueStride(1),
+    _cache(NULL),
+    _cacheSize(0),
+    _shared(NULL),
+    _sharedMemory(false),
+    _numReaderThreads(1),
+    _compressed(NULL),
+    _compressionTolerance(1.0e-6),
     _queryValues(NULL),
+    _queryOffsets(),
     _querySize(0),
     _numX(0),
     _numY(0),
@@ -52,17 +82,16 @@ spatialdata::spatialdb::SimpleGridDB::SimpleGridDB(void) :
     _units(NULL),
     _filename(""),
     _cs(NULL),
-    _converter(new spatialdata::geocoords::Converter),
-    _queryType(NEAREST) {}
+    _queryType(NEAREST),
+    _precision(DOUBLE),
+    _layout(FLAT),
+    _compression(UNCOMPRESSED) {}
 
 
 // ----------------------------------------------------------------------
 // Destructor
 spatialdata::spatialdb::SimpleGridDB::~SimpleGridDB(void) {
-    delete[] _data;_data = NULL;
-    delete[] _x;_x = NULL;
-    delete[] _y;_y = NULL;
-    delete[] _z;_z = NULL;
+    _deallocate();
     _numX = 0;
     _numY = 0;
     _numZ = 0;
@@ -73,7 +102,6 @@ spatialdata::spatialdb::SimpleGridDB::~SimpleGridDB(void) {
     _querySize = 0;
 
     delete _cs;_cs = NULL;
-    delete _converter;_converter = NULL;
 } // destructor
 
 
@@ -89,18 +117,49 @@ spatialdata::spatialdb::SimpleGridDB::setFilename(const char* value) {
 // Open the database and prepare for querying.
 void
 spatialdata::spatialdb::SimpleGridDB::open(void) {
-    SimpleGridAscii::read(this);
+    _deallocate();
+    if (SimpleGridBinary::isBinary(_filename.c_str())) {
+        // Values in binary files are already in SI units.
+        SimpleGridBinary::read(this);
+    } else {
+        if (( _cacheSize > 0) && ( UNCOMPRESSED == _compression) ) {
+            std::ostringstream msg;
+            msg << "Cache for out-of-core queries of spatial database '" << getLabel()
+                << "' requires binary file with brick layout.";
+            throw std::runtime_error(msg.str());
+        } // if
+        if (_sharedMemory) {
+            if (UNCOMPRESSED != _compression) {
+                std::ostringstream msg;
+                msg << "Compressed values of spatial database '" << getLabel() << "' cannot be shared in shared memory.";
+                throw std::runtime_error(msg.str());
+            } // if
 
-    // Convert to SI units
-    const size_t numLocs = (3 == _spaceDim) ? _numX * _numY * _numZ : (2 == _spaceDim) ? _numX * _numY : _numX;
-    try {
-        SpatialDB::_convertToSI(_data, _units, numLocs, _numValues);
-    } catch (const std::exception& err) {
-        std::ostringstream msg;
-        msg << "Error parsing units for spatial database '" << getLabel() << "':\n"
-            << err.what();
-        throw std::runtime_error(msg.str().c_str());
-    } // try/catch
+            // First process to open the file fills the segment with the
+            // values in their final precision and layout.
+            std::ostringstream key;
+            key << "precision=" << _precision << " layout=" << _layout;
+            GridSharedMemory* shared = new GridSharedMemory(_filename.c_str(), key.str().c_str());
+            try {
+                if (shared->attach()) {
+                    _readAscii();
+                    _buildLookups();
+                    _arrangeData();
+                    SimpleGridBinary::writeShared(this, shared);
+                    shared->publish();
+                } // if
+                SimpleGridBinary::readShared(this, *shared);
+            } catch (...) {
+                delete shared;
+                throw;
+            } // try/catch
+            _shared = shared;
+        } else {
+            _readAscii();
+        } // if/else
+    } // if/else
+    _buildLookups();
+    _arrangeData();
 
     // Default query values is all values.
     _querySize = _numValues;
@@ -108,6 +167,7 @@ spatialdata::spatialdb::SimpleGridDB::open(void) {
     for (size_t i = 0; i < _querySize; ++i) {
         _queryValues[i] = i;
     } // for
+    _arrangeValues();
 } // open
 
 
@@ -115,13 +175,11 @@ spatialdata::spatialdb::SimpleGridDB::open(void) {
 // Close the database.
 void
 spatialdata::spatialdb::SimpleGridDB::close(void) {
-    delete[] _data;_data = NULL;
-    delete[] _x;_x = NULL;
-    delete[] _y;_y = NULL;
-    delete[] _z;_z = NULL;
+    _deallocate();
     _numX = 0;
     _numY = 0;
     _numZ = 0;
+    _buildLookups();
 
     _numValues = 0;
     delete[] _names;_names = NULL;
@@ -129,6 +187,7 @@ spatialdata::spatialdb::SimpleGridDB::close(void) {
 
     _querySize = 0;
     delete[] _queryValues;_queryValues = NULL;
+    _queryOffsets.clear();
 } // close
 
 
@@ -140,6 +199,95 @@ spatialdata::spatialdb::SimpleGridDB::setQueryType(const QueryEnum value) {
 } // setQueryType
 
 
+// ----------------------------------------------------------------------
+// Set precision of stored values.
+void
+spatialdata::spatialdb::SimpleGridDB::setPrecision(const PrecisionEnum value) {
+    _precision = value;
+} // setPrecision
+
+
+// ----------------------------------------------------------------------
+// Set layout of stored values.
+void
+spatialdata::spatialdb::SimpleGridDB::setLayout(const LayoutEnum value) {
+    _layout = value;
+} // setLayout
+
+
+// ----------------------------------------------------------------------
+// Set maximum size of cache of chunks of values for out-of-core queries.
+void
+spatialdata::spatialdb::SimpleGridDB::setCacheSize(const size_t value) {
+    _cacheSize = value;
+} // setCacheSize
+
+
+// ----------------------------------------------------------------------
+// Set whether processes on the same node share coordinates and values
+// in shared memory.
+void
+spatialdata::spatialdb::SimpleGridDB::setSharedMemory(const bool value) {
+    _sharedMemory = value;
+} // setSharedMemory
+
+
+// ----------------------------------------------------------------------
+// Set number of threads used to parse values in ASCII files.
+void
+spatialdata::spatialdb::SimpleGridDB::setNumReaderThreads(const size_t value) {
+    _numReaderThreads = value;
+} // setNumReaderThreads
+
+
+// ----------------------------------------------------------------------
+// Set compression of stored values.
+void
+spatialdata::spatialdb::SimpleGridDB::setCompression(const CompressionEnum value) {
+    _compression = value;
+} // setCompression
+
+
+// ----------------------------------------------------------------------
+// Set tolerance for lossy compression.
+void
+spatialdata::spatialdb::SimpleGridDB::setCompressionTolerance(const double value) {
+    _compressionTolerance = value;
+} // setCompressionTolerance
+
+
+// ----------------------------------------------------------------------
+// Get size of compressed values.
+size_t
+spatialdata::spatialdb::SimpleGridDB::getCompressedSize(void) const {
+    return (_compressed) ? _compressed->getCompressedSize() : 0;
+} // getCompressedSize
+
+
+// ----------------------------------------------------------------------
+// Get number of queries of values in chunks held in cache.
+size_t
+spatialdata::spatialdb::SimpleGridDB::getCacheHits(void) const {
+    return (_cache) ? _cache->getNumHits() : 0;
+} // getCacheHits
+
+
+// ----------------------------------------------------------------------
+// Get number of queries of values in chunks read from file.
+size_t
+spatialdata::spatialdb::SimpleGridDB::getCacheMisses(void) const {
+    return (_cache) ? _cache->getNumMisses() : 0;
+} // getCacheMisses
+
+
+// ----------------------------------------------------------------------
+// Get number of chunks evicted from cache.
+size_t
+spatialdata::spatialdb::SimpleGridDB::getCacheEvictions(void) const {
+    return (_cache) ? _cache->getNumEvictions() : 0;
+} // getCacheEvictions
+
+
 // ----------------------------------------------------------------------
 // Get names of values in spatial database.
 void
@@ -162,7 +310,7 @@ spatialdata::spatialdb::SimpleGridDB::getNamesDBValues(const char*** valueNames,
 void
 spatialdata::spatialdb::SimpleGridDB::setQueryValues(const char* const* names,
                                                      const size_t numVals) {
-    assert(_data);
+    assert(_data || _dataF || _cache);
     if (0 == numVals) {
         std::ostringstream msg;
         msg
@@ -195,6 +343,7 @@ spatialdata::spatialdb::SimpleGridDB::setQueryValues(const char* const* names,
         } // if
         _queryValues[iVal] = iName;
     } // for
+    _arrangeValues();
 } // queryVals
 
 
@@ -206,18 +355,102 @@ spatialdata::spatialdb::SimpleGridDB::query(double* vals,
                                             const double* coords,
                                             const size_t numDims,
                                             const spatialdata::geocoords::CoordSys* csQuery) {
-    const size_t querySize = _querySize;
+    int err = 0;
+    queryBatch(_getQueryContext(), vals, numVals, &err, coords, 1, numDims, csQuery);
+
+    return err;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::SimpleGridDB::isThreadSafe(void) const {
+    return !_cache;
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::SimpleGridDB::queryBatch(QueryContext* context,
+                                                 double* vals,
+                                                 const size_t numVals,
+                                                 int* err,
+                                                 const double* coords,
+                                                 const size_t numLocs,
+                                                 const size_t numDims,
+                                                 const spatialdata::geocoords::CoordSys* csQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+    assert(coords);
+
+    _checkQuery(numVals, numDims);
+
+    // Convert coordinates of all locations at once.
+    std::vector<double>& xyz = context->coords;
+    xyz.assign(coords, coords+numLocs*numDims);
+    spatialdata::geocoords::Converter* converter = context->getConverter(this);
+    assert(converter);
+    converter->convert(&xyz[0], numLocs, numDims, _cs, csQuery);
+
+    _queryBlock(vals, numVals, err, &xyz[0], numLocs, numDims);
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations with single precision values
+// and coordinates.
+void
+spatialdata::spatialdb::SimpleGridDB::queryBatch(QueryContext* context,
+                                                 float* vals,
+                                                 const size_t numVals,
+                                                 int* err,
+                                                 const float* coords,
+                                                 const size_t numLocs,
+                                                 const size_t numDims,
+                                                 const spatialdata::geocoords::CoordSys* csQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+    assert(coords);
+
+    _checkQuery(numVals, numDims);
+
+    // Coordinates are converted in double precision; values are
+    // interpolated directly into the single precision array.
+    std::vector<double>& xyz = context->coords;
+    xyz.assign(coords, coords+numLocs*numDims);
+    spatialdata::geocoords::Converter* converter = context->getConverter(this);
+    assert(converter);
+    converter->convert(&xyz[0], numLocs, numDims, _cs, csQuery);
 
-    if (0 == querySize) {
+    _queryBlock(vals, numVals, err, &xyz[0], numLocs, numDims);
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Check arguments of query.
+void
+spatialdata::spatialdb::SimpleGridDB::_checkQuery(const size_t numVals,
+                                                  const size_t numDims) const {
+    if (0 == _querySize) {
         std::ostringstream msg;
         msg << "Values to be returned by spatial database " << getLabel() << "\n"
             << "have not been set. Please call setQueryValues() before query().\n";
         throw std::logic_error(msg.str());
-    } else if (numVals != querySize) {
+    } else if (numVals != _querySize) {
         std::ostringstream msg;
         msg << "Number of values to be returned by spatial database "
             << getLabel() << "\n"
-            << "(" << querySize << ") does not match size of array provided ("
+            << "(" << _querySize << ") does not match size of array provided ("
             << numVals << ").\n";
         throw std::invalid_argument(msg.str());
     } else if (numDims != _spaceDim) {
@@ -226,55 +459,140 @@ spatialdata::spatialdb::SimpleGridDB::query(double* vals,
             << ") does not match spatial dimension of spatial database (" << _spaceDim << ").";
         throw std::invalid_argument(msg.str());
     } // if
+} // _checkQuery
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations in coordinate system of
+// database.
+template<typename T>
+void
+spatialdata::spatialdb::SimpleGridDB::_queryBlock(T* vals,
+                                                  const size_t numVals,
+                                                  int* err,
+                                                  const double* xyz,
+                                                  const size_t numLocs,
+                                                  const size_t numDims) const {
+    if (( LINEAR != _queryType) || _cache) {
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            err[iLoc] = _queryPoint(&vals[iLoc*numVals], numVals, &xyz[iLoc*numDims]);
+        } // for
+    } else if (_dataF) {
+        _interpolateBlock(vals, numVals, err, xyz, numLocs, numDims, _dataF);
+    } else {
+        _interpolateBlock(vals, numVals, err, xyz, numLocs, numDims, _data);
+    } // if/else
+} // _queryBlock
+
+
+// ----------------------------------------------------------------------
+// Interpolate values at multiple locations in coordinate system of
+// database.
+template<typename T, typename D>
+void
+spatialdata::spatialdb::SimpleGridDB::_interpolateBlock(T* vals,
+                                                        const size_t numVals,
+                                                        int* err,
+                                                        const double* xyz,
+                                                        const size_t numLocs,
+                                                        const size_t numDims,
+                                                        const D* data) const {
+    // Gather the cells containing blocks of locations and interpolate
+    // each block at once.
+    const size_t dataDim = _dataDim;
+    assert(dataDim >= 1 && dataDim <= 3);
+    const size_t numCorners = size_t(1) << dataDim;
+    GridInterpolator interpolator(data, &_queryOffsets[0], _querySize, dataDim);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        double index[3];
+        size_t size[3];
+        _getIndices(index, size, &xyz[iLoc*numDims]);
+        if (!_isInside(index, size)) {
+            err[iLoc] = 1;
+            continue;
+        } // if
+        err[iLoc] = 0;
+
+        size_t indexLower[3] = { 0, 0, 0 };
+        double wtsLower[3];
+        for (size_t iDim = 0; iDim < dataDim; ++iDim) {
+            assert(size[iDim] >= 2);
+            indexLower[iDim] = std::min(size[iDim]-2, size_t(std::floor(index[iDim])));
+            wtsLower[iDim] = 1.0 - (index[iDim] - indexLower[iDim]);
+        } // for
+
+        size_t offsets[8];
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            size_t indexCorner[3] = { indexLower[0], indexLower[1], indexLower[2] };
+            for (size_t iDim = 0; iDim < dataDim; ++iDim) {
+                indexCorner[iDim] += (iCorner >> (dataDim-1-iDim)) & 1;
+            } // for
+            offsets[iCorner] = _getDataIndex(indexCorner[0], size[0], indexCorner[1], size[1], indexCorner[2], size[2]);
+        } // for
+
+        interpolator.addPoint(iLoc, offsets, wtsLower);
+        if (interpolator.isFull()) {
+            interpolator.interpolate(vals, numVals);
+        } // if
+    } // for
+    interpolator.interpolate(vals, numVals);
+} // _interpolateBlock
 
-    // Convert coordinates
-    assert(numDims <= 3);
-    memcpy(_xyz, coords, numDims*sizeof(double));
-    assert(_converter);
-    _converter->convert(_xyz, 1, numDims, _cs, csQuery);
 
+// ----------------------------------------------------------------------
+// Query the database at location in coordinate system of database.
+template<typename T>
+int
+spatialdata::spatialdb::SimpleGridDB::_queryPoint(T* vals,
+                                                  const size_t numVals,
+                                                  const double* xyz) const {
+    if (_cache) {
+        return (sizeof(float) == _cache->getValueSize()) ?
+               _queryCached<T, float>(vals, xyz) :
+               _queryCached<T, double>(vals, xyz);
+    } // if
+
+    const size_t querySize = _querySize;
     int queryFlag = 0;
-    const int spaceDim = _spaceDim;
 
-    double index0 = 0.0;
-    double index1 = 0.0;
-    double index2 = 0.0;
-    size_t size0 = 0;
-    size_t size1 = 0;
-    size_t size2 = 0;
-    if (3 == spaceDim) {
-        index0 = _search(_xyz[0], _x, _numX);
-        index1 = _search(_xyz[1], _y, _numY);
-        index2 = _search(_xyz[2], _z, _numZ);
-        _reindex3d(&index0, &size0, &index1, &size1, &index2, &size2);
-    } else if (2 == spaceDim) {
-        index0 = _search(_xyz[0], _x, _numX);
-        index1 = _search(_xyz[1], _y, _numY);
-        _reindex2d(&index0, &size0, &index1, &size1);
-    } else { // else
-        assert(1 == spaceDim);
-        index0 = _search(_xyz[0], _x, _numX);
-        size0 = _numX;
-    } // if/else
+    double index[3];
+    size_t size[3];
+    _getIndices(index, size, xyz);
+    double index0 = index[0];
+    double index1 = index[1];
+    double index2 = index[2];
+    const size_t size0 = size[0];
+    const size_t size1 = size[1];
+    const size_t size2 = size[2];
 
     switch (_queryType) {
     case LINEAR:
-        if (( index0 < 0.0) || (( index0 > 0) && ( index0 > size0-1.0) ) ||
-            ( index1 < 0.0) || (( index1 > 0) && ( index1 > size1-1.0) ) ||
-            ( index2 < 0.0) || (( index2 > 0) && ( index2 > size2-1.0) )) {
+        if (!_isInside(index, size)) {
             queryFlag = 1;
             return queryFlag;
         } // if
 
         switch (_dataDim) {
         case 1:
-            _interpolate1D(vals, numVals, index0, size0);
+            if (_dataF) {
+                _interpolate1D(vals, numVals, _dataF, index0, size0);
+            } else {
+                _interpolate1D(vals, numVals, _data, index0, size0);
+            } // if/else
             break;
         case 2:
-            _interpolate2D(vals, numVals, index0, size0, index1, size1);
+            if (_dataF) {
+                _interpolate2D(vals, numVals, _dataF, index0, size0, index1, size1);
+            } else {
+                _interpolate2D(vals, numVals, _data, index0, size0, index1, size1);
+            } // if/else
             break;
         case 3:
-            _interpolate3D(vals, numVals, index0, index1, index2);
+            if (_dataF) {
+                _interpolate3D(vals, numVals, _dataF, index0, index1, index2);
+            } else {
+                _interpolate3D(vals, numVals, _data, index0, index1, index2);
+            } // if/else
             break;
         default:
             assert(false);
@@ -294,7 +612,7 @@ spatialdata::spatialdb::SimpleGridDB::query(double* vals,
         const size_t indexData = _getDataIndex(indexNearest0, size0, indexNearest1, size1, indexNearest2, size2);
 
         for (size_t iVal = 0; iVal < querySize; ++iVal) {
-            vals[iVal] = _data[indexData+_queryValues[iVal]];
+            vals[iVal] = _dataF ? _dataF[indexData+_queryOffsets[iVal]] : _data[indexData+_queryOffsets[iVal]];
 #if 0 // DEBUGGING
             std::cout << "val["<<iVal<<"]: " << vals[iVal]
                       << ", indexData: " << indexData
@@ -312,7 +630,131 @@ spatialdata::spatialdb::SimpleGridDB::query(double* vals,
     } // switch
 
     return queryFlag;
-} // query
+} // _queryPoint
+
+
+// ----------------------------------------------------------------------
+// Query the database at location in coordinate system of database
+// using values in cache of chunks.
+template<typename T, typename D>
+int
+spatialdata::spatialdb::SimpleGridDB::_queryCached(T* vals,
+                                                   const double* xyz) const {
+    assert(_cache);
+    const size_t dataDim = _dataDim;
+    assert(dataDim >= 1 && dataDim <= 3);
+
+    double index[3];
+    size_t size[3];
+    _getIndices(index, size, xyz);
+
+    // Chunks are bricks (or runs of points for lower data dimensions),
+    // so the offset of a value gives its chunk.
+    const size_t chunkSize = _cache->getChunkSize() / sizeof(D);
+    const size_t querySize = _querySize;
+    if (NEAREST == _queryType) {
+        size_t indexNearest[3];
+        for (size_t iDim = 0; iDim < 3; ++iDim) {
+            const double indexClamped = std::max(std::min(index[iDim], size[iDim]-1.0), 0.0);
+            indexNearest[iDim] = size_t(std::floor(indexClamped+0.5));
+        } // for
+        const size_t offset = _getDataIndex(indexNearest[0], size[0], indexNearest[1], size[1], indexNearest[2], size[2]);
+        const D* values = (const D*)_cache->getChunk(offset / chunkSize) + offset % chunkSize;
+        for (size_t iVal = 0; iVal < querySize; ++iVal) {
+            vals[iVal] = values[_queryOffsets[iVal]];
+        } // for
+        return 0;
+    } // if
+
+    if (!_isInside(index, size)) {
+        return 1;
+    } // if
+
+    size_t indexLower[3] = { 0, 0, 0 };
+    double wtsLower[3];
+    for (size_t iDim = 0; iDim < dataDim; ++iDim) {
+        assert(size[iDim] >= 2);
+        indexLower[iDim] = std::min(size[iDim]-2, size_t(std::floor(index[iDim])));
+        wtsLower[iDim] = 1.0 - (index[iDim] - indexLower[iDim]);
+    } // for
+
+    // Get all corners before summing; the cache holds at least eight
+    // chunks, so the corners remain loaded.
+    const size_t numCorners = size_t(1) << dataDim;
+    const D* corners[8];
+    double wts[8];
+    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+        size_t indexCorner[3] = { indexLower[0], indexLower[1], indexLower[2] };
+        double wt = 1.0;
+        for (size_t iDim = 0; iDim < dataDim; ++iDim) {
+            const size_t upper = (iCorner >> (dataDim-1-iDim)) & 1;
+            indexCorner[iDim] = indexLower[iDim] + upper;
+            wt *= (upper) ? 1.0 - wtsLower[iDim] : wtsLower[iDim];
+        } // for
+        const size_t offset = _getDataIndex(indexCorner[0], size[0], indexCorner[1], size[1], indexCorner[2], size[2]);
+        corners[iCorner] = (const D*)_cache->getChunk(offset / chunkSize) + offset % chunkSize;
+        wts[iCorner] = wt;
+    } // for
+
+    for (size_t iVal = 0; iVal < querySize; ++iVal) {
+        const size_t qVal = _queryOffsets[iVal];
+        double value = 0.0;
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            value += wts[iCorner] * corners[iCorner][qVal];
+        } // for
+        vals[iVal] = value;
+    } // for
+
+    return 0;
+} // _queryCached
+
+
+// ----------------------------------------------------------------------
+// Get fractional indices of location in grid.
+void
+spatialdata::spatialdb::SimpleGridDB::_getIndices(double index[3],
+                                                  size_t size[3],
+                                                  const double* xyz) const {
+    double index0 = 0.0;
+    double index1 = 0.0;
+    double index2 = 0.0;
+    size_t size0 = 0;
+    size_t size1 = 0;
+    size_t size2 = 0;
+    if (3 == _spaceDim) {
+        index0 = _search(xyz[0], _x, _numX, _lookupX);
+        index1 = _search(xyz[1], _y, _numY, _lookupY);
+        index2 = _search(xyz[2], _z, _numZ, _lookupZ);
+        _reindex3d(&index0, &size0, &index1, &size1, &index2, &size2);
+    } else if (2 == _spaceDim) {
+        index0 = _search(xyz[0], _x, _numX, _lookupX);
+        index1 = _search(xyz[1], _y, _numY, _lookupY);
+        _reindex2d(&index0, &size0, &index1, &size1);
+    } else { // else
+        assert(1 == _spaceDim);
+        index0 = _search(xyz[0], _x, _numX, _lookupX);
+        size0 = _numX;
+    } // if/else
+
+    index[0] = index0;
+    index[1] = index1;
+    index[2] = index2;
+    size[0] = size0;
+    size[1] = size1;
+    size[2] = size2;
+} // _getIndices
+
+
+// ----------------------------------------------------------------------
+// Check whether fractional indices are inside grid for linear
+// interpolation.
+bool
+spatialdata::spatialdb::SimpleGridDB::_isInside(const double index[3],
+                                                const size_t size[3]) const {
+    return !(( index[0] < 0.0) || (( index[0] > 0) && ( index[0] > size[0]-1.0) ) ||
+             ( index[1] < 0.0) || (( index[1] > 0) && ( index[1] > size[1]-1.0) ) ||
+             ( index[2] < 0.0) || (( index[2] > 0) && ( index[2] > size[2]-1.0) ));
+} // _isInside
 
 
 // ----------------------------------------------------------------------
@@ -334,11 +776,13 @@ spatialdata::spatialdb::SimpleGridDB::allocate(const size_t numX,
     _checkCompatibility();
 
     const size_t numLocs = (3 == spaceDim) ? _numX * _numY * _numZ : (2 == spaceDim) ? _numX * _numY : _numX;
-    delete[] _data;_data = (numLocs*numValues > 0) ? new double[numLocs*numValues] : NULL;
+    _deallocate();
+    _data = (numLocs*numValues > 0) ? new double[numLocs*numValues] : NULL;
 
-    delete[] _x;_x = (numX > 0) ? new double[numX] : NULL;
-    delete[] _y;_y = (numY > 0) ? new double[numY] : NULL;
-    delete[] _z;_z = (numZ > 0) ? new double[numZ] : NULL;
+    _x = (numX > 0) ? new double[numX] : NULL;
+    _y = (numY > 0) ? new double[numY] : NULL;
+    _z = (numZ > 0) ? new double[numZ] : NULL;
+    _buildLookups();
 } // allocate
 
 
@@ -361,6 +805,7 @@ spatialdata::spatialdb::SimpleGridDB::setX(const double* values,
     for (size_t i = 0; i < size; ++i) {
         _x[i] = values[i];
     } // for
+    _buildLookup(&_lookupX, _x, _numX);
 } // setD
 
 
@@ -383,6 +828,7 @@ spatialdata::spatialdb::SimpleGridDB::setY(const double* values,
     for (size_t i = 0; i < size; ++i) {
         _y[i] = values[i];
     } // for
+    _buildLookup(&_lookupY, _y, _numY);
 } // setY
 
 
@@ -405,6 +851,7 @@ spatialdata::spatialdb::SimpleGridDB::setZ(const double* values,
     for (size_t i = 0; i < size; ++i) {
         _z[i] = values[i];
     } // for
+    _buildLookup(&_lookupZ, _z, _numZ);
 } // setZ
 
 
@@ -436,17 +883,50 @@ spatialdata::spatialdb::SimpleGridDB::setData(const double* coords,
         throw std::invalid_argument(msg.str());
     } // if
 
-    if (!_data) {
+    if (_compressed) {
+        throw std::logic_error("Cannot set values of SimpleGridDB with compressed values.");
+    } // if
+    if (_cache) {
+        throw std::logic_error("Cannot set values of SimpleGridDB with values in cache for out-of-core queries.");
+    } // if
+    if (_shared) {
+        throw std::logic_error("Cannot set values of SimpleGridDB with values in shared memory.");
+    } // if
+    if (!_data && !_dataF) {
         const size_t size = numLocs*numValues;
         _data = (size > 0) ? new double[size] : NULL;
     } // if
 
-    assert(_data);
-    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+    assert(_data || _dataF);
+
+    // Locations in the same order as the grid points (x fastest, then y,
+    // then z) map directly to the data array without searching.
+    const size_t numOrdered = _getNumOrdered(coords, numLocs, spaceDim);
+    if (_data && !_valueMajor && _brickX.empty()) {
+        std::copy(values, values+numOrdered*numValues, _data);
+    } else {
+        for (size_t iLoc = 0; iLoc < numOrdered; ++iLoc) {
+            const size_t indexData = _getDataIndex(iLoc);
+            const size_t jj = iLoc*numValues;
+            for (size_t iV = 0; iV < numValues; ++iV) {
+                if (_dataF) {
+                    _dataF[indexData+iV*_valueStride] = values[jj+iV];
+                } else {
+                    _data[indexData+iV*_valueStride] = values[jj+iV];
+                } // if/else
+            } // for
+        } // for
+    } // if/else
+
+    for (size_t iLoc = numOrdered; iLoc < numLocs; ++iLoc) {
         const size_t indexData = _getDataIndex(&coords[iLoc*spaceDim], spaceDim);
         const size_t jj = iLoc*numValues;
         for (size_t iV = 0; iV < numValues; ++iV) {
-            _data[indexData+iV] = values[jj+iV];
+            if (_dataF) {
+                _dataF[indexData+iV*_valueStride] = values[jj+iV];
+            } else {
+                _data[indexData+iV*_valueStride] = values[jj+iV];
+            } // if/else
         } // for
     } // for
 } // setData
@@ -563,6 +1043,332 @@ spatialdata::spatialdb::SimpleGridDB::_checkCompatibility(void) const {
 } // _checkCompatibility
 
 
+// ----------------------------------------------------------------------
+// Deallocate (or unmap) coordinates and values.
+void
+spatialdata::spatialdb::SimpleGridDB::_deallocate(void) {
+    if (_mapping) {
+        // Coordinates and values refer to memory-mapped file.
+        munmap(_mapping, _mappingSize);
+        _mapping = NULL;
+        _mappingSize = 0;
+    } else if (!_shared) {
+        delete[] _data;
+        delete[] _dataF;
+        delete[] _x;
+        delete[] _y;
+        delete[] _z;
+    } // if/else
+    _data = NULL;
+    _dataF = NULL;
+    _x = NULL;
+    _y = NULL;
+    _z = NULL;
+    _brickX.clear();
+    _brickY.clear();
+    _brickZ.clear();
+    _valueMajor = false;
+    _valueStride = 1;
+    delete _cache;_cache = NULL;
+    delete _compressed;_compressed = NULL;
+    delete _shared;_shared = NULL;
+} // _deallocate
+
+
+// ----------------------------------------------------------------------
+// Read ASCII file and convert values to SI units.
+void
+spatialdata::spatialdb::SimpleGridDB::_readAscii(void) {
+    SimpleGridAscii::read(this);
+
+    // Convert to SI units
+    const size_t numLocs = (3 == _spaceDim) ? _numX * _numY * _numZ : (2 == _spaceDim) ? _numX * _numY : _numX;
+    try {
+        SpatialDB::_convertToSI(_data, _units, numLocs, _numValues);
+    } catch (const std::exception& err) {
+        std::ostringstream msg;
+        msg << "Error parsing units for spatial database '" << getLabel() << "':\n"
+            << err.what();
+        throw std::runtime_error(msg.str().c_str());
+    } // try/catch
+} // _readAscii
+
+
+// ----------------------------------------------------------------------
+// Arrange values in storage selected for queries.
+void
+spatialdata::spatialdb::SimpleGridDB::_arrangeData(void) {
+    // Memory-mapped values keep the precision of the file.
+    if (( SINGLE == _precision) && _data && !_mapping) {
+        const size_t numLocs = (3 == _spaceDim) ? _numX * _numY * _numZ : (2 == _spaceDim) ? _numX * _numY : _numX;
+        const size_t size = numLocs*_numValues;
+        _dataF = new float[size];
+        for (size_t i = 0; i < size; ++i) {
+            _dataF[i] = _data[i];
+        } // for
+        delete[] _data;_data = NULL;
+    } // if
+
+    // Values in binary files with brick layout are already in bricks.
+    // Compressed 3-D grids are compressed brick by brick.
+    const bool useBricks = ( BRICK == _layout) || ( UNCOMPRESSED != _compression);
+    if (useBricks && ( 3 == _dataDim) && (_data || _dataF) && _brickX.empty()) {
+        _buildBricks();
+        double* data = _data ? _copyToBricks(_data) : NULL;
+        float* dataF = _dataF ? _copyToBricks(_dataF) : NULL;
+        if (_mapping) {
+            _releaseMapping();
+        } else {
+            delete[] _data;
+            delete[] _dataF;
+        } // if/else
+        _data = data;
+        _dataF = dataF;
+    } // if
+
+    if (( UNCOMPRESSED != _compression) && (_data || _dataF) && !_shared) {
+        _compressValues();
+    } // if
+} // _arrangeData
+
+
+// ----------------------------------------------------------------------
+// Compress values and set up cache of decompressed blocks.
+void
+spatialdata::spatialdb::SimpleGridDB::_compressValues(void) {
+    assert(_data || _dataF);
+    assert(!_valueMajor);
+    assert(!_cache);
+
+    // Tolerance of each value is relative to its range over the grid
+    // points, excluding points padding bricks.
+    const size_t numValues = _numValues;
+    std::vector<double> tolerances(numValues, 0.0);
+    if (( LOSSY == _compression) && ( _compressionTolerance > 0.0) ) {
+        const size_t numLocs = (3 == _spaceDim) ? _numX * _numY * _numZ : (2 == _spaceDim) ? _numX * _numY : _numX;
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            double valueMin = 0.0;
+            double valueMax = 0.0;
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                const size_t index = _getDataIndex(iLoc) + iVal;
+                const double value = _dataF ? _dataF[index] : _data[index];
+                valueMin = (iLoc > 0) ? std::min(valueMin, value) : value;
+                valueMax = (iLoc > 0) ? std::max(valueMax, value) : value;
+            } // for
+            tolerances[iVal] = _compressionTolerance * (valueMax - valueMin);
+        } // for
+    } // if
+
+    // Blocks are bricks for 3-D grids; each brick is a contiguous
+    // chunk of values.
+    const size_t blockSize = _brickSize*_brickSize*_brickSize;
+    GridCompressedBlocks* compressed = new GridCompressedBlocks(blockSize, numValues);
+    if (_dataF) {
+        compressed->compress(_dataF, _getNumPoints(), &tolerances[0]);
+    } else {
+        compressed->compress(_data, _getNumPoints(), &tolerances[0]);
+    } // if/else
+    _compressed = compressed;
+    _cache = new GridChunkCache(compressed, _cacheSize);
+
+    if (_mapping) {
+        _releaseMapping();
+    } else {
+        delete[] _data;
+        delete[] _dataF;
+    } // if/else
+    _data = NULL;
+    _dataF = NULL;
+} // _compressValues
+
+
+// ----------------------------------------------------------------------
+// Copy coordinates and release memory-mapped file.
+void
+spatialdata::spatialdb::SimpleGridDB::_releaseMapping(void) {
+    assert(_mapping);
+
+    double* x = new double[_numX];
+    double* y = new double[_numY];
+    double* z = new double[_numZ];
+    std::copy(_x, _x+_numX, x);
+    std::copy(_y, _y+_numY, y);
+    std::copy(_z, _z+_numZ, z);
+    munmap(_mapping, _mappingSize);
+    _mapping = NULL;
+    _mappingSize = 0;
+    _x = x;
+    _y = y;
+    _z = z;
+} // _releaseMapping
+
+
+// ----------------------------------------------------------------------
+// Arrange values in interleaved or value-major order for the values
+// returned by queries and set offsets of query values.
+void
+spatialdata::spatialdb::SimpleGridDB::_arrangeValues(void) {
+    // Store each value contiguously when only a subset of the values
+    // is queried. Memory-mapped values keep the order in the file.
+    const bool valueMajor = (_querySize < _numValues) && !_mapping && !_cache && !_shared;
+    if (valueMajor != _valueMajor) {
+        const size_t numPoints = _getNumPoints();
+        if (_data) {
+            _transposeValues(_data, numPoints, valueMajor);
+        } // if
+        if (_dataF) {
+            _transposeValues(_dataF, numPoints, valueMajor);
+        } // if
+        _valueMajor = valueMajor;
+        _valueStride = valueMajor ? numPoints : 1;
+        if (!_brickX.empty()) {
+            _buildBricks();
+        } // if
+    } // if
+
+    _queryOffsets.resize(_querySize);
+    for (size_t iVal = 0; iVal < _querySize; ++iVal) {
+        _queryOffsets[iVal] = _queryValues[iVal]*_valueStride;
+    } // for
+} // _arrangeValues
+
+
+// ----------------------------------------------------------------------
+// Transpose values in place between interleaved and value-major order.
+template<typename D>
+void
+spatialdata::spatialdb::SimpleGridDB::_transposeValues(D* data,
+                                                       const size_t numPoints,
+                                                       const bool toValueMajor) const {
+    assert(data);
+
+    // Values move through a buffer holding one value at every point.
+    // The first n values at each point are kept interleaved at the start
+    // of the array, with the planes of the remaining values after them.
+    const size_t numValues = _numValues;
+    std::vector<D> buffer(numPoints);
+    if (toValueMajor) {
+        // Move last interleaved value to its plane and pack the others.
+        for (size_t n = numValues; n > 1; --n) {
+            for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+                buffer[iPoint] = data[iPoint*n+n-1];
+            } // for
+            for (size_t iPoint = 1; iPoint < numPoints; ++iPoint) {
+                for (size_t iVal = 0; iVal+1 < n; ++iVal) {
+                    data[iPoint*(n-1)+iVal] = data[iPoint*n+iVal];
+                } // for
+            } // for
+            std::copy(buffer.begin(), buffer.end(), &data[numPoints*(n-1)]);
+        } // for
+    } else {
+        // Spread interleaved values and insert first remaining plane.
+        for (size_t n = 1; n < numValues; ++n) {
+            std::copy(&data[numPoints*n], &data[numPoints*(n+1)], buffer.begin());
+            for (size_t iPoint = numPoints; iPoint-- > 0; ) {
+                for (size_t iVal = n; iVal-- > 0; ) {
+                    data[iPoint*(n+1)+iVal] = data[iPoint*n+iVal];
+                } // for
+                data[iPoint*(n+1)+n] = buffer[iPoint];
+            } // for
+        } // for
+    } // if/else
+} // _transposeValues
+
+
+// ----------------------------------------------------------------------
+// Get number of points in array of values.
+size_t
+spatialdata::spatialdb::SimpleGridDB::_getNumPoints(void) const {
+    if (!_brickX.empty()) {
+        const size_t numBricks = ((_numX + _brickSize - 1) / _brickSize) *
+                                 ((_numY + _brickSize - 1) / _brickSize) *
+                                 ((_numZ + _brickSize - 1) / _brickSize);
+        return numBricks*_brickSize*_brickSize*_brickSize;
+    } // if
+
+    return (3 == _spaceDim) ? _numX * _numY * _numZ : (2 == _spaceDim) ? _numX * _numY : _numX;
+} // _getNumPoints
+
+
+// ----------------------------------------------------------------------
+// Build offsets of points along each axis for brick layout.
+void
+spatialdata::spatialdb::SimpleGridDB::_buildBricks(void) {
+    assert(3 == _dataDim);
+
+    const size_t brickVolume = _brickSize*_brickSize*_brickSize;
+    const size_t numBricksX = (_numX + _brickSize - 1) / _brickSize;
+    const size_t numBricksY = (_numY + _brickSize - 1) / _brickSize;
+    const size_t pointStride = _valueMajor ? 1 : _numValues;
+
+    // Bricks are ordered with x fastest; points within a brick are in
+    // Morton order, so each 2x2x2 block of points is contiguous.
+    _brickX.resize(_numX);
+    for (size_t i = 0; i < _numX; ++i) {
+        _brickX[i] = ((i / _brickSize)*brickVolume + _spreadBits(i % _brickSize))*pointStride;
+    } // for
+    _brickY.resize(_numY);
+    for (size_t i = 0; i < _numY; ++i) {
+        _brickY[i] = ((i / _brickSize)*numBricksX*brickVolume + (_spreadBits(i % _brickSize) << 1))*pointStride;
+    } // for
+    _brickZ.resize(_numZ);
+    for (size_t i = 0; i < _numZ; ++i) {
+        _brickZ[i] = ((i / _brickSize)*numBricksX*numBricksY*brickVolume + (_spreadBits(i % _brickSize) << 2))*pointStride;
+    } // for
+} // _buildBricks
+
+
+// ----------------------------------------------------------------------
+// Copy values from flat layout to brick layout.
+template<typename D>
+D*
+spatialdata::spatialdb::SimpleGridDB::_copyToBricks(const D* data) const {
+    assert(data);
+    assert(_brickX.size() == _numX && _brickY.size() == _numY && _brickZ.size() == _numZ);
+
+    // Bricks are padded to full size; values at padding points are never used.
+    const size_t size = _getNumPoints()*_numValues;
+    D* bricks = new D[size];
+    std::fill(bricks, bricks+size, D(0));
+
+    const D* src = data;
+    for (size_t iZ = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            const size_t offsetYZ = _brickY[iY] + _brickZ[iZ];
+            for (size_t iX = 0; iX < _numX; ++iX, src += _numValues) {
+                std::copy(src, src+_numValues, &bricks[offsetYZ + _brickX[iX]]);
+            } // for
+        } // for
+    } // for
+
+    return bricks;
+} // _copyToBricks
+
+
+// ----------------------------------------------------------------------
+// Spread bits of index of point within brick for Morton order.
+size_t
+spatialdata::spatialdb::SimpleGridDB::_spreadBits(const size_t index) {
+    size_t spread = 0;
+    for (size_t iBit = 0; (index >> iBit) > 0; ++iBit) {
+        spread |= ((index >> iBit) & 1) << (3*iBit);
+    } // for
+    return spread;
+} // _spreadBits
+
+
+// ----------------------------------------------------------------------
+// Compact bits of Morton index of point within brick.
+size_t
+spatialdata::spatialdb::SimpleGridDB::_compactBits(const size_t index) {
+    size_t compact = 0;
+    for (size_t iBit = 0; (index >> (3*iBit)) > 0; ++iBit) {
+        compact |= ((index >> (3*iBit)) & 1) << iBit;
+    } // for
+    return compact;
+} // _compactBits
+
+
 // ----------------------------------------------------------------------
 // Bilinear search for coordinate.
 double
@@ -604,11 +1410,128 @@ spatialdata::spatialdb::SimpleGridDB::_search(const double target,
 } // _search
 
 
+// ----------------------------------------------------------------------
+// Search for coordinate using lookup table.
+double
+spatialdata::spatialdb::SimpleGridDB::_search(const double target,
+                                              const double* vals,
+                                              const size_t nvals,
+                                              const AxisLookup& lookup) const {
+    if (1 == nvals) {
+        return 0.0;
+    } // if
+    if (lookup.size != nvals) {
+        return _search(target, vals, nvals);
+    } // if
+
+    assert(vals);
+    assert(nvals > 1);
+
+    double index = -1.0;
+    const size_t indexMax = nvals - 2;
+    const double tolerance = 1.0e-6;
+    if (( target >= vals[0]-tolerance) && ( target <= vals[nvals-1]+tolerance) ) {
+        // Initial guess for interval from lookup table.
+        const double position = (target - lookup.origin) * lookup.scale;
+        size_t indexL = 0;
+        if (lookup.buckets.empty()) {
+            indexL = (position > 0.0) ? std::min(indexMax, size_t(position)) : 0;
+        } else {
+            const size_t numBuckets = lookup.buckets.size() - 1;
+            indexL = lookup.buckets[(position > 0.0) ? std::min(numBuckets, size_t(position)) : 0];
+        } // if/else
+
+        // Adjust to the interval selected by the binary search: the
+        // last interval starting at or below the target.
+        while (indexL > 0 && target < vals[indexL]) {
+            --indexL;
+        } // while
+        while (indexL < indexMax && target >= vals[indexL+1]) {
+            ++indexL;
+        } // while
+        const size_t indexR = indexL + 1;
+        assert(target >= vals[indexL]-tolerance);
+        assert(vals[indexR] > vals[indexL]);
+        index = double(indexL) + (target - vals[indexL]) / (vals[indexR] - vals[indexL]);
+    } else if (_queryType == NEAREST) {
+        if (target <= vals[0]) {
+            index = 0.0;
+        } else {
+            index = double(nvals-1);
+        } // if/else
+    } // if/else
+
+    return index;
+} // _search
+
+
+// ----------------------------------------------------------------------
+// Build lookup table for ordered coordinates along an axis.
+void
+spatialdata::spatialdb::SimpleGridDB::_buildLookup(AxisLookup* lookup,
+                                                   const double* vals,
+                                                   const size_t nvals) {
+    assert(lookup);
+
+    lookup->buckets.clear();
+    lookup->origin = 0.0;
+    lookup->scale = 0.0;
+    lookup->size = 0;
+    if (!vals || (nvals < 2) || !(vals[nvals-1] > vals[0])) {
+        return;
+    } // if
+
+    const double origin = vals[0];
+    const double range = vals[nvals-1] - vals[0];
+    const size_t numIntervals = nvals - 1;
+    const double dx = range / numIntervals;
+
+    // Uniform spacing: interval is computed directly.
+    const double tolerance = 1.0e-6;
+    bool isUniform = true;
+    for (size_t i = 1; i < nvals && isUniform; ++i) {
+        isUniform = std::fabs(vals[i] - (origin + i*dx)) <= tolerance*dx;
+    } // for
+
+    lookup->origin = origin;
+    if (isUniform) {
+        lookup->scale = numIntervals / range;
+    } else {
+        // Twice as many buckets as intervals, so most buckets
+        // overlap only one or two intervals.
+        const size_t numBuckets = 2*numIntervals;
+        lookup->scale = numBuckets / range;
+        lookup->buckets.resize(numBuckets+1);
+        size_t indexL = 0;
+        for (size_t iBucket = 0; iBucket <= numBuckets; ++iBucket) {
+            const double x = origin + iBucket / lookup->scale;
+            while (indexL < numIntervals-1 && vals[indexL+1] <= x) {
+                ++indexL;
+            } // while
+            lookup->buckets[iBucket] = indexL;
+        } // for
+    } // if/else
+    lookup->size = nvals;
+} // _buildLookup
+
+
+// ----------------------------------------------------------------------
+// Build lookup tables for all axes.
+void
+spatialdata::spatialdb::SimpleGridDB::_buildLookups(void) {
+    _buildLookup(&_lookupX, _x, _numX);
+    _buildLookup(&_lookupY, _y, _numY);
+    _buildLookup(&_lookupZ, _z, _numZ);
+} // _buildLookups
+
+
 // ----------------------------------------------------------------------
 // Interpolate to get values at target location defined by indices in 1-D.
+template<typename T, typename D>
 void
-spatialdata::spatialdb::SimpleGridDB::_interpolate1D(double* vals,
+spatialdata::spatialdb::SimpleGridDB::_interpolate1D(T* vals,
                                                      const size_t numVals,
+                                                     const D* data,
                                                      const double indexX,
                                                      const size_t numX) const {
     assert(numX >= 2);
@@ -627,14 +1550,14 @@ spatialdata::spatialdb::SimpleGridDB::_interpolate1D(double* vals,
 
     const size_t querySize = _querySize;
     for (size_t iVal = 0; iVal < querySize; ++iVal) {
-        const size_t qVal = _queryValues[iVal];
+        const size_t qVal = _queryOffsets[iVal];
         vals[iVal] =
-            wt000 * _data[index000+qVal] +
-            wt100 * _data[index100+qVal];
+            wt000 * data[index000+qVal] +
+            wt100 * data[index100+qVal];
 #if 0 // DEBUGGING
         std::cout << "val["<<iVal<<"]: " << vals[iVal]
-                  << ", wt000: " << wt000 << ", data: " << _data[index000+qVal]
-                  << ", wt100: " << wt100 << ", data: " << _data[index100+qVal]
+                  << ", wt000: " << wt000 << ", data: " << data[index000+qVal]
+                  << ", wt100: " << wt100 << ", data: " << data[index100+qVal]
                   << std::endl;
 #endif
     } // for
@@ -644,9 +1567,11 @@ spatialdata::spatialdb::SimpleGridDB::_interpolate1D(double* vals,
 
 // ----------------------------------------------------------------------
 // Interpolate to get values at target location defined by indices in 2-D.
+template<typename T, typename D>
 void
-spatialdata::spatialdb::SimpleGridDB::_interpolate2D(double* vals,
+spatialdata::spatialdb::SimpleGridDB::_interpolate2D(T* vals,
                                                      const size_t numVals,
+                                                     const D* data,
                                                      const double indexX,
                                                      const size_t numX,
                                                      const double indexY,
@@ -679,18 +1604,18 @@ spatialdata::spatialdb::SimpleGridDB::_interpolate2D(double* vals,
 
     const size_t querySize = _querySize;
     for (size_t iVal = 0; iVal < querySize; ++iVal) {
-        const size_t qVal = _queryValues[iVal];
+        const size_t qVal = _queryOffsets[iVal];
         vals[iVal] =
-            wt000 * _data[index000+qVal] +
-            wt010 * _data[index010+qVal] +
-            wt100 * _data[index100+qVal] +
-            wt110 * _data[index110+qVal];
+            wt000 * data[index000+qVal] +
+            wt010 * data[index010+qVal] +
+            wt100 * data[index100+qVal] +
+            wt110 * data[index110+qVal];
 #if 0 // DEBUGGING
         std::cout << "val["<<iVal<<"]: " << vals[iVal]
-                  << ", wt000: " << wt000 << ", data: " << _data[index000+qVal]
-                  << ", wt010: " << wt010 << ", data: " << _data[index010+qVal]
-                  << ", wt100: " << wt100 << ", data: " << _data[index100+qVal]
-                  << ", wt110: " << wt110 << ", data: " << _data[index110+qVal]
+                  << ", wt000: " << wt000 << ", data: " << data[index000+qVal]
+                  << ", wt010: " << wt010 << ", data: " << data[index010+qVal]
+                  << ", wt100: " << wt100 << ", data: " << data[index100+qVal]
+                  << ", wt110: " << wt110 << ", data: " << data[index110+qVal]
                   << std::endl;
 #endif
     } // for
@@ -700,9 +1625,11 @@ spatialdata::spatialdb::SimpleGridDB::_interpolate2D(double* vals,
 
 // ----------------------------------------------------------------------
 // Interpolate to get values at target location defined by indices in 3-D.
+template<typename T, typename D>
 void
-spatialdata::spatialdb::SimpleGridDB::_interpolate3D(double* vals,
+spatialdata::spatialdb::SimpleGridDB::_interpolate3D(T* vals,
                                                      const size_t numVals,
+                                                     const D* data,
                                                      const double indexX,
                                                      const double indexY,
                                                      const double indexZ) const {
@@ -754,26 +1681,26 @@ spatialdata::spatialdb::SimpleGridDB::_interpolate3D(double* vals,
 
     const size_t querySize = _querySize;
     for (size_t iVal = 0; iVal < querySize; ++iVal) {
-        const size_t qVal = _queryValues[iVal];
+        const size_t qVal = _queryOffsets[iVal];
         vals[iVal] =
-            wt000 * _data[index000+qVal] +
-            wt001 * _data[index001+qVal] +
-            wt010 * _data[index010+qVal] +
-            wt011 * _data[index011+qVal] +
-            wt100 * _data[index100+qVal] +
-            wt101 * _data[index101+qVal] +
-            wt110 * _data[index110+qVal] +
-            wt111 * _data[index111+qVal];
+            wt000 * data[index000+qVal] +
+            wt001 * data[index001+qVal] +
+            wt010 * data[index010+qVal] +
+            wt011 * data[index011+qVal] +
+            wt100 * data[index100+qVal] +
+            wt101 * data[index101+qVal] +
+            wt110 * data[index110+qVal] +
+            wt111 * data[index111+qVal];
 #if 0 // DEBUGGING
         std::cout << "val["<<iVal<<"]: " << vals[iVal]
-                  << ", wt000: " << wt000 << ", data: " << _data[index000+qVal]
-                  << ", wt001: " << wt001 << ", data: " << _data[index001+qVal]
-                  << ", wt010: " << wt010 << ", data: " << _data[index010+qVal]
-                  << ", wt011: " << wt011 << ", data: " << _data[index011+qVal]
-                  << ", wt100: " << wt100 << ", data: " << _data[index100+qVal]
-                  << ", wt101: " << wt101 << ", data: " << _data[index101+qVal]
-                  << ", wt110: " << wt110 << ", data: " << _data[index110+qVal]
-                  << ", wt111: " << wt111 << ", data: " << _data[index111+qVal]
+                  << ", wt000: " << wt000 << ", data: " << data[index000+qVal]
+                  << ", wt001: " << wt001 << ", data: " << data[index001+qVal]
+                  << ", wt010: " << wt010 << ", data: " << data[index010+qVal]
+                  << ", wt011: " << wt011 << ", data: " << data[index011+qVal]
+                  << ", wt100: " << wt100 << ", data: " << data[index100+qVal]
+                  << ", wt101: " << wt101 << ", data: " << data[index101+qVal]
+                  << ", wt110: " << wt110 << ", data: " << data[index110+qVal]
+                  << ", wt111: " << wt111 << ", data: " << data[index111+qVal]
                   << std::endl;
 #endif
     } // for
@@ -873,17 +1800,17 @@ spatialdata::spatialdb::SimpleGridDB::_getDataIndex(const double* const coords,
     size_t size1 = 0;
     size_t size2 = 0;
     if (spaceDim > 2) {
-        index0 = std::floor(_search(coords[0], _x, _numX)+0.5);
-        index1 = std::floor(_search(coords[1], _y, _numY)+0.5);
-        index2 = std::floor(_search(coords[2], _z, _numZ)+0.5);
+        index0 = std::floor(_search(coords[0], _x, _numX, _lookupX)+0.5);
+        index1 = std::floor(_search(coords[1], _y, _numY, _lookupY)+0.5);
+        index2 = std::floor(_search(coords[2], _z, _numZ, _lookupZ)+0.5);
         _reindex3d(&index0, &size0, &index1, &size1, &index2, &size2);
     } else if (spaceDim > 1) {
-        index0 = std::floor(_search(coords[0], _x, _numX)+0.5);
-        index1 = std::floor(_search(coords[1], _y, _numY)+0.5);
+        index0 = std::floor(_search(coords[0], _x, _numX, _lookupX)+0.5);
+        index1 = std::floor(_search(coords[1], _y, _numY, _lookupY)+0.5);
         _reindex2d(&index0, &size0, &index1, &size1);
     } else {
         assert(1 == spaceDim);
-        index0 = std::floor(_search(coords[0], _x, _numX)+0.5);
+        index0 = std::floor(_search(coords[0], _x, _numX, _lookupX)+0.5);
     } // if
 
     const size_t indexData = _getDataIndex(size_t(index0), size0, size_t(index1), size1, size_t(index2), size2);
@@ -891,4 +1818,42 @@ spatialdata::spatialdb::SimpleGridDB::_getDataIndex(const double* const coords,
 } // _getDataIndex
 
 
+// ----------------------------------------------------------------------
+// Get number of leading locations that match grid points in order.
+size_t
+spatialdata::spatialdb::SimpleGridDB::_getNumOrdered(const double* coords,
+                                                     const size_t numLocs,
+                                                     const size_t spaceDim) const {
+    const size_t numX = _numX;
+    const size_t numY = (spaceDim > 1) ? _numY : 1;
+    const size_t numZ = (spaceDim > 2) ? _numZ : 1;
+    // Axes with a single point match any coordinate, consistent with _search().
+    const bool checkX = numX > 1;
+    const bool checkY = numY > 1;
+    const bool checkZ = numZ > 1;
+    if (!coords || (checkX && !_x) || (checkY && !_y) || (checkZ && !_z)) {
+        return 0;
+    } // if
+
+    size_t iLoc = 0;
+    for (size_t iZ = 0; iZ < numZ; ++iZ) {
+        for (size_t iY = 0; iY < numY; ++iY) {
+            for (size_t iX = 0; iX < numX; ++iX, ++iLoc) {
+                if (iLoc >= numLocs) {
+                    return iLoc;
+                } // if
+                const double* xyz = &coords[iLoc*spaceDim];
+                if ((checkX && (xyz[0] != _x[iX])) ||
+                    (checkY && (xyz[1] != _y[iY])) ||
+                    (checkZ && (xyz[2] != _z[iZ]))) {
+                    return iLoc;
+                } // if
+            } // for
+        } // for
+    } // for
+
+    return iLoc;
+} // _getNumOrdered
+
+
 // End of file
@@ -26,11 +26,15 @@
 #include "SpatialDB.hh" // ISA SpatialDB
 
 #include <string> // HASA std::string
+#include <vector> // HASA std::vector
 
 class spatialdata::spatialdb::SimpleGridDB : public SpatialDB { // SimpleGridDB
     friend class TestSimpleGridDB; // unit testing
     friend class TestSimpleGridAscii;
+    friend class TestSimpleGridBinary;
     friend class SimpleGridAscii; // reader
+    friend class SimpleGridBinary; // reader
+    friend class OctreeGridDB; // converter
 
 public:
 
@@ -42,6 +46,25 @@ public:
         LINEAR=1, ///< Linear interpolation.
     };
 
+    /** Precision of stored values */
+    enum PrecisionEnum {
+        DOUBLE=0, ///< Store values in double precision.
+        SINGLE=1, ///< Store values in single precision.
+    };
+
+    /** Layout of stored values */
+    enum LayoutEnum {
+        FLAT=0, ///< Points ordered with x fastest, then y, then z.
+        BRICK=1, ///< Points grouped in bricks of 8x8x8 points.
+    };
+
+    /** Compression of stored values */
+    enum CompressionEnum {
+        UNCOMPRESSED=0, ///< Values are not compressed.
+        LOSSLESS=1, ///< Values are compressed without loss.
+        LOSSY=2, ///< Values are compressed within a tolerance.
+    };
+
     // PUBLIC MEMBERS ///////////////////////////////////////////////////////
 public:
 
@@ -65,7 +88,140 @@ public:
      */
     void setQueryType(const QueryEnum queryType);
 
-    /// Open the database and prepare for querying.
+    /** Set precision of stored values.
+     *
+     * Storing values in single precision halves the memory and memory
+     * bandwidth used by the values; interpolation is still done in
+     * double precision. Values read from ASCII files are converted
+     * after reading. Binary files keep the precision of the values in
+     * the file. SimpleGridBinary::write() writes values with this
+     * precision.
+     *
+     * @pre Must call before open().
+     *
+     * @param value Precision of stored values.
+     */
+    void setPrecision(const PrecisionEnum value);
+
+    /** Set layout of stored values.
+     *
+     * The brick layout groups the points of 3-D grids into bricks of
+     * 8x8x8 points with the points in each brick in Morton order, so
+     * the eight corners of a cell are usually within a few cache lines
+     * and queries that move along y or z stay within the same pages.
+     * The layout is built when the database is opened; values in
+     * memory-mapped binary files are copied. Grids with lower data
+     * dimensions always use the flat layout.
+     *
+     * @pre Must call before open().
+     *
+     * @param value Layout of stored values.
+     */
+    void setLayout(const LayoutEnum value);
+
+    /** Set maximum size of cache of chunks of values for out-of-core
+     * queries.
+     *
+     * If the size is positive, the values in a binary file with the
+     * brick layout are not loaded when the database is opened; queries
+     * read the bricks of values they need from the file into a
+     * least-recently-used cache holding at most this many bytes (and
+     * at least eight bricks). Queries of databases using the cache are
+     * not thread safe. With compressed values, the cache holds
+     * decompressed blocks instead (see setCompression()).
+     *
+     * @pre Must call before open().
+     *
+     * @param value Maximum size in bytes of cache (0 to load all values).
+     */
+    void setCacheSize(const size_t value);
+
+    /** Set whether processes on the same node share coordinates and
+     * values in shared memory.
+     *
+     * The first process to open an ASCII file reads it into a POSIX
+     * shared-memory segment; the other processes opening the same file
+     * with the same precision and layout wait for it and then use the
+     * segment read-only instead of reading the file. The segment is
+     * removed when the last process closes the database. Binary files
+     * are memory-mapped, so they are already shared through the
+     * operating system's file cache.
+     *
+     * @pre Must call before open().
+     *
+     * @param value True to share values in shared memory, false otherwise.
+     */
+    void setSharedMemory(const bool value);
+
+    /** Set number of threads used to parse values in ASCII files.
+     *
+     * Under MPI with one process per core, keep the default of one
+     * thread so that opening the database does not oversubscribe the
+     * node.
+     *
+     * @pre Must call before open().
+     *
+     * @param value Number of threads (0 to use number of cores).
+     */
+    void setNumReaderThreads(const size_t value);
+
+    /** Set compression of stored values.
+     *
+     * Compressed values are split into blocks of 512 points (the
+     * bricks of 3-D grids, which always use the brick layout when
+     * compressed, or runs of consecutive points for lower data
+     * dimensions) that are compressed independently. Queries
+     * decompress the blocks they need into a least-recently-used cache
+     * holding at most the number of bytes set by setCacheSize() (and at
+     * least eight blocks). Queries of databases with compressed values
+     * are not thread safe. Compressed values cannot be shared in shared
+     * memory.
+     *
+     * @pre Must call before open().
+     *
+     * @param value Compression of stored values.
+     */
+    void setCompression(const CompressionEnum value);
+
+    /** Set tolerance for lossy compression.
+     *
+     * @pre Must call before open().
+     *
+     * @param value Maximum error of each value relative to the range of
+     *   the value over the grid.
+     */
+    void setCompressionTolerance(const double value);
+
+    /** Get size of compressed values.
+     *
+     * @returns Size in bytes of compressed values (0 if values are not
+     *   compressed).
+     */
+    size_t getCompressedSize(void) const;
+
+    /** Get number of queries of values in chunks held in cache.
+     *
+     * @returns Number of hits (0 if cache is not used).
+     */
+    size_t getCacheHits(void) const;
+
+    /** Get number of queries of values in chunks read from file.
+     *
+     * @returns Number of misses (0 if cache is not used).
+     */
+    size_t getCacheMisses(void) const;
+
+    /** Get number of chunks evicted from cache.
+     *
+     * @returns Number of evictions (0 if cache is not used).
+     */
+    size_t getCacheEvictions(void) const;
+
+    /** Open the database and prepare for querying.
+     *
+     * Binary files (written by SimpleGridBinary) are memory-mapped;
+     * other files are read as ASCII files.
+     */
     void open(void);
 
     /// Close the database.
@@ -80,6 +236,19 @@ public:
                           size_t* numValues) const;
 
     /** Set values to be returned by queries.
+     *
+     * When only a subset of the values is returned by queries, the
+     * values are rearranged so each value is stored contiguously
+     * (value-major order) and queries load only the values they
+     * use. Values in memory-mapped binary files keep the order in the
+     * file.
+     *
+     * The values are rearranged in place whenever queries switch
+     * between a subset and all of the values. Each switch allocates a
+     * temporary buffer holding one value at every grid point (the size
+     * of the values divided by the number of values), and its cost
+     * grows with the square of the number of values, so avoid
+     * alternating between a subset and all of the values.
      *
      * @pre Must call open() before setQueryValues()
      *
@@ -110,6 +279,63 @@ public:
               const size_t numDims,
               const spatialdata::geocoords::CoordSys* pCSQuery);
 
+    /** Can the database be queried concurrently?
+     *
+     * The grid is not modified by queries, except for the cache of
+     * chunks of values for out-of-core queries.
+     *
+     * @returns True if queryBatch() may be called concurrently using
+     *   separate query contexts, false otherwise.
+     */
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
+    /** Query the database at multiple locations with single precision
+     * values and coordinates.
+     *
+     * Values are interpolated directly into the single precision array.
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    float* vals,
+                    const size_t numVals,
+                    int* err,
+                    const float* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
     /** Allocate room for data.
      *
      * @param numX Number of locations along x-axis.
@@ -188,12 +414,194 @@ public:
      */
     void setCoordSys(const geocoords::CoordSys& cs);
 
+    // PRIVATE STRUCTS //////////////////////////////////////////////////////
+private:
+
+    /** Lookup table for locating the grid interval containing a
+     * coordinate without a binary search.
+     *
+     * For uniformly spaced coordinates the interval is computed
+     * directly. Otherwise the range of coordinates is divided into
+     * equal buckets and the table holds the interval containing the
+     * start of each bucket.
+     */
+    struct AxisLookup {
+        std::vector<size_t> buckets; ///< Interval containing start of each bucket (empty if uniform).
+        double origin; ///< First coordinate.
+        double scale; ///< Number of intervals (uniform) or buckets per unit length.
+        size_t size; ///< Number of coordinates (0 if lookup table is not available).
+    }; // AxisLookup
+
     // PRIVATE METHODS //////////////////////////////////////////////////////
 private:
 
     /// Check compatibility of spatial database parameters.
     void _checkCompatibility(void) const;
 
+    /// Deallocate (or unmap) coordinates and values.
+    void _deallocate(void);
+
+    /// Read ASCII file and convert values to SI units.
+    void _readAscii(void);
+
+    /// Arrange values in storage selected for queries.
+    void _arrangeData(void);
+
+    /// Compress values and set up cache of decompressed blocks.
+    void _compressValues(void);
+
+    /// Copy coordinates and release memory-mapped file.
+    void _releaseMapping(void);
+
+    /** Arrange values in interleaved or value-major order for the
+     * values returned by queries and set offsets of query values.
+     */
+    void _arrangeValues(void);
+
+    /** Transpose values in place between interleaved and value-major
+     * order.
+     *
+     * Uses a temporary buffer with one value at every point.
+     *
+     * @param data Array of values.
+     * @param numPoints Number of points in array of values.
+     * @param toValueMajor True if transposing to value-major order, false
+     *   if transposing to interleaved order.
+     */
+    template<typename D>
+    void _transposeValues(D* data,
+                          const size_t numPoints,
+                          const bool toValueMajor) const;
+
+    /** Get number of points in array of values.
+     *
+     * @returns Number of points, including points padding bricks.
+     */
+    size_t _getNumPoints(void) const;
+
+    /// Build offsets of points along each axis for brick layout.
+    void _buildBricks(void);
+
+    /** Copy values from flat layout to brick layout.
+     *
+     * @param data Array of values in flat layout.
+     * @returns Array of values in brick layout.
+     */
+    template<typename D>
+    D* _copyToBricks(const D* data) const;
+
+    /** Spread bits of index of point within brick for Morton order.
+     *
+     * @param index Index of point along axis within brick.
+     * @returns Index with two zero bits inserted after each bit.
+     */
+    static
+    size_t _spreadBits(const size_t index);
+
+    /** Compact bits of Morton index of point within brick.
+     *
+     * @param index Morton index of point within brick.
+     * @returns Index along axis from every third bit of Morton index.
+     */
+    static
+    size_t _compactBits(const size_t index);
+
+    /** Check number of values and spatial dimension of query.
+     *
+     * @param numVals Number of values expected.
+     * @param numDims Number of dimensions for coordinates.
+     */
+    void _checkQuery(const size_t numVals,
+                     const size_t numDims) const;
+
+    /** Query the database at multiple locations in coordinate system of
+     * database.
+     *
+     * Linear interpolation is done for blocks of locations at once.
+     *
+     * @param vals Array for computed values (output from query) [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param xyz Coordinates of locations in coordinate system of database [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     */
+    template<typename T>
+    void _queryBlock(T* vals,
+                     const size_t numVals,
+                     int* err,
+                     const double* xyz,
+                     const size_t numLocs,
+                     const size_t numDims) const;
+
+    /** Interpolate values at multiple locations in coordinate system
+     * of database.
+     *
+     * @param vals Array for computed values (output from query) [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param xyz Coordinates of locations in coordinate system of database [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param data Array of values at grid points.
+     */
+    template<typename T, typename D>
+    void _interpolateBlock(T* vals,
+                           const size_t numVals,
+                           int* err,
+                           const double* xyz,
+                           const size_t numLocs,
+                           const size_t numDims,
+                           const D* data) const;
+
+    /** Query the database at location in coordinate system of database.
+     *
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling query().
+     * @param numVals Number of values expected (size of pVals array)
+     * @param xyz Coordinates of location in coordinate system of database.
+     *
+     * @returns 0 on success, 1 on failure (i.e., could not interpolate)
+     */
+    template<typename T>
+    int _queryPoint(T* vals,
+                    const size_t numVals,
+                    const double* xyz) const;
+
+    /** Query the database at location in coordinate system of database
+     * using values in cache of chunks.
+     *
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling query().
+     * @param xyz Coordinates of location in coordinate system of database.
+     *
+     * @returns 0 on success, 1 on failure (i.e., could not interpolate)
+     */
+    template<typename T, typename D>
+    int _queryCached(T* vals,
+                     const double* xyz) const;
+
+    /** Get fractional indices of location in grid, adjusted for lower
+     * dimension distributions.
+     *
+     * @param index Fractional index along each dimension [output].
+     * @param size Number of grid points along each dimension [output].
+     * @param xyz Coordinates of location in coordinate system of database.
+     */
+    void _getIndices(double index[3],
+                     size_t size[3],
+                     const double* xyz) const;
+
+    /** Check whether fractional indices are inside grid for linear
+     * interpolation.
+     *
+     * @param index Fractional index along each dimension.
+     * @param size Number of grid points along each dimension.
+     * @returns True if inside grid, false otherwise.
+     */
+    bool _isInside(const double index[3],
+                   const size_t size[3]) const;
+
     /** Bilinear search for coordinate.
      *
      * Returns index of target as a double.
@@ -206,17 +614,51 @@ private:
                    const double* vals,
                    const size_t nvals) const;
 
+    /** Search for coordinate using lookup table.
+     *
+     * Returns the same index as the binary search, but locates the
+     * interval containing the target using the lookup table for the
+     * axis. Falls back to the binary search if the lookup table is
+     * not available.
+     *
+     * @param target Coordinates of target.
+     * @param vals Array of ordered values to search.
+     * @param nvals Number of values.
+     * @param lookup Lookup table for values.
+     */
+    double _search(const double target,
+                   const double* vals,
+                   const size_t nvals,
+                   const AxisLookup& lookup) const;
+
+    /** Build lookup table for ordered coordinates along an axis.
+     *
+     * @param lookup Lookup table [output].
+     * @param vals Array of ordered values.
+     * @param nvals Number of values.
+     */
+    static
+    void _buildLookup(AxisLookup* lookup,
+                      const double* vals,
+                      const size_t nvals);
+
+    /// Build lookup tables for all axes.
+    void _buildLookups(void);
+
     /** Interpolate in 1-D to get values at target location defined by
      * indices.
      *
      * @param vals Array for computed values (output from query), must be
      *   allocated BEFORE calling query().
      * @param numVals Number of values expected (size of pVals array)
+     * @param data Array of values at grid points.
      * @param indexX Index along x dimension.
      * @param numX Number of coordinates along x dimension.
      */
-    void _interpolate1D(double* vals,
+    template<typename T, typename D>
+    void _interpolate1D(T* vals,
                         const size_t numVals,
+                        const D* data,
                         const double indexX,
                         const size_t numX) const;
 
@@ -226,13 +668,16 @@ private:
      * @param vals Array for computed values (output from query), must be
      *   allocated BEFORE calling query().
      * @param numVals Number of values expected (size of pVals array)
+     * @param data Array of values at grid points.
      * @param indexX Index along x dimension.
      * @param numX Number of coordinates along x dimension.
      * @param indexY Index along y dimension.
      * @param numY Number of coordinates along y dimension.
      */
-    void _interpolate2D(double* vals,
+    template<typename T, typename D>
+    void _interpolate2D(T* vals,
                         const size_t numVals,
+                        const D* data,
                         const double indexX,
                         const size_t numX,
                         const double indexY,
@@ -244,12 +689,15 @@ private:
      * @param vals Array for computed values (output from query), must be
      *   allocated BEFORE calling query().
      * @param numVals Number of values expected (size of pVals array)
+     * @param data Array of values at grid points.
      * @param indexX Index along x dimension.
      * @param indexY Index along y dimension.
      * @param indexZ Index along z dimension.
      */
-    void _interpolate3D(double* vals,
+    template<typename T, typename D>
+    void _interpolate3D(T* vals,
                         const size_t numVals,
+                        const D* data,
                         const double indexX,
                         const double indexY,
                         const double indexZ) const;
@@ -312,17 +760,56 @@ private:
     size_t _getDataIndex(const double* const coords,
                          const size_t spaceDim) const;
 
+    /** Get index into data array.
+     *
+     * @param indexLoc Index of point with points ordered with x
+     *   fastest, then y, then z.
+     *
+     * @returns Index into data array.
+     */
+    size_t _getDataIndex(const size_t indexLoc) const;
+
+    /** Get number of leading locations that coincide with the grid
+     * points ordered with x fastest, then y, then z.
+     *
+     * @param coords Coordinates of locations.
+     * @param numLocs Number of locations.
+     * @param spaceDim Coordinate dimension.
+     *
+     * @returns Number of locations before the first one out of order.
+     */
+    size_t _getNumOrdered(const double* coords,
+                          const size_t numLocs,
+                          const size_t spaceDim) const;
+
     // PRIVATE MEMBERS //////////////////////////////////////////////////////
 private:
 
-    double* _data; ///< Array of data values.
+    double* _data; ///< Array of data values (NULL if stored in single precision).
+    float* _dataF; ///< Array of data values in single precision (NULL if stored in double precision).
     double* _x; ///< Array of x coordinates.
     double* _y; ///< Array of y coordinates.
     double* _z; ///< Array of z coordinates.
-
-    double _xyz[3];
+    AxisLookup _lookupX; ///< Lookup table for x coordinates.
+    AxisLookup _lookupY; ///< Lookup table for y coordinates.
+    AxisLookup _lookupZ; ///< Lookup table for z coordinates.
+    void* _mapping; ///< Memory-mapped file holding coordinates and values (NULL if allocated).
+    size_t _mappingSize; ///< Size of memory-mapped file.
+    std::vector<size_t> _brickX; ///< Offset in data array of points along x axis (empty for flat layout).
+    std::vector<size_t> _brickY; ///< Offset in data array of points along y axis (empty for flat layout).
+    std::vector<size_t> _brickZ; ///< Offset in data array of points along z axis (empty for flat layout).
+    bool _valueMajor; ///< True if each value is stored contiguously, false if values are interleaved.
+    size_t _valueStride; ///< Stride in data array between values at a point.
+    GridChunkCache* _cache; ///< Cache of bricks of values for out-of-core queries (NULL if values are loaded).
+    size_t _cacheSize; ///< Maximum size in bytes of cache of bricks of values.
+    GridSharedMemory* _shared; ///< Shared memory segment holding coordinates and values (NULL if not shared).
+    bool _sharedMemory; ///< True if coordinates and values are shared with other processes.
+    size_t _numReaderThreads; ///< Number of threads used to parse values in ASCII files.
+    GridCompressedBlocks* _compressed; ///< Compressed blocks of values (NULL if not compressed).
+    double _compressionTolerance; ///< Tolerance for lossy compression relative to range of each value.
 
     size_t* _queryValues; ///< Indices of values to be returned in queries.
+    std::vector<size_t> _queryOffsets; ///< Offsets in data array of values returned in queries relative to point.
     size_t _querySize; ///< Number of values requested to be returned in queries.
 
     size_t _numX; ///< Number of points along x dimension.
@@ -337,11 +824,14 @@ private:
 
     std::string _filename; ///< Filename of data file
     geocoords::CoordSys* _cs; ///< Coordinate system
-    spatialdata::geocoords::Converter* _converter; /// Convert query points to local coordinate system.
 
     QueryEnum _queryType; ///< Query type
+    PrecisionEnum _precision; ///< Precision of stored values.
+    LayoutEnum _layout; ///< Layout of stored values.
+    CompressionEnum _compression; ///< Compression of stored values.
 
     static const char* FILEHEADER;
+    static const size_t _brickSize; ///< Number of points along each axis of a brick.
 
     // NOT IMPLEMENTED //////////////////////////////////////////////////////
 private:
@@ -27,6 +27,7 @@
 #include "spatialdata/geocoords/CSPicklerAscii.hh" // USES CSPicklerAscii
 
 #include "spatialdata/utils/LineParser.hh" // USES LineParser
+#include "spatialdata/utils/DataParser.hh" // USES DataParser
 
 #include <fstream> // USES std::ofstream, std::ifstream
 #include <iomanip> // USES setw(), setiosflags(), resetiosflags()
@@ -42,6 +43,20 @@
 const char* spatialdata::spatialdb::SimpleIOAscii::HEADER =
     "#SPATIAL.ascii";
 
+// ----------------------------------------------------------------------
+// Default constructor.
+spatialdata::spatialdb::SimpleIOAscii::SimpleIOAscii(void) :
+    _numReaderThreads(1) {}
+
+
+// ----------------------------------------------------------------------
+// Set number of threads used to parse values.
+void
+spatialdata::spatialdb::SimpleIOAscii::setNumReaderThreads(const size_t value) {
+    _numReaderThreads = value;
+} // setNumReaderThreads
+
+
 // ----------------------------------------------------------------------
 // Read ascii database file.
 void
@@ -82,7 +97,7 @@ spatialdata::spatialdb::SimpleIOAscii::read(SimpleDBData* pData,
         buffer >> version;
         switch (version) { // switch
         case 1:
-            _readV1(pData, ppCS, filein);
+            _readV1(pData, ppCS, filein, _numReaderThreads);
             break;
         default:
         { // default
@@ -93,7 +108,7 @@ spatialdata::spatialdb::SimpleIOAscii::read(SimpleDBData* pData,
             throw std::runtime_error(msg.str());
         } // default
         } // switch
-        if (!filein.good()) {
+        if (filein.bad()) {
             throw std::runtime_error("Unknown error while reading.");
         }
     } catch (const std::exception& err) {
@@ -117,7 +132,8 @@ spatialdata::spatialdb::SimpleIOAscii::read(SimpleDBData* pData,
 void
 spatialdata::spatialdb::SimpleIOAscii::_readV1(SimpleDBData* pData,
                                                spatialdata::geocoords::CoordSys** ppCS,
-                                               std::istream& filein) { // ReadV1
+                                               std::istream& filein,
+                                               const size_t numThreads) { // ReadV1
     assert(pData);
     assert(ppCS);
 
@@ -246,32 +262,32 @@ spatialdata::spatialdb::SimpleIOAscii::_readV1(SimpleDBData* pData,
     delete[] cnames;cnames = NULL;
     delete[] cunits;cunits = NULL;
 
+    // Lines are read in large blocks and parsed concurrently.
+    const size_t numFields = spaceDim + numValues;
+    utils::DataParser dataParser(filein, "//", numFields, numLocs, numThreads);
     int count = 0;
-    for (int iLoc = 0; iLoc < numLocs; ++iLoc, ++count) {
-        buffer.str(parser.next());
-        buffer.clear();
-        double* coordinates = pData->getCoordinates(iLoc);
-        for (int iDim = 0; iDim < spaceDim; ++iDim) {
-            if (!buffer.good()) {
-                std::ostringstream msg;
-                msg << "Read data for " << count << " out of " << numLocs << " points.\n"
-                    << "Error reading coordinates from buffer '" << buffer.str() << "'.";
-                throw std::runtime_error(msg.str());
-            } // if
-            buffer >> coordinates[iDim];
-        } // for
-        double* data = pData->getData(iLoc);
-        for (int iVal = 0; iVal < numValues; ++iVal) {
-            if (!buffer.good()) {
-                std::ostringstream msg;
-                msg << "Read data for " << count << " out of " << numLocs << " points.\n"
-                    << "Error reading data from buffer '" << buffer.str() << "'.";
-                throw std::runtime_error(msg.str());
-            } // if
-            buffer >> data[iVal];
+    while (count < numLocs) {
+        const size_t numLines = dataParser.parse();
+        const double* fields = dataParser.getValues();
+        for (size_t iLine = 0; iLine < numLines; ++iLine, ++count) {
+            double* coordinates = pData->getCoordinates(count);
+            for (int iDim = 0; iDim < spaceDim; ++iDim) {
+                coordinates[iDim] = fields[iLine*numFields+iDim];
+            } // for
+            double* data = pData->getData(count);
+            for (int iVal = 0; iVal < numValues; ++iVal) {
+                data[iVal] = fields[iLine*numFields+spaceDim+iVal];
+            } // for
         } // for
-    } // for
-    if (!filein.good()) {
+        if (dataParser.hasError()) {
+            const char* field = (dataParser.getErrorNumValues() < size_t(spaceDim)) ? "coordinates" : "data";
+            std::ostringstream msg;
+            msg << "Read data for " << count << " out of " << numLocs << " points.\n"
+                << "Error reading " << field << " from buffer '" << dataParser.getErrorLine() << "'.";
+            throw std::runtime_error(msg.str());
+        } // if
+    } // while
+    if (!dataParser.hasEndOfLine() || filein.bad()) {
         std::ostringstream msg;
         msg << "I/O error while reading SimpleDB data. ";
         if (count < numLocs) {
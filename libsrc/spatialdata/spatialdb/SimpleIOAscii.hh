@@ -33,12 +33,23 @@ class spatialdata::spatialdb::SimpleIOAscii : public SimpleIO
 public :
   // PUBLIC METHODS /////////////////////////////////////////////////////
 
-  // Using default constructor.
+  /// Default constructor.
+  SimpleIOAscii(void);
   
   // Using default destructor.
 
   // Using default copy constructor
   
+  /** Set number of threads used to parse values.
+   *
+   * Under MPI with one process per core, keep the default of one
+   * thread so that opening the database does not oversubscribe the
+   * node.
+   *
+   * @param value Number of threads (0 to use number of cores).
+   */
+  void setNumReaderThreads(const size_t value);
+
   /** Clone object.
    *
    * @returns Pointer copy of this.
@@ -69,10 +80,12 @@ private :
    * @param pData Database data
    * @param ppCS Pointer to coordinate system
    * @param filein File input stream
+   * @param numThreads Number of threads used to parse values.
    */
   static void _readV1(SimpleDBData* pData,
 		      spatialdata::geocoords::CoordSys** ppCS,
-		      std::istream& filein);
+		      std::istream& filein,
+		      const size_t numThreads);
 
  private :
   // PRIVATE MEMBERS ////////////////////////////////////////////////////
@@ -80,6 +93,8 @@ private :
   /** Magic header in ascii files */
   static const char* HEADER;
 
+  size_t _numReaderThreads; ///< Number of threads used to parse values.
+
 }; // class SimpleIOAscii
 
 #include "SimpleIOAscii.icc" // inline methods
@@ -18,8 +18,13 @@
 
 #include "SpatialDB.hh" // Implementation of class methods
 
+#include "QueryContext.hh" // HOLDSA QueryContext
+
 #include <cassert> // USES assert()
 #include <vector> // USES std::vector
+#include <algorithm> // USES std::min(), std::max()
+#include <thread> // USES std::thread
+#include <exception> // USES std::exception_ptr
 
 // Include ios here to avoid some Python/gcc issues
 #include <ios>
@@ -29,21 +34,29 @@
 // ----------------------------------------------------------------------
 /// Default constructor
 spatialdata::spatialdb::SpatialDB::SpatialDB(void) :
-    _label("")
+    _label(""),
+    _queryContext(NULL),
+    _minChunkSize(512)
 {}
 
 
 // ----------------------------------------------------------------------
 /// Constructor with label
 spatialdata::spatialdb::SpatialDB::SpatialDB(const char* label) :
-    _label(label)
+    _label(label),
+    _queryContext(NULL),
+    _minChunkSize(512)
 {}
 
 
 // ----------------------------------------------------------------------
 /// Default destructor
-spatialdata::spatialdb::SpatialDB::~SpatialDB(void)
-{}
+spatialdata::spatialdb::SpatialDB::~SpatialDB(void) {
+    delete _queryContext;_queryContext = NULL;
+    for (size_t i = 0; i < _threadContexts.size(); ++i) {
+        delete _threadContexts[i];_threadContexts[i] = NULL;
+    } // for
+} // destructor
 
 
 // ----------------------------------------------------------------------
@@ -54,24 +67,72 @@ spatialdata::spatialdb::SpatialDB::query(float* vals,
                                          const float* coords,
                                          const size_t numDims,
                                          const spatialdata::geocoords::CoordSys* csQuery) {
-    double* coordsD = (numDims > 0) ? new double[numDims] : NULL;
-    for (size_t i = 0; i < numDims; ++i) {
-        coordsD[i] = coords[i];
-    } // for
+    int err = 0;
+    queryBatch(_getQueryContext(), vals, numVals, &err, coords, 1, numDims, csQuery);
+
+    return err;
+} // query
+
 
-    double* valsD = (numVals > 0) ? new double[numVals] : NULL;
+// ----------------------------------------------------------------------
+// Can database be queried concurrently using separate query contexts?
+bool
+spatialdata::spatialdb::SpatialDB::isThreadSafe(void) const {
+    return false;
+} // isThreadSafe
 
-    const int err = query(valsD, numVals, coordsD, numDims, csQuery);
 
-    for (size_t i = 0; i < numVals; ++i) {
-        vals[i] = valsD[i];
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::SpatialDB::queryBatch(QueryContext* context,
+                                              double* vals,
+                                              const size_t numVals,
+                                              int* err,
+                                              const double* coords,
+                                              const size_t numLocs,
+                                              const size_t numDims,
+                                              const spatialdata::geocoords::CoordSys* csQuery) {
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        err[iLoc] = query(&vals[iLoc*numVals], numVals, &coords[iLoc*numDims], numDims, csQuery);
     } // for
+} // queryBatch
 
-    delete[] valsD;valsD = NULL;
-    delete[] coordsD;coordsD = NULL;
 
-    return err;
-} // query
+// ----------------------------------------------------------------------
+// Query the database at multiple locations with single precision
+// values and coordinates.
+void
+spatialdata::spatialdb::SpatialDB::queryBatch(QueryContext* context,
+                                              float* vals,
+                                              const size_t numVals,
+                                              int* err,
+                                              const float* coords,
+                                              const size_t numLocs,
+                                              const size_t numDims,
+                                              const spatialdata::geocoords::CoordSys* csQuery) {
+    assert(context);
+
+    // Convert blocks of locations to double precision and query each
+    // block as a batch.
+    const size_t blockSize = 1024;
+    std::vector<double>& coordsD = context->coordsD;
+    std::vector<double>& valsD = context->valsD;
+    coordsD.resize(std::min(blockSize, numLocs)*numDims);
+    valsD.resize(std::min(blockSize, numLocs)*numVals);
+    for (size_t iLoc = 0; iLoc < numLocs; iLoc += blockSize) {
+        const size_t numLocsBlock = std::min(blockSize, numLocs-iLoc);
+        for (size_t i = 0; i < numLocsBlock*numDims; ++i) {
+            coordsD[i] = coords[iLoc*numDims+i];
+        } // for
+
+        queryBatch(context, valsD.data(), numVals, &err[iLoc], coordsD.data(), numLocsBlock, numDims, csQuery);
+
+        for (size_t i = 0; i < numLocsBlock*numVals; ++i) {
+            vals[iLoc*numVals+i] = valsD[i];
+        } // for
+    } // for
+} // queryBatch
 
 
 // ----------------------------------------------------------------------
@@ -85,7 +146,8 @@ spatialdata::spatialdb::SpatialDB::multiquery(double* vals,
                                               const double* coords,
                                               const size_t numLocsC,
                                               const size_t numDimsC,
-                                              const spatialdata::geocoords::CoordSys* csQuery) {
+                                              const spatialdata::geocoords::CoordSys* csQuery,
+                                              const size_t numThreads) {
     assert(numLocsV == numLocsE);
     assert(numLocsC == numLocsE);
     assert( (!vals && 0 == numLocsV && 0 == numValsV) ||
@@ -95,11 +157,7 @@ spatialdata::spatialdb::SpatialDB::multiquery(double* vals,
     assert( (!coords && 0 == numLocsC && 0 == numDimsC) ||
             (coords && numLocsC > 0 && numDimsC > 0) );
 
-    for (size_t i = 0, indexV = 0, indexC = 0;
-         i < numLocsV;
-         ++i, indexV += numValsV, indexC += numDimsC) {
-        err[i] = query(&vals[indexV], numValsV, &coords[indexC], numDimsC, csQuery);
-    } // for
+    _queryThreaded(vals, numValsV, err, coords, numLocsV, numDimsC, csQuery, numThreads);
 } // multiquery
 
 
@@ -114,7 +172,8 @@ spatialdata::spatialdb::SpatialDB::multiquery(float* vals,
                                               const float* coords,
                                               const size_t numLocsC,
                                               const size_t numDimsC,
-                                              const spatialdata::geocoords::CoordSys* csQuery) { // multiquery
+                                              const spatialdata::geocoords::CoordSys* csQuery,
+                                              const size_t numThreads) { // multiquery
     assert(numLocsV == numLocsE);
     assert(numLocsC == numLocsE);
     assert( (!vals && 0 == numLocsV && 0 == numValsV) ||
@@ -124,11 +183,7 @@ spatialdata::spatialdb::SpatialDB::multiquery(float* vals,
     assert( (!coords && 0 == numLocsC && 0 == numDimsC) ||
             (coords && numLocsC > 0 && numDimsC > 0) );
 
-    for (size_t i = 0, indexV = 0, indexC = 0;
-         i < numLocsV;
-         ++i, indexV += numValsV, indexC += numDimsC) {
-        err[i] = query(&vals[indexV], numValsV, &coords[indexC], numDimsC, csQuery);
-    } // for
+    _queryThreaded(vals, numValsV, err, coords, numLocsV, numDimsC, csQuery, numThreads);
 } // multiquery
 
 
@@ -163,4 +218,85 @@ spatialdata::spatialdb::SpatialDB::_convertToSI(double* vals,
 } // _convertToSI
 
 
+// ----------------------------------------------------------------------
+// Get query context used by query() and multiquery().
+spatialdata::spatialdb::QueryContext*
+spatialdata::spatialdb::SpatialDB::_getQueryContext(void) {
+    if (!_queryContext) {
+        _queryContext = new QueryContext;
+    } // if
+    return _queryContext;
+} // _getQueryContext
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations, splitting the locations
+// into chunks that are queried concurrently.
+template<typename T>
+void
+spatialdata::spatialdb::SpatialDB::_queryThreaded(T* vals,
+                                                  const size_t numVals,
+                                                  int* err,
+                                                  const T* coords,
+                                                  const size_t numLocs,
+                                                  const size_t numDims,
+                                                  const spatialdata::geocoords::CoordSys* csQuery,
+                                                  const size_t numThreads) {
+    size_t numChunks = (numThreads > 0) ? numThreads : std::thread::hardware_concurrency();
+    numChunks = std::min(numChunks, numLocs / std::max(_minChunkSize, size_t(1)));
+    if ((numChunks <= 1) || !isThreadSafe()) {
+        queryBatch(_getQueryContext(), vals, numVals, err, coords, numLocs, numDims, csQuery);
+        return;
+    } // if
+
+    // Each chunk is a contiguous range of locations queried with its own
+    // context, so results do not depend on the number of threads.
+    // Contexts are created here, before any threads start. Rounding up
+    // the chunk size can leave trailing chunks empty, so the number of
+    // chunks is recomputed from the chunk size.
+    const size_t chunkSize = (numLocs + numChunks - 1) / numChunks;
+    numChunks = (numLocs + chunkSize - 1) / chunkSize;
+    while (_threadContexts.size() < numChunks-1) {
+        _threadContexts.push_back(new QueryContext);
+    } // while
+    std::vector<std::exception_ptr> errors(numChunks);
+    auto queryChunk = [=, &errors] (const size_t iChunk,
+                                    QueryContext* context) {
+        const size_t iLoc = iChunk*chunkSize;
+        const size_t numLocsChunk = std::min(chunkSize, numLocs-iLoc);
+        try {
+            queryBatch(context, &vals[iLoc*numVals], numVals, &err[iLoc], &coords[iLoc*numDims], numLocsChunk, numDims, csQuery);
+        } catch (...) {
+            errors[iChunk] = std::current_exception();
+        } // try/catch
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(numChunks-1);
+    for (size_t iChunk = 1; iChunk < numChunks; ++iChunk) {
+        try {
+            threads.push_back(std::thread(queryChunk, iChunk, _threadContexts[iChunk-1]));
+        } catch (...) {
+            // Thread could not be started (for example, limit on number
+            // of processes); remaining chunks are queried in this thread.
+            break;
+        } // try/catch
+    } // for
+
+    // Query first chunk and chunks without a thread in this thread.
+    queryChunk(0, _getQueryContext());
+    for (size_t iChunk = threads.size()+1; iChunk < numChunks; ++iChunk) {
+        queryChunk(iChunk, _getQueryContext());
+    } // for
+
+    for (size_t i = 0; i < threads.size(); ++i) {
+        threads[i].join();
+    } // for
+    for (size_t iChunk = 0; iChunk < numChunks; ++iChunk) {
+        if (errors[iChunk]) {
+            std::rethrow_exception(errors[iChunk]);
+        } // if
+    } // for
+} // _queryThreaded
+
+
 // End of file
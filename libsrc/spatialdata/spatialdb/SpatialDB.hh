@@ -26,6 +26,7 @@
 #include "spatialdata/geocoords/geocoordsfwd.hh"
 
 #include <string> // USES std::string
+#include <vector> // HASA std::vector
 
 /// C++ manager for spatial database.
 class spatialdata::spatialdb::SpatialDB { // class SpatialDB
@@ -128,7 +129,89 @@ public:
               const size_t numDims,
               const spatialdata::geocoords::CoordSys* csQuery);
 
+    /** Can the database be queried concurrently?
+     *
+     * @returns True if queryBatch() may be called concurrently from
+     *   several threads using separate query contexts, false otherwise.
+     */
+    virtual
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * The default implementation calls query() for each location.
+     * Implementations override this method to amortize per-query work,
+     * such as validating arguments and converting coordinates, over
+     * the entire batch of locations.
+     *
+     * The implementations in spatialdata keep all per-query state in
+     * the query context and do not modify the database, so an opened
+     * database may be queried concurrently from several threads as
+     * long as each thread uses its own context. The default
+     * implementation does not provide this guarantee.
+     *
+     * @note vals should be preallocated to accommodate numVals values
+     * at numLocs locations.
+     *
+     * @pre Must call open() and setQueryValues() before queryBatch().
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flag values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param csQuery Coordinate system of coordinates.
+     */
+    virtual
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* csQuery);
+
+    /** Query the database at multiple locations with single precision
+     * values and coordinates.
+     *
+     * The default implementation converts blocks of locations to double
+     * precision (using buffers in the query context) and calls the
+     * double precision queryBatch(). Implementations override this
+     * method to compute single precision values directly.
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flag values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param csQuery Coordinate system of coordinates.
+     */
+    virtual
+    void queryBatch(QueryContext* context,
+                    float* vals,
+                    const size_t numVals,
+                    int* err,
+                    const float* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* csQuery);
+
     /** Perform multiple queries of the database.
+     *
+     * With more than one thread, the locations are split into
+     * contiguous chunks that are queried concurrently, each with its
+     * own query context. The results are identical to those from a
+     * single thread. Databases that are not thread safe (see
+     * isThreadSafe()) are always queried using a single thread.
      *
      * @note vals should be preallocated to accommodate numVals values
      * at numLocs locations.
@@ -148,6 +231,8 @@ public:
      * @param numLocsC Number of locations.
      * @param numDimsC Number of dimensions for coordinates.
      * @param csQuery Coordinate system of coordinates.
+     * @param numThreads Number of threads to use (0 for number of
+     *   hardware threads).
      */
     void multiquery(double* vals,
                     const size_t numLocsV,
@@ -157,7 +242,8 @@ public:
                     const double* coords,
                     const size_t numLocsC,
                     const size_t numDimsC,
-                    const spatialdata::geocoords::CoordSys* csQuery);
+                    const spatialdata::geocoords::CoordSys* csQuery,
+                    const size_t numThreads=1);
 
     /** Perform multiple queries of the database.
      *
@@ -179,6 +265,8 @@ public:
      * @param numLocsC Number of locations.
      * @param numDimsC Number of dimensions for coordinates.
      * @param csQuery Coordinate system of coordinates.
+     * @param numThreads Number of threads to use (0 for number of
+     *   hardware threads).
      */
     void multiquery(float* vals,
                     const size_t numLocsV,
@@ -188,7 +276,8 @@ public:
                     const float* coords,
                     const size_t numLocsC,
                     const size_t numDimsC,
-                    const spatialdata::geocoords::CoordSys* csQuery);
+                    const spatialdata::geocoords::CoordSys* csQuery,
+                    const size_t numThreads=1);
 
     // PROTECTED METHODS //////////////////////////////////////////////////
 protected:
@@ -206,9 +295,57 @@ protected:
                       const size_t numLocs,
                       const size_t numVals);
 
+    /** Get query context used by query() and multiquery().
+     *
+     * The context is created the first time it is needed.
+     *
+     * @returns Query context owned by database.
+     */
+    QueryContext* _getQueryContext(void);
+
+    /** Get query contexts for additional threads in multiquery().
+     *
+     * @returns Query contexts owned by database.
+     */
+    const std::vector<QueryContext*>& _getThreadContexts(void) const;
+
+    /** Get smallest number of locations queried by a thread in multiquery().
+     *
+     * @returns Smallest number of locations in a chunk.
+     */
+    size_t _getMinChunkSize(void) const;
+
+    /** Set smallest number of locations queried by a thread in multiquery().
+     *
+     * @param value Smallest number of locations in a chunk.
+     */
+    void _setMinChunkSize(const size_t value);
+
     // PRIVATE METHODS ////////////////////////////////////////////////////
 private:
 
+    /** Query the database at multiple locations using one or more threads.
+     *
+     * @param vals Array for computed values [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flag values [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param csQuery Coordinate system of coordinates.
+     * @param numThreads Number of threads to use (0 for number of
+     *   hardware threads).
+     */
+    template<typename T>
+    void _queryThreaded(T* vals,
+                        const size_t numVals,
+                        int* err,
+                        const T* coords,
+                        const size_t numLocs,
+                        const size_t numDims,
+                        const spatialdata::geocoords::CoordSys* csQuery,
+                        const size_t numThreads);
+
     SpatialDB(const SpatialDB& data); ///< Not implemented
     const SpatialDB& operator=(const SpatialDB& data); ///< Not implemented
 
@@ -217,6 +354,14 @@ private:
     // PRIVATE MEMBERS ////////////////////////////////////////////////////
 
     std::string _label; ///< Label of spatial database.
+    QueryContext* _queryContext; ///< Query context used by query() and multiquery().
+    size_t _minChunkSize; ///< Smallest number of locations worth the overhead of a thread.
+
+    /** Query contexts for additional threads in multiquery(). Contexts
+     * are kept across calls so their converters reuse PROJ contexts and
+     * transformations.
+     */
+    std::vector<QueryContext*> _threadContexts;
 
 }; // class SpatialDB
 
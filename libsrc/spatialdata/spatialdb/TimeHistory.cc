@@ -79,34 +79,47 @@ spatialdata::spatialdb::TimeHistory::close(void) {
 int
 spatialdata::spatialdb::TimeHistory::query(double* value,
                                            const double t) {
+    return query(value, t, &_ilower);
+} // query
+
+
+// ----------------------------------------------------------------------
+// Query the database using caller-owned search hint.
+int
+spatialdata::spatialdb::TimeHistory::query(double* value,
+                                           const double t,
+                                           size_t* ilower) const {
     assert(0 != _npts);
+    assert(ilower);
 
     *value = 0.0;
     if (_npts > 1) {
-        if (t < _time[_ilower]) {
-            while (_ilower > 0) {
-                if (t >= _time[_ilower]) {
+        size_t index = (*ilower < _npts-1) ? *ilower : 0;
+        if (t < _time[index]) {
+            while (index > 0) {
+                if (t >= _time[index]) {
                     break;
                 }
-                --_ilower;
+                --index;
             } // while
-        } else if (t > _time[_ilower+1]) {
+        } else if (t > _time[index+1]) {
             const size_t imax = _npts-2;
-            while (_ilower < imax) {
-                if (t <= _time[_ilower+1]) {
+            while (index < imax) {
+                if (t <= _time[index+1]) {
                     break;
                 }
-                ++_ilower;
+                ++index;
             } // while
         } // if/else
+        *ilower = index;
 
-        assert(_ilower < _npts-1);
-        if (( t >= _time[_ilower]) && ( t <= _time[_ilower+1]) ) {
-            const double tL = _time[_ilower];
-            const double tU = _time[_ilower+1];
+        assert(index < _npts-1);
+        if (( t >= _time[index]) && ( t <= _time[index+1]) ) {
+            const double tL = _time[index];
+            const double tU = _time[index+1];
             const double wtL = (tU - t) / (tU - tL);
             const double wtU = (t - tL) / (tU - tL);
-            *value = wtL * _amplitude[_ilower] + wtU * _amplitude[_ilower+1];
+            *value = wtL * _amplitude[index] + wtU * _amplitude[index+1];
         } else {
             return 1;
         } // else
@@ -89,6 +89,24 @@ public:
     int query(double* value,
               const double t);
 
+    /** Query the database using a search hint owned by the caller.
+     *
+     * The time history is not modified, so concurrent queries are
+     * safe as long as each thread uses its own hint.
+     *
+     * @pre Must call open() before query()
+     *
+     * @param value Value in time history.
+     * @param t Time for query.
+     * @param ilower Index of point preceding time of previous query
+     *   (input) and of this query (output).
+     *
+     * @returns 0 on success, 1 on failure (i.e., could not interpolate)
+     */
+    int query(double* value,
+              const double t,
+              size_t* ilower) const;
+
     /** Query the database.
      *
      * @pre Must call open() before query()
@@ -110,7 +128,7 @@ private:
     double* _time; ///< Time stamps for points in time history.
     double* _amplitude; ///< Amplitude at points in time history.
     size_t _npts; ///< Number of points in time history.
-    size_t _ilower; ///< Current index for point preceding current time.
+    size_t _ilower; ///< Current index for point preceding current time (for queries without hint).
 
 private:
 
@@ -0,0 +1,606 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "Triangulation.hh" // implementation of class methods
+
+#include <algorithm> // USES std::sort(), std::swap()
+#include <utility> // USES std::pair
+#include <cmath> // USES sqrt()
+#include <cassert> // USES assert()
+
+// ----------------------------------------------------------------------
+// Default constructor.
+spatialdata::spatialdb::Triangulation::Triangulation(void) :
+    _dimension(0),
+    _numLocs(0)
+{}
+
+
+// ----------------------------------------------------------------------
+// Default destructor.
+spatialdata::spatialdb::Triangulation::~Triangulation(void) {
+    deallocate();
+} // destructor
+
+
+// ----------------------------------------------------------------------
+// Deallocate data structures.
+void
+spatialdata::spatialdb::Triangulation::deallocate(void) {
+    std::vector<double>().swap(_points);
+    std::vector<int>().swap(_cells);
+    std::vector<int>().swap(_neighbors);
+    std::vector<int>().swap(_vertexCells);
+    std::vector<int>().swap(_freeCells);
+    std::vector<char>().swap(_inCavity);
+    _dimension = 0;
+    _numLocs = 0;
+} // deallocate
+
+
+// ----------------------------------------------------------------------
+// Build triangulation of points.
+void
+spatialdata::spatialdb::Triangulation::build(const double* coordinates,
+                                             const size_t numLocs,
+                                             const size_t spaceDim) {
+    deallocate();
+    if (( spaceDim < 2) || ( spaceDim > 3) || ( numLocs < spaceDim+1) ) {
+        return;
+    } // if
+    assert(coordinates);
+
+    // Bounding box of points.
+    double xyzMin[3] = { 0.0, 0.0, 0.0 };
+    double xyzMax[3] = { 0.0, 0.0, 0.0 };
+    for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+        xyzMin[iDim] = xyzMax[iDim] = coordinates[iDim];
+    } // for
+    for (size_t iLoc = 1; iLoc < numLocs; ++iLoc) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            const double x = coordinates[iLoc*spaceDim+iDim];
+            if (x < xyzMin[iDim]) {
+                xyzMin[iDim] = x;
+            } else if (x > xyzMax[iDim]) {
+                xyzMax[iDim] = x;
+            } // if/else
+        } // for
+    } // for
+    double extent = 0.0;
+    double radius = 0.0;
+    for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+        const double dx = xyzMax[iDim] - xyzMin[iDim];
+        extent = std::max(extent, dx);
+        radius += dx*dx;
+    } // for
+    if (extent <= 0.0) {
+        return;
+    } // if
+    radius = 0.5*sqrt(radius);
+
+    _dimension = spaceDim;
+    _numLocs = numLocs;
+    const size_t numCorners = _dimension+1;
+
+    // Copy coordinates, padding to 3-D space and perturbing to avoid
+    // degenerate configurations. Points of enclosing simplex follow
+    // the points in the database.
+    const double perturbation = 1.0e-9*extent;
+    unsigned long seed = 12345;
+    _points.resize(3*(numLocs+numCorners), 0.0);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            seed = (1103515245*seed + 12345) % 2147483648UL;
+            const double r = 2.0*double(seed)/2147483648.0 - 1.0;
+            _points[3*iLoc+iDim] = coordinates[iLoc*spaceDim+iDim] + perturbation*r;
+        } // for
+    } // for
+
+    // Enclosing simplex with inscribed radius much larger than radius of points.
+    double center[3] = { 0.0, 0.0, 0.0 };
+    for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+        center[iDim] = 0.5*(xyzMin[iDim] + xyzMax[iDim]);
+    } // for
+    const double scale = 20.0*radius;
+    if (2 == _dimension) {
+        const double corners[3][2] = {
+            { 0.0, 2.0 },
+            { -sqrt(3.0), -1.0 },
+            { +sqrt(3.0), -1.0 },
+        };
+        for (size_t iCorner = 0; iCorner < 3; ++iCorner) {
+            for (size_t iDim = 0; iDim < 2; ++iDim) {
+                _points[3*(numLocs+iCorner)+iDim] = center[iDim] + scale*corners[iCorner][iDim];
+            } // for
+        } // for
+    } else {
+        const double corners[4][3] = {
+            { +1.0, +1.0, +1.0 },
+            { +1.0, -1.0, -1.0 },
+            { -1.0, +1.0, -1.0 },
+            { -1.0, -1.0, +1.0 },
+        };
+        for (size_t iCorner = 0; iCorner < 4; ++iCorner) {
+            for (size_t iDim = 0; iDim < 3; ++iDim) {
+                _points[3*(numLocs+iCorner)+iDim] = center[iDim] + scale*corners[iCorner][iDim];
+            } // for
+        } // for
+    } // if/else
+    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+        _cells.push_back(int(numLocs+iCorner));
+        _neighbors.push_back(-1);
+    } // for
+    _inCavity.push_back(0);
+    if (_orient(0, -1, NULL) < 0.0) {
+        std::swap(_cells[0], _cells[1]);
+    } // if
+
+    // Insert points in Morton (Z-curve) order so that consecutive
+    // points are close together and walks are short.
+    const unsigned long long numBits = (3 == _dimension) ? 10 : 16;
+    const double numBins = double(1ULL << numBits);
+    std::vector<std::pair<unsigned long long, int> > order(numLocs);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        unsigned long long bins[3] = { 0, 0, 0 };
+        for (size_t iDim = 0; iDim < _dimension; ++iDim) {
+            const double dx = xyzMax[iDim] - xyzMin[iDim];
+            const double xi = (dx > 0.0) ? (coordinates[iLoc*spaceDim+iDim] - xyzMin[iDim]) / dx : 0.0;
+            bins[iDim] = std::min((unsigned long long)(xi*numBins), (1ULL << numBits) - 1);
+        } // for
+        unsigned long long code = 0;
+        for (unsigned long long iBit = 0; iBit < numBits; ++iBit) {
+            for (size_t iDim = 0; iDim < _dimension; ++iDim) {
+                code |= ((bins[iDim] >> iBit) & 1ULL) << (iBit*_dimension + iDim);
+            } // for
+        } // for
+        order[iLoc] = std::make_pair(code, int(iLoc));
+    } // for
+    std::sort(order.begin(), order.end());
+
+    std::vector<int> duplicateOf(numLocs, -1);
+    int cell = 0;
+    for (size_t i = 0; i < numLocs; ++i) {
+        const int iLoc = order[i].second;
+        const double* pt = &_points[3*iLoc];
+
+        int found = _locate(cell, pt);
+        if (found < 0) {
+            // Walk failed; fall back to checking every simplex.
+            const size_t numCells = _cells.size() / numCorners;
+            for (size_t iCell = 0; iCell < numCells && found < 0; ++iCell) {
+                if (_cells[iCell*numCorners] < 0) {
+                    continue;
+                } // if
+                bool inside = true;
+                for (size_t iCorner = 0; iCorner < numCorners && inside; ++iCorner) {
+                    inside = _orient(iCell, int(iCorner), pt) >= 0.0;
+                } // for
+                if (inside) {
+                    found = int(iCell);
+                } // if
+            } // for
+            if (found < 0) {
+                continue;
+            } // if
+        } // if
+
+        // Skip exact duplicates of vertices.
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            const int iVertex = _cells[found*numCorners+iCorner];
+            if (iVertex >= int(numLocs)) {
+                continue;
+            } // if
+            bool same = true;
+            for (size_t iDim = 0; iDim < spaceDim && same; ++iDim) {
+                same = coordinates[iLoc*spaceDim+iDim] == coordinates[iVertex*spaceDim+iDim];
+            } // for
+            if (same) {
+                duplicateOf[iLoc] = iVertex;
+                break;
+            } // if
+        } // for
+        if (duplicateOf[iLoc] >= 0) {
+            cell = found;
+            continue;
+        } // if
+
+        cell = _insert(iLoc, found);
+    } // for
+
+    _finalize();
+
+    _vertexCells.resize(numLocs);
+    std::fill(_vertexCells.begin(), _vertexCells.end(), -1);
+    const size_t numCells = _cells.size() / numCorners;
+    for (size_t iCell = 0; iCell < numCells; ++iCell) {
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            _vertexCells[_cells[iCell*numCorners+iCorner]] = int(iCell);
+        } // for
+    } // for
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        if (duplicateOf[iLoc] >= 0) {
+            _vertexCells[iLoc] = _vertexCells[duplicateOf[iLoc]];
+        } // if
+    } // for
+} // build
+
+
+// ----------------------------------------------------------------------
+// Get dimension of simplices in triangulation.
+size_t
+spatialdata::spatialdb::Triangulation::getDimension(void) const {
+    return _dimension;
+} // getDimension
+
+
+// ----------------------------------------------------------------------
+// Get number of simplices in triangulation.
+size_t
+spatialdata::spatialdb::Triangulation::getNumCells(void) const {
+    return (_dimension > 0) ? _cells.size() / (_dimension+1) : 0;
+} // getNumCells
+
+
+// ----------------------------------------------------------------------
+// Find simplex containing location and compute barycentric weights.
+bool
+spatialdata::spatialdb::Triangulation::findSimplex(size_t* vertices,
+                                                   double* weights,
+                                                   const double pt[3],
+                                                   const size_t startLoc) const {
+    assert(vertices);
+    assert(weights);
+    assert(pt);
+
+    if (( 0 == getNumCells()) || ( startLoc >= _numLocs) ) {
+        return false;
+    } // if
+    int cell = _vertexCells[startLoc];
+    if (cell < 0) {
+        return false;
+    } // if
+
+    const double tolerance = 1.0e-06;
+    const size_t numCorners = _dimension+1;
+    const size_t maxSteps = getNumCells();
+    for (size_t iStep = 0; iStep < maxSteps; ++iStep) {
+        const double volume = _orient(cell, -1, pt);
+        if (volume <= 0.0) {
+            return false;
+        } // if
+        size_t iMin = 0;
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            weights[iCorner] = _orient(cell, int(iCorner), pt) / volume;
+            if (weights[iCorner] < weights[iMin]) {
+                iMin = iCorner;
+            } // if
+        } // for
+        const int neighbor = _neighbors[cell*numCorners+iMin];
+        if (( weights[iMin] >= 0.0) || (( neighbor < 0) && ( weights[iMin] >= -tolerance) )) {
+            for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                vertices[iCorner] = _cells[cell*numCorners+iCorner];
+            } // for
+            return true;
+        } else if (neighbor < 0) {
+            return false;
+        } // if/else
+        cell = neighbor;
+    } // for
+
+    return false;
+} // findSimplex
+
+
+// ----------------------------------------------------------------------
+// Compute orientation of simplex with vertex replaced by location.
+double
+spatialdata::spatialdb::Triangulation::_orient(const size_t cell,
+                                               const int replace,
+                                               const double pt[3]) const {
+    const size_t numCorners = _dimension+1;
+    const double* v[4] = { NULL, NULL, NULL, NULL };
+    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+        v[iCorner] = (int(iCorner) == replace) ? pt : &_points[3*_cells[cell*numCorners+iCorner]];
+    } // for
+
+    if (2 == _dimension) {
+        return (v[1][0]-v[0][0])*(v[2][1]-v[0][1]) - (v[1][1]-v[0][1])*(v[2][0]-v[0][0]);
+    } // if
+
+    const double uX = v[1][0]-v[0][0];
+    const double uY = v[1][1]-v[0][1];
+    const double uZ = v[1][2]-v[0][2];
+    const double vX = v[2][0]-v[0][0];
+    const double vY = v[2][1]-v[0][1];
+    const double vZ = v[2][2]-v[0][2];
+    const double wX = v[3][0]-v[0][0];
+    const double wY = v[3][1]-v[0][1];
+    const double wZ = v[3][2]-v[0][2];
+    return uX*(vY*wZ - vZ*wY) - uY*(vX*wZ - vZ*wX) + uZ*(vX*wY - vY*wX);
+} // _orient
+
+
+// ----------------------------------------------------------------------
+// Check whether location is inside circumcircle or circumsphere of simplex.
+bool
+spatialdata::spatialdb::Triangulation::_inCircumsphere(const size_t cell,
+                                                       const double pt[3]) const {
+    const size_t numCorners = _dimension+1;
+
+    // Rows contain coordinates relative to location and squared distance.
+    double m[4][4];
+    for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+        const double* v = &_points[3*_cells[cell*numCorners+iCorner]];
+        double dist2 = 0.0;
+        for (size_t iDim = 0; iDim < _dimension; ++iDim) {
+            m[iCorner][iDim] = v[iDim] - pt[iDim];
+            dist2 += m[iCorner][iDim]*m[iCorner][iDim];
+        } // for
+        m[iCorner][_dimension] = dist2;
+    } // for
+
+    if (2 == _dimension) {
+        const double det =
+            m[0][0]*(m[1][1]*m[2][2] - m[1][2]*m[2][1]) -
+            m[0][1]*(m[1][0]*m[2][2] - m[1][2]*m[2][0]) +
+            m[0][2]*(m[1][0]*m[2][1] - m[1][1]*m[2][0]);
+        return det > 0.0;
+    } // if
+
+    // Expand determinant along last column.
+    double det = 0.0;
+    for (size_t iRow = 0; iRow < 4; ++iRow) {
+        const double* a = m[(iRow+1) % 4];
+        const double* b = m[(iRow+2) % 4];
+        const double* c = m[(iRow+3) % 4];
+        const double minor =
+            a[0]*(b[1]*c[2] - b[2]*c[1]) -
+            a[1]*(b[0]*c[2] - b[2]*c[0]) +
+            a[2]*(b[0]*c[1] - b[1]*c[0]);
+        // Cyclic ordering of remaining rows is an even permutation, so
+        // only the cofactor sign alternates.
+        det += (iRow % 2) ? minor*m[iRow][3] : -minor*m[iRow][3];
+    } // for
+    return det < 0.0;
+} // _inCircumsphere
+
+
+// ----------------------------------------------------------------------
+// Walk from simplex towards simplex containing location.
+int
+spatialdata::spatialdb::Triangulation::_locate(const int cell,
+                                               const double pt[3]) const {
+    const size_t numCorners = _dimension+1;
+    const size_t maxSteps = _cells.size() / numCorners + 1;
+
+    int current = cell;
+    for (size_t iStep = 0; iStep < maxSteps; ++iStep) {
+        size_t iMin = 0;
+        double orientMin = 0.0;
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            const double orient = _orient(current, int(iCorner), pt);
+            if (orient < orientMin) {
+                orientMin = orient;
+                iMin = iCorner;
+            } // if
+        } // for
+        if (orientMin >= 0.0) {
+            return current;
+        } // if
+        current = _neighbors[current*numCorners+iMin];
+        if (current < 0) {
+            return -1;
+        } // if
+    } // for
+
+    return -1;
+} // _locate
+
+
+// ----------------------------------------------------------------------
+// Insert point into triangulation.
+int
+spatialdata::spatialdb::Triangulation::_insert(const int iLoc,
+                                               const int cell) {
+    const size_t numCorners = _dimension+1;
+    const double* pt = &_points[3*iLoc];
+
+    // Cavity consists of simplices with circumspheres containing point.
+    std::vector<int> cavity;
+    cavity.push_back(cell);
+    _inCavity[cell] = 1;
+    for (size_t i = 0; i < cavity.size(); ++i) {
+        const int iCell = cavity[i];
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            const int neighbor = _neighbors[iCell*numCorners+iCorner];
+            if (( neighbor >= 0) && !_inCavity[neighbor] && _inCircumsphere(neighbor, pt)) {
+                _inCavity[neighbor] = 1;
+                cavity.push_back(neighbor);
+            } // if
+        } // for
+    } // for
+
+    // Grow cavity until it is star-shaped with respect to the point,
+    // which guards against inconsistent roundoff in nearly degenerate
+    // configurations.
+    for (bool changed = true; changed;) {
+        changed = false;
+        for (size_t i = 0; i < cavity.size(); ++i) {
+            const int iCell = cavity[i];
+            for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                const int neighbor = _neighbors[iCell*numCorners+iCorner];
+                if (( neighbor < 0) || _inCavity[neighbor]) {
+                    continue;
+                } // if
+                if (_orient(iCell, int(iCorner), pt) <= 0.0) {
+                    _inCavity[neighbor] = 1;
+                    cavity.push_back(neighbor);
+                    changed = true;
+                } // if
+            } // for
+        } // for
+    } // for
+
+    // Faces on boundary of cavity.
+    struct Facet {
+        int vertices[4]; ///< Vertices of new simplex.
+        int corner; ///< Index of point in new simplex.
+        int neighbor; ///< Neighbor outside cavity.
+        int neighborCorner; ///< Index of vertex in neighbor opposite face.
+    }; // Facet
+    std::vector<Facet> facets;
+    for (size_t i = 0; i < cavity.size(); ++i) {
+        const int iCell = cavity[i];
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            const int neighbor = _neighbors[iCell*numCorners+iCorner];
+            if (( neighbor >= 0) && _inCavity[neighbor]) {
+                continue;
+            } // if
+            Facet facet;
+            for (size_t jCorner = 0; jCorner < numCorners; ++jCorner) {
+                facet.vertices[jCorner] = _cells[iCell*numCorners+jCorner];
+            } // for
+            facet.vertices[iCorner] = iLoc;
+            facet.corner = int(iCorner);
+            facet.neighbor = neighbor;
+            facet.neighborCorner = -1;
+            if (neighbor >= 0) {
+                for (size_t jCorner = 0; jCorner < numCorners; ++jCorner) {
+                    if (_neighbors[neighbor*numCorners+jCorner] == iCell) {
+                        facet.neighborCorner = int(jCorner);
+                        break;
+                    } // if
+                } // for
+                assert(facet.neighborCorner >= 0);
+            } // if
+            facets.push_back(facet);
+        } // for
+    } // for
+
+    // Remove cavity.
+    for (size_t i = 0; i < cavity.size(); ++i) {
+        const int iCell = cavity[i];
+        _inCavity[iCell] = 0;
+        _cells[iCell*numCorners] = -1;
+        _freeCells.push_back(iCell);
+    } // for
+
+    // Create new simplices connecting point to faces on boundary of cavity.
+    typedef std::pair<std::pair<int, int>, std::pair<int, int> > FaceEntry;
+    std::vector<FaceEntry> faces;
+    int newCell = -1;
+    const size_t numFacets = facets.size();
+    for (size_t iFacet = 0; iFacet < numFacets; ++iFacet) {
+        const Facet& facet = facets[iFacet];
+        if (_freeCells.size() > 0) {
+            newCell = _freeCells.back();
+            _freeCells.pop_back();
+        } else {
+            newCell = int(_cells.size() / numCorners);
+            _cells.resize(_cells.size()+numCorners);
+            _neighbors.resize(_neighbors.size()+numCorners);
+            _inCavity.push_back(0);
+        } // if/else
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            _cells[newCell*numCorners+iCorner] = facet.vertices[iCorner];
+            _neighbors[newCell*numCorners+iCorner] = -1;
+        } // for
+        _neighbors[newCell*numCorners+facet.corner] = facet.neighbor;
+        if (facet.neighbor >= 0) {
+            _neighbors[facet.neighbor*numCorners+facet.neighborCorner] = newCell;
+        } // if
+
+        // Faces containing the point are shared with other new simplices.
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            if (int(iCorner) == facet.corner) {
+                continue;
+            } // if
+            int key[2] = { -1, -1 };
+            for (size_t jCorner = 0, k = 0; jCorner < numCorners; ++jCorner) {
+                if (( jCorner != iCorner) && ( int(jCorner) != facet.corner) ) {
+                    key[k++] = facet.vertices[jCorner];
+                } // if
+            } // for
+            if (( key[1] >= 0) && ( key[1] < key[0]) ) {
+                std::swap(key[0], key[1]);
+            } // if
+            faces.push_back(FaceEntry(std::make_pair(key[0], key[1]), std::make_pair(newCell, int(iCorner))));
+        } // for
+    } // for
+    std::sort(faces.begin(), faces.end());
+    for (size_t i = 0; i+1 < faces.size(); ++i) {
+        if (faces[i].first == faces[i+1].first) {
+            const int cellA = faces[i].second.first;
+            const int cornerA = faces[i].second.second;
+            const int cellB = faces[i+1].second.first;
+            const int cornerB = faces[i+1].second.second;
+            _neighbors[cellA*numCorners+cornerA] = cellB;
+            _neighbors[cellB*numCorners+cornerB] = cellA;
+            ++i;
+        } // if
+    } // for
+
+    return newCell;
+} // _insert
+
+
+// ----------------------------------------------------------------------
+// Remove simplices with vertices of enclosing simplex and compact storage.
+void
+spatialdata::spatialdb::Triangulation::_finalize(void) {
+    const size_t numCorners = _dimension+1;
+    const size_t numCellsAll = _cells.size() / numCorners;
+
+    std::vector<int> newIndex(numCellsAll, -1);
+    int numCells = 0;
+    for (size_t iCell = 0; iCell < numCellsAll; ++iCell) {
+        if (_cells[iCell*numCorners] < 0) {
+            continue;
+        } // if
+        bool keep = true;
+        for (size_t iCorner = 0; iCorner < numCorners && keep; ++iCorner) {
+            keep = _cells[iCell*numCorners+iCorner] < int(_numLocs);
+        } // for
+        if (keep) {
+            newIndex[iCell] = numCells++;
+        } // if
+    } // for
+
+    std::vector<int> cells(numCells*numCorners);
+    std::vector<int> neighbors(numCells*numCorners);
+    for (size_t iCell = 0; iCell < numCellsAll; ++iCell) {
+        const int iNew = newIndex[iCell];
+        if (iNew < 0) {
+            continue;
+        } // if
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            cells[iNew*numCorners+iCorner] = _cells[iCell*numCorners+iCorner];
+            const int neighbor = _neighbors[iCell*numCorners+iCorner];
+            neighbors[iNew*numCorners+iCorner] = (neighbor >= 0) ? newIndex[neighbor] : -1;
+        } // for
+    } // for
+    _cells.swap(cells);
+    _neighbors.swap(neighbors);
+    _points.resize(3*_numLocs);
+
+    std::vector<int>().swap(_freeCells);
+    std::vector<char>().swap(_inCavity);
+} // _finalize
+
+
+// End of file
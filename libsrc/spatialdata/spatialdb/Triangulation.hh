@@ -0,0 +1,164 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/spatialdb/Triangulation.hh
+ *
+ * @brief C++ Delaunay triangulation (2-D) or tetrahedralization (3-D)
+ * of scattered points for linear interpolation.
+ *
+ * The triangulation is constructed using incremental Bowyer-Watson
+ * insertion. Points are inserted along a space-filling curve and
+ * located using a walking search. To avoid degenerate (cocircular or
+ * cospherical) configurations, which are common for points on a
+ * regular grid, the coordinates used in the triangulation are
+ * perturbed by a small amount (1.0e-9 times the size of the domain).
+ * Exact duplicate points are not inserted.
+ */
+
+#if !defined(spatialdata_spatialdb_triangulation_hh)
+#define spatialdata_spatialdb_triangulation_hh
+
+#include "spatialdbfwd.hh" // forward declarations
+
+#include <vector> // USES std::vector
+#include <cstddef> // USES size_t
+
+class spatialdata::spatialdb::Triangulation { // class Triangulation
+    friend class TestTriangulation; // unit testing
+
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /// Default constructor.
+    Triangulation(void);
+
+    /// Default destructor.
+    ~Triangulation(void);
+
+    /// Deallocate data structures.
+    void deallocate(void);
+
+    /** Build triangulation of points.
+     *
+     * The triangulation is empty if the spatial dimension is not 2 or
+     * 3 or if there are not enough points to form a simplex.
+     *
+     * @param coordinates Array of coordinates of points [numLocs*spaceDim].
+     * @param numLocs Number of points.
+     * @param spaceDim Spatial dimension of points.
+     */
+    void build(const double* coordinates,
+               const size_t numLocs,
+               const size_t spaceDim);
+
+    /** Get dimension of simplices in triangulation.
+     *
+     * @returns Dimension of simplices (0 if triangulation is empty).
+     */
+    size_t getDimension(void) const;
+
+    /** Get number of simplices in triangulation.
+     *
+     * @returns Number of simplices.
+     */
+    size_t getNumCells(void) const;
+
+    /** Find simplex containing location and compute barycentric weights.
+     *
+     * The search walks through the triangulation starting from a
+     * simplex incident on a point near the location (usually the
+     * nearest point).
+     *
+     * @param vertices Indices of points of simplex [dimension+1] (output).
+     * @param weights Barycentric weights of points [dimension+1] (output).
+     * @param pt Coordinates of location in 3-D space.
+     * @param startLoc Index of point at which to start search.
+     * @returns True if simplex containing location was found, false otherwise.
+     */
+    bool findSimplex(size_t* vertices,
+                     double* weights,
+                     const double pt[3],
+                     const size_t startLoc) const;
+
+private:
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /** Compute orientation (signed area or volume scaled by the
+     * dimension factorial) of simplex with vertex replaced by location.
+     *
+     * @param cell Index of simplex.
+     * @param replace Index of vertex in simplex to replace (-1 for none).
+     * @param pt Coordinates of location in 3-D space.
+     * @returns Orientation of simplex.
+     */
+    double _orient(const size_t cell,
+                   const int replace,
+                   const double pt[3]) const;
+
+    /** Check whether location is inside circumcircle (2-D) or
+     * circumsphere (3-D) of simplex.
+     *
+     * @param cell Index of simplex.
+     * @param pt Coordinates of location in 3-D space.
+     * @returns True if location is strictly inside.
+     */
+    bool _inCircumsphere(const size_t cell,
+                         const double pt[3]) const;
+
+    /** Walk from simplex towards simplex containing location.
+     *
+     * @param cell Index of simplex at which to start search.
+     * @param pt Coordinates of location in 3-D space.
+     * @returns Index of simplex containing location or -1 if not found.
+     */
+    int _locate(const int cell,
+                const double pt[3]) const;
+
+    /** Insert point into triangulation.
+     *
+     * @param iLoc Index of point.
+     * @param cell Index of simplex containing point.
+     * @returns Index of one of the new simplices.
+     */
+    int _insert(const int iLoc,
+                const int cell);
+
+    /// Remove simplices with vertices of enclosing simplex and compact storage.
+    void _finalize(void);
+
+    Triangulation(const Triangulation&); ///< Not implemented
+    const Triangulation& operator=(const Triangulation&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    std::vector<double> _points; ///< Coordinates of points in 3-D space (perturbed) [numPoints*3].
+    std::vector<int> _cells; ///< Vertices of simplices [numCells*(dimension+1)].
+    std::vector<int> _neighbors; ///< Neighbor opposite each vertex of simplices (-1 for none) [numCells*(dimension+1)].
+    std::vector<int> _vertexCells; ///< Simplex incident on each point (-1 for none) [numLocs].
+    std::vector<int> _freeCells; ///< Unused simplices (during construction).
+    std::vector<char> _inCavity; ///< Flags for simplices in insertion cavity (during construction).
+    size_t _dimension; ///< Dimension of simplices.
+    size_t _numLocs; ///< Number of points.
+
+}; // class Triangulation
+
+#endif // spatialdata_spatialdb_triangulation_hh
+
+// End of file
@@ -177,13 +177,63 @@ spatialdata::spatialdb::UniformDB::query(double* vals,
                                          const double* coords,
                                          const size_t numDims,
                                          const spatialdata::geocoords::CoordSys* pCSQuery) {
+    _checkQuery(numVals);
+
+    for (size_t iVal = 0; iVal < _querySize; ++iVal) {
+        vals[iVal] = _values[_queryValues[iVal]];
+    } // for
+
+    return 0;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::UniformDB::isThreadSafe(void) const {
+    return true;
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::UniformDB::queryBatch(QueryContext* context,
+                                              double* vals,
+                                              const size_t numVals,
+                                              int* err,
+                                              const double* coords,
+                                              const size_t numLocs,
+                                              const size_t numDims,
+                                              const spatialdata::geocoords::CoordSys* pCSQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+
+    _checkQuery(numVals);
+
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        for (size_t iVal = 0; iVal < _querySize; ++iVal) {
+            vals[iLoc*numVals+iVal] = _values[_queryValues[iVal]];
+        } // for
+        err[iLoc] = 0;
+    } // for
+} // queryBatch
+
+
+// ----------------------------------------------------------------------
+// Check number of values to be returned by query.
+void
+spatialdata::spatialdb::UniformDB::_checkQuery(const size_t numVals) const {
     if (0 == _querySize) {
         std::ostringstream msg;
         msg << "Values to be returned by spatial database " << getLabel() << "\n"
             << "have not been set. Please call setQueryValues() before query().\n";
         throw std::logic_error(msg.str());
-    } // if
-    else if (numVals != _querySize) {
+    } else if (numVals != _querySize) {
         std::ostringstream msg;
         msg << "Number of values to be returned by spatial database "
             << getLabel() << "\n"
@@ -191,13 +241,7 @@ spatialdata::spatialdb::UniformDB::query(double* vals,
             << numVals << ").\n";
         throw std::invalid_argument(msg.str());
     } // if
-
-    for (size_t iVal = 0; iVal < _querySize; ++iVal) {
-        vals[iVal] = _values[_queryValues[iVal]];
-    } // for
-
-    return 0;
-} // query
+} // _checkQuery
 
 
 // End of file
@@ -17,6 +17,7 @@
 #include <portinfo>
 
 #include "spatialdata/spatialdb/UserFunctionDB.hh" // Implementation of class methods
+#include "spatialdata/spatialdb/QueryContext.hh" // USES QueryContext
 
 // Include ios here to avoid some Python/gcc issues
 #include <ios>
@@ -26,6 +27,7 @@
 #include "spatialdata/units/Parser.hh" // USES Parser
 
 #include <string> // USES std::string
+#include <vector> // USES std::vector
 #include <stdexcept> // USES std::runtime_error
 #include <sstream> // USES std::ostringstream
 #include <cassert> // USES assert()
@@ -99,8 +101,8 @@ private:
 spatialdata::spatialdb::UserFunctionDB::UserFunctionDB(void) :
     _queryFunctions(NULL),
     _cs(NULL),
-    _converter(new spatialdata::geocoords::Converter),
-    _querySize(0) {}
+    _querySize(0),
+    _isThreadSafe(false) {}
 
 
 // ----------------------------------------------------------------------
@@ -114,7 +116,6 @@ spatialdata::spatialdb::UserFunctionDB::~UserFunctionDB(void) {
     } // for
 
     delete _cs;_cs = NULL;
-    delete _converter;_converter = NULL;
 } // destructor
 
 
@@ -262,19 +263,89 @@ spatialdata::spatialdb::UserFunctionDB::query(double* vals,
                                               const double* coords,
                                               const size_t numDims,
                                               const spatialdata::geocoords::CoordSys* csQuery) {
+    int err = 0;
+    queryBatch(_getQueryContext(), vals, numVals, &err, coords, 1, numDims, csQuery);
+
+    return err;
+} // query
+
+
+// ----------------------------------------------------------------------
+// Set whether the user functions may be called concurrently.
+void
+spatialdata::spatialdb::UserFunctionDB::setThreadSafe(const bool value) {
+    _isThreadSafe = value;
+} // setThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Can the database be queried concurrently?
+bool
+spatialdata::spatialdb::UserFunctionDB::isThreadSafe(void) const {
+    return _isThreadSafe;
+} // isThreadSafe
+
+
+// ----------------------------------------------------------------------
+// Query the database at multiple locations.
+void
+spatialdata::spatialdb::UserFunctionDB::queryBatch(QueryContext* context,
+                                                   double* vals,
+                                                   const size_t numVals,
+                                                   int* err,
+                                                   const double* coords,
+                                                   const size_t numLocs,
+                                                   const size_t numDims,
+                                                   const spatialdata::geocoords::CoordSys* csQuery) {
+    if (0 == numLocs) {
+        return;
+    } // if
+    assert(context);
+    assert(vals);
+    assert(err);
+    assert(coords);
+    assert(_cs);
+
+    _checkQuery(numVals, numDims);
+
+    // Convert coordinates of all locations at once.
+    std::vector<double>& xyz = context->coords;
+    xyz.assign(coords, coords+numLocs*numDims);
+    spatialdata::geocoords::Converter* converter = context->getConverter(this);
+    assert(converter);
+    converter->convert(&xyz[0], numLocs, numDims, _cs, csQuery);
+
     const size_t querySize = _querySize;
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        int queryFlag = 0;
+        for (size_t iVal = 0; iVal < querySize; ++iVal) {
+            assert(_queryFunctions[iVal]->fn);
+            double* const value = &vals[iLoc*numVals+iVal];
+            queryFlag = _queryFunctions[iVal]->fn->query(value, &xyz[iLoc*numDims], numDims);
+            if (queryFlag) { break; }
+            *value *= _queryFunctions[iVal]->scale; // Convert to SI units.
+        } // for
+        err[iLoc] = queryFlag;
+    } // for
+} // queryBatch
+
 
+// ----------------------------------------------------------------------
+// Check number of values and spatial dimension of query.
+void
+spatialdata::spatialdb::UserFunctionDB::_checkQuery(const size_t numVals,
+                                                    const size_t numDims) const {
     assert(_cs);
 
-    if (0 == querySize) {
+    if (0 == _querySize) {
         std::ostringstream msg;
         msg << "Values to be returned by spatial database " << getLabel()
             << " have not been set. Please call setQueryValues() before query().\n";
         throw std::logic_error(msg.str());
-    } else if (numVals != querySize) {
+    } else if (numVals != _querySize) {
         std::ostringstream msg;
         msg << "Number of values to be returned by spatial database "
-            << getLabel() << " (" << querySize << ") does not match size of array provided ("
+            << getLabel() << " (" << _querySize << ") does not match size of array provided ("
             << numVals << ").\n";
         throw std::invalid_argument(msg.str());
     } else if (numDims != _cs->getSpaceDim()) {
@@ -283,24 +354,7 @@ spatialdata::spatialdb::UserFunctionDB::query(double* vals,
             << ") does not match spatial dimension of spatial database (" << _cs->getSpaceDim() << ").";
         throw std::invalid_argument(msg.str());
     } // if
-
-    // Convert coordinates
-    assert(numDims <= 3);
-    double xyz[3];
-    memcpy(xyz, coords, numDims*sizeof(double));
-    assert(_converter);
-    _converter->convert(xyz, 1, numDims, _cs, csQuery);
-
-    int queryFlag = 0;
-    for (size_t iVal = 0; iVal < querySize; ++iVal) {
-        assert(_queryFunctions[iVal]->fn);
-        queryFlag = _queryFunctions[iVal]->fn->query(&vals[iVal], xyz, numDims);
-        if (queryFlag) { break; }
-        vals[iVal] *= _queryFunctions[iVal]->scale; // Convert to SI units.
-    } // for
-
-    return queryFlag;
-} // query
+} // _checkQuery
 
 
 // ----------------------------------------------------------------------
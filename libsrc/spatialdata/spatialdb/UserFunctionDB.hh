@@ -146,6 +146,47 @@ public:
               const size_t numDims,
               const spatialdata::geocoords::CoordSys* pCSQuery);
 
+    /** Set whether the user functions may be called concurrently.
+     *
+     * The database cannot determine whether the user functions are
+     * reentrant, so it is queried using a single thread unless the
+     * caller declares them safe to call concurrently (e.g., they do not
+     * use static variables).
+     *
+     * @param value True if user functions are reentrant, false otherwise.
+     */
+    void setThreadSafe(const bool value);
+
+    /** Can the database be queried concurrently?
+     *
+     * @returns True if queryBatch() may be called concurrently using
+     *   separate query contexts, false otherwise.
+     */
+    bool isThreadSafe(void) const;
+
+    /** Query the database at multiple locations.
+     *
+     * @pre Must call open() before queryBatch()
+     *
+     * @param context Scratch state for queries.
+     * @param vals Array for computed values (output from query), must be
+     *   allocated BEFORE calling queryBatch() [numLocs*numVals].
+     * @param numVals Number of values expected at each location.
+     * @param err Array for error flags (output from query) [numLocs].
+     * @param coords Coordinates of points for query [numLocs*numDims].
+     * @param numLocs Number of locations.
+     * @param numDims Number of dimensions for coordinates.
+     * @param pCSQuery Coordinate system of coordinates.
+     */
+    void queryBatch(QueryContext* context,
+                    double* vals,
+                    const size_t numVals,
+                    int* err,
+                    const double* coords,
+                    const size_t numLocs,
+                    const size_t numDims,
+                    const spatialdata::geocoords::CoordSys* pCSQuery);
+
     /** Set coordinate system associated with user functions.
      *
      * @param cs Coordinate system.
@@ -168,6 +209,14 @@ private:
                                 const size_t dim);
 
     // PRIVATE METHODS //////////////////////////////////////////////////////
+    /** Check number of values and spatial dimension of query.
+     *
+     * @param numVals Number of values expected.
+     * @param numDims Number of dimensions for coordinates.
+     */
+    void _checkQuery(const size_t numVals,
+                     const size_t numDims) const;
+
 private:
 
     /** Check suitability of arguments for adding user function.
@@ -219,8 +268,8 @@ private:
     UserData** _queryFunctions; ///< Array of pointers to _functions of values to be returned in queries.
     std::map<std::string, UserData> _functions; ///< User functions for values.
     spatialdata::geocoords::CoordSys* _cs; ///< Coordinate system
-    spatialdata::geocoords::Converter* _converter; ///< Convert query points to local coordinate system.U
     size_t _querySize; ///< Number of values to be returned in queries.
+    bool _isThreadSafe; ///< True if user functions may be called concurrently.
 
     // NOT IMPLEMENTED //////////////////////////////////////////////////////
 private:
@@ -30,14 +30,24 @@ namespace spatialdata {
     class OutOfBounds;
 
     class SpatialDB;
+    class QueryContext;
     class SimpleDB;
     class SimpleDBData;
     class SimpleDBQuery;
+    class KDTree;
+    class Triangulation;
     class SimpleIO;
     class SimpleIOAscii;
     class UniformDB;
     class SimpleGridDB;
     class SimpleGridAscii;
+    class SimpleGridBinary;
+    class GridInterpolator;
+    class GridChunkCache;
+    class GridCompressedBlocks;
+    class GridSharedMemory;
+    class OctreeGridDB;
+    class OctreeGridBinary;
     class UserFunctionDB;
     class CompositeDB;
     class SCECCVMH;
@@ -0,0 +1,390 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include "DataParser.hh" // implementation of class methods
+
+#include <istream> // USES std::istream
+#include <sstream> // USES std::istringstream
+#include <locale> // USES std::locale
+#include <algorithm> // USES std::search(), std::min()
+#include <thread> // USES std::thread
+#include <exception> // USES std::exception_ptr
+#include <cstring> // USES memchr()
+#include <stdint.h> // USES uint64_t
+#include <assert.h> // USES assert()
+
+// ----------------------------------------------------------------------
+const size_t spatialdata::utils::DataParser::_blockSize = 16*1024*1024;
+const size_t spatialdata::utils::DataParser::_minChunkSize = 256*1024;
+const double spatialdata::utils::DataParser::_powers10[] = {
+    1.0e+0, 1.0e+1, 1.0e+2, 1.0e+3, 1.0e+4, 1.0e+5, 1.0e+6, 1.0e+7,
+    1.0e+8, 1.0e+9, 1.0e+10, 1.0e+11, 1.0e+12, 1.0e+13, 1.0e+14, 1.0e+15,
+    1.0e+16, 1.0e+17, 1.0e+18, 1.0e+19, 1.0e+20, 1.0e+21, 1.0e+22,
+};
+
+// ----------------------------------------------------------------------
+// Constructor.
+spatialdata::utils::DataParser::DataParser(std::istream& sin,
+                                           const char* delimiter,
+                                           const size_t numValues,
+                                           const size_t numLines,
+                                           const size_t numThreads) :
+    _in(sin),
+    _delimiter(delimiter),
+    _numValues(numValues),
+    _numLines(numLines),
+    _numThreads(numThreads),
+    _buffer(),
+    _begin(0),
+    _endOfStream(false),
+    _appendedEndOfLine(false),
+    _values(),
+    _numLinesParsed(0),
+    _hasEndOfLine(true),
+    _error(false),
+    _errorLine(),
+    _errorNumValues(0) {
+    assert(!_delimiter.empty());
+    if (!_numThreads) {
+        _numThreads = std::max(1u, std::thread::hardware_concurrency());
+    } // if
+} // constructor
+
+
+// ----------------------------------------------------------------------
+// Destructor.
+spatialdata::utils::DataParser::~DataParser(void) {}
+
+
+// ----------------------------------------------------------------------
+// Parse next block of lines.
+size_t
+spatialdata::utils::DataParser::parse(void) {
+    _values.clear();
+
+    size_t numLines = 0;
+    while (!numLines && !_error && (_numLinesParsed < _numLines)) {
+        // Only parse complete lines.
+        size_t end = _buffer.size();
+        while (end > _begin && '\n' != _buffer[end-1]) {
+            --end;
+        } // while
+        if (end == _begin) {
+            if (_endOfStream) {
+                _error = true;
+                _errorLine.clear();
+                _errorNumValues = 0;
+                break;
+            } // if
+            _fill();
+            continue;
+        } // if
+
+        // Split lines into chunks parsed concurrently.
+        size_t numChunks = std::min(_numThreads, (end - _begin) / _minChunkSize);
+        numChunks = std::max(numChunks, size_t(1));
+        std::vector<Chunk> chunks(numChunks);
+        size_t begin = _begin;
+        for (size_t iChunk = 0; iChunk < numChunks; ++iChunk) {
+            size_t chunkEnd = end;
+            if (( iChunk+1 < numChunks) && ( begin < end) ) {
+                chunkEnd = std::max(begin, _begin + (iChunk+1)*(end - _begin) / numChunks);
+                const char* eol = (const char*)memchr(&_buffer[chunkEnd], '\n', end - chunkEnd);
+                assert(eol);
+                chunkEnd = eol - &_buffer[0] + 1;
+            } // if
+            chunks[iChunk].begin = begin;
+            chunks[iChunk].end = chunkEnd;
+            begin = chunkEnd;
+        } // for
+
+        const size_t maxLines = _numLines - _numLinesParsed;
+        std::vector<std::exception_ptr> errors(numChunks);
+        std::vector<std::thread> threads;
+        threads.reserve(numChunks-1);
+        auto parseChunk = [=, &chunks, &errors] (const size_t iChunk) {
+            try {
+                _parseChunk(&chunks[iChunk], maxLines);
+            } catch (...) {
+                errors[iChunk] = std::current_exception();
+            } // try/catch
+        };
+        for (size_t iChunk = 1; iChunk < numChunks; ++iChunk) {
+            try {
+                threads.push_back(std::thread(parseChunk, iChunk));
+            } catch (...) {
+                // Thread could not be started (for example, limit on
+                // number of processes); remaining chunks are parsed in
+                // this thread.
+                break;
+            } // try/catch
+        } // for
+
+        // Parse first chunk and chunks without a thread in this thread.
+        parseChunk(0);
+        for (size_t iChunk = threads.size()+1; iChunk < numChunks; ++iChunk) {
+            parseChunk(iChunk);
+        } // for
+        for (size_t i = 0; i < threads.size(); ++i) {
+            threads[i].join();
+        } // for
+        for (size_t iChunk = 0; iChunk < numChunks; ++iChunk) {
+            if (errors[iChunk]) {
+                std::rethrow_exception(errors[iChunk]);
+            } // if
+        } // for
+
+        // Gather lines in order, stopping at first error or after last line.
+        for (size_t iChunk = 0; iChunk < numChunks; ++iChunk) {
+            const Chunk& chunk = chunks[iChunk];
+            const size_t numChunkLines = std::min(chunk.lineEnds.size(), maxLines - numLines);
+            _values.insert(_values.end(), chunk.values.begin(), chunk.values.begin() + numChunkLines*_numValues);
+            numLines += numChunkLines;
+            if (numChunkLines > 0) {
+                _begin = chunk.lineEnds[numChunkLines-1];
+                _hasEndOfLine = !(_appendedEndOfLine && (_begin == _buffer.size()));
+            } // if
+            if (numChunkLines < chunk.lineEnds.size()) {
+                break;
+            } else if (chunk.error) {
+                if (numLines < maxLines) {
+                    _error = true;
+                    _errorLine.assign(&_buffer[chunk.errorBegin], chunk.errorEnd - chunk.errorBegin);
+                    _errorNumValues = chunk.errorNumValues;
+                } // if
+                break;
+            } // if/else
+            _begin = chunk.end;
+        } // for
+    } // while
+    _numLinesParsed += numLines;
+
+    return numLines;
+} // parse
+
+
+// ----------------------------------------------------------------------
+// Get values from lines parsed in last block.
+const double*
+spatialdata::utils::DataParser::getValues(void) const {
+    return _values.empty() ? NULL : &_values[0];
+} // getValues
+
+
+// ----------------------------------------------------------------------
+// Check whether there was an error parsing a line.
+bool
+spatialdata::utils::DataParser::hasError(void) const {
+    return _error;
+} // hasError
+
+
+// ----------------------------------------------------------------------
+// Get line with error.
+const std::string&
+spatialdata::utils::DataParser::getErrorLine(void) const {
+    return _errorLine;
+} // getErrorLine
+
+
+// ----------------------------------------------------------------------
+// Get number of values parsed from line with error.
+size_t
+spatialdata::utils::DataParser::getErrorNumValues(void) const {
+    return _errorNumValues;
+} // getErrorNumValues
+
+
+// ----------------------------------------------------------------------
+// Check whether last line parsed ends with an end-of-line character.
+bool
+spatialdata::utils::DataParser::hasEndOfLine(void) const {
+    return _hasEndOfLine;
+} // hasEndOfLine
+
+
+// ----------------------------------------------------------------------
+// Append next block from stream to buffer, discarding parsed lines.
+void
+spatialdata::utils::DataParser::_fill(void) {
+    assert(!_endOfStream);
+
+    _buffer.erase(_buffer.begin(), _buffer.begin() + _begin);
+    _begin = 0;
+
+    const size_t size = _buffer.size();
+    _buffer.resize(size + _blockSize);
+    _in.read(&_buffer[size], _blockSize);
+    const size_t numRead = _in.gcount();
+    _buffer.resize(size + numRead);
+
+    if (numRead < _blockSize) {
+        _endOfStream = true;
+        // Treat unterminated last line as a complete line.
+        if (!_buffer.empty() && ('\n' != _buffer.back())) {
+            _buffer.push_back('\n');
+            _appendedEndOfLine = true;
+        } // if
+    } // if
+} // _fill
+
+
+// ----------------------------------------------------------------------
+// Parse lines in chunk of buffer.
+void
+spatialdata::utils::DataParser::_parseChunk(Chunk* chunk,
+                                            const size_t maxLines) const {
+    assert(chunk);
+
+    chunk->error = false;
+    if (chunk->begin == chunk->end) {
+        return;
+    } // if
+
+    const char* const buffer = &_buffer[0];
+    const char* const end = buffer + chunk->end;
+    const char* pos = buffer + chunk->begin;
+    while (pos < end && chunk->lineEnds.size() < maxLines) {
+        // Skip whitespace, including blank lines.
+        if (( ' ' == *pos) || ( '\t' == *pos) || ( '\n' == *pos) || ( '\r' == *pos) || ( '\v' == *pos) || ( '\f' == *pos) ) {
+            ++pos;
+            continue;
+        } // if
+
+        const char* eol = (const char*)memchr(pos, '\n', end - pos);
+        assert(eol);
+        const char* lineEnd = std::search(pos, eol, _delimiter.begin(), _delimiter.end());
+        if (lineEnd == pos) {
+            pos = eol + 1;
+            continue;
+        } // if
+
+        const char* value = pos;
+        for (size_t iValue = 0; iValue < _numValues; ++iValue) {
+            double number = 0.0;
+            if (!_parseNumber(&value, lineEnd, &number)) {
+                chunk->error = true;
+                chunk->errorBegin = pos - buffer;
+                chunk->errorEnd = lineEnd - buffer;
+                chunk->errorNumValues = iValue;
+                return;
+            } // if
+            chunk->values.push_back(number);
+        } // for
+        pos = eol + 1;
+        chunk->lineEnds.push_back(pos - buffer);
+    } // while
+} // _parseChunk
+
+
+// ----------------------------------------------------------------------
+// Parse number.
+bool
+spatialdata::utils::DataParser::_parseNumber(const char** pos,
+                                             const char* end,
+                                             double* value) {
+    assert(pos);
+    assert(value);
+
+    const char* p = *pos;
+    while (p < end && (( ' ' == *p) || ( '\t' == *p) || ( '\r' == *p) || ( '\v' == *p) || ( '\f' == *p) )) {
+        ++p;
+    } // while
+    const char* const start = p;
+
+    bool negative = false;
+    if (( p < end) && (( '-' == *p) || ( '+' == *p) )) {
+        negative = '-' == *p;
+        ++p;
+    } // if
+
+    // Accumulate up to 19 significant digits, which fit in 64 bits.
+    uint64_t mantissa = 0;
+    int numDigits = 0;
+    int exponent = 0;
+    bool exact = true;
+    bool hasDigits = false;
+    for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        hasDigits = true;
+        if (numDigits < 19) {
+            mantissa = 10*mantissa + (*p - '0');
+            numDigits += mantissa > 0;
+        } else {
+            ++exponent;
+            exact = false;
+        } // if/else
+    } // for
+    if (( p < end) && ( '.' == *p) ) {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+            hasDigits = true;
+            if (numDigits < 19) {
+                mantissa = 10*mantissa + (*p - '0');
+                numDigits += mantissa > 0;
+                --exponent;
+            } else {
+                exact = false;
+            } // if/else
+        } // for
+    } // if
+    if (!hasDigits) {
+        return false;
+    } // if
+    if (( p < end) && (( 'e' == *p) || ( 'E' == *p) )) {
+        const char* q = p + 1;
+        bool negativeExp = false;
+        if (( q < end) && (( '-' == *q) || ( '+' == *q) )) {
+            negativeExp = '-' == *q;
+            ++q;
+        } // if
+        if (( q < end) && *q >= '0' && *q <= '9') {
+            int exp10 = 0;
+            for (; q < end && *q >= '0' && *q <= '9'; ++q) {
+                exp10 = std::min(10*exp10 + (*q - '0'), 100000);
+            } // for
+            exponent += negativeExp ? -exp10 : exp10;
+            p = q;
+        } // if
+    } // if
+    if (( p < end) && ( ' ' != *p) && ( '\t' != *p) && ( '\r' != *p) && ( '\v' != *p) && ( '\f' != *p) ) {
+        return false;
+    } // if
+
+    // Mantissa and power of 10 are both exact, so a single multiplication
+    // or division is correctly rounded. Otherwise fall back to the
+    // standard library.
+    const uint64_t maxMantissa = uint64_t(1) << 53;
+    if (!mantissa) {
+        *value = negative ? -0.0 : 0.0;
+    } else if (exact && ( mantissa <= maxMantissa) && ( exponent >= -22) && ( exponent <= 22) ) {
+        const double result = (exponent < 0) ? double(mantissa) / _powers10[-exponent] : double(mantissa) * _powers10[exponent];
+        *value = negative ? -result : result;
+    } else {
+        std::istringstream buffer(std::string(start, p));
+        buffer.imbue(std::locale::classic());
+        buffer >> *value;
+        if (buffer.fail()) {
+            return false;
+        } // if
+    } // if/else
+
+    *pos = p;
+    return true;
+} // _parseNumber
+
+
+// End of file
@@ -0,0 +1,180 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file libsrc/utils/DataParser.hh
+ *
+ * @brief C++ parser for lines of numbers in the data section of ASCII
+ * files.
+ *
+ * The input stream is read in large blocks that are split at
+ * end-of-line characters and parsed concurrently. Lines are handled
+ * the same way as LineParser with whitespace ignored: blank lines and
+ * lines starting with a comment are skipped, and comments at the end
+ * of a line are removed. Numbers are parsed independent of the locale.
+ */
+
+#if !defined(spatialdata_utils_dataparser_hh)
+#define spatialdata_utils_dataparser_hh
+
+#include "utilsfwd.hh"
+
+#include <string> // HASA std::string
+#include <vector> // HASA std::vector
+#include <iosfwd> // USES std::istream
+
+/// C++ parser for lines of numbers in the data section of ASCII files.
+class spatialdata::utils::DataParser { // class DataParser
+    friend class TestDataParser;
+
+public:
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+
+    /** Constructor.
+     *
+     * @param sin Input stream positioned at first line of data.
+     * @param delimiter String that marks beginning of comment.
+     * @param numValues Number of values to parse from each line.
+     * @param numLines Number of lines to parse.
+     * @param numThreads Number of threads (0 to use number of cores).
+     */
+    DataParser(std::istream& sin,
+               const char* delimiter,
+               const size_t numValues,
+               const size_t numLines,
+               const size_t numThreads=1);
+
+    /// Destructor.
+    ~DataParser(void);
+
+    /** Parse next block of lines.
+     *
+     * Parsing stops at the first line with an error; the lines before
+     * it are returned.
+     *
+     * @returns Number of lines parsed (0 when all lines have been parsed).
+     */
+    size_t parse(void);
+
+    /** Get values from lines parsed in last block.
+     *
+     * @returns Array of values [numLines*numValues].
+     */
+    const double* getValues(void) const;
+
+    /** Check whether there was an error parsing a line.
+     *
+     * @returns True if a line has fewer values than expected or a value
+     * could not be parsed, including when the stream ends before all
+     * lines are parsed.
+     */
+    bool hasError(void) const;
+
+    /** Get line with error, with leading whitespace and comment removed.
+     *
+     * @returns Line with error (empty if stream ended).
+     */
+    const std::string& getErrorLine(void) const;
+
+    /** Get number of values parsed from line with error.
+     *
+     * @returns Number of values parsed before error.
+     */
+    size_t getErrorNumValues(void) const;
+
+    /** Check whether last line parsed ends with an end-of-line character.
+     *
+     * @returns False if last line parsed was terminated by end of stream.
+     */
+    bool hasEndOfLine(void) const;
+
+private:
+
+    // PRIVATE STRUCTS ////////////////////////////////////////////////////
+
+    /// Lines parsed from a contiguous piece of the buffer.
+    struct Chunk {
+        size_t begin; ///< Offset of first character in buffer.
+        size_t end; ///< Offset after last character in buffer.
+        std::vector<double> values; ///< Values parsed from lines.
+        std::vector<size_t> lineEnds; ///< Offset after end of each line parsed.
+        bool error; ///< True if there was an error parsing a line.
+        size_t errorBegin; ///< Offset of beginning of line with error.
+        size_t errorEnd; ///< Offset of end of line with error.
+        size_t errorNumValues; ///< Number of values parsed from line with error.
+    };
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+
+    /// Append next block from stream to buffer, discarding parsed lines.
+    void _fill(void);
+
+    /** Parse lines in chunk of buffer.
+     *
+     * @param chunk Chunk of buffer.
+     * @param maxLines Maximum number of lines to parse.
+     */
+    void _parseChunk(Chunk* chunk,
+                     const size_t maxLines) const;
+
+    /** Parse number.
+     *
+     * @param pos Position of number, updated to position after number.
+     * @param end End of line.
+     * @param value Value of number.
+     * @returns True if number was parsed, false otherwise.
+     */
+    static
+    bool _parseNumber(const char** pos,
+                      const char* end,
+                      double* value);
+
+    // NOT IMPLEMENTED ////////////////////////////////////////////////////
+
+    DataParser(const DataParser&); ///< Not implemented
+    const DataParser& operator=(const DataParser&); ///< Not implemented
+
+private:
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+
+    static const size_t _blockSize; ///< Number of characters read from stream at a time.
+    static const size_t _minChunkSize; ///< Smallest number of characters worth the overhead of a thread.
+    static const double _powers10[]; ///< Powers of 10 that are exact in double precision.
+
+    std::istream& _in; ///< Input stream.
+    std::string _delimiter; ///< Comment delimiter.
+    const size_t _numValues; ///< Number of values on each line.
+    const size_t _numLines; ///< Number of lines to parse.
+    size_t _numThreads; ///< Number of threads.
+
+    std::vector<char> _buffer; ///< Characters read from stream.
+    size_t _begin; ///< Offset of first character in buffer not yet parsed.
+    bool _endOfStream; ///< True if all characters have been read from stream.
+    bool _appendedEndOfLine; ///< True if end-of-line was appended to last line in stream.
+
+    std::vector<double> _values; ///< Values parsed from last block.
+    size_t _numLinesParsed; ///< Number of lines parsed.
+    bool _hasEndOfLine; ///< True if last line parsed ends with end-of-line.
+    bool _error; ///< True if there was an error parsing a line.
+    std::string _errorLine; ///< Line with error.
+    size_t _errorNumValues; ///< Number of values parsed from line with error.
+
+}; // class DataParser
+
+#endif // spatialdata_utils_dataparser_hh
+
+// End of file
@@ -28,6 +28,7 @@
 namespace spatialdata {
   namespace utils {
     class LineParser;
+    class DataParser;
     class PointsStream;
 
     class SpatialdataVersion;
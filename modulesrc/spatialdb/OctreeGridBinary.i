@@ -0,0 +1,65 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file modulesrc/spatialdb/OctreeGridBinary.i
+ *
+ * @brief SWIG interface to C++ OctreeGridBinary object.
+ */
+
+namespace spatialdata {
+  namespace spatialdb {
+
+    class spatialdata::spatialdb::OctreeGridBinary
+    { // OctreeGridBinary
+
+    public :
+      // PUBLIC METHODS /////////////////////////////////////////////////
+
+      // Using default constructor.
+
+      // Using default destructor.
+
+      // Using default copy constructor
+
+      /** Check whether file is a binary OctreeGridDB file.
+       *
+       * @param filename Name of file.
+       * @returns True if file starts with binary file header, false otherwise.
+       */
+      static
+      bool isBinary(const char* filename);
+
+      /** Read the database.
+       *
+       * @param db Spatial database.
+       */
+      static
+      void read(OctreeGridDB* db);
+
+      /** Write the database.
+       *
+       * @param db Spatial database.
+       */
+      static
+      void write(const OctreeGridDB& db);
+
+    }; // class OctreeGridBinary
+
+  } // spatialdb
+} // spatialdata
+
+
+// End of file
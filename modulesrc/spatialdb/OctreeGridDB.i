@@ -0,0 +1,153 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file modulesrc/spatialdb/OctreeGridDB.i
+ *
+ * @brief SWIG interface to C++ OctreeGridDB object.
+ */
+
+namespace spatialdata {
+  namespace spatialdb {
+
+    class OctreeGridDB : public SpatialDB
+    { // class OctreeGridDB
+
+    public :
+      // PUBLIC ENUM ////////////////////////////////////////////////////
+
+      /** Type of query */
+      enum QueryEnum {
+	NEAREST=0,
+	LINEAR=1
+      };
+
+    public :
+      // PUBLIC METHODS /////////////////////////////////////////////////
+
+      /// Default constructor.
+      OctreeGridDB(void);
+
+      /// Default destructor.
+      ~OctreeGridDB(void);
+
+      /** Set filename containing data.
+       *
+       * @param value Name of data file.
+       */
+      void setFilename(const char* value);
+
+      /** Set query type.
+       *
+       * @param queryType Set type of query
+       */
+      void setQueryType(const OctreeGridDB::QueryEnum queryType);
+
+      /** Set values that build() reproduces exactly.
+       *
+       * @pre Must call before build().
+       *
+       * @param names Names of values to reproduce exactly.
+       * @param numNames Number of names.
+       */
+      %apply(const char* const* string_list, const int list_len){
+	(const char* const* names, const size_t numNames)
+	  };
+      void setExactValues(const char* const* names,
+			  const size_t numNames);
+      %clear(const char* const* names, const size_t numNames);
+
+      /** Build octree from values on fine grid.
+       *
+       * @param fine Spatial database with values on fine grid.
+       * @param tolerance Maximum error of each value relative to the range
+       *   of the value over the grid (0 to reproduce values exactly).
+       */
+      void build(SimpleGridDB* fine,
+		 const double tolerance);
+
+      /** Get number of leaves in octree.
+       *
+       * @returns Number of leaves.
+       */
+      size_t getNumLeaves(void) const;
+
+      /** Get depth of octree.
+       *
+       * @returns Number of levels below root.
+       */
+      size_t getDepth(void) const;
+
+      /** Get size of octree and values.
+       *
+       * @returns Size in bytes of nodes, leaves, and values.
+       */
+      size_t getStorageSize(void) const;
+
+      /// Open the database and prepare for querying.
+      void open(void);
+
+      /// Close the database.
+      void close(void);
+
+      /** Set values to be returned by queries.
+       *
+       * @pre Must call open() before setQueryValues()
+       *
+       * @param names Names of values to be returned in queries
+       * @param numVals Number of values to be returned in queries
+       */
+      %apply(const char* const* string_list, const int list_len){
+	(const char* const* names, const size_t numVals)
+	  };
+      void setQueryValues(const char* const* names,
+		     const size_t numVals);
+      %clear(const char* const* names, const size_t numVals);
+
+      /** Query the database.
+       *
+       * @pre Must call open() before query()
+       *
+       * @param vals Array for computed values (output from query), vals
+       *   must be allocated BEFORE calling query().
+       * @param numVals Number of values expected (size of pVals array)
+       * @param coords Coordinates of point for query
+       * @param numDims Number of dimensions for coordinates
+       * @param pCSQuery Coordinate system of coordinates
+       *
+       * @returns 0 on success, 1 on failure (i.e., could not interpolate
+       *   so values set to 0)
+       */
+      %apply(double* INPLACE_ARRAY1, int DIM1) {
+	(double* vals, const size_t numVals)
+	  };
+      %apply(double* IN_ARRAY1, int DIM1) {
+	(const double* coords, const size_t numDims)
+	  };
+      int query(double* vals,
+		const size_t numVals,
+		const double* coords,
+		const size_t numDims,
+		const spatialdata::geocoords::CoordSys* pCSQuery);
+      %clear(double* vals, const size_t numVals);
+      %clear(const double* coords, const size_t numDims);
+
+    }; // class OctreeGridDB
+
+  } // spatialdb
+} // spatialdata
+
+
+// End of file
@@ -43,6 +43,35 @@ namespace spatialdata {
        * @param dir Directory containing data files.
        */
       void setDataDir(const char* dir);
+
+      /** Set directory for cache files holding voxet values in native
+       * byte order.
+       *
+       * @param dir Directory for cache files (empty for no cache files).
+       */
+      void setCacheDir(const char* dir);
+
+      /** Set region of interest, so that only the part of the voxets
+       * needed for queries inside the region is read.
+       *
+       * @param xMin Minimum x coordinate of region.
+       * @param yMin Minimum y coordinate of region.
+       * @param xMax Maximum x coordinate of region.
+       * @param yMax Maximum y coordinate of region.
+       * @param cs Coordinate system of region.
+       */
+      void setRegion(const double xMin,
+		     const double yMin,
+		     const double xMax,
+		     const double yMax,
+		     const spatialdata::geocoords::CoordSys* cs);
+
+      /** Did a query outside the region of interest read the full voxets?
+       *
+       * @returns True if the full voxets were read after a query
+       *   outside the region of interest, false otherwise.
+       */
+      bool isRegionExceeded(void) const;
       
       /** Set minimum shear wave speed. Corresponding minima for Vp and
        * density are enforced using nominal Vp->Vs relation and
@@ -40,7 +40,8 @@ namespace spatialdata {
       /** Type of query */
       enum QueryEnum {
 	NEAREST=0,
-	LINEAR=1
+	LINEAR=1,
+	DELAUNAY=2
       };
 
     public :
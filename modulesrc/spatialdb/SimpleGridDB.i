@@ -35,6 +35,25 @@ namespace spatialdata {
 	LINEAR=1
       };
 
+      /** Precision of stored values */
+      enum PrecisionEnum {
+	DOUBLE=0,
+	SINGLE=1
+      };
+
+      /** Layout of stored values */
+      enum LayoutEnum {
+	FLAT=0,
+	BRICK=1
+      };
+
+      /** Compression of stored values */
+      enum CompressionEnum {
+	UNCOMPRESSED=0,
+	LOSSLESS=1,
+	LOSSY=2
+      };
+
     public :
       // PUBLIC METHODS /////////////////////////////////////////////////
 
@@ -58,6 +77,89 @@ namespace spatialdata {
        */
       void setQueryType(const SimpleGridDB::QueryEnum queryType);
 
+      /** Set precision of stored values.
+       *
+       * @pre Must call before open().
+       *
+       * @param value Precision of stored values.
+       */
+      void setPrecision(const SimpleGridDB::PrecisionEnum value);
+
+      /** Set layout of stored values.
+       *
+       * @pre Must call before open().
+       *
+       * @param value Layout of stored values.
+       */
+      void setLayout(const SimpleGridDB::LayoutEnum value);
+
+      /** Set maximum size of cache of values read as they are queried.
+       *
+       * @pre Must call before open().
+       *
+       * @param value Maximum size in bytes of cache (0 to load all values).
+       */
+      void setCacheSize(const size_t value);
+
+      /** Set whether processes on the same node share coordinates and
+       * values in shared memory.
+       *
+       * @pre Must call before open().
+       *
+       * @param value True to share values in shared memory, false otherwise.
+       */
+      void setSharedMemory(const bool value);
+
+      /** Set number of threads used to parse values in ASCII files.
+       *
+       * @pre Must call before open().
+       *
+       * @param value Number of threads (0 to use number of cores).
+       */
+      void setNumReaderThreads(const size_t value);
+
+      /** Set compression of stored values.
+       *
+       * @pre Must call before open().
+       *
+       * @param value Compression of stored values.
+       */
+      void setCompression(const SimpleGridDB::CompressionEnum value);
+
+      /** Set tolerance for lossy compression.
+       *
+       * @pre Must call before open().
+       *
+       * @param value Maximum error of each value relative to the range of
+       *   the value over the grid.
+       */
+      void setCompressionTolerance(const double value);
+
+      /** Get size of compressed values.
+       *
+       * @returns Size in bytes of compressed values (0 if values are not
+       *   compressed).
+       */
+      size_t getCompressedSize(void) const;
+
+      /** Get number of queries of values in chunks held in cache.
+       *
+       * @returns Number of hits (0 if cache is not used).
+       */
+      size_t getCacheHits(void) const;
+
+      /** Get number of queries of values in chunks read from file.
+       *
+       * @returns Number of misses (0 if cache is not used).
+       */
+      size_t getCacheMisses(void) const;
+
+      /** Get number of chunks evicted from cache.
+       *
+       * @returns Number of evictions (0 if cache is not used).
+       */
+      size_t getCacheEvictions(void) const;
+
       /// Open the database and prepare for querying.
       void open(void);
 
@@ -35,6 +35,12 @@ namespace spatialdata {
       /// Default destructor.
       ~SimpleIOAscii(void);  
       
+      /** Set number of threads used to parse values.
+       *
+       * @param value Number of threads (0 to use number of cores).
+       */
+      void setNumReaderThreads(const size_t value);
+      
       /** Read the database.
        *
        * @param pData Database data
@@ -26,6 +26,9 @@ namespace spatialdata {
 
   namespace spatialdb {
 
+    // Release the GIL while querying multiple locations.
+    %thread SpatialDB::multiquery;
+
     class SpatialDB
     { // class SpatialDB
 
@@ -110,7 +113,17 @@ namespace spatialdata {
       %clear(double* vals, const size_t numVals);
       %clear(const double* coords, const size_t numDims);
       
+      /** Can the database be queried concurrently?
+       *
+       * @returns True if multiquery() can use several threads, false otherwise.
+       */
+      virtual
+      bool isThreadSafe(void) const;
+
       /** Perform multiple queries of the database.
+       *
+       * The Python global interpreter lock is released during the
+       * queries.
        *
        * @note vals should be preallocated to accommodate numVals values
        * at numLocs locations.
@@ -130,6 +143,8 @@ namespace spatialdata {
        * @param numLocsC Number of locations.
        * @param numDimsC Number of dimensions for coordinates.
        * @param csQuery Coordinate system of coordinates.
+       * @param numThreads Number of threads to use (0 for number of
+       *   hardware threads).
        */
       %apply(double* INPLACE_ARRAY2, int DIM1, int DIM2) {
 	(double* vals,
@@ -153,7 +168,8 @@ namespace spatialdata {
 		      const double* coords,
 		      const size_t numLocsC,
 		      const size_t numDimsC,
-		      const spatialdata::geocoords::CoordSys* csQuery);
+		      const spatialdata::geocoords::CoordSys* csQuery,
+		      const size_t numThreads=1);
       %clear(double* vals, const size_t numLocsV, const size_t numValsV);
       %clear(int* err, const size_t numLocsE);
       %clear(const double* coords, const size_t numLocsC, const size_t numDimsC);
@@ -141,6 +141,15 @@ namespace spatialdata {
 	    %clear(double* vals, const size_t numVals);
 	    %clear(const double* coords, const size_t numDims);
 	    
+	    /** Set whether the user functions may be called concurrently.
+	     *
+	     * The database is queried using a single thread unless the
+	     * user functions are declared reentrant.
+	     *
+	     * @param value True if user functions are reentrant, false otherwise.
+	     */
+	    void setThreadSafe(const bool value);
+	    
 	    /** Set coordinate system associated with user functions.
 	     *
 	     * @param cs Coordinate system.
@@ -15,7 +15,8 @@
 //
 
 // SWIG interface
-%module spatialdb
+%module(threads="1") spatialdb
+%nothread; // Only methods marked with %thread release the GIL.
 
 // Header files for module C++ code
 %{
@@ -32,6 +33,9 @@
 #include "spatialdata/spatialdb/UniformDB.hh"
 #include "spatialdata/spatialdb/SimpleGridDB.hh"
 #include "spatialdata/spatialdb/SimpleGridAscii.hh"
+#include "spatialdata/spatialdb/SimpleGridBinary.hh"
+#include "spatialdata/spatialdb/OctreeGridDB.hh"
+#include "spatialdata/spatialdb/OctreeGridBinary.hh"
 #include "spatialdata/spatialdb/UserFunctionDB.hh"
 #include "spatialdata/spatialdb/CompositeDB.hh"
 #include "spatialdata/spatialdb/SCECCVMH.hh"
@@ -72,6 +76,9 @@ import_array();
 %include "UniformDB.i"
 %include "SimpleGridDB.i"
 %include "SimpleGridAscii.i"
+%include "SimpleGridBinary.i"
+%include "OctreeGridDB.i"
+%include "OctreeGridBinary.i"
 %include "UserFunctionDB.i"
 %include "CompositeDB.i"
 %include "SCECCVMH.i"
@@ -0,0 +1,112 @@
+# ----------------------------------------------------------------------
+#
+# Brad T. Aagaard, U.S. Geological Survey
+#
+# This code was developed as part of the Computational Infrastructure
+# for Geodynamics (http://geodynamics.org).
+#
+# Copyright (c) 2010-2017 University of California, Davis
+#
+# See COPYING for license information.
+#
+# ----------------------------------------------------------------------
+#
+
+# @file spatialdata/spatialdb/OctreeGridDB.py
+#
+# @brief Python manager for spatial database on adaptive octree.
+#
+# Factory: spatial_database
+
+from .SpatialDBObj import SpatialDBObj
+from .spatialdb import OctreeGridDB as ModuleOctreeGridDB
+
+
+def validateFilename(value):
+    """
+    Validate filename.
+    """
+    if 0 == len(value):
+        raise ValueError("Name of OctreeGridDB file must be specified.")
+    try:
+        fin = open(value, "r")
+    except IOError:
+        raise IOError("Spatial database file '{}' not found.".format(value))
+    return value
+
+
+class OctreeGridDB(SpatialDBObj, ModuleOctreeGridDB):
+    """
+    Python manager for spatial database on adaptive octree.
+
+    Factory: spatial_database
+
+    INVENTORY
+
+    Properties
+      - *filename* Name of binary spatial database file (written by OctreeGridBinary).
+      - *query_type* Type of query to perform.
+      - *exact_values* Names of values that build() reproduces exactly.
+
+    Facilities
+      - None
+    """
+
+    import pythia.pyre.inventory
+
+    filename = pythia.pyre.inventory.str("filename", default="", validator=validateFilename)
+    filename.meta['tip'] = "Name for data file."
+
+    queryType = pythia.pyre.inventory.str("query_type", default="nearest")
+    queryType.validator = pythia.pyre.inventory.choice(["nearest", "linear"])
+    queryType.meta['tip'] = "Type of query to perform."
+
+    exactValues = pythia.pyre.inventory.list("exact_values", default=[])
+    exactValues.meta['tip'] = "Names of values that build() reproduces exactly regardless of tolerance (e.g., tags or material ids)."
+
+    # PUBLIC METHODS /////////////////////////////////////////////////////
+
+    def __init__(self, name="octreegriddb"):
+        """
+        Constructor.
+        """
+        SpatialDBObj.__init__(self, name)
+        return
+
+    # PRIVATE METHODS ////////////////////////////////////////////////////
+
+    def _configure(self):
+        """
+        Set members based on inventory.
+        """
+        SpatialDBObj._configure(self)
+        ModuleOctreeGridDB.setFilename(self, self.filename)
+        ModuleOctreeGridDB.setQueryType(self, self._parseQueryString(self.queryType))
+        ModuleOctreeGridDB.setExactValues(self, self.exactValues)
+
+    def _createModuleObj(self):
+        """
+        Create Python module object.
+        """
+        ModuleOctreeGridDB.__init__(self)
+
+    def _parseQueryString(self, label):
+        if label.lower() == "nearest":
+            value = ModuleOctreeGridDB.NEAREST
+        elif label.lower() == "linear":
+            value = ModuleOctreeGridDB.LINEAR
+        else:
+            raise ValueError("Unknown value for query type '%s' in spatial database %s." % (label, self.label))
+        return value
+
+
+# FACTORIES ////////////////////////////////////////////////////////////
+
+def spatial_database():
+    """
+    Factory associated with OctreeGridDB.
+    """
+    return OctreeGridDB()
+
+
+# End of file
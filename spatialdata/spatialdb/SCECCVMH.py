@@ -32,13 +32,15 @@ class SCECCVMH(SpatialDBObj, ModuleSCECCVMH):
 
     Properties
       - *data_dir* Directory containing SCEC CVM-H data files.
+      - *cache_dir* Directory for cache files with voxet values in native byte order (empty for none).
+      - *region* Region of interest [x_min, y_min, x_max, y_max] (empty for entire model).
       - *min_vs* Minimum shear wave speed.
       - *squash* Squash topography/bathymetry to sea level.
       - *squash_limit* Elevation above which topography/bathymetry is adjusted.
       - *label* Descriptive label for seismic velocity model.
 
     Facilities
-      - None
+      - *region_coordsys* Coordinate system of region of interest.
     """
 
     import pythia.pyre.inventory
@@ -46,6 +48,16 @@ class SCECCVMH(SpatialDBObj, ModuleSCECCVMH):
     dataDir = pythia.pyre.inventory.str("data_dir", default=".")
     dataDir.meta['tip'] = "Directory containing SCEC CVM-H data files."
 
+    cacheDir = pythia.pyre.inventory.str("cache_dir", default="")
+    cacheDir.meta['tip'] = "Directory for cache files with voxet values in native byte order (empty for none)."
+
+    region = pythia.pyre.inventory.list("region", default=[])
+    region.meta['tip'] = "Region of interest [x_min, y_min, x_max, y_max] (empty for entire model)."
+
+    from spatialdata.geocoords.CSGeo import CSGeo
+    regionCS = pythia.pyre.inventory.facility("region_coordsys", factory=CSGeo)
+    regionCS.meta['tip'] = "Coordinate system of region of interest."
+
     from pythia.pyre.units.length import meter
     from pythia.pyre.units.time import second
     minVs = pythia.pyre.inventory.dimensional("min_vs", default=500.0 * meter / second)
@@ -69,6 +81,17 @@ class SCECCVMH(SpatialDBObj, ModuleSCECCVMH):
         """
         SpatialDBObj.__init__(self, name)
 
+    def close(self):
+        """
+        Close the database, reporting whether a query outside the region of interest read the full voxets.
+        """
+        if ModuleSCECCVMH.isRegionExceeded(self):
+            self._warning.log(
+                "Query location was outside the region of interest of spatial database '%s', so the full "
+                "SCEC CVM-H voxets were read. Set a region of interest that contains all query locations "
+                "to limit memory use." % self.label)
+        ModuleSCECCVMH.close(self)
+
     # PRIVATE METHODS ////////////////////////////////////////////////////
 
     def _configure(self):
@@ -76,8 +99,13 @@ class SCECCVMH(SpatialDBObj, ModuleSCECCVMH):
         Set members based on inventory.
         """
         SpatialDBObj._configure(self)
+        self._validateParameters(self.inventory)
         ModuleSCECCVMH.setLabel(self, "SCEC CVM-H")
         ModuleSCECCVMH.setDataDir(self, self.dataDir)
+        ModuleSCECCVMH.setCacheDir(self, self.cacheDir)
+        if len(self.region) > 0:
+            region = list(map(float, self.region))
+            ModuleSCECCVMH.setRegion(self, region[0], region[1], region[2], region[3], self.regionCS)
         ModuleSCECCVMH.setMinVs(self, self.minVs.value)
         ModuleSCECCVMH.setSquashFlag(self, self.squash, self.squashLimit.value)
 
@@ -87,6 +115,17 @@ class SCECCVMH(SpatialDBObj, ModuleSCECCVMH):
         """
         ModuleSCECCVMH.__init__(self)
 
+    def _validateParameters(self, params):
+        """
+        Validate parameters.
+        """
+        if len(params.region) not in (0, 4):
+            raise ValueError("Region of interest must be empty or a 4 component list [x_min, y_min, x_max, y_max].")
+        try:
+            regionFloat = list(map(float, params.region))
+        except:
+            raise ValueError("Region of interest must contain floating point values.")
+
 
 # FACTORIES ////////////////////////////////////////////////////////////
 
@@ -31,7 +31,7 @@ class SimpleDB(SpatialDBObj, ModuleSimpleDB):
     INVENTORY
 
     Properties
-      - *query_type* Type of query to perform [nearest, linear].
+      - *query_type* Type of query to perform [nearest, linear, delaunay].
 
     Facilities
       - *iohandler* I/O handler for database.
@@ -40,7 +40,7 @@ class SimpleDB(SpatialDBObj, ModuleSimpleDB):
     import pythia.pyre.inventory
 
     queryType = pythia.pyre.inventory.str("query_type", default="nearest")
-    queryType.validator = pythia.pyre.inventory.choice(["nearest", "linear"])
+    queryType.validator = pythia.pyre.inventory.choice(["nearest", "linear", "delaunay"])
     queryType.meta['tip'] = "Type of query to perform."
 
     from .SimpleIOAscii import SimpleIOAscii
@@ -77,6 +77,8 @@ class SimpleDB(SpatialDBObj, ModuleSimpleDB):
             value = ModuleSimpleDB.NEAREST
         elif label.lower() == "linear":
             value = ModuleSimpleDB.LINEAR
+        elif label.lower() == "delaunay":
+            value = ModuleSimpleDB.DELAUNAY
         else:
             raise ValueError("Unknown value for query type '%s'." % label)
         return value
@@ -46,6 +46,13 @@ class SimpleGridDB(SpatialDBObj, ModuleSimpleGridDB):
     Properties
       - *filename* Name of spatial database file.
       - *query_type* Type of query to perform.
+      - *precision* Precision of stored values.
+      - *layout* Layout of stored values.
+      - *cache_size* Maximum size in bytes of cache of values read as they are queried.
+      - *shared_memory* Share values among processes on the same node.
+      - *num_reader_threads* Number of threads used to parse values in ASCII files.
+      - *compression* Compression of stored values.
+      - *compression_tolerance* Tolerance for lossy compression relative to range of each value.
 
     Facilities
       - None
@@ -60,6 +67,33 @@ class SimpleGridDB(SpatialDBObj, ModuleSimpleGridDB):
     queryType.validator = pythia.pyre.inventory.choice(["nearest", "linear"])
     queryType.meta['tip'] = "Type of query to perform."
 
+    precision = pythia.pyre.inventory.str("precision", default="double")
+    precision.validator = pythia.pyre.inventory.choice(["double", "single"])
+    precision.meta['tip'] = "Precision of stored values (values are interpolated in double precision)."
+
+    layout = pythia.pyre.inventory.str("layout", default="flat")
+    layout.validator = pythia.pyre.inventory.choice(["flat", "brick"])
+    layout.meta['tip'] = "Layout of stored values (brick groups points of 3-D grids in 8x8x8 bricks)."
+
+    cacheSize = pythia.pyre.inventory.int("cache_size", default=0)
+    cacheSize.validator = pythia.pyre.inventory.greaterEqual(0)
+    cacheSize.meta['tip'] = "Maximum size in bytes of cache of values read as they are queried (0 to load all values; requires binary file with brick layout)."
+
+    sharedMemory = pythia.pyre.inventory.bool("shared_memory", default=False)
+    sharedMemory.meta['tip'] = "Share values among processes on the same node in shared memory (ASCII files; binary files are shared through the file cache)."
+
+    numReaderThreads = pythia.pyre.inventory.int("num_reader_threads", default=1)
+    numReaderThreads.validator = pythia.pyre.inventory.greaterEqual(0)
+    numReaderThreads.meta['tip'] = "Number of threads used to parse values in ASCII files (0 to use number of cores)."
+
+    compression = pythia.pyre.inventory.str("compression", default="none")
+    compression.validator = pythia.pyre.inventory.choice(["none", "lossless", "lossy"])
+    compression.meta['tip'] = "Compression of stored values (queries decompress blocks of values into cache with size cache_size)."
+
+    compressionTolerance = pythia.pyre.inventory.float("compression_tolerance", default=1.0e-6)
+    compressionTolerance.validator = pythia.pyre.inventory.greaterEqual(0.0)
+    compressionTolerance.meta['tip'] = "Maximum error of values for lossy compression relative to range of each value."
+
     # PUBLIC METHODS /////////////////////////////////////////////////////
 
     def __init__(self, name="simplegriddb"):
@@ -78,6 +112,13 @@ class SimpleGridDB(SpatialDBObj, ModuleSimpleGridDB):
         SpatialDBObj._configure(self)
         ModuleSimpleGridDB.setFilename(self, self.filename)
         ModuleSimpleGridDB.setQueryType(self, self._parseQueryString(self.queryType))
+        ModuleSimpleGridDB.setPrecision(self, self._parsePrecisionString(self.precision))
+        ModuleSimpleGridDB.setLayout(self, self._parseLayoutString(self.layout))
+        ModuleSimpleGridDB.setCacheSize(self, self.cacheSize)
+        ModuleSimpleGridDB.setSharedMemory(self, self.sharedMemory)
+        ModuleSimpleGridDB.setNumReaderThreads(self, self.numReaderThreads)
+        ModuleSimpleGridDB.setCompression(self, self._parseCompressionString(self.compression))
+        ModuleSimpleGridDB.setCompressionTolerance(self, self.compressionTolerance)
 
     def _createModuleObj(self):
         """
@@ -94,6 +135,35 @@ class SimpleGridDB(SpatialDBObj, ModuleSimpleGridDB):
             raise ValueError("Unknown value for query type '%s' in spatial database %s." % (label, self.label))
         return value
 
+    def _parsePrecisionString(self, label):
+        if label.lower() == "double":
+            value = ModuleSimpleGridDB.DOUBLE
+        elif label.lower() == "single":
+            value = ModuleSimpleGridDB.SINGLE
+        else:
+            raise ValueError("Unknown value for precision '%s' in spatial database %s." % (label, self.label))
+        return value
+
+    def _parseLayoutString(self, label):
+        if label.lower() == "flat":
+            value = ModuleSimpleGridDB.FLAT
+        elif label.lower() == "brick":
+            value = ModuleSimpleGridDB.BRICK
+        else:
+            raise ValueError("Unknown value for layout '%s' in spatial database %s." % (label, self.label))
+        return value
+
+    def _parseCompressionString(self, label):
+        if label.lower() == "none":
+            value = ModuleSimpleGridDB.UNCOMPRESSED
+        elif label.lower() == "lossless":
+            value = ModuleSimpleGridDB.LOSSLESS
+        elif label.lower() == "lossy":
+            value = ModuleSimpleGridDB.LOSSY
+        else:
+            raise ValueError("Unknown value for compression '%s' in spatial database %s." % (label, self.label))
+        return value
+
 
 # FACTORIES ////////////////////////////////////////////////////////////
 
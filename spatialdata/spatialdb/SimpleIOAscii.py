@@ -27,8 +27,23 @@ class SimpleIOAscii(SimpleIO, ModuleSimpleIOAscii):
     Python ascii I/O manager for simple spatial database (SimpleDB).
 
     Factory: simpledb_io
+
+    INVENTORY
+
+    Properties
+      - *filename* Name of spatial database file.
+      - *num_reader_threads* Number of threads used to parse values.
+
+    Facilities
+      - None
     """
 
+    import pythia.pyre.inventory
+
+    numReaderThreads = pythia.pyre.inventory.int("num_reader_threads", default=1)
+    numReaderThreads.validator = pythia.pyre.inventory.greaterEqual(0)
+    numReaderThreads.meta['tip'] = "Number of threads used to parse values (0 to use number of cores)."
+
     # PUBLIC METHODS /////////////////////////////////////////////////////
 
     def __init__(self, name="simpleioascii"):
@@ -81,6 +96,7 @@ class SimpleIOAscii(SimpleIO, ModuleSimpleIOAscii):
 
     def _configure(self):
         ModuleSimpleIOAscii.setFilename(self, self.filename)
+        ModuleSimpleIOAscii.setNumReaderThreads(self, self.numReaderThreads)
 
     def _createModuleObj(self):
         """
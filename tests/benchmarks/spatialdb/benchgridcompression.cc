@@ -0,0 +1,234 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file tests/benchmarks/spatialdb/benchgridcompression.cc
+ *
+ * @brief Benchmark memory use and throughput of SimpleGridDB queries
+ * with uncompressed values and with values compressed without loss and
+ * within a tolerance.
+ *
+ * The grid holds a smooth velocity gradient, a velocity that is
+ * constant within layers, and a material tag, queried with locations
+ * in random order and in mesh order (a regular lattice of points
+ * numbered with z fastest).
+ *
+ * Usage: benchgridcompression [numPerAxis] [numQueries] [cacheSize] [tolerance]
+ *
+ * numPerAxis is the number of grid points along each axis of the 3-D
+ * grid (default is 128). cacheSize is the maximum size in bytes of the
+ * cache of decompressed blocks (default is 4 MiB). tolerance is the
+ * tolerance for lossy compression relative to the range of each value
+ * (default is 1.0e-4).
+ */
+
+#include <portinfo>
+
+#include "spatialdata/spatialdb/SimpleGridDB.hh" // USES SimpleGridDB
+#include "spatialdata/spatialdb/SimpleGridBinary.hh" // USES SimpleGridBinary
+#include "spatialdata/geocoords/CSCart.hh" // USES CSCart
+
+#include <chrono> // USES std::chrono
+#include <iostream> // USES std::cout
+#include <cstdlib> // USES atoi(), atof()
+#include <cstdio> // USES remove()
+#include <cmath> // USES cbrt(), floor(), fabs()
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::max()
+
+// ----------------------------------------------------------------------
+namespace {
+    /// Generate pseudo-random number in [0,1).
+    double
+    random01(unsigned long* seed) {
+        *seed = (1103515245*(*seed) + 12345) % 2147483648UL;
+        return double(*seed) / 2147483648.0;
+    } // random01
+
+    /** Query database at locations and report throughput.
+     *
+     * @param db Spatial database.
+     * @param values Array for values at locations.
+     * @param points Coordinates of query locations.
+     * @param cs Coordinate system of query locations.
+     * @param label Label for output.
+     * @returns Query time in seconds.
+     */
+    double
+    runQueries(spatialdata::spatialdb::SimpleGridDB* db,
+               std::vector<double>* values,
+               const std::vector<double>& points,
+               const spatialdata::geocoords::CoordSys& cs,
+               const char* label) {
+        const size_t spaceDim = 3;
+        const size_t numValues = 3;
+        const size_t numQueries = points.size() / spaceDim;
+
+        values->resize(numQueries*numValues);
+        std::vector<int> err(numQueries);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        db->multiquery(&(*values)[0], numQueries, numValues, &err[0], numQueries, &points[0], numQueries, spaceDim, &cs);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << "  " << label << ": " << numQueries / elapsed.count() << " queries/s" << std::endl;
+        return elapsed.count();
+    } // runQueries
+} // namespace
+
+// ----------------------------------------------------------------------
+int
+main(int argc,
+     char* argv[]) {
+    const size_t numPerAxis = (argc > 1) ? atoi(argv[1]) : 128;
+    const size_t numQueries = (argc > 2) ? atoi(argv[2]) : 1000000;
+    const size_t cacheSize = (argc > 3) ? atoi(argv[3]) : 4*1048576;
+    const double tolerance = (argc > 4) ? atof(argv[4]) : 1.0e-4;
+
+    const size_t spaceDim = 3;
+    const size_t dataDim = 3;
+    const size_t numValues = 3;
+    const char* names[numValues] = { "vp", "vs", "material-id" };
+    const char* units[numValues] = { "m/s", "m/s", "none" };
+
+    // Uniform grid in unit cube with smooth, layered, and tag values.
+    const size_t numLocs = numPerAxis*numPerAxis*numPerAxis;
+    std::vector<double> axis(numPerAxis);
+    for (size_t i = 0; i < numPerAxis; ++i) {
+        axis[i] = double(i) / (numPerAxis-1);
+    } // for
+    std::vector<double> coordinates(numLocs*spaceDim);
+    std::vector<double> values(numLocs*numValues);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        double* xyz = &coordinates[iLoc*spaceDim];
+        xyz[0] = axis[iLoc % numPerAxis];
+        xyz[1] = axis[(iLoc / numPerAxis) % numPerAxis];
+        xyz[2] = axis[iLoc / (numPerAxis*numPerAxis)];
+        const double layer = floor(4.0*xyz[2] + 0.25*xyz[0]);
+        values[iLoc*numValues+0] = 6000.0 + 100.0*xyz[0] - 200.0*xyz[1] + 1000.0*xyz[2];
+        values[iLoc*numValues+1] = 2000.0 + 500.0*layer;
+        values[iLoc*numValues+2] = 1.0 + layer;
+    } // for
+
+    spatialdata::geocoords::CSCart cs;
+    spatialdata::spatialdb::SimpleGridDB dbOut;
+    dbOut.setCoordSys(cs);
+    dbOut.allocate(numPerAxis, numPerAxis, numPerAxis, numValues, spaceDim, dataDim);
+    dbOut.setX(&axis[0], numPerAxis);
+    dbOut.setY(&axis[0], numPerAxis);
+    dbOut.setZ(&axis[0], numPerAxis);
+    dbOut.setData(&coordinates[0], numLocs, spaceDim, &values[0], numLocs, numValues);
+    dbOut.setNames(names, numValues);
+    dbOut.setUnits(units, numValues);
+
+    const char* filename = "benchgridcompression.spatialdb";
+    dbOut.setFilename(filename);
+    dbOut.setLayout(spatialdata::spatialdb::SimpleGridDB::BRICK);
+    spatialdata::spatialdb::SimpleGridBinary::write(dbOut);
+    dbOut.close();
+
+    // Random locations inside the grid.
+    unsigned long seed = 12345;
+    std::vector<double> points(numQueries*spaceDim);
+    for (size_t i = 0; i < numQueries*spaceDim; ++i) {
+        points[i] = random01(&seed);
+    } // for
+
+    // Lattice of locations inside the grid numbered with z fastest.
+    const size_t numPerAxisMesh = size_t(cbrt(double(numQueries)));
+    std::vector<double> pointsMesh(numPerAxisMesh*numPerAxisMesh*numPerAxisMesh*spaceDim);
+    for (size_t iX = 0, i = 0; iX < numPerAxisMesh; ++iX) {
+        for (size_t iY = 0; iY < numPerAxisMesh; ++iY) {
+            for (size_t iZ = 0; iZ < numPerAxisMesh; ++iZ, i += spaceDim) {
+                pointsMesh[i+0] = (iX + 0.5) / numPerAxisMesh;
+                pointsMesh[i+1] = (iY + 0.5) / numPerAxisMesh;
+                pointsMesh[i+2] = (iZ + 0.5) / numPerAxisMesh;
+            } // for
+        } // for
+    } // for
+
+    const double sizeValues = numLocs*numValues*sizeof(double) / 1048576.0;
+    std::cout << "grid: " << numPerAxis << "x" << numPerAxis << "x" << numPerAxis << " points, "
+              << numValues << " values (" << sizeValues << " MiB)" << std::endl;
+    std::cout << "cache: " << cacheSize / 1048576.0 << " MiB, lossy tolerance: " << tolerance << std::endl;
+
+    const size_t numCases = 3;
+    const spatialdata::spatialdb::SimpleGridDB::CompressionEnum compressions[numCases] = {
+        spatialdata::spatialdb::SimpleGridDB::UNCOMPRESSED,
+        spatialdata::spatialdb::SimpleGridDB::LOSSLESS,
+        spatialdata::spatialdb::SimpleGridDB::LOSSY,
+    };
+    const char* labels[numCases] = { "uncompressed", "lossless", "lossy" };
+    std::vector<double> valuesE;
+    std::vector<double> valuesQuery;
+    double elapsedRandom[numCases];
+    double elapsedMesh[numCases];
+    for (size_t i = 0; i < numCases; ++i) {
+        spatialdata::spatialdb::SimpleGridDB db;
+        db.setFilename(filename);
+        db.setLayout(spatialdata::spatialdb::SimpleGridDB::BRICK);
+        db.setCompression(compressions[i]);
+        db.setCompressionTolerance(tolerance);
+        // Cache only holds decompressed blocks; uncompressed values are loaded.
+        db.setCacheSize((spatialdata::spatialdb::SimpleGridDB::UNCOMPRESSED == compressions[i]) ? 0 : cacheSize);
+
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        db.open();
+        const std::chrono::duration<double> elapsedOpen = std::chrono::steady_clock::now() - start;
+        db.setQueryType(spatialdata::spatialdb::SimpleGridDB::LINEAR);
+        db.setQueryValues(names, numValues);
+
+        const double sizeCompressed = db.getCompressedSize() / 1048576.0;
+        std::cout << labels[i] << " (open in " << elapsedOpen.count() << " s)";
+        if (sizeCompressed > 0.0) {
+            std::cout << ": " << sizeCompressed << " MiB compressed, ratio " << sizeValues / sizeCompressed;
+        } // if
+        std::cout << std::endl;
+
+        elapsedRandom[i] = runQueries(&db, &valuesQuery, points, cs, "random order");
+        if (0 == i) {
+            valuesE = valuesQuery;
+        } else {
+            double maxError[numValues] = { 0.0, 0.0, 0.0 };
+            for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+                for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                    const size_t index = iQuery*numValues + iVal;
+                    maxError[iVal] = std::max(maxError[iVal], fabs(valuesQuery[index] - valuesE[index]));
+                } // for
+            } // for
+            std::cout << "  max error:";
+            for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                std::cout << " " << names[iVal] << "=" << maxError[iVal];
+            } // for
+            std::cout << std::endl;
+        } // if/else
+        if (db.getCacheMisses() > 0) {
+            std::cout << "  cache hit rate: " << double(db.getCacheHits()) / (db.getCacheHits() + db.getCacheMisses())
+                      << std::endl;
+        } // if
+        elapsedMesh[i] = runQueries(&db, &valuesQuery, pointsMesh, cs, "mesh order");
+        db.close();
+    } // for
+    for (size_t i = 1; i < numCases; ++i) {
+        std::cout << "slowdown (" << labels[i] << "/uncompressed): random order " << elapsedRandom[i] / elapsedRandom[0]
+                  << ", mesh order " << elapsedMesh[i] / elapsedMesh[0] << std::endl;
+    } // for
+
+    remove(filename);
+
+    return 0;
+} // main
+
+
+// End of file
@@ -0,0 +1,170 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file tests/benchmarks/spatialdb/benchsimpledb.cc
+ *
+ * @brief Benchmark throughput of SimpleDB queries for locations where
+ * interpolation succeeds and locations outside the data (where
+ * interpolation fails).
+ *
+ * Usage: benchsimpledb [numLocs] [numQueries] [query_type] [numThreads]
+ *
+ * query_type is one of nearest, linear, or delaunay (default is linear).
+ * numThreads is the number of threads used by multiquery() (default is 1,
+ * 0 for number of hardware threads).
+ */
+
+#include <portinfo>
+
+#include "spatialdata/spatialdb/SimpleDB.hh" // USES SimpleDB
+#include "spatialdata/spatialdb/SimpleDBData.hh" // USES SimpleDBData
+#include "spatialdata/spatialdb/SimpleIOAscii.hh" // USES SimpleIOAscii
+#include "spatialdata/geocoords/CSCart.hh" // USES CSCart
+
+#include <chrono> // USES std::chrono
+#include <iostream> // USES std::cout
+#include <cstdlib> // USES atoi()
+#include <cstring> // USES strcmp()
+#include <cstdio> // USES remove()
+#include <vector> // USES std::vector
+
+// ----------------------------------------------------------------------
+namespace {
+    /// Generate pseudo-random number in [0,1).
+    double
+    random01(unsigned long* seed) {
+        *seed = (1103515245*(*seed) + 12345) % 2147483648UL;
+        return double(*seed) / 2147483648.0;
+    } // random01
+
+    /** Query database at locations and report throughput.
+     *
+     * @param db Spatial database.
+     * @param points Coordinates of query locations.
+     * @param cs Coordinate system of query locations.
+     * @param label Label for output.
+     * @param numThreads Number of threads for multiquery().
+     */
+    void
+    runQueries(spatialdata::spatialdb::SimpleDB* db,
+               const std::vector<double>& points,
+               const spatialdata::geocoords::CoordSys& cs,
+               const char* label,
+               const size_t numThreads) {
+        const size_t spaceDim = 3;
+        const size_t numValues = 2;
+        const size_t numQueries = points.size() / spaceDim;
+        double values[numValues];
+
+        size_t numFailed = 0;
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+            numFailed += db->query(values, numValues, &points[iQuery*spaceDim], spaceDim, &cs);
+        } // for
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << label << ": " << numQueries << " queries (" << numFailed << " failed) in "
+                  << elapsed.count() << " s, " << numQueries / elapsed.count() << " queries/s"
+                  << std::endl;
+
+        // Same locations as a single batch.
+        std::vector<double> valuesBatch(numQueries*numValues);
+        std::vector<int> err(numQueries);
+        const std::chrono::steady_clock::time_point startBatch = std::chrono::steady_clock::now();
+        db->multiquery(&valuesBatch[0], numQueries, numValues, &err[0], numQueries, &points[0], numQueries, spaceDim, &cs,
+                       numThreads);
+        const std::chrono::duration<double> elapsedBatch = std::chrono::steady_clock::now() - startBatch;
+
+        std::cout << label << " (multiquery, " << numThreads << " threads): " << numQueries << " queries in "
+                  << elapsedBatch.count() << " s, " << numQueries / elapsedBatch.count() << " queries/s"
+                  << std::endl;
+    } // runQueries
+} // namespace
+
+// ----------------------------------------------------------------------
+int
+main(int argc,
+     char* argv[]) {
+    const size_t numLocs = (argc > 1) ? atoi(argv[1]) : 20000;
+    const size_t numQueries = (argc > 2) ? atoi(argv[2]) : 20000;
+    const char* queryType = (argc > 3) ? argv[3] : "linear";
+    const size_t numThreads = (argc > 4) ? atoi(argv[4]) : 1;
+
+    const size_t spaceDim = 3;
+    const size_t dataDim = 3;
+    const size_t numValues = 2;
+    const char* names[numValues] = { "one", "two" };
+    const char* units[numValues] = { "none", "none" };
+
+    // Scattered points in unit cube with values varying linearly.
+    unsigned long seed = 12345;
+    std::vector<double> coordinates(numLocs*spaceDim);
+    std::vector<double> values(numLocs*numValues);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coordinates[iLoc*spaceDim+iDim] = random01(&seed);
+        } // for
+        const double* xyz = &coordinates[iLoc*spaceDim];
+        values[iLoc*numValues+0] = 1.0 + xyz[0] + 2.0*xyz[1] + 3.0*xyz[2];
+        values[iLoc*numValues+1] = 2.0 - xyz[2];
+    } // for
+
+    spatialdata::spatialdb::SimpleDBData data;
+    data.allocate(numLocs, numValues, spaceDim, dataDim);
+    data.setCoordinates(&coordinates[0], numLocs, spaceDim);
+    data.setData(&values[0], numLocs, numValues);
+    data.setNames(names, numValues);
+    data.setUnits(units, numValues);
+
+    spatialdata::geocoords::CSCart cs;
+    const char* filename = "benchsimpledb.spatialdb";
+    spatialdata::spatialdb::SimpleIOAscii writer;
+    writer.setFilename(filename);
+    writer.write(data, &cs);
+
+    spatialdata::spatialdb::SimpleDB db;
+    db.setIOHandler(&writer);
+    if (0 == strcmp(queryType, "nearest")) {
+        db.setQueryType(spatialdata::spatialdb::SimpleDB::NEAREST);
+    } else if (0 == strcmp(queryType, "delaunay")) {
+        db.setQueryType(spatialdata::spatialdb::SimpleDB::DELAUNAY);
+    } else {
+        db.setQueryType(spatialdata::spatialdb::SimpleDB::LINEAR);
+    } // if/else
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    db.open();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::cout << "open: " << numLocs << " points in " << elapsed.count() << " s" << std::endl;
+
+    // Locations well inside the data and well outside the data.
+    std::vector<double> pointsInside(numQueries*spaceDim);
+    std::vector<double> pointsOutside(numQueries*spaceDim);
+    for (size_t i = 0; i < numQueries*spaceDim; ++i) {
+        pointsInside[i] = 0.1 + 0.8*random01(&seed);
+        pointsOutside[i] = 1.5 + random01(&seed);
+    } // for
+
+    runQueries(&db, pointsInside, cs, "inside", numThreads);
+    runQueries(&db, pointsOutside, cs, "outside", numThreads);
+
+    db.close();
+    remove(filename);
+
+    return 0;
+} // main
+
+
+// End of file
@@ -0,0 +1,215 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+/** @file tests/benchmarks/spatialdb/benchsimplegriddb.cc
+ *
+ * @brief Benchmark memory use and throughput of SimpleGridDB queries
+ * with values stored in double and single precision and with values
+ * stored in flat and brick layouts.
+ *
+ * The layouts are compared using query locations in random order and
+ * in mesh order (a regular lattice of points numbered with z fastest,
+ * like the vertices of a mesh numbered column by column).
+ *
+ * Usage: benchsimplegriddb [numPerAxis] [numQueries] [query_type]
+ *
+ * numPerAxis is the number of grid points along each axis of the 3-D
+ * grid (default is 128). query_type is one of nearest or linear
+ * (default is linear).
+ */
+
+#include <portinfo>
+
+#include "spatialdata/spatialdb/SimpleGridDB.hh" // USES SimpleGridDB
+#include "spatialdata/spatialdb/SimpleGridBinary.hh" // USES SimpleGridBinary
+#include "spatialdata/geocoords/CSCart.hh" // USES CSCart
+
+#include <chrono> // USES std::chrono
+#include <iostream> // USES std::cout
+#include <cstdlib> // USES atoi()
+#include <cstring> // USES strcmp()
+#include <cstdio> // USES remove()
+#include <cmath> // USES cbrt()
+#include <vector> // USES std::vector
+
+// ----------------------------------------------------------------------
+namespace {
+    /// Generate pseudo-random number in [0,1).
+    double
+    random01(unsigned long* seed) {
+        *seed = (1103515245*(*seed) + 12345) % 2147483648UL;
+        return double(*seed) / 2147483648.0;
+    } // random01
+
+    /** Query database at locations and report throughput.
+     *
+     * @param db Spatial database.
+     * @param points Coordinates of query locations.
+     * @param cs Coordinate system of query locations.
+     * @param label Label for output.
+     * @returns Query time in seconds.
+     */
+    double
+    runQueries(spatialdata::spatialdb::SimpleGridDB* db,
+               const std::vector<double>& points,
+               const spatialdata::geocoords::CoordSys& cs,
+               const char* label) {
+        const size_t spaceDim = 3;
+        const size_t numValues = 3;
+        const size_t numQueries = points.size() / spaceDim;
+
+        std::vector<double> values(numQueries*numValues);
+        std::vector<int> err(numQueries);
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        db->multiquery(&values[0], numQueries, numValues, &err[0], numQueries, &points[0], numQueries, spaceDim, &cs);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        std::cout << label << ": " << numQueries << " queries in "
+                  << elapsed.count() << " s, " << numQueries / elapsed.count() << " queries/s"
+                  << std::endl;
+        return elapsed.count();
+    } // runQueries
+} // namespace
+
+// ----------------------------------------------------------------------
+int
+main(int argc,
+     char* argv[]) {
+    const size_t numPerAxis = (argc > 1) ? atoi(argv[1]) : 128;
+    const size_t numQueries = (argc > 2) ? atoi(argv[2]) : 1000000;
+    const char* queryType = (argc > 3) ? argv[3] : "linear";
+
+    const size_t spaceDim = 3;
+    const size_t dataDim = 3;
+    const size_t numValues = 3;
+    const char* names[numValues] = { "vp", "vs", "density" };
+    const char* units[numValues] = { "m/s", "m/s", "kg/m**3" };
+
+    // Uniform grid in unit cube with values varying smoothly.
+    const size_t numLocs = numPerAxis*numPerAxis*numPerAxis;
+    std::vector<double> axis(numPerAxis);
+    for (size_t i = 0; i < numPerAxis; ++i) {
+        axis[i] = double(i) / (numPerAxis-1);
+    } // for
+    std::vector<double> coordinates(numLocs*spaceDim);
+    std::vector<double> values(numLocs*numValues);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        double* xyz = &coordinates[iLoc*spaceDim];
+        xyz[0] = axis[iLoc % numPerAxis];
+        xyz[1] = axis[(iLoc / numPerAxis) % numPerAxis];
+        xyz[2] = axis[iLoc / (numPerAxis*numPerAxis)];
+        values[iLoc*numValues+0] = 6000.0 + 100.0*xyz[0] - 200.0*xyz[1] + 1000.0*xyz[2];
+        values[iLoc*numValues+1] = 3500.0 + 50.0*xyz[0]*xyz[1] + 500.0*xyz[2];
+        values[iLoc*numValues+2] = 2700.0 + 10.0*xyz[0] + 20.0*xyz[1]*xyz[2];
+    } // for
+
+    spatialdata::geocoords::CSCart cs;
+    spatialdata::spatialdb::SimpleGridDB dbOut;
+    dbOut.setCoordSys(cs);
+    dbOut.allocate(numPerAxis, numPerAxis, numPerAxis, numValues, spaceDim, dataDim);
+    dbOut.setX(&axis[0], numPerAxis);
+    dbOut.setY(&axis[0], numPerAxis);
+    dbOut.setZ(&axis[0], numPerAxis);
+    dbOut.setData(&coordinates[0], numLocs, spaceDim, &values[0], numLocs, numValues);
+    dbOut.setNames(names, numValues);
+    dbOut.setUnits(units, numValues);
+
+    const char* filenameDouble = "benchsimplegriddb_double.spatialdb";
+    const char* filenameSingle = "benchsimplegriddb_single.spatialdb";
+    dbOut.setFilename(filenameDouble);
+    dbOut.setPrecision(spatialdata::spatialdb::SimpleGridDB::DOUBLE);
+    spatialdata::spatialdb::SimpleGridBinary::write(dbOut);
+    dbOut.setFilename(filenameSingle);
+    dbOut.setPrecision(spatialdata::spatialdb::SimpleGridDB::SINGLE);
+    spatialdata::spatialdb::SimpleGridBinary::write(dbOut);
+    dbOut.close();
+
+    // Random locations inside the grid.
+    unsigned long seed = 12345;
+    std::vector<double> points(numQueries*spaceDim);
+    for (size_t i = 0; i < numQueries*spaceDim; ++i) {
+        points[i] = random01(&seed);
+    } // for
+
+    const spatialdata::spatialdb::SimpleGridDB::QueryEnum query = (0 == strcmp(queryType, "nearest")) ?
+                                                                  spatialdata::spatialdb::SimpleGridDB::NEAREST :
+                                                                  spatialdata::spatialdb::SimpleGridDB::LINEAR;
+    const double sizeDouble = numLocs*numValues*sizeof(double) / 1048576.0;
+    const double sizeSingle = numLocs*numValues*sizeof(float) / 1048576.0;
+    std::cout << "grid: " << numPerAxis << "x" << numPerAxis << "x" << numPerAxis << " points, "
+              << numValues << " values" << std::endl;
+    std::cout << "values (double): " << sizeDouble << " MiB" << std::endl;
+    std::cout << "values (single): " << sizeSingle << " MiB (saves " << sizeDouble - sizeSingle << " MiB)" << std::endl;
+
+    double elapsed[2];
+    const char* filenames[2] = { filenameDouble, filenameSingle };
+    const char* labels[2] = { "double", "single" };
+    for (size_t i = 0; i < 2; ++i) {
+        spatialdata::spatialdb::SimpleGridDB db;
+        db.setFilename(filenames[i]);
+        db.open();
+        db.setQueryType(query);
+        db.setQueryValues(names, numValues);
+        runQueries(&db, points, cs, labels[i]); // Touch all pages before timing.
+        elapsed[i] = runQueries(&db, points, cs, labels[i]);
+        db.close();
+    } // for
+    std::cout << "speedup (single/double): " << elapsed[0] / elapsed[1] << std::endl;
+
+    // Lattice of locations inside the grid numbered with z fastest.
+    const size_t numPerAxisMesh = size_t(cbrt(double(numQueries)));
+    std::vector<double> pointsMesh(numPerAxisMesh*numPerAxisMesh*numPerAxisMesh*spaceDim);
+    for (size_t iX = 0, i = 0; iX < numPerAxisMesh; ++iX) {
+        for (size_t iY = 0; iY < numPerAxisMesh; ++iY) {
+            for (size_t iZ = 0; iZ < numPerAxisMesh; ++iZ, i += spaceDim) {
+                pointsMesh[i+0] = (iX + 0.5) / numPerAxisMesh;
+                pointsMesh[i+1] = (iY + 0.5) / numPerAxisMesh;
+                pointsMesh[i+2] = (iZ + 0.5) / numPerAxisMesh;
+            } // for
+        } // for
+    } // for
+
+    double elapsedRandom[2];
+    double elapsedMesh[2];
+    const spatialdata::spatialdb::SimpleGridDB::LayoutEnum layouts[2] = {
+        spatialdata::spatialdb::SimpleGridDB::FLAT,
+        spatialdata::spatialdb::SimpleGridDB::BRICK,
+    };
+    const char* labelsRandom[2] = { "flat, random order", "brick, random order" };
+    const char* labelsMesh[2] = { "flat, mesh order", "brick, mesh order" };
+    for (size_t i = 0; i < 2; ++i) {
+        spatialdata::spatialdb::SimpleGridDB db;
+        db.setFilename(filenameDouble);
+        db.setLayout(layouts[i]);
+        db.open();
+        db.setQueryType(query);
+        db.setQueryValues(names, numValues);
+        runQueries(&db, points, cs, labelsRandom[i]); // Touch all pages before timing.
+        elapsedRandom[i] = runQueries(&db, points, cs, labelsRandom[i]);
+        elapsedMesh[i] = runQueries(&db, pointsMesh, cs, labelsMesh[i]);
+        db.close();
+    } // for
+    std::cout << "speedup (brick/flat), random order: " << elapsedRandom[0] / elapsedRandom[1] << std::endl;
+    std::cout << "speedup (brick/flat), mesh order: " << elapsedMesh[0] / elapsedMesh[1] << std::endl;
+
+    remove(filenameDouble);
+    remove(filenameSingle);
+
+    return 0;
+} // main
+
+
+// End of file
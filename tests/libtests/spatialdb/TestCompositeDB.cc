@@ -45,6 +45,7 @@ class spatialdata::spatialdb::TestCompositeDB : public CppUnit::TestFixture {
     CPPUNIT_TEST(testQueryAB);
     CPPUNIT_TEST(testQueryA);
     CPPUNIT_TEST(testQueryB);
+    CPPUNIT_TEST(testMultiquery);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -81,6 +82,9 @@ public:
     /// Test query() with values in dbB.
     void testQueryB(void);
 
+    /// Test multiquery() with values in both dbA and dbB.
+    void testMultiquery(void);
+
 private:
 
     UniformDB _dbA; ///< Spatial database A.
@@ -458,4 +462,48 @@ spatialdata::spatialdb::TestCompositeDB::testQueryB(void) {
 } // testQueryB
 
 
+// ----------------------------------------------------------------------
+// Test multiquery() with values in both dbA and dbB.
+void
+spatialdata::spatialdb::TestCompositeDB::testMultiquery(void) {
+    CompositeDB db;
+
+    const size_t numNamesA = 2;
+    const char* namesA[2] = { "three", "one" };
+    db.setDBA(&_dbA, namesA, numNamesA);
+
+    const size_t numNamesB = 1;
+    const char* namesB[1] = { "five" };
+    db.setDBB(&_dbB, namesB, numNamesB);
+
+    const size_t querySize = 3;
+    const char* queryVals[3] = { "five", "one", "three" };
+
+    const size_t spaceDim = 2;
+    const size_t numLocs = 3;
+    spatialdata::geocoords::CSCart cs;
+    cs.setSpaceDim(spaceDim);
+    const double coords[numLocs*spaceDim] = {
+        2.3, 5.6,
+        -1.0, 0.0,
+        4.0, 8.0,
+    };
+    double data[numLocs*querySize];
+    int err[numLocs];
+    const double valsE[querySize] = { 5.5, 1.1, 3.3 };
+
+    db.open();
+    db.setQueryValues(queryVals, querySize);
+    db.multiquery(data, numLocs, querySize, err, numLocs, coords, numLocs, spaceDim, &cs);
+    db.close();
+
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        CPPUNIT_ASSERT_EQUAL(0, err[iLoc]);
+        for (size_t i = 0; i < querySize; ++i) {
+            CPPUNIT_ASSERT_EQUAL(valsE[i], data[iLoc*querySize+i]);
+        } // for
+    } // for
+} // testMultiquery
+
+
 // End of file
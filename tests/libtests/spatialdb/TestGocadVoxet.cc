@@ -0,0 +1,621 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/GocadVoxet.hh" // USES GocadVoxet
+
+#include <fstream> // USES std::ofstream
+#include <string> // USES std::string
+#include <vector> // USES std::vector
+#include <cstring> // USES memcpy()
+#include <stdint.h> // USES uint32_t
+#include <stdexcept> // USES std::runtime_error
+#include <cstdio> // USES remove()
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestGocadVoxet;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestGocadVoxet : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestGocadVoxet);
+
+    CPPUNIT_TEST(testRead);
+    CPPUNIT_TEST(testReadSingle);
+    CPPUNIT_TEST(testReadErrors);
+    CPPUNIT_TEST(testQuery);
+    CPPUNIT_TEST(testQueryNoData);
+    CPPUNIT_TEST(testQueryBatch);
+    CPPUNIT_TEST(testCache);
+    CPPUNIT_TEST(testRegion);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Setup test.
+    void setUp(void);
+
+    /// Test read() with several properties.
+    void testRead(void);
+
+    /// Test read() with one property matches reading several properties.
+    void testReadSingle(void);
+
+    /// Test read() with missing files and properties.
+    void testReadErrors(void);
+
+    /// Test query() and queryNearest().
+    void testQuery(void);
+
+    /// Test query() skipping "no data" samples.
+    void testQueryNoData(void);
+
+    /// Test queryBatch() and queryNearestBatch() match query() and queryNearest().
+    void testQueryBatch(void);
+
+    /// Test reading values from cache files in native byte order.
+    void testCache(void);
+
+    /// Test reading region of voxet.
+    void testRegion(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Write property file with values in big endian order.
+     *
+     * @param filename Name of property file.
+     * @param values Array of values.
+     * @param numValues Number of values.
+     */
+    void _writeProperty(const char* filename,
+                        const float* values,
+                        const size_t numValues);
+
+    /** Get expected value of property at sample.
+     *
+     * @param iProperty Index of property (0=vp, 1=tag).
+     * @param indexX Index of sample along x axis.
+     * @param indexY Index of sample along y axis.
+     * @param indexZ Index of sample along z axis.
+     * @returns Value of property.
+     */
+    float _value(const size_t iProperty,
+                 const int indexX,
+                 const int indexY,
+                 const int indexZ) const;
+
+    /** Get coordinates of sample.
+     *
+     * @param pt Coordinates of sample.
+     * @param indexX Index of sample along x axis.
+     * @param indexY Index of sample along y axis.
+     * @param indexZ Index of sample along z axis.
+     */
+    void _point(double pt[3],
+                const int indexX,
+                const int indexY,
+                const int indexZ) const;
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    static const char* _dir; ///< Directory with voxet files.
+    static const char* _filename; ///< Name of voxet file.
+    static const int _numX; ///< Number of samples along x axis.
+    static const int _numY; ///< Number of samples along y axis.
+    static const int _numZ; ///< Number of samples along z axis.
+    static const double _origin[3]; ///< Origin of voxet.
+    static const double _spacing; ///< Spacing of samples.
+
+}; // class TestGocadVoxet
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestGocadVoxet);
+
+// ----------------------------------------------------------------------
+const char* spatialdata::spatialdb::TestGocadVoxet::_dir = "data";
+const char* spatialdata::spatialdb::TestGocadVoxet::_filename = "gocadvoxet.vo";
+const int spatialdata::spatialdb::TestGocadVoxet::_numX = 4;
+const int spatialdata::spatialdb::TestGocadVoxet::_numY = 3;
+const int spatialdata::spatialdb::TestGocadVoxet::_numZ = 5;
+const double spatialdata::spatialdb::TestGocadVoxet::_origin[3] = { 1000.0, 2000.0, -400.0 };
+const double spatialdata::spatialdb::TestGocadVoxet::_spacing = 100.0;
+
+// ----------------------------------------------------------------------
+// Setup test.
+void
+spatialdata::spatialdb::TestGocadVoxet::setUp(void) {
+    std::ofstream fileout((std::string(_dir) + "/" + _filename).c_str());
+    fileout
+        << "GOCAD Voxet 1\n"
+        << "HEADER {\n"
+        << "name:test\n"
+        << "}\n"
+        << "AXIS_O " << _origin[0] << " " << _origin[1] << " " << _origin[2] << "\n"
+        << "AXIS_U 1 0 0\n"
+        << "AXIS_V 0 1 0\n"
+        << "AXIS_W 0 0 1\n"
+        << "AXIS_MIN 0 0 0\n"
+        << "AXIS_MAX " << (_numX-1)*_spacing << " " << (_numY-1)*_spacing << " " << (_numZ-1)*_spacing << "\n"
+        << "AXIS_N " << _numX << " " << _numY << " " << _numZ << "\n"
+        << "AXIS_NAME \"X\" \"Y\" \"Z\"\n"
+        << "AXIS_TYPE even even even\n"
+        << "\n"
+        << "PROPERTY 1 \"vp\"\n"
+        << "PROP_NO_DATA_VALUE 1 -99999\n"
+        << "PROP_ESIZE 1 4\n"
+        << "PROP_ETYPE 1 IEEE\n"
+        << "PROP_OFFSET 1 0\n"
+        << "PROP_FILE 1 gocadvoxet_vp@@\n"
+        << "\n"
+        << "PROPERTY 2 \"tag\"\n"
+        << "PROP_NO_DATA_VALUE 2 -1\n"
+        << "PROP_ESIZE 2 4\n"
+        << "PROP_ETYPE 2 IEEE\n"
+        << "PROP_OFFSET 2 0\n"
+        << "PROP_FILE 2 gocadvoxet_tag@@\n"
+        << "END\n";
+    fileout.close();
+
+    const size_t numValues = _numX*_numY*_numZ;
+    for (size_t iProperty = 0; iProperty < 2; ++iProperty) {
+        std::vector<float> values(numValues);
+        for (int iZ = 0; iZ < _numZ; ++iZ) {
+            for (int iY = 0; iY < _numY; ++iY) {
+                for (int iX = 0; iX < _numX; ++iX) {
+                    values[(iZ*_numY+iY)*_numX+iX] = _value(iProperty, iX, iY, iZ);
+                } // for
+            } // for
+        } // for
+        const char* filename = (0 == iProperty) ? "data/gocadvoxet_vp@@" : "data/gocadvoxet_tag@@";
+        _writeProperty(filename, &values[0], numValues);
+    } // for
+} // setUp
+
+
+// ----------------------------------------------------------------------
+// Test read() with several properties.
+void
+spatialdata::spatialdb::TestGocadVoxet::testRead(void) {
+    GocadVoxet voxet;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of properties before read.", size_t(0), voxet.getNumProperties());
+
+    const char* properties[2] = { "\"vp\"", "\"tag\"" };
+    voxet.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of properties.", size_t(2), voxet.getNumProperties());
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along x.", _numX, voxet._geometry.n[0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along y.", _numY, voxet._geometry.n[1]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along z.", _numZ, voxet._geometry.n[2]);
+    const double tolerance = 1.0e-6;
+    for (int i = 0; i < 3; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in origin.", _origin[i], voxet._geometry.o[i], tolerance);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in scale.", 1.0, voxet._geometry.scale[i]*_spacing, tolerance);
+    } // for
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in name of property 0.", std::string(properties[0]), voxet._properties[0].name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in name of property 1.", std::string(properties[1]), voxet._properties[1].name);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in no data value of property 0.", float(-99999.0), voxet._properties[0].noDataValue);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in no data value of property 1.", float(-1.0), voxet._properties[1].noDataValue);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in file of property 0.", std::string("gocadvoxet_vp@@"), voxet._properties[0].filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in file of property 1.", std::string("gocadvoxet_tag@@"), voxet._properties[1].filename);
+
+    // Properties requested in a different order than in file.
+    const char* propertiesReversed[2] = { "\"tag\"", "\"vp\"" };
+    voxet.read(_dir, _filename, propertiesReversed, 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in file of reversed property 0.", std::string("gocadvoxet_tag@@"), voxet._properties[0].filename);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in file of reversed property 1.", std::string("gocadvoxet_vp@@"), voxet._properties[1].filename);
+    double pt[3];
+    _point(pt, 2, 1, 3);
+    double value = 0.0;
+    CPPUNIT_ASSERT_EQUAL(0, voxet.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value of reversed property 0.", double(_value(1, 2, 1, 3)), value);
+    CPPUNIT_ASSERT_EQUAL(0, voxet.query(&value, pt, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value of reversed property 1.", double(_value(0, 2, 1, 3)), value);
+} // testRead
+
+
+// ----------------------------------------------------------------------
+// Test read() with one property matches reading several properties.
+void
+spatialdata::spatialdb::TestGocadVoxet::testReadSingle(void) {
+    const char* properties[2] = { "\"vp\"", "\"tag\"" };
+    GocadVoxet voxet;
+    voxet.read(_dir, _filename, properties, 2);
+
+    for (size_t iProperty = 0; iProperty < 2; ++iProperty) {
+        GocadVoxet voxetSingle;
+        voxetSingle.read(_dir, _filename, properties[iProperty]);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of properties.", size_t(1), voxetSingle.getNumProperties());
+
+        for (int iZ = 0; iZ < _numZ; ++iZ) {
+            for (int iY = 0; iY < _numY; ++iY) {
+                for (int iX = 0; iX < _numX; ++iX) {
+                    double pt[3];
+                    _point(pt, iX, iY, iZ);
+                    double value = 0.0;
+                    double valueSingle = 0.0;
+                    const int err = voxet.query(&value, pt, iProperty);
+                    const int errSingle = voxetSingle.query(&valueSingle, pt);
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", err, errSingle);
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value.", value, valueSingle);
+                } // for
+            } // for
+        } // for
+    } // for
+} // testReadSingle
+
+
+// ----------------------------------------------------------------------
+// Test read() with missing files and properties.
+void
+spatialdata::spatialdb::TestGocadVoxet::testReadErrors(void) {
+    GocadVoxet voxet;
+    CPPUNIT_ASSERT_THROW(voxet.read(_dir, "nonexistent.vo", "\"vp\""), std::runtime_error);
+
+    const char* properties[2] = { "\"vp\"", "\"vs\"" };
+    CPPUNIT_ASSERT_THROW(voxet.read(_dir, _filename, properties, 2), std::runtime_error);
+} // testReadErrors
+
+
+// ----------------------------------------------------------------------
+// Test query() and queryNearest().
+void
+spatialdata::spatialdb::TestGocadVoxet::testQuery(void) {
+    const char* properties[2] = { "\"vp\"", "\"tag\"" };
+    GocadVoxet voxet;
+    voxet.read(_dir, _filename, properties, 2);
+
+    // Locations offset from samples by less than half of spacing.
+    double pt[3];
+    _point(pt, 3, 2, 4);
+    pt[0] -= 0.4*_spacing;
+    pt[1] += 0.3*_spacing;
+    pt[2] -= 0.2*_spacing;
+    double value = 0.0;
+    float valueF = 0.0;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", 0, voxet.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value of property 0.", double(_value(0, 3, 2, 4)), value);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", 0, voxet.query(&valueF, pt, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value of property 1.", _value(1, 3, 2, 4), valueF);
+
+    // Outside voxet.
+    pt[1] += _spacing;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag outside voxet.", 1, voxet.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value of property 0 outside voxet.", -99999.0, value);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag outside voxet.", 1, voxet.query(&value, pt, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value of property 1 outside voxet.", -1.0, value);
+
+    // Nearest sample is on boundary.
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag for nearest.", 0, voxet.queryNearest(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nearest value of property 0.", double(_value(0, 3, 2, 4)), value);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag for nearest.", 0, voxet.queryNearest(&valueF, pt, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nearest value of property 1.", _value(1, 3, 2, 4), valueF);
+} // testQuery
+
+
+// ----------------------------------------------------------------------
+// Test query() skipping "no data" samples.
+void
+spatialdata::spatialdb::TestGocadVoxet::testQueryNoData(void) {
+    const char* properties[2] = { "\"vp\"", "\"tag\"" };
+    GocadVoxet voxet;
+    voxet.read(_dir, _filename, properties, 2);
+
+    double pt[3];
+    double value = 0.0;
+
+    // No data near bottom: use next sample above.
+    _point(pt, 1, 1, 0);
+    CPPUNIT_ASSERT_EQUAL(0, voxet.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value near bottom.", double(_value(0, 1, 1, 2)), value);
+
+    // No data near top: use next sample below.
+    _point(pt, 2, 0, 4);
+    CPPUNIT_ASSERT_EQUAL(0, voxet.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value near top.", double(_value(0, 2, 0, 3)), value);
+
+    // No data between valid samples: use next sample below.
+    _point(pt, 3, 2, 2);
+    CPPUNIT_ASSERT_EQUAL(0, voxet.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value between valid samples.", double(_value(0, 3, 2, 1)), value);
+
+    // Other properties are not affected.
+    _point(pt, 1, 1, 0);
+    CPPUNIT_ASSERT_EQUAL(0, voxet.query(&value, pt, 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value of property 1.", double(_value(1, 1, 1, 0)), value);
+
+    // First and last valid samples in columns.
+    const std::vector<int>& validRanges = voxet._validRanges[0];
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in size of valid ranges.", size_t(2*_numX*_numY), validRanges.size());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first valid sample of column (0,0).", 0, validRanges[0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in last valid sample of column (0,0).", _numZ-1, validRanges[1]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first valid sample of column (1,1).", 2, validRanges[2*(1*_numX+1)+0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in last valid sample of column (1,1).", _numZ-1, validRanges[2*(1*_numX+1)+1]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first valid sample of column (2,0).", 0, validRanges[2*(0*_numX+2)+0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in last valid sample of column (2,0).", _numZ-2, validRanges[2*(0*_numX+2)+1]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first valid sample of column (3,2) with gap.", -1, validRanges[2*(2*_numX+3)+0]);
+} // testQueryNoData
+
+
+// ----------------------------------------------------------------------
+// Test queryBatch() and queryNearestBatch() match query() and queryNearest().
+void
+spatialdata::spatialdb::TestGocadVoxet::testQueryBatch(void) {
+    const char* properties[2] = { "\"vp\"", "\"tag\"" };
+    GocadVoxet voxet;
+    voxet.read(_dir, _filename, properties, 2);
+
+    // Locations inside and outside voxet, including "no data" samples.
+    const int numPts = (_numX+2)*(_numY+2)*(_numZ+2);
+    std::vector<double> pts(numPts*3);
+    for (int iZ = -1, iPt = 0; iZ <= _numZ; ++iZ) {
+        for (int iY = -1; iY <= _numY; ++iY) {
+            for (int iX = -1; iX <= _numX; ++iX, ++iPt) {
+                _point(&pts[iPt*3], iX, iY, iZ);
+                pts[iPt*3+0] += 0.1*_spacing;
+                pts[iPt*3+2] -= 0.2*_spacing;
+            } // for
+        } // for
+    } // for
+
+    for (size_t iProperty = 0; iProperty < 2; ++iProperty) {
+        std::vector<double> values(numPts);
+        std::vector<int> err(numPts);
+        voxet.queryBatch(&values[0], &err[0], &pts[0], numPts, iProperty);
+        std::vector<double> valuesNearest(numPts);
+        voxet.queryNearestBatch(&valuesNearest[0], &pts[0], numPts, iProperty);
+        for (int iPt = 0; iPt < numPts; ++iPt) {
+            double valueE = 0.0;
+            const int errE = voxet.query(&valueE, &pts[iPt*3], iProperty);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", errE, err[iPt]);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value.", valueE, values[iPt]);
+
+            voxet.queryNearest(&valueE, &pts[iPt*3], iProperty);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nearest value.", valueE, valuesNearest[iPt]);
+        } // for
+    } // for
+} // testQueryBatch
+
+
+// ----------------------------------------------------------------------
+// Test reading values from cache files in native byte order.
+void
+spatialdata::spatialdb::TestGocadVoxet::testCache(void) {
+    const char* properties[2] = { "\"vp\"", "\"tag\"" };
+
+    GocadVoxet voxetE;
+    voxetE.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_MESSAGE("Expected values in memory without cache directory.", !voxetE._mappings[0]);
+
+    // Cache file names depend on the absolute path of the property file.
+    voxetE.setCacheDir(_dir);
+    uint64_t pathHashes[2];
+    const std::string cacheFilenames[2] = {
+        voxetE._cacheFilename("data/gocadvoxet_vp@@", 0, &pathHashes[0]),
+        voxetE._cacheFilename("data/gocadvoxet_tag@@", 1, &pathHashes[1]),
+    };
+    uint64_t pathHash = 0;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in cache file name for same property file.", cacheFilenames[0],
+                                 voxetE._cacheFilename("data/../data/gocadvoxet_vp@@", 0, &pathHash));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in hash of path for same property file.", pathHashes[0], pathHash);
+    CPPUNIT_ASSERT_MESSAGE("Expected different cache file name for property file in other directory.",
+                           cacheFilenames[0] != voxetE._cacheFilename("other/gocadvoxet_vp@@", 0, &pathHash));
+    CPPUNIT_ASSERT_MESSAGE("Expected different hash of path for property file in other directory.", pathHashes[0] != pathHash);
+    remove(cacheFilenames[0].c_str());
+    remove(cacheFilenames[1].c_str());
+
+    // First read writes cache files; second read only maps them.
+    for (int iRead = 0; iRead < 2; ++iRead) {
+        GocadVoxet voxet;
+        voxet.setCacheDir(_dir);
+        voxet.read(_dir, _filename, properties, 2);
+        for (size_t iProperty = 0; iProperty < 2; ++iProperty) {
+            CPPUNIT_ASSERT_MESSAGE("Expected values in mapped cache file.", voxet._mappings[iProperty]);
+            std::ifstream cachefile(cacheFilenames[iProperty].c_str());
+            CPPUNIT_ASSERT_MESSAGE("Expected cache file.", cachefile.is_open());
+
+            const int numValues = _numX*_numY*_numZ;
+            for (int i = 0; i < numValues; ++i) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value from cache file.", voxetE._data[iProperty][i], voxet._data[iProperty][i]);
+            } // for
+            CPPUNIT_ASSERT_MESSAGE("Mismatch in valid ranges from cache file.", voxetE._validRanges[iProperty] == voxet._validRanges[iProperty]);
+        } // for
+    } // for
+
+    // Cache file for property file in other directory is stale.
+    {
+        GocadVoxet voxet;
+        voxet.read(_dir, _filename, properties, 2);
+        GocadVoxet::CacheHeader header;
+        std::ifstream cachefile(cacheFilenames[0].c_str(), std::ios::binary);
+        cachefile.read((char*)&header, sizeof(header));
+        CPPUNIT_ASSERT_MESSAGE("Could not read header of cache file.", cachefile.good());
+        CPPUNIT_ASSERT_MESSAGE("Expected up to date cache file to be mapped.", voxet._mapCacheFile(cacheFilenames[0].c_str(), header, 0));
+        header.sourceHash += 1;
+        CPPUNIT_ASSERT_MESSAGE("Expected cache file for other path to be stale.", !voxet._mapCacheFile(cacheFilenames[0].c_str(), header, 0));
+    } // stale path
+
+    // Stale cache file is replaced.
+    std::ofstream stalefile(cacheFilenames[0].c_str(), std::ios::binary);
+    stalefile << "stale";
+    stalefile.close();
+    GocadVoxet voxet;
+    voxet.setCacheDir(_dir);
+    voxet.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_MESSAGE("Expected values in mapped cache file after replacing stale file.", voxet._mappings[0]);
+    double pt[3];
+    _point(pt, 2, 1, 3);
+    double value = 0.0;
+    CPPUNIT_ASSERT_EQUAL(0, voxet.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value after replacing stale file.", double(_value(0, 2, 1, 3)), value);
+
+    // Values are read into memory if cache file cannot be written.
+    GocadVoxet voxetNoCache;
+    voxetNoCache.setCacheDir("data/nonexistent");
+    voxetNoCache.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_MESSAGE("Expected values in memory with unwritable cache directory.", !voxetNoCache._mappings[0]);
+    CPPUNIT_ASSERT_EQUAL(0, voxetNoCache.query(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value with unwritable cache directory.", double(_value(0, 2, 1, 3)), value);
+} // testCache
+
+
+// ----------------------------------------------------------------------
+// Test reading region of voxet.
+void
+spatialdata::spatialdb::TestGocadVoxet::testRegion(void) {
+    const char* properties[2] = { "\"vp\"", "\"tag\"" };
+    GocadVoxet voxetE;
+    voxetE.read(_dir, _filename, properties, 2);
+
+    CPPUNIT_ASSERT_THROW(voxetE.setRegion(_origin[0]+_spacing, _origin[1], _origin[0], _origin[1]), std::invalid_argument);
+
+    // Region covers samples 1-3 along x and 1-2 along y.
+    const double xMin = _origin[0] + 1.2*_spacing;
+    const double xMax = _origin[0] + 2.6*_spacing;
+    const double yMin = _origin[1] + 1.1*_spacing;
+    const double yMax = _origin[1] + 1.9*_spacing;
+    GocadVoxet voxet;
+    voxet.setRegion(xMin, yMin, xMax, yMax);
+    voxet.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first sample along x.", 1, voxet._geometry.start[0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first sample along y.", 1, voxet._geometry.start[1]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along x.", 3, voxet._geometry.n[0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along y.", 2, voxet._geometry.n[1]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along z.", _numZ, voxet._geometry.n[2]);
+
+    // Queries inside region, including "no data" samples, match full voxet.
+    const int numSteps = 8;
+    for (int iZ = -1; iZ <= _numZ; ++iZ) {
+        for (int iY = 0; iY <= numSteps; ++iY) {
+            for (int iX = 0; iX <= numSteps; ++iX) {
+                double pt[3];
+                _point(pt, 0, 0, iZ);
+                pt[0] = xMin + (xMax-xMin)*iX/numSteps;
+                pt[1] = yMin + (yMax-yMin)*iY/numSteps;
+                for (size_t iProperty = 0; iProperty < 2; ++iProperty) {
+                    double valueE = 0.0;
+                    double value = 0.0;
+                    const int errE = voxetE.query(&valueE, pt, iProperty);
+                    const int err = voxet.query(&value, pt, iProperty);
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag inside region.", errE, err);
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value inside region.", valueE, value);
+
+                    voxetE.queryNearest(&valueE, pt, iProperty);
+                    voxet.queryNearest(&value, pt, iProperty);
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nearest value inside region.", valueE, value);
+                } // for
+            } // for
+        } // for
+    } // for
+
+    // Samples outside region are outside voxet.
+    double pt[3];
+    _point(pt, 0, 1, 3);
+    double value = 0.0;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag outside region.", 1, voxet.query(&value, pt, 0));
+
+    // Region outside voxet keeps nearest samples on boundary.
+    GocadVoxet voxetOutside;
+    voxetOutside.setRegion(_origin[0]-5.0*_spacing, _origin[1]+0.2*_spacing, _origin[0]-2.0*_spacing, _origin[1]+0.4*_spacing);
+    voxetOutside.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along x for region outside voxet.", 1, voxetOutside._geometry.n[0]);
+    _point(pt, -3, 0, 3);
+    CPPUNIT_ASSERT_EQUAL(0, voxetOutside.queryNearest(&value, pt, 0));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nearest value for region outside voxet.", double(_value(0, 0, 0, 3)), value);
+
+    // Region is ignored with cache files; full voxet is read after clearing region.
+    GocadVoxet voxetCache;
+    voxetCache.setRegion(xMin, yMin, xMax, yMax);
+    voxetCache.setCacheDir(_dir);
+    voxetCache.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along x with cache files.", _numX, voxetCache._geometry.n[0]);
+    voxet.clearRegion();
+    voxet.read(_dir, _filename, properties, 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first sample along x after clearing region.", 0, voxet._geometry.start[0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of samples along x after clearing region.", _numX, voxet._geometry.n[0]);
+} // testRegion
+
+
+// ----------------------------------------------------------------------
+// Write property file with values in big endian order.
+void
+spatialdata::spatialdb::TestGocadVoxet::_writeProperty(const char* filename,
+                                                       const float* values,
+                                                       const size_t numValues) {
+    std::ofstream fileout(filename, std::ios::binary);
+    for (size_t i = 0; i < numValues; ++i) {
+        uint32_t bits = 0;
+        memcpy(&bits, &values[i], sizeof(float));
+        const unsigned char bytes[4] = {
+            (unsigned char)(bits >> 24),
+            (unsigned char)(bits >> 16),
+            (unsigned char)(bits >> 8),
+            (unsigned char)(bits),
+        };
+        fileout.write((const char*)bytes, 4);
+    } // for
+    fileout.close();
+} // _writeProperty
+
+
+// ----------------------------------------------------------------------
+// Get expected value of property at sample.
+float
+spatialdata::spatialdb::TestGocadVoxet::_value(const size_t iProperty,
+                                               const int indexX,
+                                               const int indexY,
+                                               const int indexZ) const {
+    const int index = (indexZ*_numY+indexY)*_numX+indexX;
+    if (0 == iProperty) {
+        // No data at bottom two samples of column (1,1), top sample of
+        // column (2,0), and middle sample of column (3,2).
+        if (( 1 == indexX) && ( 1 == indexY) && ( indexZ < 2) ) {
+            return -99999.0;
+        } // if
+        if (( 2 == indexX) && ( 0 == indexY) && ( indexZ == _numZ-1) ) {
+            return -99999.0;
+        } // if
+        if (( 3 == indexX) && ( 2 == indexY) && ( indexZ == 2) ) {
+            return -99999.0;
+        } // if
+        return 1500.0 + 10.0*index;
+    } // if
+    return index % 7;
+} // _value
+
+
+// ----------------------------------------------------------------------
+// Get coordinates of sample.
+void
+spatialdata::spatialdb::TestGocadVoxet::_point(double pt[3],
+                                               const int indexX,
+                                               const int indexY,
+                                               const int indexZ) const {
+    pt[0] = _origin[0] + indexX*_spacing;
+    pt[1] = _origin[1] + indexY*_spacing;
+    pt[2] = _origin[2] + indexZ*_spacing;
+} // _point
+
+
+// End of file
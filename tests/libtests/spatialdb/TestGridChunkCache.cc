@@ -0,0 +1,216 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/GridChunkCache.hh" // USES GridChunkCache
+
+#include <fstream> // USES std::ofstream
+#include <vector> // USES std::vector
+#include <stdexcept> // USES std::runtime_error
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestGridChunkCache;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestGridChunkCache : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestGridChunkCache);
+
+    CPPUNIT_TEST(testConstructor);
+    CPPUNIT_TEST(testGetChunk);
+    CPPUNIT_TEST(testEviction);
+    CPPUNIT_TEST(testReadErrors);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Setup test.
+    void setUp(void);
+
+    /// Test constructor.
+    void testConstructor(void);
+
+    /// Test getChunk() and counters.
+    void testGetChunk(void);
+
+    /// Test eviction of least recently used chunk.
+    void testEviction(void);
+
+    /// Test errors opening file and reading chunks.
+    void testReadErrors(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Check contents of chunk.
+     *
+     * @param chunk Contents of chunk.
+     * @param index Index of chunk.
+     */
+    void _checkChunk(const char* chunk,
+                     const size_t index);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    static const char* _filename; ///< Name of file with chunks.
+    static const size_t _dataOffset; ///< Offset in bytes of first chunk.
+    static const size_t _chunkSize; ///< Size in bytes of each chunk.
+    static const size_t _numChunks; ///< Number of chunks in file.
+
+}; // class TestGridChunkCache
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestGridChunkCache);
+
+// ----------------------------------------------------------------------
+const char* spatialdata::spatialdb::TestGridChunkCache::_filename = "data/gridchunkcache.dat";
+const size_t spatialdata::spatialdb::TestGridChunkCache::_dataOffset = 16;
+const size_t spatialdata::spatialdb::TestGridChunkCache::_chunkSize = 4*sizeof(double);
+const size_t spatialdata::spatialdb::TestGridChunkCache::_numChunks = 12;
+
+// ----------------------------------------------------------------------
+// Setup test.
+void
+spatialdata::spatialdb::TestGridChunkCache::setUp(void) {
+    // Each value holds index of chunk plus index of value within chunk.
+    std::ofstream fileout(_filename, std::ios::binary);
+    const std::vector<char> header(_dataOffset, 0);
+    fileout.write(&header[0], _dataOffset);
+    for (size_t iChunk = 0; iChunk < _numChunks; ++iChunk) {
+        for (size_t iValue = 0; iValue < _chunkSize / sizeof(double); ++iValue) {
+            const double value = iChunk + 0.1*iValue;
+            fileout.write((const char*)&value, sizeof(double));
+        } // for
+    } // for
+    fileout.close();
+} // setUp
+
+
+// ----------------------------------------------------------------------
+// Test constructor.
+void
+spatialdata::spatialdb::TestGridChunkCache::testConstructor(void) {
+    // Cache holds at least eight chunks.
+    GridChunkCache cacheMin(_filename, _dataOffset, _chunkSize, _numChunks, sizeof(double), 1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in minimum number of slots.", size_t(8), cacheMin.getNumSlots());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in chunk size.", _chunkSize, cacheMin.getChunkSize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value size.", sizeof(double), cacheMin.getValueSize());
+
+    GridChunkCache cache(_filename, _dataOffset, _chunkSize, _numChunks, sizeof(double), 10*_chunkSize+1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of slots.", size_t(10), cache.getNumSlots());
+
+    // Cache holds no more than number of chunks in file.
+    GridChunkCache cacheMax(_filename, _dataOffset, _chunkSize, _numChunks, sizeof(double), 100*_chunkSize);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in maximum number of slots.", _numChunks, cacheMax.getNumSlots());
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of hits.", size_t(0), cache.getNumHits());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of misses.", size_t(0), cache.getNumMisses());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of evictions.", size_t(0), cache.getNumEvictions());
+} // testConstructor
+
+
+// ----------------------------------------------------------------------
+// Test getChunk() and counters.
+void
+spatialdata::spatialdb::TestGridChunkCache::testGetChunk(void) {
+    GridChunkCache cache(_filename, _dataOffset, _chunkSize, _numChunks, sizeof(double), 0);
+
+    _checkChunk(cache.getChunk(3), 3);
+    _checkChunk(cache.getChunk(3), 3);
+    _checkChunk(cache.getChunk(5), 5);
+    _checkChunk(cache.getChunk(3), 3);
+    _checkChunk(cache.getChunk(11), 11);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of hits.", size_t(2), cache.getNumHits());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of misses.", size_t(3), cache.getNumMisses());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of evictions.", size_t(0), cache.getNumEvictions());
+
+    cache.resetStats();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of hits after reset.", size_t(0), cache.getNumHits());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of misses after reset.", size_t(0), cache.getNumMisses());
+
+    _checkChunk(cache.getChunk(5), 5);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of hits after chunk is reused.", size_t(1), cache.getNumHits());
+} // testGetChunk
+
+
+// ----------------------------------------------------------------------
+// Test eviction of least recently used chunk.
+void
+spatialdata::spatialdb::TestGridChunkCache::testEviction(void) {
+    GridChunkCache cache(_filename, _dataOffset, _chunkSize, _numChunks, sizeof(double), 0);
+    CPPUNIT_ASSERT_EQUAL(size_t(8), cache.getNumSlots());
+
+    // Fill cache, then use chunk 0 so chunk 1 is least recently used.
+    for (size_t iChunk = 0; iChunk < 8; ++iChunk) {
+        _checkChunk(cache.getChunk(iChunk), iChunk);
+    } // for
+    _checkChunk(cache.getChunk(0), 0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of evictions with full cache.", size_t(0), cache.getNumEvictions());
+
+    _checkChunk(cache.getChunk(8), 8);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of evictions.", size_t(1), cache.getNumEvictions());
+
+    // Chunk 0 is still in cache; chunk 1 was evicted.
+    cache.resetStats();
+    _checkChunk(cache.getChunk(0), 0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected chunk 0 in cache.", size_t(1), cache.getNumHits());
+    _checkChunk(cache.getChunk(1), 1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected chunk 1 to be evicted.", size_t(1), cache.getNumMisses());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected chunk 2 to be evicted.", size_t(1), cache.getNumEvictions());
+    _checkChunk(cache.getChunk(2), 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected chunk 2 to be read again.", size_t(2), cache.getNumMisses());
+} // testEviction
+
+
+// ----------------------------------------------------------------------
+// Test errors opening file and reading chunks.
+void
+spatialdata::spatialdb::TestGridChunkCache::testReadErrors(void) {
+    CPPUNIT_ASSERT_THROW(GridChunkCache("data/nonexistent.dat", _dataOffset, _chunkSize, _numChunks, sizeof(double), 0),
+                         std::runtime_error);
+
+    // File holds fewer chunks than cache expects.
+    GridChunkCache cache(_filename, _dataOffset, _chunkSize, _numChunks+1, sizeof(double), 0);
+    _checkChunk(cache.getChunk(_numChunks-1), _numChunks-1);
+    CPPUNIT_ASSERT_THROW(cache.getChunk(_numChunks), std::runtime_error);
+
+    // Cache remains usable after error.
+    _checkChunk(cache.getChunk(0), 0);
+    _checkChunk(cache.getChunk(_numChunks-1), _numChunks-1);
+} // testReadErrors
+
+
+// ----------------------------------------------------------------------
+// Check contents of chunk.
+void
+spatialdata::spatialdb::TestGridChunkCache::_checkChunk(const char* chunk,
+                                                       const size_t index) {
+    CPPUNIT_ASSERT(chunk);
+    const double* values = (const double*)chunk;
+    for (size_t iValue = 0; iValue < _chunkSize / sizeof(double); ++iValue) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in value in chunk.", index + 0.1*iValue, values[iValue], 1.0e-12);
+    } // for
+} // _checkChunk
+
+
+// End of file
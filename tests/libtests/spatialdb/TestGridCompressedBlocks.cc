@@ -0,0 +1,234 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/GridCompressedBlocks.hh" // USES GridCompressedBlocks
+#include "spatialdata/spatialdb/GridChunkCache.hh" // USES GridChunkCache
+
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::min()
+#include <cmath> // USES sin(), fabs()
+#include <cstring> // USES memcmp()
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestGridCompressedBlocks;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestGridCompressedBlocks : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestGridCompressedBlocks);
+
+    CPPUNIT_TEST(testLossless);
+    CPPUNIT_TEST(testLosslessSingle);
+    CPPUNIT_TEST(testLossy);
+    CPPUNIT_TEST(testVarint);
+    CPPUNIT_TEST(testCache);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Setup test.
+    void setUp(void);
+
+    /// Test compress() and decompress() without loss.
+    void testLossless(void);
+
+    /// Test compress() and decompress() without loss in single precision.
+    void testLosslessSingle(void);
+
+    /// Test compress() and decompress() within tolerance.
+    void testLossy(void);
+
+    /// Test _appendVarint() and _readVarint().
+    void testVarint(void);
+
+    /// Test GridChunkCache with chunks decompressed from blocks.
+    void testCache(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    static const size_t _blockSize; ///< Number of points in each block.
+    static const size_t _numValues; ///< Number of values at each point.
+    static const size_t _numPoints; ///< Number of points (last block is partial).
+
+    std::vector<double> _values; ///< Values at points [numPoints*numValues].
+
+}; // class TestGridCompressedBlocks
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestGridCompressedBlocks);
+
+// ----------------------------------------------------------------------
+const size_t spatialdata::spatialdb::TestGridCompressedBlocks::_blockSize = 64;
+const size_t spatialdata::spatialdb::TestGridCompressedBlocks::_numValues = 4;
+const size_t spatialdata::spatialdb::TestGridCompressedBlocks::_numPoints = 5*64 + 17;
+
+// ----------------------------------------------------------------------
+// Setup test.
+void
+spatialdata::spatialdb::TestGridCompressedBlocks::setUp(void) {
+    // Values: constant tag, smooth field, noisy field, and a tag that
+    // changes within some blocks.
+    _values.resize(_numPoints*_numValues);
+    unsigned long seed = 12345;
+    for (size_t iPoint = 0; iPoint < _numPoints; ++iPoint) {
+        seed = (1103515245*seed + 12345) % 2147483648UL;
+        _values[iPoint*_numValues+0] = 3.0;
+        _values[iPoint*_numValues+1] = 2500.0 + 10.0*sin(0.01*iPoint);
+        _values[iPoint*_numValues+2] = -1.0e+5 * double(seed) / 2147483648.0;
+        _values[iPoint*_numValues+3] = (iPoint % 100 < 50) ? 1.0 : 2.0;
+    } // for
+} // setUp
+
+
+// ----------------------------------------------------------------------
+// Test compress() and decompress() without loss.
+void
+spatialdata::spatialdb::TestGridCompressedBlocks::testLossless(void) {
+    GridCompressedBlocks blocks(_blockSize, _numValues);
+    const std::vector<double> tolerances(_numValues, 0.0);
+    blocks.compress(&_values[0], _numPoints, &tolerances[0]);
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of blocks.", size_t(6), blocks.getNumBlocks());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value size.", sizeof(double), blocks.getValueSize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in block size.", _blockSize*_numValues*sizeof(double), blocks.getBlockSize());
+    CPPUNIT_ASSERT_MESSAGE("Expected compressed values to be smaller.",
+                           blocks.getCompressedSize() < _numPoints*_numValues*sizeof(double));
+
+    std::vector<double> block(_blockSize*_numValues);
+    for (size_t iBlock = 0; iBlock < blocks.getNumBlocks(); ++iBlock) {
+        blocks.decompress(iBlock, (char*)&block[0]);
+        const size_t numBlockPoints = std::min(_blockSize, _numPoints - iBlock*_blockSize);
+        CPPUNIT_ASSERT_MESSAGE("Mismatch in decompressed values.",
+                               0 == memcmp(&_values[iBlock*_blockSize*_numValues], &block[0],
+                                           numBlockPoints*_numValues*sizeof(double)));
+    } // for
+} // testLossless
+
+
+// ----------------------------------------------------------------------
+// Test compress() and decompress() without loss in single precision.
+void
+spatialdata::spatialdb::TestGridCompressedBlocks::testLosslessSingle(void) {
+    std::vector<float> valuesF(_values.begin(), _values.end());
+
+    GridCompressedBlocks blocks(_blockSize, _numValues);
+    const std::vector<double> tolerances(_numValues, 0.0);
+    blocks.compress(&valuesF[0], _numPoints, &tolerances[0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value size.", sizeof(float), blocks.getValueSize());
+
+    std::vector<float> block(_blockSize*_numValues);
+    for (size_t iBlock = 0; iBlock < blocks.getNumBlocks(); ++iBlock) {
+        blocks.decompress(iBlock, (char*)&block[0]);
+        const size_t numBlockPoints = std::min(_blockSize, _numPoints - iBlock*_blockSize);
+        CPPUNIT_ASSERT_MESSAGE("Mismatch in decompressed values.",
+                               0 == memcmp(&valuesF[iBlock*_blockSize*_numValues], &block[0],
+                                           numBlockPoints*_numValues*sizeof(float)));
+    } // for
+} // testLosslessSingle
+
+
+// ----------------------------------------------------------------------
+// Test compress() and decompress() within tolerance.
+void
+spatialdata::spatialdb::TestGridCompressedBlocks::testLossy(void) {
+    const double tolerances[4] = { 0.1, 1.0e-3, 1.0, 1.0e-30 };
+
+    GridCompressedBlocks blocksLossless(_blockSize, _numValues);
+    const std::vector<double> tolerancesLossless(_numValues, 0.0);
+    blocksLossless.compress(&_values[0], _numPoints, &tolerancesLossless[0]);
+
+    GridCompressedBlocks blocks(_blockSize, _numValues);
+    blocks.compress(&_values[0], _numPoints, tolerances);
+    CPPUNIT_ASSERT_MESSAGE("Expected lossy compression to be smaller than lossless compression.",
+                           blocks.getCompressedSize() < blocksLossless.getCompressedSize());
+
+    std::vector<double> block(_blockSize*_numValues);
+    for (size_t iBlock = 0; iBlock < blocks.getNumBlocks(); ++iBlock) {
+        blocks.decompress(iBlock, (char*)&block[0]);
+        const size_t numBlockPoints = std::min(_blockSize, _numPoints - iBlock*_blockSize);
+        for (size_t iPoint = 0; iPoint < numBlockPoints; ++iPoint) {
+            for (size_t iVal = 0; iVal < _numValues; ++iVal) {
+                const double valueE = _values[(iBlock*_blockSize+iPoint)*_numValues+iVal];
+                const double value = block[iPoint*_numValues+iVal];
+                CPPUNIT_ASSERT_MESSAGE("Decompressed value exceeds tolerance.", fabs(value - valueE) <= tolerances[iVal]);
+                if (iVal != 1 && iVal != 2) {
+                    // Tags are multiples of the step, or stored losslessly
+                    // when the tolerance is too small.
+                    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in tag.", valueE, value);
+                } // if
+            } // for
+        } // for
+    } // for
+} // testLossy
+
+
+// ----------------------------------------------------------------------
+// Test _appendVarint() and _readVarint().
+void
+spatialdata::spatialdb::TestGridCompressedBlocks::testVarint(void) {
+    const int64_t valuesE[] = { 0, 1, -1, 63, -64, 64, 1000000, -1000000, 4503599627370496LL, -4503599627370496LL };
+    const size_t numValues = sizeof(valuesE) / sizeof(int64_t);
+
+    GridCompressedBlocks blocks(1, 1);
+    for (size_t i = 0; i < numValues; ++i) {
+        blocks._appendVarint(valuesE[i]);
+        if (4 == i) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected one byte for each small integer.", size_t(5), blocks._bytes.size());
+        } // if
+    } // for
+
+    const unsigned char* pos = &blocks._bytes[0];
+    for (size_t i = 0; i < numValues; ++i) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in integer.", valuesE[i], GridCompressedBlocks::_readVarint(&pos));
+    } // for
+    CPPUNIT_ASSERT_MESSAGE("Expected position at end of integers.", pos == &blocks._bytes[0] + blocks._bytes.size());
+} // testVarint
+
+
+// ----------------------------------------------------------------------
+// Test GridChunkCache with chunks decompressed from blocks.
+void
+spatialdata::spatialdb::TestGridCompressedBlocks::testCache(void) {
+    GridCompressedBlocks blocks(_blockSize, _numValues);
+    const std::vector<double> tolerances(_numValues, 0.0);
+    blocks.compress(&_values[0], _numPoints, &tolerances[0]);
+
+    GridChunkCache cache(&blocks, 0);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in chunk size.", blocks.getBlockSize(), cache.getChunkSize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value size.", sizeof(double), cache.getValueSize());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of slots.", blocks.getNumBlocks(), cache.getNumSlots());
+
+    for (size_t iPass = 0; iPass < 2; ++iPass) {
+        for (size_t iBlock = 0; iBlock < blocks.getNumBlocks(); ++iBlock) {
+            const double* values = (const double*)cache.getChunk(iBlock);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in first value of chunk.",
+                                         _values[iBlock*_blockSize*_numValues+1], values[1]);
+        } // for
+    } // for
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of misses.", blocks.getNumBlocks(), cache.getNumMisses());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of hits.", blocks.getNumBlocks(), cache.getNumHits());
+} // testCache
+
+
+// End of file
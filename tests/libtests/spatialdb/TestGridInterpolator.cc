@@ -0,0 +1,224 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/GridInterpolator.hh" // USES GridInterpolator
+
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::fill()
+#include <cmath> // USES fabs()
+#include <stdexcept> // USES std::invalid_argument
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestGridInterpolator;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestGridInterpolator : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestGridInterpolator);
+
+    CPPUNIT_TEST(testSetSimd);
+    CPPUNIT_TEST(testInterpolate);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Test setSimd() and getSimdSupported().
+    void testSetSimd(void);
+
+    /// Test interpolate() with each supported instruction set.
+    void testInterpolate(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Check interpolate() against direct evaluation.
+     *
+     * @param dim Dimension of grid cells.
+     * @param numPoints Number of points in block.
+     * @param simd Instruction set.
+     */
+    void _checkInterpolate(const size_t dim,
+                           const size_t numPoints,
+                           const GridInterpolator::SimdEnum simd);
+
+    /// Generate pseudo-random number in [0,1).
+    double _random(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    unsigned long _seed; ///< Seed for pseudo-random numbers.
+
+}; // class TestGridInterpolator
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestGridInterpolator);
+
+// ----------------------------------------------------------------------
+// Test setSimd() and getSimdSupported().
+void
+spatialdata::spatialdb::TestGridInterpolator::testSetSimd(void) {
+    const double data[2] = { 1.0, 2.0 };
+    const size_t queryValues[1] = { 0 };
+    GridInterpolator interpolator(data, queryValues, 1, 1);
+
+    const GridInterpolator::SimdEnum simdSupported = GridInterpolator::getSimdSupported();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in default instruction set.", simdSupported, interpolator._simd);
+
+    interpolator.setSimd(GridInterpolator::SCALAR);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in instruction set.", GridInterpolator::SCALAR, interpolator._simd);
+
+    if (simdSupported < GridInterpolator::AVX512) {
+        CPPUNIT_ASSERT_THROW(interpolator.setSimd(GridInterpolator::AVX512), std::invalid_argument);
+    } // if
+} // testSetSimd
+
+
+// ----------------------------------------------------------------------
+// Test interpolate() with each supported instruction set.
+void
+spatialdata::spatialdb::TestGridInterpolator::testInterpolate(void) {
+    _seed = 12345;
+
+    // Number of points covers partial and full vectors and a full block.
+    const size_t numPointsCases[5] = { 1, 3, 8, 13, 64 };
+    const GridInterpolator::SimdEnum simdSupported = GridInterpolator::getSimdSupported();
+    for (int simd = GridInterpolator::SCALAR; simd <= simdSupported; ++simd) {
+        for (size_t dim = 1; dim <= 3; ++dim) {
+            for (size_t iCase = 0; iCase < 5; ++iCase) {
+                _checkInterpolate(dim, numPointsCases[iCase], GridInterpolator::SimdEnum(simd));
+            } // for
+        } // for
+    } // for
+} // testInterpolate
+
+
+// ----------------------------------------------------------------------
+// Check interpolate() against direct evaluation.
+void
+spatialdata::spatialdb::TestGridInterpolator::_checkInterpolate(const size_t dim,
+                                                                const size_t numPoints,
+                                                                const GridInterpolator::SimdEnum simd) {
+    const size_t numCorners = size_t(1) << dim;
+    const size_t numValues = 3;
+    const size_t numGridPoints = 40;
+    std::vector<double> data(numGridPoints*numValues);
+    for (size_t i = 0; i < data.size(); ++i) {
+        data[i] = -10.0 + 20.0*_random();
+    } // for
+
+    // Query two values in reverse order; output has room for numValues.
+    const size_t querySize = 2;
+    const size_t queryValues[querySize] = { 2, 0 };
+    GridInterpolator interpolator(&data[0], queryValues, querySize, dim);
+    interpolator.setSimd(simd);
+
+    // Points are stored at every other location.
+    const size_t numLocs = 2*numPoints;
+    std::vector<double> valsE(numLocs*numValues, 0.0);
+    std::vector<double> vals(numLocs*numValues, 0.0);
+    std::vector<float> valsF(numLocs*numValues, 0.0);
+    std::vector<size_t> offsets(numPoints*numCorners);
+    std::vector<double> wtsLower(numPoints*dim);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            offsets[iPoint*numCorners+iCorner] = size_t(numGridPoints*_random())*numValues;
+        } // for
+        for (size_t iDim = 0; iDim < dim; ++iDim) {
+            wtsLower[iPoint*dim+iDim] = _random();
+        } // for
+
+        const size_t iLoc = 2*iPoint + 1;
+        for (size_t iVal = 0; iVal < querySize; ++iVal) {
+            double value = 0.0;
+            for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                double wt = 1.0;
+                for (size_t iDim = 0; iDim < dim; ++iDim) {
+                    const double wtLower = wtsLower[iPoint*dim+iDim];
+                    wt *= ((iCorner >> (dim-1-iDim)) & 1) ? 1.0 - wtLower : wtLower;
+                } // for
+                value += wt * data[offsets[iPoint*numCorners+iCorner]+queryValues[iVal]];
+            } // for
+            valsE[iLoc*numValues+iVal] = value;
+        } // for
+
+        interpolator.addPoint(iLoc, &offsets[iPoint*numCorners], &wtsLower[iPoint*dim]);
+    } // for
+    interpolator.interpolate(&vals[0], numValues);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected empty block after interpolate().", size_t(0), interpolator._numPoints);
+
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        interpolator.addPoint(2*iPoint+1, &offsets[iPoint*numCorners], &wtsLower[iPoint*dim]);
+    } // for
+    interpolator.interpolate(&valsF[0], numValues);
+
+    const double tolerance = 1.0e-12;
+    for (size_t i = 0; i < numLocs*numValues; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in interpolated value.", valsE[i], vals[i], tolerance);
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in single precision interpolated value.",
+                                             valsE[i], valsF[i], 1.0e-6*(1.0+fabs(valsE[i])));
+    } // for
+
+    // Values stored in single precision are summed in double precision.
+    std::vector<float> dataF(data.size());
+    for (size_t i = 0; i < data.size(); ++i) {
+        dataF[i] = data[i];
+    } // for
+    GridInterpolator interpolatorF(&dataF[0], queryValues, querySize, dim);
+    interpolatorF.setSimd(simd);
+    std::vector<double> valsEF(numLocs*numValues, 0.0);
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        const size_t iLoc = 2*iPoint + 1;
+        for (size_t iVal = 0; iVal < querySize; ++iVal) {
+            double value = 0.0;
+            for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+                double wt = 1.0;
+                for (size_t iDim = 0; iDim < dim; ++iDim) {
+                    const double wtLower = wtsLower[iPoint*dim+iDim];
+                    wt *= ((iCorner >> (dim-1-iDim)) & 1) ? 1.0 - wtLower : wtLower;
+                } // for
+                value += wt * double(dataF[offsets[iPoint*numCorners+iCorner]+queryValues[iVal]]);
+            } // for
+            valsEF[iLoc*numValues+iVal] = value;
+        } // for
+        interpolatorF.addPoint(iLoc, &offsets[iPoint*numCorners], &wtsLower[iPoint*dim]);
+    } // for
+    std::fill(vals.begin(), vals.end(), 0.0);
+    interpolatorF.interpolate(&vals[0], numValues);
+    for (size_t i = 0; i < numLocs*numValues; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in value interpolated from single precision data.",
+                                             valsEF[i], vals[i], tolerance);
+    } // for
+} // _checkInterpolate
+
+
+// ----------------------------------------------------------------------
+// Generate pseudo-random number in [0,1).
+double
+spatialdata::spatialdb::TestGridInterpolator::_random(void) {
+    _seed = (1103515245*_seed + 12345) % 2147483648UL;
+    return double(_seed) / 2147483648.0;
+} // _random
+
+
+// End of file
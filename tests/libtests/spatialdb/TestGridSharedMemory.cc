@@ -0,0 +1,278 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/GridSharedMemory.hh" // USES GridSharedMemory
+
+#include <string> // USES std::string
+#include <cstring> // USES memcpy(), memcmp()
+#include <fcntl.h> // USES O_RDONLY, O_RDWR, O_CREAT, O_EXCL
+#include <unistd.h> // USES close(), fork(), _exit()
+#include <sys/mman.h> // USES shm_open()
+#include <sys/stat.h> // USES S_IRUSR, S_IWUSR
+#include <sys/wait.h> // USES waitpid()
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestGridSharedMemory;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestGridSharedMemory : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestGridSharedMemory);
+
+    CPPUNIT_TEST(testName);
+    CPPUNIT_TEST(testAttach);
+    CPPUNIT_TEST(testUnpublished);
+    CPPUNIT_TEST(testStaleProcesses);
+    CPPUNIT_TEST(testStaleSegment);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Test constructor and getName().
+    void testName(void);
+
+    /// Test attach(), allocate(), publish(), and detach().
+    void testAttach(void);
+
+    /// Test detach() before publish().
+    void testUnpublished(void);
+
+    /// Test attach() and detach() with processes that exited without detaching.
+    void testStaleProcesses(void);
+
+    /// Test attach() with segment left by creator that exited before setting it up.
+    void testStaleSegment(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Check whether segment exists.
+     *
+     * @param name Name of segment.
+     * @returns True if segment exists, false otherwise.
+     */
+    static
+    bool _exists(const std::string& name);
+
+    /** Get process id of a process that has exited.
+     *
+     * @returns Process id of exited process.
+     */
+    static
+    int _exitedProcess(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    static const char* _filename; ///< Name of file identifying segment.
+
+}; // class TestGridSharedMemory
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestGridSharedMemory);
+
+// ----------------------------------------------------------------------
+const char* spatialdata::spatialdb::TestGridSharedMemory::_filename = "data/grid_volume3d.spatialdb";
+
+// ----------------------------------------------------------------------
+// Test constructor and getName().
+void
+spatialdata::spatialdb::TestGridSharedMemory::testName(void) {
+    GridSharedMemory segment(_filename, "key");
+    GridSharedMemory segmentSame(_filename, "key");
+    GridSharedMemory segmentKey(_filename, "other key");
+    GridSharedMemory segmentFile("data/grid_area2d.spatialdb", "key");
+
+    const std::string name(segment.getName());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected leading slash in name.", '/', name[0]);
+    CPPUNIT_ASSERT_MESSAGE("Expected no other slashes in name.", std::string::npos == name.find('/', 1));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in name for same file and key.", name, std::string(segmentSame.getName()));
+    CPPUNIT_ASSERT_MESSAGE("Expected different name for different key.", name != segmentKey.getName());
+    CPPUNIT_ASSERT_MESSAGE("Expected different name for different file.", name != segmentFile.getName());
+
+    CPPUNIT_ASSERT(!segment.getContents());
+    CPPUNIT_ASSERT_EQUAL(size_t(0), segment.getSize());
+} // testName
+
+
+// ----------------------------------------------------------------------
+// Test attach(), allocate(), publish(), and detach().
+void
+spatialdata::spatialdb::TestGridSharedMemory::testAttach(void) {
+    const char contentsE[] = "shared contents";
+    const size_t sizeE = sizeof(contentsE);
+
+    GridSharedMemory creator(_filename, "testAttach");
+    const std::string name(creator.getName());
+    CPPUNIT_ASSERT_MESSAGE("Expected creator to create segment.", creator.attach());
+    CPPUNIT_ASSERT(creator._filling);
+    char* contents = creator.allocate(sizeE);
+    CPPUNIT_ASSERT(contents);
+    memcpy(contents, contentsE, sizeE);
+    creator.publish();
+    CPPUNIT_ASSERT(!creator._filling);
+
+    GridSharedMemory attacher(_filename, "testAttach");
+    CPPUNIT_ASSERT_MESSAGE("Expected attacher to use existing segment.", !attacher.attach());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in size of contents.", sizeE, attacher.getSize());
+    CPPUNIT_ASSERT_MESSAGE("Mismatch in contents.", 0 == memcmp(contentsE, attacher.getContents(), sizeE));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of processes attached.", uint64_t(2), attacher._control->numAttached);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in process id of creator.", int32_t(getpid()), attacher._control->pids[0]);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in process id of attacher.", int32_t(getpid()), attacher._control->pids[1]);
+
+    // Segment remains until last process detaches.
+    creator.detach();
+    CPPUNIT_ASSERT(!creator.getContents());
+    CPPUNIT_ASSERT_MESSAGE("Expected segment to remain.", _exists(name));
+    CPPUNIT_ASSERT_MESSAGE("Mismatch in contents.", 0 == memcmp(contentsE, attacher.getContents(), sizeE));
+    attacher.detach();
+    CPPUNIT_ASSERT_MESSAGE("Expected segment to be removed.", !_exists(name));
+
+    // Detaching again is a no-op.
+    attacher.detach();
+} // testAttach
+
+
+// ----------------------------------------------------------------------
+// Test detach() before publish().
+void
+spatialdata::spatialdb::TestGridSharedMemory::testUnpublished(void) {
+    { // Detach before publish.
+        GridSharedMemory creator(_filename, "testUnpublished");
+        const std::string name(creator.getName());
+        CPPUNIT_ASSERT(creator.attach());
+        creator.allocate(16);
+        creator.detach();
+        CPPUNIT_ASSERT_MESSAGE("Expected unpublished segment to be removed.", !_exists(name));
+
+        // Next process creates segment again.
+        GridSharedMemory next(_filename, "testUnpublished");
+        CPPUNIT_ASSERT_MESSAGE("Expected segment to be created again.", next.attach());
+    } // Detach before publish
+
+    { // Destructor detaches from unpublished segment.
+        std::string name;
+        {
+            GridSharedMemory creator(_filename, "testUnpublished");
+            name = creator.getName();
+            CPPUNIT_ASSERT(creator.attach());
+        }
+        CPPUNIT_ASSERT_MESSAGE("Expected unpublished segment to be removed.", !_exists(name));
+    } // Destructor detaches from unpublished segment
+} // testUnpublished
+
+
+// ----------------------------------------------------------------------
+// Test attach() and detach() with processes that exited without detaching.
+void
+spatialdata::spatialdb::TestGridSharedMemory::testStaleProcesses(void) {
+    const int32_t pidExited = _exitedProcess();
+
+    { // Attach drops exited processes.
+        GridSharedMemory creator(_filename, "testStaleProcesses");
+        CPPUNIT_ASSERT(creator.attach());
+        creator.allocate(16);
+        creator.publish();
+        creator._control->pids[creator._control->numAttached++] = pidExited;
+
+        GridSharedMemory attacher(_filename, "testStaleProcesses");
+        CPPUNIT_ASSERT(!attacher.attach());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of processes attached.", uint64_t(2), attacher._control->numAttached);
+        for (uint64_t i = 0; i < attacher._control->numAttached; ++i) {
+            CPPUNIT_ASSERT_MESSAGE("Expected exited process to be dropped.", pidExited != attacher._control->pids[i]);
+        } // for
+    } // Attach drops exited processes.
+
+    { // Last running process removes segment.
+        GridSharedMemory creator(_filename, "testStaleProcesses");
+        const std::string name(creator.getName());
+        CPPUNIT_ASSERT(creator.attach());
+        creator.allocate(16);
+        creator.publish();
+        creator._control->pids[creator._control->numAttached++] = pidExited;
+
+        creator.detach();
+        CPPUNIT_ASSERT_MESSAGE("Expected segment attached only by exited process to be removed.", !_exists(name));
+    } // Last running process removes segment.
+} // testStaleProcesses
+
+
+// ----------------------------------------------------------------------
+// Test attach() with segment left by creator that exited before setting it up.
+void
+spatialdata::spatialdb::TestGridSharedMemory::testStaleSegment(void) {
+    const char contentsE[] = "shared contents";
+    const size_t sizeE = sizeof(contentsE);
+
+    GridSharedMemory creator(_filename, "testStaleSegment");
+    const std::string name(creator.getName());
+
+    // Segment created with zero size, as if creator exited before ftruncate().
+    const int fd = shm_open(name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    CPPUNIT_ASSERT_MESSAGE("Could not create stale segment.", fd >= 0);
+    close(fd);
+
+    CPPUNIT_ASSERT_MESSAGE("Expected stale segment to be replaced.", creator.attach());
+    char* contents = creator.allocate(sizeE);
+    memcpy(contents, contentsE, sizeE);
+    creator.publish();
+
+    GridSharedMemory attacher(_filename, "testStaleSegment");
+    CPPUNIT_ASSERT_MESSAGE("Expected attacher to use new segment.", !attacher.attach());
+    CPPUNIT_ASSERT_MESSAGE("Mismatch in contents.", 0 == memcmp(contentsE, attacher.getContents(), sizeE));
+
+    creator.detach();
+    attacher.detach();
+    CPPUNIT_ASSERT_MESSAGE("Expected segment to be removed.", !_exists(name));
+} // testStaleSegment
+
+
+// ----------------------------------------------------------------------
+// Check whether segment exists.
+bool
+spatialdata::spatialdb::TestGridSharedMemory::_exists(const std::string& name) {
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    } // if
+    close(fd);
+    return true;
+} // _exists
+
+
+// ----------------------------------------------------------------------
+// Get process id of a process that has exited.
+int
+spatialdata::spatialdb::TestGridSharedMemory::_exitedProcess(void) {
+    const pid_t pid = fork();
+    CPPUNIT_ASSERT_MESSAGE("Could not create process.", pid >= 0);
+    if (0 == pid) {
+        _exit(0);
+    } // if
+    int status = 0;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Could not wait for process.", pid, waitpid(pid, &status, 0));
+    return pid;
+} // _exitedProcess
+
+
+// End of file
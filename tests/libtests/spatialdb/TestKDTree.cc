@@ -0,0 +1,287 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/KDTree.hh" // USES KDTree
+
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::sort()
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestKDTree;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestKDTree : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestKDTree);
+
+    CPPUNIT_TEST(testBuild);
+    CPPUNIT_TEST(testFindNearest);
+    CPPUNIT_TEST(testFindNearestK);
+    CPPUNIT_TEST(testFindNearestTies);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Setup testing data.
+    void setUp(void);
+
+    /// Test build() and getNumLocs().
+    void testBuild(void);
+
+    /// Test findNearest() for single point.
+    void testFindNearest(void);
+
+    /// Test findNearest() for multiple points.
+    void testFindNearestK(void);
+
+    /// Test findNearest() with equidistant points.
+    void testFindNearestTies(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Compute square of distance between location and point using brute force.
+     *
+     * @param pt Coordinates of location in 3-D space.
+     * @param iLoc Index of point.
+     * @returns Square of distance.
+     */
+    double _distSquared(const double pt[3],
+                        const size_t iLoc) const;
+
+    /** Check findNearest() against brute force search.
+     *
+     * @param tree K-d tree.
+     * @param pt Coordinates of location in 3-D space.
+     * @param numNear Number of nearest points.
+     */
+    void _checkNearest(const KDTree& tree,
+                       const double pt[3],
+                       const size_t numNear) const;
+
+    /** Generate pseudo-random number in [0,1).
+     *
+     * @returns Pseudo-random number.
+     */
+    double _random(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    std::vector<double> _coordinates; ///< Coordinates of points.
+    size_t _spaceDim; ///< Spatial dimension of points.
+    unsigned long _seed; ///< State of pseudo-random number generator.
+
+}; // class TestKDTree
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestKDTree);
+
+// ----------------------------------------------------------------------
+// Setup testing data.
+void
+spatialdata::spatialdb::TestKDTree::setUp(void) {
+    _seed = 12345;
+    _spaceDim = 3;
+    const size_t numLocs = 500;
+    _coordinates.resize(numLocs*_spaceDim);
+    for (size_t i = 0; i < _coordinates.size(); ++i) {
+        _coordinates[i] = 2.0e+3 * _random() - 1.0e+3;
+    } // for
+} // setUp
+
+
+// ----------------------------------------------------------------------
+// Test build() and getNumLocs().
+void
+spatialdata::spatialdb::TestKDTree::testBuild(void) {
+    KDTree tree;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of points in empty tree.", size_t(0), tree.getNumLocs());
+
+    const size_t numLocs = _coordinates.size() / _spaceDim;
+    tree.build(&_coordinates[0], numLocs, _spaceDim);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of points.", numLocs, tree.getNumLocs());
+
+    // Every point must appear in tree exactly once.
+    std::vector<size_t> indices(tree._indices);
+    std::sort(indices.begin(), indices.end());
+    for (size_t i = 0; i < numLocs; ++i) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in indices of points in tree.", i, indices[i]);
+    } // for
+
+    tree.deallocate();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of points after deallocate().", size_t(0), tree.getNumLocs());
+} // testBuild
+
+
+// ----------------------------------------------------------------------
+// Test findNearest() for single point.
+void
+spatialdata::spatialdb::TestKDTree::testFindNearest(void) {
+    const size_t numLocs = _coordinates.size() / _spaceDim;
+    KDTree tree;
+    tree.build(&_coordinates[0], numLocs, _spaceDim);
+
+    const size_t numQueries = 200;
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        const double pt[3] = {
+            2.4e+3 * _random() - 1.2e+3,
+            2.4e+3 * _random() - 1.2e+3,
+            2.4e+3 * _random() - 1.2e+3,
+        };
+        _checkNearest(tree, pt, 1);
+    } // for
+} // testFindNearest
+
+
+// ----------------------------------------------------------------------
+// Test findNearest() for multiple points.
+void
+spatialdata::spatialdb::TestKDTree::testFindNearestK(void) {
+    const size_t numLocs = _coordinates.size() / _spaceDim;
+    KDTree tree;
+    tree.build(&_coordinates[0], numLocs, _spaceDim);
+
+    const size_t numQueries = 50;
+    const size_t numNear[3] = { 4, 100, 2*numLocs };
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        const double pt[3] = {
+            2.4e+3 * _random() - 1.2e+3,
+            2.4e+3 * _random() - 1.2e+3,
+            2.4e+3 * _random() - 1.2e+3,
+        };
+        for (size_t iNear = 0; iNear < 3; ++iNear) {
+            _checkNearest(tree, pt, numNear[iNear]);
+        } // for
+    } // for
+} // testFindNearestK
+
+
+// ----------------------------------------------------------------------
+// Test findNearest() with equidistant points.
+void
+spatialdata::spatialdb::TestKDTree::testFindNearestTies(void) {
+    // Regular 2-D grid with duplicate points yields many equidistant points.
+    _spaceDim = 2;
+    const size_t numX = 7;
+    const size_t numY = 5;
+    _coordinates.resize(2*numX*numY*_spaceDim);
+    for (size_t iCopy = 0, iLoc = 0; iCopy < 2; ++iCopy) {
+        for (size_t iY = 0; iY < numY; ++iY) {
+            for (size_t iX = 0; iX < numX; ++iX, ++iLoc) {
+                _coordinates[iLoc*_spaceDim+0] = 10.0 * iX;
+                _coordinates[iLoc*_spaceDim+1] = 10.0 * iY;
+            } // for
+        } // for
+    } // for
+    const size_t numLocs = _coordinates.size() / _spaceDim;
+    KDTree tree;
+    tree.build(&_coordinates[0], numLocs, _spaceDim);
+
+    const double points[5][3] = {
+        { 0.0, 0.0, 0.0 },
+        { 5.0, 5.0, 0.0 },
+        { 20.0, 15.0, 0.0 },
+        { 35.0, 25.0, 0.0 },
+        { -5.0, 20.0, 0.0 },
+    };
+    const size_t numNear[4] = { 1, 3, 10, 100 };
+    for (size_t iPt = 0; iPt < 5; ++iPt) {
+        for (size_t iNear = 0; iNear < 4; ++iNear) {
+            _checkNearest(tree, points[iPt], numNear[iNear]);
+        } // for
+    } // for
+} // testFindNearestTies
+
+
+// ----------------------------------------------------------------------
+// Compute square of distance between location and point using brute force.
+double
+spatialdata::spatialdb::TestKDTree::_distSquared(const double pt[3],
+                                                 const size_t iLoc) const {
+    double xyz[3] = { 0.0, 0.0, 0.0 };
+    for (size_t iDim = 0; iDim < _spaceDim; ++iDim) {
+        xyz[iDim] = _coordinates[iLoc*_spaceDim+iDim];
+    } // for
+    const double abX = xyz[0]-pt[0];
+    const double abY = xyz[1]-pt[1];
+    const double abZ = xyz[2]-pt[2];
+    return abX*abX + abY*abY + abZ*abZ;
+} // _distSquared
+
+
+// ----------------------------------------------------------------------
+// Check findNearest() against brute force search.
+void
+spatialdata::spatialdb::TestKDTree::_checkNearest(const KDTree& tree,
+                                                  const double pt[3],
+                                                  const size_t numNear) const {
+    const size_t numLocs = _coordinates.size() / _spaceDim;
+
+    if (1 == numNear) {
+        // Nearest point; smallest index wins ties.
+        size_t iNearE = 0;
+        double nearDist = _distSquared(pt, 0);
+        for (size_t iLoc = 1; iLoc < numLocs; ++iLoc) {
+            const double dist2 = _distSquared(pt, iLoc);
+            if (dist2 < nearDist) {
+                nearDist = dist2;
+                iNearE = iLoc;
+            } // if
+        } // for
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nearest point.", iNearE, tree.findNearest(pt));
+    } // if
+
+    // Nearest points sorted by distance; largest index first for ties.
+    std::vector<std::pair<double, size_t> > sorted(numLocs);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        sorted[iLoc] = std::make_pair(_distSquared(pt, iLoc), numLocs-1-iLoc);
+    } // for
+    std::sort(sorted.begin(), sorted.end());
+    const size_t nearSizeE = (numNear < numLocs) ? numNear : numLocs;
+
+    std::vector<size_t> nearest;
+    tree.findNearest(&nearest, pt, numNear);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of nearest points.", nearSizeE, nearest.size());
+    for (size_t i = 0; i < nearSizeE; ++i) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nearest points.", numLocs-1-sorted[i].second, nearest[i]);
+    } // for
+
+    // Search with caller-owned scratch space (not empty) gives same result.
+    std::vector<KDTree::DistIndex> heap(3, std::make_pair(0.0, size_t(0)));
+    std::vector<size_t> nearestHeap;
+    tree.findNearest(&nearestHeap, &heap, pt, numNear);
+    CPPUNIT_ASSERT_MESSAGE("Mismatch in nearest points with scratch space.", nearest == nearestHeap);
+} // _checkNearest
+
+
+// ----------------------------------------------------------------------
+// Generate pseudo-random number in [0,1).
+double
+spatialdata::spatialdb::TestKDTree::_random(void) {
+    _seed = (1103515245*_seed + 12345) % 2147483648UL;
+    return double(_seed) / 2147483648.0;
+} // _random
+
+
+// End of file
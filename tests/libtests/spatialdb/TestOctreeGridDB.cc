@@ -0,0 +1,634 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/OctreeGridDB.hh" // USES OctreeGridDB
+#include "spatialdata/spatialdb/OctreeGridBinary.hh" // USES OctreeGridBinary
+#include "spatialdata/spatialdb/SimpleGridDB.hh" // USES SimpleGridDB
+
+#include "spatialdata/geocoords/CSCart.hh" // USE CSCart
+
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <iterator> // USES std::istreambuf_iterator
+#include <vector> // USES std::vector
+#include <stdexcept> // USES std::runtime_error
+#include <algorithm> // USES std::min(), std::max()
+#include <cmath> // USES fabs(), exp(), floor()
+#include <cstdio> // USES remove()
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestOctreeGridDB;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestOctreeGridDB : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestOctreeGridDB);
+
+    CPPUNIT_TEST(testBuild);
+    CPPUNIT_TEST(testBuildLinear);
+    CPPUNIT_TEST(testBuildInteger);
+    CPPUNIT_TEST(testBuildWholeNumbers);
+    CPPUNIT_TEST(testBuildExactFractions);
+    CPPUNIT_TEST(testBuildErrors);
+    CPPUNIT_TEST(testQueryOutside);
+    CPPUNIT_TEST(testIO);
+    CPPUNIT_TEST(testReadTruncated);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Setup test.
+    void setUp(void);
+
+    /// Tear down test.
+    void tearDown(void);
+
+    /// Test build() and queries against fine grid.
+    void testBuild(void);
+
+    /// Test build() with values that vary linearly.
+    void testBuildLinear(void);
+
+    /// Test build() and nearest queries with values reproduced exactly.
+    void testBuildInteger(void);
+
+    /// Test build() coarsens smooth values stored as whole numbers.
+    void testBuildWholeNumbers(void);
+
+    /// Test build() and nearest queries with non-integer values reproduced exactly.
+    void testBuildExactFractions(void);
+
+    /// Test build() with fine grids that cannot be converted.
+    void testBuildErrors(void);
+
+    /// Test queries outside grid.
+    void testQueryOutside(void);
+
+    /// Test OctreeGridBinary::write(), isBinary(), and read() via open().
+    void testIO(void);
+
+    /// Test read() with truncated file.
+    void testReadTruncated(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Check queries of octree against queries of fine grid.
+     *
+     * @param db Octree database.
+     * @param queryType Type of query.
+     * @param points Coordinates of query locations.
+     */
+    void _checkQueries(OctreeGridDB* db,
+                       const OctreeGridDB::QueryEnum queryType,
+                       const std::vector<double>& points);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    static const size_t _numX; ///< Number of points along x axis.
+    static const size_t _numY; ///< Number of points along y axis.
+    static const size_t _numZ; ///< Number of points along z axis.
+    static const size_t _numValues; ///< Number of values at each point.
+    static const double _tolerance; ///< Tolerance relative to range of values.
+    static const double _ranges[3]; ///< Range of each value over grid.
+
+    SimpleGridDB* _fine; ///< Fine grid with localized detail.
+    std::vector<double> _points; ///< Pseudo-random query locations inside grid.
+
+}; // class TestOctreeGridDB
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestOctreeGridDB);
+
+// ----------------------------------------------------------------------
+const size_t spatialdata::spatialdb::TestOctreeGridDB::_numX = 33;
+const size_t spatialdata::spatialdb::TestOctreeGridDB::_numY = 25;
+const size_t spatialdata::spatialdb::TestOctreeGridDB::_numZ = 17;
+const size_t spatialdata::spatialdb::TestOctreeGridDB::_numValues = 3;
+const double spatialdata::spatialdb::TestOctreeGridDB::_tolerance = 1.0e-3;
+const double spatialdata::spatialdb::TestOctreeGridDB::_ranges[3] = { 5600.0, 500.0, 1.0 };
+
+// ----------------------------------------------------------------------
+// Setup test.
+void
+spatialdata::spatialdb::TestOctreeGridDB::setUp(void) {
+    // Smooth gradient, a narrow bump, and a small block with a
+    // different tag; the bump and the block are near one corner.
+    const size_t spaceDim = 3;
+    const size_t numLocs = _numX*_numY*_numZ;
+    std::vector<double> x(_numX);
+    std::vector<double> y(_numY);
+    std::vector<double> z(_numZ);
+    for (size_t i = 0; i < _numX; ++i) {
+        x[i] = 100.0*i;
+    } // for
+    for (size_t i = 0; i < _numY; ++i) {
+        y[i] = -1000.0 + 50.0*i;
+    } // for
+    for (size_t i = 0; i < _numZ; ++i) {
+        z[i] = -1600.0 + 100.0*i;
+    } // for
+    std::vector<double> coords(numLocs*spaceDim);
+    std::vector<double> values(numLocs*_numValues);
+    for (size_t iZ = 0, iLoc = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            for (size_t iX = 0; iX < _numX; ++iX, ++iLoc) {
+                coords[iLoc*spaceDim+0] = x[iX];
+                coords[iLoc*spaceDim+1] = y[iY];
+                coords[iLoc*spaceDim+2] = z[iZ];
+                const double r2 = (iX-4.0)*(iX-4.0) + (iY-5.0)*(iY-5.0) + (iZ-3.0)*(iZ-3.0);
+                values[iLoc*_numValues+0] = 6000.0 + 0.5*x[iX] - 2.0*y[iY] + z[iZ];
+                values[iLoc*_numValues+1] = 3000.0 + 500.0*exp(-0.5*r2);
+                values[iLoc*_numValues+2] = (iX >= 2 && iX < 5 && iY >= 2 && iY < 4 && iZ < 3) ? 2.0 : 1.0;
+            } // for
+        } // for
+    } // for
+    const char* names[_numValues] = { "vp", "vs", "tag" };
+    const char* units[_numValues] = { "m/s", "m/s", "none" };
+
+    geocoords::CSCart cs;
+    _fine = new SimpleGridDB;
+    _fine->setCoordSys(cs);
+    _fine->allocate(_numX, _numY, _numZ, _numValues, spaceDim, 3);
+    _fine->setX(&x[0], _numX);
+    _fine->setY(&y[0], _numY);
+    _fine->setZ(&z[0], _numZ);
+    _fine->setData(&coords[0], numLocs, spaceDim, &values[0], numLocs, _numValues);
+    _fine->setNames(names, _numValues);
+    _fine->setUnits(units, _numValues);
+
+    const size_t numPoints = 500;
+    _points.resize(numPoints*spaceDim);
+    unsigned long seed = 12345;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            seed = (1103515245*seed + 12345) % 2147483648UL;
+            const double t = double(seed) / 2147483648.0;
+            const std::vector<double>& axis = (0 == iDim) ? x : (1 == iDim) ? y : z;
+            _points[iPoint*spaceDim+iDim] = axis.front() + t*(axis.back() - axis.front());
+        } // for
+    } // for
+} // setUp
+
+
+// ----------------------------------------------------------------------
+// Tear down test.
+void
+spatialdata::spatialdb::TestOctreeGridDB::tearDown(void) {
+    delete _fine;_fine = NULL;
+} // tearDown
+
+
+// ----------------------------------------------------------------------
+// Test build() and queries against fine grid.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testBuild(void) {
+    OctreeGridDB db;
+    db.build(_fine, _tolerance);
+
+    const size_t numCells = (_numX-1)*(_numY-1)*(_numZ-1);
+    CPPUNIT_ASSERT_MESSAGE("Expected few leaves outside region of detail.", db.getNumLeaves() < numCells / 4);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in depth.", size_t(5), db.getDepth());
+    CPPUNIT_ASSERT_MESSAGE("Expected octree to be smaller than fine grid.",
+                           db.getStorageSize() < _numX*_numY*_numZ*_numValues*sizeof(double) / 4);
+
+    // Fine grid points and locations between them.
+    std::vector<double> points;
+    for (size_t iZ = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            for (size_t iX = 0; iX < _numX; ++iX) {
+                points.push_back(100.0*iX);
+                points.push_back(-1000.0 + 50.0*iY);
+                points.push_back(-1600.0 + 100.0*iZ);
+            } // for
+        } // for
+    } // for
+    _checkQueries(&db, OctreeGridDB::LINEAR, points);
+    _checkQueries(&db, OctreeGridDB::LINEAR, _points);
+    _checkQueries(&db, OctreeGridDB::NEAREST, _points);
+
+    // Query values are restored in fine grid.
+    const char* queryNames[1] = { "tag" };
+    _fine->setQueryValues(queryNames, 1);
+    OctreeGridDB dbSubset;
+    dbSubset.build(_fine, _tolerance);
+    geocoords::CSCart cs;
+    const double xyzTag[3] = { 300.0, -875.0, -1500.0 };
+    double tag = 0.0;
+    CPPUNIT_ASSERT_EQUAL(0, _fine->query(&tag, 1, xyzTag, 3, &cs));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in query value of fine grid.", 2.0, tag);
+} // testBuild
+
+
+// ----------------------------------------------------------------------
+// Test build() with values that vary linearly.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testBuildLinear(void) {
+    const size_t numLocs = _numX*_numY*_numZ;
+    const size_t spaceDim = 3;
+    std::vector<double> coords(numLocs*spaceDim);
+    std::vector<double> values(numLocs*_numValues);
+    for (size_t iZ = 0, iLoc = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            for (size_t iX = 0; iX < _numX; ++iX, ++iLoc) {
+                coords[iLoc*spaceDim+0] = 100.0*iX;
+                coords[iLoc*spaceDim+1] = -1000.0 + 50.0*iY;
+                coords[iLoc*spaceDim+2] = -1600.0 + 100.0*iZ;
+                values[iLoc*_numValues+0] = 6000.0 + 2.0*iX - 3.0*iY + 5.0*iZ;
+                values[iLoc*_numValues+1] = 3000.0 + 0.25*iX*iY;
+                values[iLoc*_numValues+2] = 1.0;
+            } // for
+        } // for
+    } // for
+    _fine->setData(&coords[0], numLocs, spaceDim, &values[0], numLocs, _numValues);
+
+    // Leaves are as large as the extent of the grid allows: two leaves
+    // with 16 cells along each edge and, where the grid ends at 24
+    // cells along y, eight leaves with 8 cells along each edge.
+    OctreeGridDB db;
+    db.build(_fine, 1.0e-10);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of leaves.", size_t(10), db.getNumLeaves());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in depth.", size_t(2), db.getDepth());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of stored corners.", size_t(36), db._values.size() / _numValues);
+
+    _checkQueries(&db, OctreeGridDB::LINEAR, _points);
+} // testBuildLinear
+
+
+// ----------------------------------------------------------------------
+// Test build() and nearest queries with values reproduced exactly.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testBuildInteger(void) {
+    // Layers with integer tags; a tolerance of half the range would
+    // allow blending tags across layers.
+    const size_t numLocs = _numX*_numY*_numZ;
+    const size_t spaceDim = 3;
+    std::vector<double> coords(numLocs*spaceDim);
+    std::vector<double> values(numLocs*_numValues);
+    for (size_t iZ = 0, iLoc = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            for (size_t iX = 0; iX < _numX; ++iX, ++iLoc) {
+                coords[iLoc*spaceDim+0] = 100.0*iX;
+                coords[iLoc*spaceDim+1] = -1000.0 + 50.0*iY;
+                coords[iLoc*spaceDim+2] = -1600.0 + 100.0*iZ;
+                values[iLoc*_numValues+0] = 6000.0 + 0.1*iX*iY;
+                values[iLoc*_numValues+1] = 3000.0 + 0.01*iZ*iZ;
+                values[iLoc*_numValues+2] = (iZ < 8 ? 1.0 : 2.0) + (iX > 20 ? 2.0 : 0.0);
+            } // for
+        } // for
+    } // for
+    _fine->setData(&coords[0], numLocs, spaceDim, &values[0], numLocs, _numValues);
+
+    OctreeGridDB db;
+    const char* exactNames[1] = { "tag" };
+    db.setExactValues(exactNames, 1);
+    db.build(_fine, 0.5);
+    const size_t numCells = (_numX-1)*(_numY-1)*(_numZ-1);
+    CPPUNIT_ASSERT_MESSAGE("Expected leaves larger than fine grid cells.", db.getNumLeaves() < numCells / 4);
+
+    const char* names[_numValues] = { "vp", "vs", "tag" };
+    db.setQueryValues(names, _numValues);
+    db.setQueryType(OctreeGridDB::NEAREST);
+    _fine->setQueryValues(names, _numValues);
+    _fine->setQueryType(SimpleGridDB::NEAREST);
+
+    geocoords::CSCart cs;
+    const size_t numPoints = _points.size() / spaceDim;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double valuesQ[_numValues];
+        double valuesE[_numValues];
+        CPPUNIT_ASSERT_EQUAL(0, _fine->query(valuesE, _numValues, &_points[iPoint*spaceDim], spaceDim, &cs));
+        CPPUNIT_ASSERT_EQUAL(0, db.query(valuesQ, _numValues, &_points[iPoint*spaceDim], spaceDim, &cs));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in integer value.", valuesE[2], valuesQ[2]);
+    } // for
+} // testBuildInteger
+
+
+// ----------------------------------------------------------------------
+// Test build() coarsens smooth values stored as whole numbers.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testBuildWholeNumbers(void) {
+    // Velocities in whole m/s with curvature along x, so interpolation
+    // is never exact but stays within the tolerance over a few cells.
+    const size_t numLocs = _numX*_numY*_numZ;
+    const size_t spaceDim = 3;
+    std::vector<double> coords(numLocs*spaceDim);
+    std::vector<double> values(numLocs*_numValues);
+    for (size_t iZ = 0, iLoc = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            for (size_t iX = 0; iX < _numX; ++iX, ++iLoc) {
+                const double x = 100.0*iX;
+                const double y = -1000.0 + 50.0*iY;
+                const double z = -1600.0 + 100.0*iZ;
+                coords[iLoc*spaceDim+0] = x;
+                coords[iLoc*spaceDim+1] = y;
+                coords[iLoc*spaceDim+2] = z;
+                values[iLoc*_numValues+0] = std::floor(6000.0 + 0.5*x - 2.0*y + z + 2.0e-4*x*x + 0.5);
+                values[iLoc*_numValues+1] = std::floor(3000.0 + 0.3*x + 1.0e-4*x*x + 0.5);
+                values[iLoc*_numValues+2] = 1.0;
+            } // for
+        } // for
+    } // for
+    _fine->setData(&coords[0], numLocs, spaceDim, &values[0], numLocs, _numValues);
+
+    OctreeGridDB db;
+    db.build(_fine, _tolerance);
+    const size_t numCells = (_numX-1)*(_numY-1)*(_numZ-1);
+    CPPUNIT_ASSERT_MESSAGE("Expected leaves larger than fine grid cells.", db.getNumLeaves() < numCells / 4);
+
+    // Linear queries are within the tolerance of the range of each value.
+    double ranges[_numValues];
+    for (size_t iVal = 0; iVal < _numValues; ++iVal) {
+        double valueMin = values[iVal];
+        double valueMax = values[iVal];
+        for (size_t iLoc = 1; iLoc < numLocs; ++iLoc) {
+            valueMin = std::min(valueMin, values[iLoc*_numValues+iVal]);
+            valueMax = std::max(valueMax, values[iLoc*_numValues+iVal]);
+        } // for
+        ranges[iVal] = valueMax - valueMin;
+    } // for
+
+    const char* names[_numValues] = { "vp", "vs", "tag" };
+    db.setQueryValues(names, _numValues);
+    db.setQueryType(OctreeGridDB::LINEAR);
+    _fine->setQueryValues(names, _numValues);
+    _fine->setQueryType(SimpleGridDB::LINEAR);
+
+    geocoords::CSCart cs;
+    const size_t numPoints = _points.size() / spaceDim;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double valuesQ[_numValues];
+        double valuesE[_numValues];
+        CPPUNIT_ASSERT_EQUAL(0, _fine->query(valuesE, _numValues, &_points[iPoint*spaceDim], spaceDim, &cs));
+        CPPUNIT_ASSERT_EQUAL(0, db.query(valuesQ, _numValues, &_points[iPoint*spaceDim], spaceDim, &cs));
+        for (size_t iVal = 0; iVal < _numValues; ++iVal) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Value exceeds tolerance.", valuesE[iVal], valuesQ[iVal],
+                                                 _tolerance*ranges[iVal] + 1.0e-8);
+        } // for
+    } // for
+} // testBuildWholeNumbers
+
+
+// ----------------------------------------------------------------------
+// Test build() and nearest queries with non-integer values reproduced exactly.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testBuildExactFractions(void) {
+    // Layers with non-integer densities, whose weighted sums over leaf
+    // corners are often rounded differently from the values themselves.
+    const size_t numLocs = _numX*_numY*_numZ;
+    const size_t spaceDim = 3;
+    std::vector<double> coords(numLocs*spaceDim);
+    std::vector<double> values(numLocs*_numValues);
+    for (size_t iZ = 0, iLoc = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            for (size_t iX = 0; iX < _numX; ++iX, ++iLoc) {
+                coords[iLoc*spaceDim+0] = 100.0*iX;
+                coords[iLoc*spaceDim+1] = -1000.0 + 50.0*iY;
+                coords[iLoc*spaceDim+2] = -1600.0 + 100.0*iZ;
+                values[iLoc*_numValues+0] = 6000.0 + 0.1*iX*iY;
+                values[iLoc*_numValues+1] = 3000.0 + 0.01*iZ*iZ;
+                values[iLoc*_numValues+2] = (iZ < 8 ? 2.7 : 3.1) + (iX > 20 ? 0.13 : 0.0);
+            } // for
+        } // for
+    } // for
+    _fine->setData(&coords[0], numLocs, spaceDim, &values[0], numLocs, _numValues);
+
+    OctreeGridDB db;
+    const char* exactNames[1] = { "tag" };
+    db.setExactValues(exactNames, 1);
+    db.build(_fine, 0.5);
+    const size_t numCells = (_numX-1)*(_numY-1)*(_numZ-1);
+    CPPUNIT_ASSERT_MESSAGE("Expected leaves larger than fine grid cells.", db.getNumLeaves() < numCells / 4);
+
+    const char* names[_numValues] = { "vp", "vs", "tag" };
+    db.setQueryValues(names, _numValues);
+    db.setQueryType(OctreeGridDB::NEAREST);
+    _fine->setQueryValues(names, _numValues);
+    _fine->setQueryType(SimpleGridDB::NEAREST);
+
+    geocoords::CSCart cs;
+    const size_t numPoints = _points.size() / spaceDim;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double valuesQ[_numValues];
+        double valuesE[_numValues];
+        CPPUNIT_ASSERT_EQUAL(0, _fine->query(valuesE, _numValues, &_points[iPoint*spaceDim], spaceDim, &cs));
+        CPPUNIT_ASSERT_EQUAL(0, db.query(valuesQ, _numValues, &_points[iPoint*spaceDim], spaceDim, &cs));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in exact value.", valuesE[2], valuesQ[2]);
+    } // for
+
+    // Every fine grid point, including those inside leaves with
+    // different values at their corners.
+    for (size_t iZ = 0, iLoc = 0; iZ < _numZ; ++iZ) {
+        for (size_t iY = 0; iY < _numY; ++iY) {
+            for (size_t iX = 0; iX < _numX; ++iX, ++iLoc) {
+                double valuesQ[_numValues];
+                CPPUNIT_ASSERT_EQUAL(0, db.query(valuesQ, _numValues, &coords[iLoc*spaceDim], spaceDim, &cs));
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in exact value at grid point.", values[iLoc*_numValues+2], valuesQ[2]);
+            } // for
+        } // for
+    } // for
+} // testBuildExactFractions
+
+
+// ----------------------------------------------------------------------
+// Test build() with fine grids that cannot be converted.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testBuildErrors(void) {
+    OctreeGridDB db;
+
+    SimpleGridDB fineEmpty;
+    CPPUNIT_ASSERT_THROW(db.build(&fineEmpty, _tolerance), std::logic_error);
+
+    const double x[2] = { 0.0, 1.0 };
+    const double y[2] = { 0.0, 1.0 };
+    const double z[1] = { 0.0 };
+    const double coords[4*3] = {
+        0.0, 0.0, 0.0,
+        1.0, 0.0, 0.0,
+        0.0, 1.0, 0.0,
+        1.0, 1.0, 0.0,
+    };
+    const double values[4] = { 1.0, 2.0, 3.0, 4.0 };
+    geocoords::CSCart cs;
+    SimpleGridDB fine2D;
+    fine2D.setCoordSys(cs);
+    fine2D.allocate(2, 2, 1, 1, 3, 2);
+    fine2D.setX(x, 2);
+    fine2D.setY(y, 2);
+    fine2D.setZ(z, 1);
+    fine2D.setData(coords, 4, 3, values, 4, 1);
+    CPPUNIT_ASSERT_THROW(db.build(&fine2D, _tolerance), std::domain_error);
+
+    const char* exactNames[1] = { "density" };
+    db.setExactValues(exactNames, 1);
+    CPPUNIT_ASSERT_THROW(db.build(_fine, _tolerance), std::out_of_range);
+} // testBuildErrors
+
+
+// ----------------------------------------------------------------------
+// Test queries outside grid.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testQueryOutside(void) {
+    OctreeGridDB db;
+    db.build(_fine, _tolerance);
+    geocoords::CSCart cs;
+
+    const double xyzAbove[3] = { 1600.0, 0.0, 10.0 };
+    const double xyzCorner[3] = { 3200.0, 200.0, 0.0 };
+    double values[3];
+    double valuesE[3];
+
+    db.setQueryType(OctreeGridDB::LINEAR);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected linear query outside grid to fail.", 1, db.query(values, 3, xyzAbove, 3, &cs));
+
+    // Nearest query returns values on boundary of grid.
+    db.setQueryType(OctreeGridDB::NEAREST);
+    CPPUNIT_ASSERT_EQUAL(0, db.query(values, 3, xyzAbove, 3, &cs));
+    db.setQueryType(OctreeGridDB::LINEAR);
+    const double xyzBoundary[3] = { 1600.0, 0.0, 0.0 };
+    CPPUNIT_ASSERT_EQUAL(0, db.query(valuesE, 3, xyzBoundary, 3, &cs));
+    for (size_t iVal = 0; iVal < 3; ++iVal) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in value on boundary.", valuesE[iVal], values[iVal], 1.0e-10);
+    } // for
+
+    // Corner of grid is in last leaf along each axis.
+    CPPUNIT_ASSERT_EQUAL(0, db.query(values, 3, xyzCorner, 3, &cs));
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in value at corner.", 6000.0+1600.0-400.0, values[0],
+                                         _tolerance*_ranges[0]);
+
+    CPPUNIT_ASSERT_THROW(db.query(values, 2, xyzCorner, 3, &cs), std::invalid_argument);
+    CPPUNIT_ASSERT_THROW(db.query(values, 3, xyzCorner, 2, &cs), std::invalid_argument);
+} // testQueryOutside
+
+
+// ----------------------------------------------------------------------
+// Test OctreeGridBinary::write(), isBinary(), and read() via open().
+void
+spatialdata::spatialdb::TestOctreeGridDB::testIO(void) {
+    OctreeGridDB dbOut;
+    dbOut.build(_fine, _tolerance);
+
+    const char* filename = "data/grid_octree.spatialdb";
+    dbOut.setFilename(filename);
+    OctreeGridBinary::write(dbOut);
+    CPPUNIT_ASSERT_MESSAGE("Expected file to be binary OctreeGridDB file.", OctreeGridBinary::isBinary(filename));
+    CPPUNIT_ASSERT_MESSAGE("Expected file not to be binary OctreeGridDB file.",
+                           !OctreeGridBinary::isBinary("data/grid_volume3d.spatialdb"));
+
+    OctreeGridDB db;
+    db.setFilename(filename);
+    db.open();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of leaves.", dbOut.getNumLeaves(), db.getNumLeaves());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in depth.", dbOut.getDepth(), db.getDepth());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in storage size.", dbOut.getStorageSize(), db.getStorageSize());
+
+    const char** names = NULL;
+    size_t numValues = 0;
+    db.getNamesDBValues(&names, &numValues);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of values.", _numValues, numValues);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in name of value.", std::string("vs"), std::string(names[1]));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in units of value.", std::string("none"), db._units[2]);
+    delete[] names;names = NULL;
+
+    const char* queryNames[2] = { "tag", "vp" };
+    db.setQueryValues(queryNames, 2);
+    dbOut.setQueryValues(queryNames, 2);
+    db.setQueryType(OctreeGridDB::LINEAR);
+    dbOut.setQueryType(OctreeGridDB::LINEAR);
+    geocoords::CSCart cs;
+    const size_t numPoints = _points.size() / 3;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double values[2];
+        double valuesE[2];
+        CPPUNIT_ASSERT_EQUAL(0, dbOut.query(valuesE, 2, &_points[iPoint*3], 3, &cs));
+        CPPUNIT_ASSERT_EQUAL(0, db.query(values, 2, &_points[iPoint*3], 3, &cs));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value 'tag'.", valuesE[0], values[0]);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value 'vp'.", valuesE[1], values[1]);
+    } // for
+
+    db.close();
+    remove(filename);
+} // testIO
+
+
+// ----------------------------------------------------------------------
+// Test read() with truncated file.
+void
+spatialdata::spatialdb::TestOctreeGridDB::testReadTruncated(void) {
+    OctreeGridDB dbOut;
+    dbOut.build(_fine, _tolerance);
+    const char* filename = "data/grid_octree_truncated.spatialdb";
+    dbOut.setFilename(filename);
+    OctreeGridBinary::write(dbOut);
+
+    std::string contents;
+    {
+        std::ifstream fin(filename, std::ios::binary);
+        contents.assign(std::istreambuf_iterator<char>(fin), std::istreambuf_iterator<char>());
+    }
+    {
+        std::ofstream fout(filename, std::ios::binary);
+        fout.write(contents.c_str(), contents.size() - 8);
+    }
+    CPPUNIT_ASSERT_MESSAGE("Expected truncated file to be binary OctreeGridDB file.",
+                           OctreeGridBinary::isBinary(filename));
+
+    OctreeGridDB db;
+    db.setFilename(filename);
+    CPPUNIT_ASSERT_THROW(db.open(), std::runtime_error);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected no leaves after failed read.", size_t(0), db.getNumLeaves());
+    remove(filename);
+} // testReadTruncated
+
+
+// ----------------------------------------------------------------------
+// Check queries of octree against queries of fine grid.
+void
+spatialdata::spatialdb::TestOctreeGridDB::_checkQueries(OctreeGridDB* db,
+                                                        const OctreeGridDB::QueryEnum queryType,
+                                                        const std::vector<double>& points) {
+    CPPUNIT_ASSERT(db);
+
+    const char* names[_numValues] = { "vp", "vs", "tag" };
+    db->setQueryValues(names, _numValues);
+    db->setQueryType(queryType);
+    _fine->setQueryValues(names, _numValues);
+    _fine->setQueryType(OctreeGridDB::LINEAR == queryType ? SimpleGridDB::LINEAR : SimpleGridDB::NEAREST);
+
+    geocoords::CSCart cs;
+    const size_t spaceDim = 3;
+    const size_t numPoints = points.size() / spaceDim;
+    for (size_t iPoint = 0; iPoint < numPoints; ++iPoint) {
+        double values[_numValues];
+        double valuesE[_numValues];
+        CPPUNIT_ASSERT_EQUAL(0, _fine->query(valuesE, _numValues, &points[iPoint*spaceDim], spaceDim, &cs));
+        CPPUNIT_ASSERT_EQUAL(0, db->query(values, _numValues, &points[iPoint*spaceDim], spaceDim, &cs));
+        for (size_t iVal = 0; iVal < _numValues; ++iVal) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Value exceeds tolerance.", valuesE[iVal], values[iVal],
+                                                 _tolerance*_ranges[iVal] + 1.0e-8);
+        } // for
+    } // for
+} // _checkQueries
+
+
+// End of file
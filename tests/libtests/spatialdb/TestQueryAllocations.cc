@@ -0,0 +1,431 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/SimpleDB.hh" // USES SimpleDB
+#include "spatialdata/spatialdb/SimpleDBData.hh" // USES SimpleDBData
+#include "spatialdata/spatialdb/SimpleIOAscii.hh" // USES SimpleIOAscii
+#include "spatialdata/spatialdb/SimpleGridDB.hh" // USES SimpleGridDB
+#include "spatialdata/spatialdb/CompositeDB.hh" // USES CompositeDB
+#include "spatialdata/geocoords/CSCart.hh" // USES CSCart
+
+#include <atomic> // USES std::atomic
+#include <new> // USES std::bad_alloc
+#include <cstdlib> // USES malloc(), free(), posix_memalign()
+#include <cstdio> // USES remove()
+#include <vector> // USES std::vector
+
+// ----------------------------------------------------------------------
+// Count allocations from operator new in the test program, so tests can
+// verify that queries do not allocate memory once the query scratch
+// buffers have reached their steady-state size.
+namespace {
+    std::atomic<size_t> numAllocations(0);
+
+    // Release memory from the operators below. Not inlined so the
+    // compiler does not pair inlined calls to free() with the library
+    // operator new.
+#if defined(__GNUC__)
+    __attribute__((noinline))
+#endif
+    void release(void* ptr) noexcept {
+        free(ptr);
+    } // release
+} // namespace
+
+void*
+operator new(size_t size) {
+    ++numAllocations;
+    void* ptr = malloc(size > 0 ? size : 1);
+    if (!ptr) {
+        throw std::bad_alloc();
+    } // if
+    return ptr;
+} // operator new
+
+void*
+operator new[](size_t size) {
+    return operator new(size);
+} // operator new[]
+
+void*
+operator new(size_t size,
+             const std::nothrow_t&) noexcept {
+    ++numAllocations;
+    return malloc(size > 0 ? size : 1);
+} // operator new
+
+void*
+operator new[](size_t size,
+               const std::nothrow_t& tag) noexcept {
+    return operator new(size, tag);
+} // operator new[]
+
+void
+operator delete(void* ptr) noexcept {
+    release(ptr);
+} // operator delete
+
+void
+operator delete[](void* ptr) noexcept {
+    release(ptr);
+} // operator delete[]
+
+void
+operator delete(void* ptr,
+                size_t) noexcept {
+    release(ptr);
+} // operator delete
+
+void
+operator delete[](void* ptr,
+                  size_t) noexcept {
+    release(ptr);
+} // operator delete[]
+
+void
+operator delete(void* ptr,
+                const std::nothrow_t&) noexcept {
+    release(ptr);
+} // operator delete
+
+void
+operator delete[](void* ptr,
+                  const std::nothrow_t&) noexcept {
+    release(ptr);
+} // operator delete[]
+
+#if defined(__cpp_aligned_new)
+void*
+operator new(size_t size,
+             std::align_val_t alignment) {
+    ++numAllocations;
+    void* ptr = NULL;
+    const size_t minAlignment = sizeof(void*);
+    const size_t align = (size_t(alignment) > minAlignment) ? size_t(alignment) : minAlignment;
+    if (posix_memalign(&ptr, align, size > 0 ? size : 1)) {
+        throw std::bad_alloc();
+    } // if
+    return ptr;
+} // operator new
+
+void*
+operator new[](size_t size,
+               std::align_val_t alignment) {
+    return operator new(size, alignment);
+} // operator new[]
+
+void
+operator delete(void* ptr,
+                std::align_val_t) noexcept {
+    release(ptr);
+} // operator delete
+
+void
+operator delete[](void* ptr,
+                  std::align_val_t) noexcept {
+    release(ptr);
+} // operator delete[]
+
+void
+operator delete(void* ptr,
+                size_t,
+                std::align_val_t) noexcept {
+    release(ptr);
+} // operator delete
+
+void
+operator delete[](void* ptr,
+                  size_t,
+                  std::align_val_t) noexcept {
+    release(ptr);
+} // operator delete[]
+#endif
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestQueryAllocations;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestQueryAllocations : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestQueryAllocations);
+
+    CPPUNIT_TEST(testSimpleDBNearest);
+    CPPUNIT_TEST(testSimpleDBLinear);
+    CPPUNIT_TEST(testSimpleDBDelaunay);
+    CPPUNIT_TEST(testSimpleGridDB);
+    CPPUNIT_TEST(testCompositeDB);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Setup test subject.
+    void setUp(void);
+
+    /// Tear down test subject.
+    void tearDown(void);
+
+    /// Test SimpleDB queries with nearest neighbor interpolation.
+    void testSimpleDBNearest(void);
+
+    /// Test SimpleDB queries with linear interpolation.
+    void testSimpleDBLinear(void);
+
+    /// Test SimpleDB queries with Delaunay interpolation.
+    void testSimpleDBDelaunay(void);
+
+    /// Test SimpleGridDB queries.
+    void testSimpleGridDB(void);
+
+    /// Test CompositeDB queries.
+    void testCompositeDB(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Check that queries do not allocate memory in steady state.
+     *
+     * @param db Spatial database.
+     */
+    void _checkQueries(SpatialDB* db);
+
+    /// Write SimpleDB file with scattered points.
+    void _writeSimpleDB(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    static const char* _filename; ///< Name of SimpleDB file.
+
+}; // class TestQueryAllocations
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestQueryAllocations);
+
+// ----------------------------------------------------------------------
+const char* spatialdata::spatialdb::TestQueryAllocations::_filename = "data/query_allocations.spatialdb";
+
+// ----------------------------------------------------------------------
+// Setup test subject.
+void
+spatialdata::spatialdb::TestQueryAllocations::setUp(void) {
+    _writeSimpleDB();
+} // setUp
+
+
+// ----------------------------------------------------------------------
+// Tear down test subject.
+void
+spatialdata::spatialdb::TestQueryAllocations::tearDown(void) {
+    remove(_filename);
+} // tearDown
+
+
+// ----------------------------------------------------------------------
+// Test SimpleDB queries with nearest neighbor interpolation.
+void
+spatialdata::spatialdb::TestQueryAllocations::testSimpleDBNearest(void) {
+    SimpleIOAscii io;
+    io.setFilename(_filename);
+    SimpleDB db;
+    db.setIOHandler(&io);
+    db.setQueryType(SimpleDB::NEAREST);
+    db.open();
+
+    _checkQueries(&db);
+
+    db.close();
+} // testSimpleDBNearest
+
+
+// ----------------------------------------------------------------------
+// Test SimpleDB queries with linear interpolation.
+void
+spatialdata::spatialdb::TestQueryAllocations::testSimpleDBLinear(void) {
+    SimpleIOAscii io;
+    io.setFilename(_filename);
+    SimpleDB db;
+    db.setIOHandler(&io);
+    db.setQueryType(SimpleDB::LINEAR);
+    db.open();
+
+    _checkQueries(&db);
+
+    db.close();
+} // testSimpleDBLinear
+
+
+// ----------------------------------------------------------------------
+// Test SimpleDB queries with Delaunay interpolation.
+void
+spatialdata::spatialdb::TestQueryAllocations::testSimpleDBDelaunay(void) {
+    SimpleIOAscii io;
+    io.setFilename(_filename);
+    SimpleDB db;
+    db.setIOHandler(&io);
+    db.setQueryType(SimpleDB::DELAUNAY);
+    db.open();
+
+    _checkQueries(&db);
+
+    db.close();
+} // testSimpleDBDelaunay
+
+
+// ----------------------------------------------------------------------
+// Test SimpleGridDB queries.
+void
+spatialdata::spatialdb::TestQueryAllocations::testSimpleGridDB(void) {
+    SimpleGridDB db;
+    db.setFilename("data/grid_volume3d.spatialdb");
+
+    db.setQueryType(SimpleGridDB::NEAREST);
+    db.open();
+    _checkQueries(&db);
+
+    db.setQueryType(SimpleGridDB::LINEAR);
+    _checkQueries(&db);
+
+    db.close();
+} // testSimpleGridDB
+
+
+// ----------------------------------------------------------------------
+// Test CompositeDB queries.
+void
+spatialdata::spatialdb::TestQueryAllocations::testCompositeDB(void) {
+    SimpleGridDB dbA;
+    dbA.setFilename("data/grid_volume3d.spatialdb");
+    dbA.setQueryType(SimpleGridDB::LINEAR);
+    SimpleGridDB dbB;
+    dbB.setFilename("data/grid_volume3d.spatialdb");
+    dbB.setQueryType(SimpleGridDB::NEAREST);
+
+    CompositeDB db;
+    const char* namesA[1] = { "one" };
+    const char* namesB[1] = { "two" };
+    db.setDBA(&dbA, namesA, 1);
+    db.setDBB(&dbB, namesB, 1);
+    db.open();
+
+    _checkQueries(&db);
+
+    db.close();
+} // testCompositeDB
+
+
+// ----------------------------------------------------------------------
+// Check that queries do not allocate memory in steady state.
+void
+spatialdata::spatialdb::TestQueryAllocations::_checkQueries(SpatialDB* db) {
+    CPPUNIT_ASSERT(db);
+
+    const size_t numLocs = 5;
+    const size_t spaceDim = 3;
+    const size_t numValues = 2;
+    const double coords[numLocs*spaceDim] = {
+        0.0, 2.5, 0.5,
+        -1.0, 3.0, 2.0,
+        1.5, 3.5, -0.2,
+        0.5, 2.5, 1.5,
+        9.0, 3.0, 0.0, // outside
+    };
+    float coordsF[numLocs*spaceDim];
+    for (size_t i = 0; i < numLocs*spaceDim; ++i) {
+        coordsF[i] = coords[i];
+    } // for
+    const char* names[numValues] = { "two", "one" };
+    db->setQueryValues(names, numValues);
+
+    spatialdata::geocoords::CSCart cs;
+    cs.setSpaceDim(spaceDim);
+
+    double values[numLocs*numValues];
+    float valuesF[numLocs*numValues];
+    int err[numLocs];
+
+    // Warm up scratch buffers.
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        db->query(&values[iLoc*numValues], numValues, &coords[iLoc*spaceDim], spaceDim, &cs);
+        db->query(&valuesF[iLoc*numValues], numValues, &coordsF[iLoc*spaceDim], spaceDim, &cs);
+    } // for
+    db->multiquery(values, numLocs, numValues, err, numLocs, coords, numLocs, spaceDim, &cs);
+    db->multiquery(valuesF, numLocs, numValues, err, numLocs, coordsF, numLocs, spaceDim, &cs);
+
+    // Counter is read before any assertions, because assertions may allocate.
+    const size_t numRepeat = 10;
+    const size_t numAllocationsStart = numAllocations;
+    for (size_t iRepeat = 0; iRepeat < numRepeat; ++iRepeat) {
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            db->query(&values[iLoc*numValues], numValues, &coords[iLoc*spaceDim], spaceDim, &cs);
+            db->query(&valuesF[iLoc*numValues], numValues, &coordsF[iLoc*spaceDim], spaceDim, &cs);
+        } // for
+        db->multiquery(values, numLocs, numValues, err, numLocs, coords, numLocs, spaceDim, &cs);
+        db->multiquery(valuesF, numLocs, numValues, err, numLocs, coordsF, numLocs, spaceDim, &cs);
+    } // for
+    const size_t numAllocationsEnd = numAllocations;
+
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected no memory allocation in queries.", numAllocationsStart, numAllocationsEnd);
+} // _checkQueries
+
+
+// ----------------------------------------------------------------------
+// Write SimpleDB file with scattered points.
+void
+spatialdata::spatialdb::TestQueryAllocations::_writeSimpleDB(void) {
+    const size_t numLocs = 5*5*5;
+    const size_t spaceDim = 3;
+    const size_t dataDim = 3;
+    const size_t numValues = 2;
+    const char* names[numValues] = { "one", "two" };
+    const char* units[numValues] = { "none", "none" };
+
+    // Perturbed grid of points with values varying linearly.
+    std::vector<double> coordinates(numLocs*spaceDim);
+    std::vector<double> values(numLocs*numValues);
+    unsigned long seed = 12345;
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const size_t index[spaceDim] = { iLoc % 5, (iLoc / 5) % 5, iLoc / 25 };
+        double* xyz = &coordinates[iLoc*spaceDim];
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            seed = (1103515245*seed + 12345) % 2147483648UL;
+            xyz[iDim] = -4.0 + 2.0*index[iDim] + 0.5*(double(seed) / 2147483648.0 - 0.5);
+        } // for
+        values[iLoc*numValues+0] = 1.0 + xyz[0] + 2.0*xyz[1] + 3.0*xyz[2];
+        values[iLoc*numValues+1] = 2.0 - xyz[2];
+    } // for
+
+    SimpleDBData data;
+    data.allocate(numLocs, numValues, spaceDim, dataDim);
+    data.setCoordinates(&coordinates[0], numLocs, spaceDim);
+    data.setData(&values[0], numLocs, numValues);
+    data.setNames(names, numValues);
+    data.setUnits(units, numValues);
+
+    spatialdata::geocoords::CSCart cs;
+    SimpleIOAscii writer;
+    writer.setFilename(_filename);
+    writer.write(data, &cs);
+} // _writeSimpleDB
+
+
+// End of file
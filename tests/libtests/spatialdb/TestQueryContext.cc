@@ -0,0 +1,168 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/QueryContext.hh" // USES QueryContext
+#include "spatialdata/spatialdb/SimpleGridDB.hh" // USES SimpleGridDB
+#include "spatialdata/spatialdb/UniformDB.hh" // USES UniformDB
+#include "spatialdata/geocoords/CSCart.hh" // USES CSCart
+
+#include <vector> // USES std::vector
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestQueryContext;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestQueryContext : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestQueryContext);
+
+    CPPUNIT_TEST(testGetConverter);
+    CPPUNIT_TEST(testGetNested);
+    CPPUNIT_TEST(testQueryBatch);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Test getConverter().
+    void testGetConverter(void);
+
+    /// Test getNested().
+    void testGetNested(void);
+
+    /// Test SpatialDB::queryBatch() with multiple contexts.
+    void testQueryBatch(void);
+
+}; // class TestQueryContext
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestQueryContext);
+
+// ----------------------------------------------------------------------
+// Test getConverter().
+void
+spatialdata::spatialdb::TestQueryContext::testGetConverter(void) {
+    UniformDB dbA;
+    UniformDB dbB;
+
+    QueryContext context;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of converters.", size_t(0), context._converters.size());
+
+    spatialdata::geocoords::Converter* converterA = context.getConverter(&dbA);
+    CPPUNIT_ASSERT(converterA);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in converter for same database.", converterA, context.getConverter(&dbA));
+
+    spatialdata::geocoords::Converter* converterB = context.getConverter(&dbB);
+    CPPUNIT_ASSERT(converterB);
+    CPPUNIT_ASSERT_MESSAGE("Expected different converters for different databases.", converterA != converterB);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of converters.", size_t(2), context._converters.size());
+
+    QueryContext contextOther;
+    CPPUNIT_ASSERT_MESSAGE("Expected different converters for different contexts.",
+                           converterA != contextOther.getConverter(&dbA));
+} // testGetConverter
+
+
+// ----------------------------------------------------------------------
+// Test getNested().
+void
+spatialdata::spatialdb::TestQueryContext::testGetNested(void) {
+    QueryContext context;
+    CPPUNIT_ASSERT(!context._nested);
+
+    QueryContext* nested = context.getNested();
+    CPPUNIT_ASSERT(nested);
+    CPPUNIT_ASSERT_MESSAGE("Expected nested context to differ from context.", nested != &context);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in nested context.", nested, context.getNested());
+    CPPUNIT_ASSERT_MESSAGE("Expected separate context for next level of nesting.", nested->getNested() != nested);
+} // testGetNested
+
+
+// ----------------------------------------------------------------------
+// Test SpatialDB::queryBatch() with multiple contexts.
+void
+spatialdata::spatialdb::TestQueryContext::testQueryBatch(void) {
+    SimpleGridDB db;
+    db.setFilename("data/grid_volume3d.spatialdb");
+    db.setQueryType(SimpleGridDB::LINEAR);
+    db.open();
+
+    const size_t numLocs = 4;
+    const size_t spaceDim = 3;
+    const size_t numValues = 2;
+    const double coordsA[numLocs*spaceDim] = {
+        0.0, 2.5, 0.5,
+        -1.0, 3.0, 2.0,
+        1.5, 3.5, -0.2,
+        9.0, 3.0, 0.0, // outside
+    };
+    const double coordsB[numLocs*spaceDim] = {
+        1.8, 2.1, 3.0,
+        -2.5, 3.9, 0.1,
+        -3.0, 2.0, 4.0,
+        0.5, 2.5, 1.5,
+    };
+    spatialdata::geocoords::CSCart cs;
+    cs.setSpaceDim(spaceDim);
+
+    // Expected values from query() using database's own context.
+    double valuesAE[numLocs*numValues];
+    double valuesBE[numLocs*numValues];
+    int errAE[numLocs];
+    int errBE[numLocs];
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        errAE[iLoc] = db.query(&valuesAE[iLoc*numValues], numValues, &coordsA[iLoc*spaceDim], spaceDim, &cs);
+        errBE[iLoc] = db.query(&valuesBE[iLoc*numValues], numValues, &coordsB[iLoc*spaceDim], spaceDim, &cs);
+    } // for
+
+    // Interleave batches of single locations between two contexts.
+    QueryContext contextA;
+    QueryContext contextB;
+    std::vector<double> valuesA(numLocs*numValues);
+    std::vector<double> valuesB(numLocs*numValues);
+    std::vector<int> errA(numLocs);
+    std::vector<int> errB(numLocs);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        db.queryBatch(&contextA, &valuesA[iLoc*numValues], numValues, &errA[iLoc], &coordsA[iLoc*spaceDim], 1, spaceDim, &cs);
+        db.queryBatch(&contextB, &valuesB[iLoc*numValues], numValues, &errB[iLoc], &coordsB[iLoc*spaceDim], 1, spaceDim, &cs);
+    } // for
+
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag for context A.", errAE[iLoc], errA[iLoc]);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag for context B.", errBE[iLoc], errB[iLoc]);
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            const size_t index = iLoc*numValues+iVal;
+            if (!errAE[iLoc]) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value for context A.", valuesAE[index], valuesA[index]);
+            } // if
+            if (!errBE[iLoc]) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value for context B.", valuesBE[index], valuesB[index]);
+            } // if
+        } // for
+    } // for
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected failed query outside grid.", 1, errA[numLocs-1]);
+
+    db.close();
+} // testQueryBatch
+
+
+// End of file
@@ -22,6 +22,7 @@
 #include "spatialdata/geocoords/CSGeo.hh" // USES CSGeo
 
 #include <math.h> // USES fabs()
+#include <stdexcept> // USES std::invalid_argument
 
 namespace spatialdata {
     namespace spatialdb {
@@ -42,6 +43,7 @@ class spatialdata::spatialdb::TestSCECCVMH : public CppUnit::TestFixture {
 #if defined(SCECCVMH_DATADIR)
     CPPUNIT_TEST(testQuery);
     CPPUNIT_TEST(testQuerySquashed);
+    CPPUNIT_TEST(testQueryRegion);
 #endif
 
     CPPUNIT_TEST_SUITE_END();
@@ -67,6 +69,9 @@ public:
     /// Test querySquashed().
     void testQuerySquashed(void);
 
+    /// Test query() with region of interest.
+    void testQueryRegion(void);
+
     /// Test calcDensity().
     void testCalcDensity(void);
 
@@ -106,6 +111,29 @@ spatialdata::spatialdb::TestSCECCVMH::testAccessors(void) {
     db.setDataDir(dataDir.c_str());
     CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in database data directory.", dataDir, db._dataDir);
 
+    // Cache directory
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in default cache directory.", std::string(""), db._cacheDir);
+    const std::string cacheDir("/path/to/cache/dir");
+    db.setCacheDir(cacheDir.c_str());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in cache directory.", cacheDir, db._cacheDir);
+
+    // Region of interest
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in default region flag.", false, db._hasRegion);
+    geocoords::CSGeo csUTM;
+    csUTM.setString("+proj=utm +zone=11 +datum=NAD27 +units=m +type=crs");
+    csUTM.setSpaceDim(2);
+    const double regionE[4] = { 360000.0, 3750000.0, 390000.0, 3790000.0 };
+    CPPUNIT_ASSERT_THROW(db.setRegion(regionE[2], regionE[1], regionE[0], regionE[3], &csUTM), std::invalid_argument);
+    db.setRegion(regionE[0], regionE[1], regionE[2], regionE[3], &csUTM);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in region flag.", true, db._hasRegion);
+    const double tolerance = 1.0e-6;
+    for (int i = 0; i < 4; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in region in UTM coordinates.", regionE[i], db._regionUTM[i], tolerance);
+    } // for
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in thread safety with cache files and region.", true, db.isThreadSafe());
+    db.setCacheDir("");
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in thread safety with region.", false, db.isThreadSafe());
+
     // Squashing
     const double limitDefault = -2000.0;
     CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in default squashing flag.", false, db._squashTopo);
@@ -611,6 +639,67 @@ spatialdata::spatialdb::TestSCECCVMH::testQuerySquashed(void) {
 } // testQuerySquashed
 
 
+// ----------------------------------------------------------------------
+// Test query() with region of interest.
+void
+spatialdata::spatialdb::TestSCECCVMH::testQueryRegion(void) {
+    geocoords::CSGeo csUTM;
+    csUTM.setString("+proj=utm +zone=11 +datum=NAD27 +units=m +type=crs");
+    csUTM.setSpaceDim(3);
+
+    SCECCVMH dbE;
+    dbE.setDataDir(SCECCVMH_DATADIR);
+    dbE.open();
+
+    SCECCVMH db;
+    db.setDataDir(SCECCVMH_DATADIR);
+    db.setRegion(360000.0, 3750000.0, 390000.0, 3790000.0, &csUTM);
+    db.open();
+    CPPUNIT_ASSERT_MESSAGE("Expected cropped voxets after opening database with region.", db._isCropped);
+    CPPUNIT_ASSERT_MESSAGE("Expected region not exceeded after opening database.", !db.isRegionExceeded());
+
+    // First two locations are inside the region, the others are outside.
+    const size_t numLocs = 4;
+    const size_t spaceDim = 3;
+    const double xyz[4*3] = {
+        376300.0, 3773700.0, -1770.0,
+        365000.0, 3760000.0, -5000.0,
+        408400.0, 3766400.0, -3000.0,
+        437100.0, 3802000.0, 1000.0,
+    };
+    const size_t querySize = 7;
+    double values[querySize];
+    double valuesE[querySize];
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const int errE = dbE.query(valuesE, querySize, &xyz[iLoc*spaceDim], spaceDim, &csUTM);
+        const int err = db.query(values, querySize, &xyz[iLoc*spaceDim], spaceDim, &csUTM);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", errE, err);
+        for (size_t iVal = 0; iVal < querySize; ++iVal) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in query value.", valuesE[iVal], values[iVal]);
+        } // for
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in cropped voxets flag.", iLoc < 2, db._isCropped);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in region exceeded flag.", iLoc >= 2, db.isRegionExceeded());
+    } // for
+
+    // Full voxets are used for all later queries.
+    const int errE = dbE.query(valuesE, querySize, &xyz[0], spaceDim, &csUTM);
+    const int err = db.query(values, querySize, &xyz[0], spaceDim, &csUTM);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag after reading full voxets.", errE, err);
+    for (size_t iVal = 0; iVal < querySize; ++iVal) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in query value after reading full voxets.", valuesE[iVal], values[iVal]);
+    } // for
+    CPPUNIT_ASSERT_MESSAGE("Expected full voxets after query outside region.", !db._isCropped);
+    CPPUNIT_ASSERT_MESSAGE("Expected region to be kept after query outside region.", db._hasRegion);
+    CPPUNIT_ASSERT_MESSAGE("Expected region exceeded flag to be kept for later queries.", db.isRegionExceeded());
+
+    // Reopening the database reads the region and clears the flag.
+    db.close();
+    db.open();
+    CPPUNIT_ASSERT_MESSAGE("Expected cropped voxets after reopening database.", db._isCropped);
+    CPPUNIT_ASSERT_MESSAGE("Expected region exceeded flag cleared after reopening database.", !db.isRegionExceeded());
+} // testQueryRegion
+
+
 #endif
 
 // End of file
@@ -25,6 +25,8 @@
 
 #include "spatialdata/geocoords/CSCart.hh" // USE CSCart
 
+#include <vector> // USES std::vector
+
 // ----------------------------------------------------------------------
 // Initialize test subject.
 void
@@ -125,6 +127,41 @@ spatialdata::spatialdb::TestSimpleDB::testQueryLinear(void) {
 } // _testQueryLinear
 
 
+// ----------------------------------------------------------------------
+// Test query() using Delaunay triangulation
+void
+spatialdata::spatialdb::TestSimpleDB::testQueryDelaunay(void) {
+    _initializeDB();
+
+    CPPUNIT_ASSERT(_db);
+    CPPUNIT_ASSERT(_data);
+
+    _db->setQueryType(SimpleDB::DELAUNAY);
+    const double* queryData = (_data->queryDelaunay) ? _data->queryDelaunay : _data->queryLinear;
+    _checkQuery(queryData, _data->errFlags);
+} // testQueryDelaunay
+
+
+// ----------------------------------------------------------------------
+// Test multiquery() and queryBatch().
+void
+spatialdata::spatialdb::TestSimpleDB::testMultiquery(void) {
+    _initializeDB();
+
+    CPPUNIT_ASSERT(_db);
+    CPPUNIT_ASSERT(_data);
+
+    _db->setQueryType(SimpleDB::NEAREST);
+    _checkMultiquery(_data->queryNearest);
+
+    _db->setQueryType(SimpleDB::LINEAR);
+    _checkMultiquery(_data->queryLinear);
+
+    _db->setQueryType(SimpleDB::DELAUNAY);
+    _checkMultiquery(_data->queryLinear);
+} // testMultiquery
+
+
 // ----------------------------------------------------------------------
 // Populate database with data.
 void
@@ -192,6 +229,101 @@ spatialdata::spatialdb::TestSimpleDB::_checkQuery(const double* queryData,
 } // _checkQuery
 
 
+// ----------------------------------------------------------------------
+// Check that multiquery() matches query() at each location.
+void
+spatialdata::spatialdb::TestSimpleDB::_checkMultiquery(const double* queryData) {
+    CPPUNIT_ASSERT(queryData);
+    CPPUNIT_ASSERT(_data);
+    CPPUNIT_ASSERT(_db);
+
+    const size_t numValues = _data->numValues;
+    const size_t spaceDim = _data->spaceDim;
+    const size_t numQueries = _data->numQueries;
+    const size_t locSize = spaceDim + numValues;
+
+    _db->setQueryValues(_data->names, numValues);
+
+    std::vector<double> coordinates(numQueries*spaceDim);
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coordinates[iQuery*spaceDim+iDim] = queryData[iQuery*locSize+iDim];
+        } // for
+    } // for
+
+    spatialdata::geocoords::CSCart csCart;
+    std::vector<double> values(numQueries*numValues);
+    std::vector<int> err(numQueries);
+    _db->multiquery(&values[0], numQueries, numValues, &err[0], numQueries, &coordinates[0], numQueries, spaceDim, &csCart);
+
+    std::vector<double> valuesE(numValues);
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        const int errE = _db->query(&valuesE[0], numValues, &coordinates[iQuery*spaceDim], spaceDim, &csCart);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in query return value.", errE, err[iQuery]);
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value.", valuesE[iVal], values[iQuery*numValues+iVal]);
+        } // for
+    } // for
+
+    // Replicate locations so multiquery() splits them among several threads.
+    const size_t numCopies = 2048 / numQueries + 1;
+    const size_t numLocs = numCopies*numQueries;
+    std::vector<double> coordsT(numLocs*spaceDim);
+    for (size_t iCopy = 0; iCopy < numCopies; ++iCopy) {
+        for (size_t i = 0; i < numQueries*spaceDim; ++i) {
+            coordsT[iCopy*numQueries*spaceDim+i] = coordinates[i];
+        } // for
+    } // for
+    const size_t numThreads = 4;
+    std::vector<double> valsT(numLocs*numValues);
+    std::vector<int> errT(numLocs);
+    _db->multiquery(&valsT[0], numLocs, numValues, &errT[0], numLocs, &coordsT[0], numLocs, spaceDim, &csCart, numThreads);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const size_t iQuery = iLoc % numQueries;
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag with multiple threads.", err[iQuery], errT[iLoc]);
+        if (!err[iQuery]) {
+            for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value with multiple threads.", values[iQuery*numValues+iVal], valsT[iLoc*numValues+iVal]);
+            } // for
+        } // if
+    } // for
+
+    // Query contexts of threads are kept for later queries.
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of query contexts for threads.", numThreads-1, _db->_getThreadContexts().size());
+    const std::vector<QueryContext*> threadContexts = _db->_getThreadContexts();
+    _db->multiquery(&valsT[0], numLocs, numValues, &errT[0], numLocs, &coordsT[0], numLocs, spaceDim, &csCart, numThreads);
+    CPPUNIT_ASSERT_MESSAGE("Expected query contexts of threads to be reused.", threadContexts == _db->_getThreadContexts());
+
+    // Chunks of one location with a number of locations that is not a
+    // multiple of the number of threads, so rounding up the chunk size
+    // (2) leaves the last chunk empty.
+    const size_t minChunkSize = _db->_getMinChunkSize();
+    _db->_setMinChunkSize(1);
+    const size_t numThreadsSmall = 4;
+    const size_t numLocsSmall = 5;
+    std::vector<double> coordsS(numLocsSmall*spaceDim);
+    for (size_t iLoc = 0; iLoc < numLocsSmall; ++iLoc) {
+        const size_t iQuery = iLoc % numQueries;
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coordsS[iLoc*spaceDim+iDim] = coordinates[iQuery*spaceDim+iDim];
+        } // for
+    } // for
+    std::vector<double> valsS(numLocsSmall*numValues);
+    std::vector<int> errS(numLocsSmall);
+    _db->multiquery(&valsS[0], numLocsSmall, numValues, &errS[0], numLocsSmall, &coordsS[0], numLocsSmall, spaceDim, &csCart, numThreadsSmall);
+    for (size_t iLoc = 0; iLoc < numLocsSmall; ++iLoc) {
+        const size_t iQuery = iLoc % numQueries;
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag with small chunks.", err[iQuery], errS[iLoc]);
+        if (!err[iQuery]) {
+            for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value with small chunks.", values[iQuery*numValues+iVal], valsS[iLoc*numValues+iVal]);
+            } // for
+        } // if
+    } // for
+    _db->_setMinChunkSize(minChunkSize);
+} // _checkMultiquery
+
+
 // Constructor
 spatialdata::spatialdb::TestSimpleDB_Data::TestSimpleDB_Data(void) :
     numLocs(0),
@@ -205,7 +337,8 @@ spatialdata::spatialdb::TestSimpleDB_Data::TestSimpleDB_Data(void) :
     units(NULL),
     queryNearest(NULL),
     queryLinear(NULL),
-    errFlags(NULL) {}
+    errFlags(NULL),
+    queryDelaunay(NULL) {}
 
 
 spatialdata::spatialdb::TestSimpleDB_Data::~TestSimpleDB_Data(void) {
@@ -217,6 +350,7 @@ spatialdata::spatialdb::TestSimpleDB_Data::~TestSimpleDB_Data(void) {
     queryNearest = NULL;
     queryLinear = NULL;
     errFlags = NULL;
+    queryDelaunay = NULL;
 } // destructor
 
 
@@ -44,6 +44,8 @@ class spatialdata::spatialdb::TestSimpleDB : public CppUnit::TestFixture {
     CPPUNIT_TEST(testGetNamesDBValues);
     CPPUNIT_TEST(testQueryNearest);
     CPPUNIT_TEST(testQueryLinear);
+    CPPUNIT_TEST(testQueryDelaunay);
+    CPPUNIT_TEST(testMultiquery);
 
     CPPUNIT_TEST_SUITE_END_ABSTRACT();
 
@@ -71,6 +73,12 @@ public:
     /// Test queryLinear()
     void testQueryLinear(void);
 
+    /// Test query() using Delaunay triangulation.
+    void testQueryDelaunay(void);
+
+    /// Test multiquery() and queryBatch().
+    void testMultiquery(void);
+
 protected:
 
     // PROTECTED METHODS //////////////////////////////////////////////////
@@ -96,6 +104,13 @@ private:
     void _checkQuery(const double* queryData,
                      const int* flagsE);
 
+    /** Check that multiquery() matches query() at each location using
+     * one and several threads.
+     *
+     * @param queryData Array of query locations and expected values.
+     */
+    void _checkMultiquery(const double* queryData);
+
 }; // class TestSimpleDB
 
 class spatialdata::spatialdb::TestSimpleDB_Data {
@@ -125,6 +140,7 @@ public:
     const double* queryNearest;
     const double* queryLinear;
     const int* errFlags;
+    const double* queryDelaunay; ///< NULL if same as queryLinear.
 
 };
 
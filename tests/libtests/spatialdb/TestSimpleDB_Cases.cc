@@ -299,6 +299,15 @@ class spatialdata::spatialdb::TestSimpleDB_Volume3D : public TestSimpleDB {
         static const int errFlags[5] = {
             0, 0, 1, 0, 0, };
         _data->errFlags = errFlags;
+
+        static const double queryDelaunay[5*(3+2)] = {
+            4.38173419e+00,  8.36254772e+00,  8.74899281e+00,  1.35000000e-01,  1.49500000e+00,
+            2.35495601e+00,  1.00264422e+01,  9.00123360e+00,  4.00000000e-01,  3.93500000e+00,
+            3.91112675e+00,  1.07838373e+01,  9.69020768e+00,  0.00000000e+00,  0.00000000e+00,
+            3.87701461e+00,  1.04910673e+01,  9.08761157e+00,  5.50000000e-01,  4.32000000e+00,
+            3.01795532e+00,  8.84019490e+00,  8.79326896e+00,  3.05000000e-01,  3.41500000e+00,
+        };
+        _data->queryDelaunay = queryDelaunay;
     } // setUp
 
 }; // TestSimpleGriDB_Volume3D
@@ -0,0 +1,519 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/SimpleGridDB.hh" // USES SimpleGridDB
+#include "spatialdata/spatialdb/SimpleGridAscii.hh" // USES SimpleGridAscii
+#include "spatialdata/spatialdb/SimpleGridBinary.hh" // USES SimpleGridBinary
+
+#include "spatialdata/geocoords/CSCart.hh" // USE CSCart
+
+#include <fstream> // USES std::ifstream, std::ofstream
+#include <iterator> // USES std::istreambuf_iterator
+#include <vector> // USES std::vector
+#include <stdexcept> // USES std::runtime_error
+#include <algorithm> // USES std::max()
+#include <cmath> // USES fabs()
+
+namespace spatialdata {
+    namespace spatialdb {
+        class TestSimpleGridBinary;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestSimpleGridBinary : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestSimpleGridBinary);
+
+    CPPUNIT_TEST(testIO);
+    CPPUNIT_TEST(testAscii);
+    CPPUNIT_TEST(testSingle);
+    CPPUNIT_TEST(testBrick);
+    CPPUNIT_TEST(testOutOfCore);
+    CPPUNIT_TEST(testReadTruncated);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Test write(), isBinary(), and read() via open().
+    void testIO(void);
+
+    /// Test queries match ASCII file after conversion to binary file.
+    void testAscii(void);
+
+    /// Test write() and read() with values in single precision.
+    void testSingle(void);
+
+    /// Test read() and write() with values in brick layout.
+    void testBrick(void);
+
+    /// Test queries with values read into cache as they are queried.
+    void testOutOfCore(void);
+
+    /// Test read() with truncated file.
+    void testReadTruncated(void);
+
+}; // class TestSimpleGridBinary
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestSimpleGridBinary);
+
+// ----------------------------------------------------------------------
+// Test write(), isBinary(), and read() via open().
+void
+spatialdata::spatialdb::TestSimpleGridBinary::testIO(void) {
+    const size_t numX = 1;
+    const size_t numY = 2;
+    const size_t numZ = 3;
+    const size_t spaceDim = 3;
+    const size_t numValues = 2;
+    const size_t dataDim = 2;
+
+    const double x[numX] = { -2.0 };
+    const double y[numY] = { 0.0, 1.0 };
+    const double z[numZ] = { -2.0, -1.0, 2.0 };
+
+    const double coords[numX*numY*numZ*spaceDim] = {
+        -2.0,  0.0, -2.0,
+        -2.0,  1.0, -2.0,
+        -2.0,  0.0, -1.0,
+        -2.0,  1.0, -1.0,
+        -2.0,  0.0,  2.0,
+        -2.0,  1.0,  2.0,
+    };
+    const double data[numX*numY*numZ*numValues] = {
+        6.6,  3.4,
+        5.5,  6.7,
+        2.3,  4.1,
+        5.7,  2.0,
+        6.3,  6.9,
+        3.4,  6.4,
+    };
+    const char* names[numValues] = { "One", "Two" };
+    const char* units[numValues] = { "km", "m" };
+    const double scales[numValues] = { 1000.0, 1.0 };
+
+    geocoords::CSCart csOut;
+    SimpleGridDB dbOut;
+    dbOut.setCoordSys(csOut);
+    dbOut.allocate(numX, numY, numZ, numValues, spaceDim, dataDim);
+    dbOut.setX(x, numX);
+    dbOut.setY(y, numY);
+    dbOut.setZ(z, numZ);
+    dbOut.setData(coords, numX*numY*numZ, spaceDim, data, numX*numY*numZ, numValues);
+    dbOut.setNames(names, numValues);
+    dbOut.setUnits(units, numValues);
+
+    const char* filename = "data/grid_binary.spatialdb";
+    dbOut.setFilename(filename);
+    SimpleGridBinary::write(dbOut);
+    CPPUNIT_ASSERT_MESSAGE("Expected file to be binary SimpleGridDB file.", SimpleGridBinary::isBinary(filename));
+    CPPUNIT_ASSERT_MESSAGE("Expected file not to be binary SimpleGridDB file.",
+                           !SimpleGridBinary::isBinary("data/grid_volume3d.spatialdb"));
+
+    SimpleGridDB dbIn;
+    dbIn.setFilename(filename);
+    dbIn.open();
+
+    CPPUNIT_ASSERT_MESSAGE("Expected values to be memory-mapped.", dbIn._mapping);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of points along x axis.", numX, dbIn._numX);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of points along y axis.", numY, dbIn._numY);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of points along z axis.", numZ, dbIn._numZ);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of values.", numValues, dbIn._numValues);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in data dimension.", dataDim, dbIn._dataDim);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in spatial dimension.", spaceDim, dbIn._spaceDim);
+    CPPUNIT_ASSERT(dbIn._cs);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in coordinate system dimension.", int(spaceDim), dbIn._cs->getSpaceDim());
+
+    CPPUNIT_ASSERT(dbIn._names);
+    CPPUNIT_ASSERT(dbIn._units);
+    for (size_t iVal = 0; iVal < numValues; ++iVal) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in names.", std::string(names[iVal]), dbIn._names[iVal]);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in units.", std::string(units[iVal]), dbIn._units[iVal]);
+    } // for
+
+    const double tolerance = 1.0e-06;
+    for (size_t i = 0; i < numX; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in x coordinates.", x[i], dbIn._x[i], tolerance);
+    } // for
+    for (size_t i = 0; i < numY; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in y coordinates.", y[i], dbIn._y[i], tolerance);
+    } // for
+    for (size_t i = 0; i < numZ; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in z coordinates.", z[i], dbIn._z[i], tolerance);
+    } // for
+
+    // Values are stored in SI units.
+    CPPUNIT_ASSERT(dbIn._data);
+    for (size_t iLoc = 0; iLoc < numX*numY*numZ; ++iLoc) {
+        const size_t iD = dbIn._getDataIndex(&coords[iLoc*spaceDim], spaceDim);
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            const double valueE = data[iLoc*numValues+iVal]*scales[iVal];
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in data values.", 1.0, dbIn._data[iD+iVal]/valueE, tolerance);
+        } // for
+    } // for
+
+    // Closing database unmaps file.
+    dbIn.close();
+    CPPUNIT_ASSERT_MESSAGE("Expected file to be unmapped.", !dbIn._mapping);
+    CPPUNIT_ASSERT_MESSAGE("Expected values to be cleared.", !dbIn._data);
+} // testIO
+
+
+// ----------------------------------------------------------------------
+// Test queries match ASCII file after conversion to binary file.
+void
+spatialdata::spatialdb::TestSimpleGridBinary::testAscii(void) {
+    const char* filenameAscii = "data/grid_volume3d.spatialdb";
+    const char* filenameBinary = "data/grid_volume3d_binary.spatialdb";
+
+    // Read ASCII file without converting to SI units and write binary file.
+    SimpleGridDB dbConvert;
+    dbConvert.setFilename(filenameAscii);
+    SimpleGridAscii::read(&dbConvert);
+    dbConvert.setFilename(filenameBinary);
+    SimpleGridBinary::write(dbConvert);
+
+    SimpleGridDB dbAscii;
+    dbAscii.setFilename(filenameAscii);
+    dbAscii.open();
+    dbAscii.setQueryType(SimpleGridDB::LINEAR);
+
+    SimpleGridDB dbBinary;
+    dbBinary.setFilename(filenameBinary);
+    dbBinary.open();
+    dbBinary.setQueryType(SimpleGridDB::LINEAR);
+
+    const size_t numLocs = 5;
+    const size_t spaceDim = 3;
+    const size_t numValues = 2;
+    const double points[numLocs*spaceDim] = {
+        0.0, 2.5, 0.5,
+        -1.0, 3.0, 2.0,
+        1.5, 3.5, -0.2,
+        2.0, 4.0, 4.0,
+        9.0, 3.0, 0.0, // outside
+    };
+
+    geocoords::CSCart cs;
+    cs.setSpaceDim(spaceDim);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        double valuesE[numValues];
+        double values[numValues];
+        const int errE = dbAscii.query(valuesE, numValues, &points[iLoc*spaceDim], spaceDim, &cs);
+        const int err = dbBinary.query(values, numValues, &points[iLoc*spaceDim], spaceDim, &cs);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in query error flag.", errE, err);
+        if (!errE) {
+            for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in query.", valuesE[iVal], values[iVal], 1.0e-12);
+            } // for
+        } // if
+    } // for
+} // testAscii
+
+
+// ----------------------------------------------------------------------
+// Test write() and read() with values in single precision.
+void
+spatialdata::spatialdb::TestSimpleGridBinary::testSingle(void) {
+    const char* filenameAscii = "data/grid_volume3d.spatialdb";
+    const char* filenameBinary = "data/grid_volume3d_single.spatialdb";
+
+    SimpleGridDB dbConvert;
+    dbConvert.setFilename(filenameAscii);
+    SimpleGridAscii::read(&dbConvert);
+    dbConvert.setFilename(filenameBinary);
+    dbConvert.setPrecision(SimpleGridDB::SINGLE);
+    SimpleGridBinary::write(dbConvert);
+
+    SimpleGridDB dbAscii;
+    dbAscii.setFilename(filenameAscii);
+    dbAscii.open();
+
+    // Precision of values follows file.
+    SimpleGridDB dbBinary;
+    dbBinary.setFilename(filenameBinary);
+    dbBinary.open();
+    CPPUNIT_ASSERT_MESSAGE("Expected values to be memory-mapped.", dbBinary._mapping);
+    CPPUNIT_ASSERT_MESSAGE("Expected values stored in single precision.", dbBinary._dataF);
+    CPPUNIT_ASSERT_MESSAGE("Expected no values stored in double precision.", !dbBinary._data);
+
+    const size_t size = dbAscii._numX*dbAscii._numY*dbAscii._numZ*dbAscii._numValues;
+    for (size_t i = 0; i < size; ++i) {
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in data values.", float(dbAscii._data[i]), dbBinary._dataF[i], 0.0);
+    } // for
+} // testSingle
+
+
+// ----------------------------------------------------------------------
+// Test read() and write() with values in brick layout.
+void
+spatialdata::spatialdb::TestSimpleGridBinary::testBrick(void) {
+    const char* filenameAscii = "data/grid_volume3d.spatialdb";
+    const char* filenameBinary = "data/grid_volume3d_binary.spatialdb";
+    const char* filenameBrick = "data/grid_volume3d_brick.spatialdb";
+
+    SimpleGridDB dbConvert;
+    dbConvert.setFilename(filenameAscii);
+    SimpleGridAscii::read(&dbConvert);
+    dbConvert.setFilename(filenameBinary);
+    SimpleGridBinary::write(dbConvert);
+
+    SimpleGridDB dbAscii;
+    dbAscii.setFilename(filenameAscii);
+    dbAscii.open();
+
+    // Values are copied to brick layout and file is unmapped.
+    SimpleGridDB dbBinary;
+    dbBinary.setFilename(filenameBinary);
+    dbBinary.setLayout(SimpleGridDB::BRICK);
+    dbBinary.open();
+    CPPUNIT_ASSERT_MESSAGE("Expected file to be unmapped.", !dbBinary._mapping);
+    CPPUNIT_ASSERT_MESSAGE("Expected brick layout.", !dbBinary._brickX.empty());
+    CPPUNIT_ASSERT_MESSAGE("Expected values stored in double precision.", dbBinary._data);
+
+    const size_t numLocs = dbAscii._numX*dbAscii._numY*dbAscii._numZ;
+    const size_t numValues = dbAscii._numValues;
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const size_t offset = dbBinary._getDataIndex(iLoc);
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in data values.", dbAscii._data[iLoc*numValues+iVal],
+                                                 dbBinary._data[offset+iVal], 0.0);
+        } // for
+    } // for
+
+    // Values are written in brick layout and used in place.
+    dbBinary.setFilename(filenameBrick);
+    SimpleGridBinary::write(dbBinary);
+    SimpleGridDB dbBrick;
+    dbBrick.setFilename(filenameBrick);
+    dbBrick.open();
+    CPPUNIT_ASSERT_MESSAGE("Expected values to be memory-mapped.", dbBrick._mapping);
+    CPPUNIT_ASSERT_MESSAGE("Expected brick layout.", !dbBrick._brickX.empty());
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const size_t offset = dbBrick._getDataIndex(iLoc);
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in data values in file with brick layout.",
+                                                 dbAscii._data[iLoc*numValues+iVal], dbBrick._data[offset+iVal], 0.0);
+        } // for
+    } // for
+
+} // testBrick
+
+
+// ----------------------------------------------------------------------
+// Test queries with values read into cache as they are queried.
+void
+spatialdata::spatialdb::TestSimpleGridBinary::testOutOfCore(void) {
+    // Grid spans several bricks along each axis.
+    const size_t numX = 21;
+    const size_t numY = 18;
+    const size_t numZ = 10;
+    const size_t spaceDim = 3;
+    const size_t numValues = 3;
+    const size_t numLocs = numX*numY*numZ;
+    const char* names[numValues] = { "One", "Two", "Three" };
+    const char* units[numValues] = { "m", "m", "m" };
+
+    std::vector<double> x(numX);
+    std::vector<double> y(numY);
+    std::vector<double> z(numZ);
+    for (size_t i = 0; i < numX; ++i) {
+        x[i] = -10.0 + 1.5*i;
+    } // for
+    for (size_t i = 0; i < numY; ++i) {
+        y[i] = 2.0 + 0.5*i + 0.01*i*i;
+    } // for
+    for (size_t i = 0; i < numZ; ++i) {
+        z[i] = -5.0 + 1.0*i;
+    } // for
+    std::vector<double> coords(numLocs*spaceDim);
+    std::vector<double> data(numLocs*numValues);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const double xyz[spaceDim] = { x[iLoc % numX], y[(iLoc / numX) % numY], z[iLoc / (numX*numY)] };
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coords[iLoc*spaceDim+iDim] = xyz[iDim];
+        } // for
+        data[iLoc*numValues+0] = 1.0 + 2.0*xyz[0] - 3.0*xyz[1];
+        data[iLoc*numValues+1] = xyz[0]*xyz[1] + xyz[2];
+        data[iLoc*numValues+2] = 0.5*iLoc;
+    } // for
+
+    geocoords::CSCart cs;
+    SimpleGridDB dbE;
+    dbE.setCoordSys(cs);
+    dbE.allocate(numX, numY, numZ, numValues, spaceDim, spaceDim);
+    dbE.setX(&x[0], numX);
+    dbE.setY(&y[0], numY);
+    dbE.setZ(&z[0], numZ);
+    dbE.setData(&coords[0], numLocs, spaceDim, &data[0], numLocs, numValues);
+    dbE.setNames(names, numValues);
+    dbE.setUnits(units, numValues);
+
+    // Cache requires brick layout.
+    const char* filenameFlat = "data/grid_binary.spatialdb";
+    dbE.setFilename(filenameFlat);
+    SimpleGridBinary::write(dbE);
+    SimpleGridDB dbFlat;
+    dbFlat.setFilename(filenameFlat);
+    dbFlat.setCacheSize(1);
+    CPPUNIT_ASSERT_THROW(dbFlat.open(), std::runtime_error);
+
+    const size_t numQueries = 400;
+    std::vector<double> points(numQueries*spaceDim);
+    unsigned long seed = 12345;
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        const double lower[spaceDim] = { x[0] - 1.0, y[0] - 1.0, z[0] - 1.0 };
+        const double upper[spaceDim] = { x[numX-1] + 1.0, y[numY-1] + 1.0, z[numZ-1] + 1.0 };
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            seed = (1103515245*seed + 12345) % 2147483648UL;
+            points[iQuery*spaceDim+iDim] = lower[iDim] + (upper[iDim] - lower[iDim]) * double(seed) / 2147483648.0;
+        } // for
+    } // for
+
+    const char* filenameBrick = "data/grid_brick.spatialdb";
+    const SimpleGridDB::PrecisionEnum precisions[2] = { SimpleGridDB::DOUBLE, SimpleGridDB::SINGLE };
+    const SimpleGridDB::QueryEnum queryTypes[2] = { SimpleGridDB::NEAREST, SimpleGridDB::LINEAR };
+    for (size_t iPrecision = 0; iPrecision < 2; ++iPrecision) {
+        dbE.setFilename(filenameBrick);
+        dbE.setLayout(SimpleGridDB::BRICK);
+        dbE.setPrecision(precisions[iPrecision]);
+        SimpleGridBinary::write(dbE);
+
+        // Cache holds minimum of eight bricks.
+        SimpleGridDB db;
+        db.setFilename(filenameBrick);
+        db.setCacheSize(1);
+        db.open();
+        CPPUNIT_ASSERT_MESSAGE("Expected cache.", db._cache);
+        CPPUNIT_ASSERT_MESSAGE("Expected file to be unmapped.", !db._mapping);
+        CPPUNIT_ASSERT_MESSAGE("Expected values not to be loaded.", !db._data && !db._dataF);
+        CPPUNIT_ASSERT_MESSAGE("Expected queries not to be thread safe.", !db.isThreadSafe());
+
+        SimpleGridDB dbMapped;
+        dbMapped.setFilename(filenameBrick);
+        dbMapped.open();
+
+        for (size_t iType = 0; iType < 2; ++iType) {
+            db.setQueryType(queryTypes[iType]);
+            dbMapped.setQueryType(queryTypes[iType]);
+
+            std::vector<double> values(numQueries*numValues);
+            std::vector<double> valuesE(numQueries*numValues);
+            std::vector<int> err(numQueries);
+            std::vector<int> errE(numQueries);
+            db.multiquery(&values[0], numQueries, numValues, &err[0], numQueries, &points[0], numQueries, spaceDim, &cs);
+            dbMapped.multiquery(&valuesE[0], numQueries, numValues, &errE[0], numQueries, &points[0], numQueries, spaceDim, &cs);
+            for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", errE[iQuery], err[iQuery]);
+                for (size_t iVal = 0; !errE[iQuery] && iVal < numValues; ++iVal) {
+                    const size_t index = iQuery*numValues + iVal;
+                    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in value.", valuesE[index], values[index],
+                                                         1.0e-12*std::max(1.0, fabs(valuesE[index])));
+                } // for
+            } // for
+
+            // Query subset of values.
+            db.setQueryValues(&names[1], 1);
+            double value = 0.0;
+            for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+                const int errQuery = db.query(&value, 1, &points[iQuery*spaceDim], spaceDim, &cs);
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag for subset of values.", errE[iQuery], errQuery);
+                if (!errQuery) {
+                    const size_t index = iQuery*numValues + 1;
+                    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in subset of values.", valuesE[index], value,
+                                                         1.0e-12*std::max(1.0, fabs(valuesE[index])));
+                } // if
+            } // for
+            db.setQueryValues(names, numValues);
+        } // for
+
+        CPPUNIT_ASSERT_MESSAGE("Expected cache hits.", db.getCacheHits() > 0);
+        CPPUNIT_ASSERT_MESSAGE("Expected cache misses.", db.getCacheMisses() > 0);
+        CPPUNIT_ASSERT_MESSAGE("Expected cache evictions.", db.getCacheEvictions() > 0);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of evictions.", db.getCacheMisses() - 8, db.getCacheEvictions());
+
+        CPPUNIT_ASSERT_THROW(db.setData(&coords[0], numLocs, spaceDim, &data[0], numLocs, numValues), std::logic_error);
+        db.close();
+        CPPUNIT_ASSERT_MESSAGE("Expected cache to be released.", !db._cache);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in cache hits without cache.", size_t(0), db.getCacheHits());
+    } // for
+
+    // Compressed values from file with flat layout are decompressed
+    // into cache brick by brick.
+    SimpleGridDB dbCompressed;
+    dbCompressed.setFilename(filenameFlat);
+    dbCompressed.setCacheSize(1);
+    dbCompressed.setCompression(SimpleGridDB::LOSSLESS);
+    dbCompressed.open();
+    CPPUNIT_ASSERT_MESSAGE("Expected compressed values.", dbCompressed._compressed);
+    CPPUNIT_ASSERT_MESSAGE("Expected file to be unmapped.", !dbCompressed._mapping);
+    CPPUNIT_ASSERT(dbCompressed.getCompressedSize() > 0);
+    dbFlat.setCacheSize(0);
+    dbFlat.open();
+    dbCompressed.setQueryType(SimpleGridDB::LINEAR);
+    dbFlat.setQueryType(SimpleGridDB::LINEAR);
+    std::vector<double> values(numQueries*numValues);
+    std::vector<double> valuesE(numQueries*numValues);
+    std::vector<int> err(numQueries);
+    std::vector<int> errE(numQueries);
+    dbCompressed.multiquery(&values[0], numQueries, numValues, &err[0], numQueries, &points[0], numQueries, spaceDim, &cs);
+    dbFlat.multiquery(&valuesE[0], numQueries, numValues, &errE[0], numQueries, &points[0], numQueries, spaceDim, &cs);
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag for compressed values.", errE[iQuery], err[iQuery]);
+        for (size_t iVal = 0; !errE[iQuery] && iVal < numValues; ++iVal) {
+            const size_t index = iQuery*numValues + iVal;
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in compressed value.", valuesE[index], values[index],
+                                                 1.0e-12*std::max(1.0, fabs(valuesE[index])));
+        } // for
+    } // for
+} // testOutOfCore
+
+
+// ----------------------------------------------------------------------
+// Test read() with truncated file.
+void
+spatialdata::spatialdb::TestSimpleGridBinary::testReadTruncated(void) {
+    const char* filenameAscii = "data/grid_volume3d.spatialdb";
+    const char* filenameBinary = "data/grid_volume3d_binary.spatialdb";
+    const char* filenameTruncated = "data/grid_volume3d_truncated.spatialdb";
+
+    SimpleGridDB dbConvert;
+    dbConvert.setFilename(filenameAscii);
+    SimpleGridAscii::read(&dbConvert);
+    dbConvert.setFilename(filenameBinary);
+    SimpleGridBinary::write(dbConvert);
+
+    // Copy all but last value.
+    std::ifstream filein(filenameBinary, std::ios::binary);
+    std::vector<char> contents((std::istreambuf_iterator<char>(filein)), std::istreambuf_iterator<char>());
+    filein.close();
+    CPPUNIT_ASSERT(contents.size() > sizeof(double));
+    std::ofstream fileout(filenameTruncated, std::ios::binary);
+    fileout.write(&contents[0], contents.size() - sizeof(double));
+    fileout.close();
+
+    SimpleGridDB db;
+    db.setFilename(filenameTruncated);
+    CPPUNIT_ASSERT_THROW(db.open(), std::runtime_error);
+    CPPUNIT_ASSERT_MESSAGE("Expected values to be cleared.", !db._data);
+} // testReadTruncated
+
+
+// End of file
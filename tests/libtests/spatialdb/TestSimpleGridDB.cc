@@ -20,9 +20,19 @@
 
 #include "spatialdata/spatialdb/SimpleGridDB.hh" // USES SimpleGridDB
 #include "spatialdata/spatialdb/SimpleGridAscii.hh" // USES SimpleGridAscii
+#include "spatialdata/spatialdb/GridSharedMemory.hh" // USES GridSharedMemory
 
 #include "spatialdata/geocoords/CSCart.hh" // USE CSCart
 
+#include <vector> // USES std::vector
+#include <algorithm> // USES std::max()
+#include <cmath> // USES fabs()
+#include <stdexcept> // USES std::logic_error
+#include <fcntl.h> // USES O_RDONLY
+#include <unistd.h> // USES fork(), _exit()
+#include <sys/mman.h> // USES shm_open()
+#include <sys/wait.h> // USES waitpid()
+
 // ----------------------------------------------------------------------
 // Setup testing data.
 void
@@ -132,6 +142,50 @@ spatialdata::spatialdb::TestSimpleGridDB::testSearch(void) {
 } // testSearch
 
 
+// ----------------------------------------------------------------------
+// Test _search() with lookup table.
+void
+spatialdata::spatialdb::TestSimpleGridDB::testSearchLookup(void) {
+    const size_t numX = 6;
+    const double xUniform[numX] = {
+        -3.0, -1.0, 1.0, 3.0, 5.0, 7.0,
+    };
+    const double xNonuniform[numX] = {
+        -3.0, -1.0, 0.0, 5.0, 8.0, 8.1,
+    };
+    const double* axes[2] = { xUniform, xNonuniform };
+
+    // Targets include grid points, points just outside the grid (within
+    // and beyond the tolerance), and points between grid points.
+    const size_t numTargets = 14;
+    const double targets[numTargets] = {
+        -20.0, -3.0-2.0e-6, -3.0-0.5e-6, -3.0, -2.0, -1.0, -0.999, 0.0,
+        4.9999999, 5.0, 7.0+0.5e-6, 8.05, 8.1+0.5e-6, 8.1+2.0e-6,
+    };
+
+    SimpleGridDB db;
+    for (size_t iAxis = 0; iAxis < 2; ++iAxis) {
+        const double* x = axes[iAxis];
+        SimpleGridDB::AxisLookup lookup;
+        SimpleGridDB::_buildLookup(&lookup, x, numX);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in size of lookup table.", numX, lookup.size);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in detection of uniform spacing.", 0 == iAxis, lookup.buckets.empty());
+
+        db.setQueryType(SimpleGridDB::NEAREST);
+        for (size_t iTarget = 0; iTarget < numTargets; ++iTarget) {
+            const double indexE = db._search(targets[iTarget], x, numX);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in index for nearest query.", indexE, db._search(targets[iTarget], x, numX, lookup));
+        } // for
+
+        db.setQueryType(SimpleGridDB::LINEAR);
+        for (size_t iTarget = 0; iTarget < numTargets; ++iTarget) {
+            const double indexE = db._search(targets[iTarget], x, numX);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in index for linear query.", indexE, db._search(targets[iTarget], x, numX, lookup));
+        } // for
+    } // for
+} // testSearchLookup
+
+
 // ----------------------------------------------------------------------
 // Test _getDataIndex()
 void
@@ -150,9 +204,97 @@ spatialdata::spatialdb::TestSimpleGridDB::testDataIndex(void) {
 
     CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in index x.", size_t(1*10), db._getDataIndex(1, db._numX, 0, db._numY, 0, db._numZ));
     CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in index xyz.", size_t(3*4*3*10 + 1*4*10 + 2*10), db._getDataIndex(2, db._numX, 1, db._numY, 3, db._numZ));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in index of location.", size_t(3*4*3*10 + 1*4*10 + 2*10), db._getDataIndex(3*4*3 + 1*4 + 2));
+
+    // Brick layout with points in Morton order within bricks of 8x8x8 points.
+    db._numZ = 10;
+    db._dataDim = 3;
+    db._buildBricks();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in brick index 0.", size_t(0), db._getDataIndex(0, db._numX, 0, db._numY, 0, db._numZ));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in brick index x.", size_t(1*10), db._getDataIndex(1, db._numX, 0, db._numY, 0, db._numZ));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in brick index y.", size_t(2*10), db._getDataIndex(0, db._numX, 1, db._numY, 0, db._numZ));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in brick index z.", size_t(4*10), db._getDataIndex(0, db._numX, 0, db._numY, 1, db._numZ));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in brick index xyz.", size_t((8 + 2 + 4 + 32)*10), db._getDataIndex(2, db._numX, 1, db._numY, 3, db._numZ));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in brick index of next brick.", size_t((512 + 2)*10), db._getDataIndex(0, db._numX, 1, db._numY, 8, db._numZ));
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in brick index of location.", size_t((8 + 2 + 4 + 32)*10), db._getDataIndex(3*4*3 + 1*4 + 2));
 } // testDataIndex
 
 
+// ----------------------------------------------------------------------
+// Test setData() with locations in and out of grid order.
+void
+spatialdata::spatialdb::TestSimpleGridDB::testSetData(void) {
+    CPPUNIT_ASSERT(_data);
+
+    const size_t spaceDim = _data->spaceDim;
+    const size_t numValues = _data->numValues;
+    const size_t numLocs = std::max(_data->numX, size_t(1)) * std::max(_data->numY, size_t(1)) * std::max(_data->numZ, size_t(1));
+
+    // Locations and values in grid order (x fastest, then y, then z).
+    std::vector<double> coordsGrid(numLocs*spaceDim, 0.0);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const size_t indexX = iLoc % std::max(_data->numX, size_t(1));
+        const size_t indexY = (iLoc / std::max(_data->numX, size_t(1))) % std::max(_data->numY, size_t(1));
+        const size_t indexZ = iLoc / (std::max(_data->numX, size_t(1))*std::max(_data->numY, size_t(1)));
+        if (_data->numX > 1) {
+            coordsGrid[iLoc*spaceDim+0] = _data->dbX[indexX];
+        } // if
+        if ((spaceDim > 1) && (_data->numY > 1)) {
+            coordsGrid[iLoc*spaceDim+1] = _data->dbY[indexY];
+        } // if
+        if ((spaceDim > 2) && (_data->numZ > 1)) {
+            coordsGrid[iLoc*spaceDim+2] = _data->dbZ[indexZ];
+        } // if
+    } // for
+
+    // Orderings: grid order, reversed, and grid order for the first half
+    // followed by the second half reversed.
+    const size_t numOrders = 3;
+    std::vector<size_t> orders[numOrders];
+    for (size_t iOrder = 0; iOrder < numOrders; ++iOrder) {
+        orders[iOrder].resize(numLocs);
+        for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+            orders[iOrder][iLoc] = iLoc;
+        } // for
+    } // for
+    std::reverse(orders[1].begin(), orders[1].end());
+    std::reverse(orders[2].begin() + numLocs/2, orders[2].end());
+
+    const SimpleGridDB::LayoutEnum layouts[2] = { SimpleGridDB::FLAT, SimpleGridDB::BRICK };
+    for (size_t iLayout = 0; iLayout < 2; ++iLayout) {
+        SimpleGridDB dbE;
+        _setupDB(&dbE);
+        dbE.setLayout(layouts[iLayout]);
+        dbE._arrangeData();
+
+        for (size_t iOrder = 0; iOrder < numOrders; ++iOrder) {
+            std::vector<double> coords(numLocs*spaceDim);
+            std::vector<double> values(numLocs*numValues);
+            for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+                const size_t indexLoc = orders[iOrder][iLoc];
+                for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+                    coords[iLoc*spaceDim+iDim] = coordsGrid[indexLoc*spaceDim+iDim];
+                } // for
+                for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                    values[iLoc*numValues+iVal] = _data->dbData[indexLoc*numValues+iVal];
+                } // for
+            } // for
+
+            SimpleGridDB db;
+            _setupDB(&db);
+            db.setLayout(layouts[iLayout]);
+            db._arrangeData();
+            std::fill(db._data, db._data+numLocs*numValues, 0.0);
+            db.setData(&coords[0], numLocs, spaceDim, &values[0], numLocs, numValues);
+
+            for (size_t i = 0; i < numLocs*numValues; ++i) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in data value.", dbE._data[i], db._data[i]);
+            } // for
+        } // for
+    } // for
+} // testSetData
+
+
 // ----------------------------------------------------------------------
 // Test getNamesDBValues().
 void
@@ -202,6 +344,196 @@ spatialdata::spatialdb::TestSimpleGridDB::testQueryLinear(void) {
 } // _testQueryLinear
 
 
+// ----------------------------------------------------------------------
+// Test multiquery() and queryBatch().
+void
+spatialdata::spatialdb::TestSimpleGridDB::testMultiquery(void) {
+    CPPUNIT_ASSERT(_data);
+
+    SimpleGridDB db;
+    _setupDB(&db);
+
+    db.setQueryType(SimpleGridDB::NEAREST);
+    _checkMultiquery(db, _data->queryNearest);
+
+    db.setQueryType(SimpleGridDB::LINEAR);
+    _checkMultiquery(db, _data->queryLinear);
+} // testMultiquery
+
+
+// ----------------------------------------------------------------------
+// Test queries with values stored in single precision.
+void
+spatialdata::spatialdb::TestSimpleGridDB::testQuerySingle(void) {
+    CPPUNIT_ASSERT(_data);
+
+    SimpleGridDB db;
+    _setupDB(&db);
+    db.setPrecision(SimpleGridDB::SINGLE);
+    db._arrangeData();
+    CPPUNIT_ASSERT_MESSAGE("Expected values stored in single precision.", db._dataF);
+    CPPUNIT_ASSERT_MESSAGE("Expected no values stored in double precision.", !db._data);
+
+    db.setQueryType(SimpleGridDB::NEAREST);
+    _checkQuery(db, _data->names, _data->queryNearest, 0, _data->numQueries, _data->spaceDim, _data->numValues);
+    _checkMultiquery(db, _data->queryNearest);
+
+    db.setQueryType(SimpleGridDB::LINEAR);
+    _checkQuery(db, _data->names, _data->queryLinear, _data->errFlags, _data->numQueries, _data->spaceDim, _data->numValues);
+    _checkMultiquery(db, _data->queryLinear);
+} // testQuerySingle
+
+
+// ----------------------------------------------------------------------
+// Test queries with values stored in brick layout.
+void
+spatialdata::spatialdb::TestSimpleGridDB::testQueryBrick(void) {
+    CPPUNIT_ASSERT(_data);
+
+    SimpleGridDB db;
+    _setupDB(&db);
+    db.setLayout(SimpleGridDB::BRICK);
+    db._arrangeData();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected brick layout only for 3-D grids.", 3 == _data->dataDim, !db._brickX.empty());
+
+    db.setQueryType(SimpleGridDB::NEAREST);
+    _checkQuery(db, _data->names, _data->queryNearest, 0, _data->numQueries, _data->spaceDim, _data->numValues);
+    _checkMultiquery(db, _data->queryNearest);
+
+    db.setQueryType(SimpleGridDB::LINEAR);
+    _checkQuery(db, _data->names, _data->queryLinear, _data->errFlags, _data->numQueries, _data->spaceDim, _data->numValues);
+    _checkMultiquery(db, _data->queryLinear);
+
+    // Brick layout with single precision values.
+    SimpleGridDB dbF;
+    _setupDB(&dbF);
+    dbF.setPrecision(SimpleGridDB::SINGLE);
+    dbF.setLayout(SimpleGridDB::BRICK);
+    dbF._arrangeData();
+    dbF.setQueryType(SimpleGridDB::LINEAR);
+    _checkQuery(dbF, _data->names, _data->queryLinear, _data->errFlags, _data->numQueries, _data->spaceDim, _data->numValues);
+} // testQueryBrick
+
+
+// ----------------------------------------------------------------------
+// Test queries of a subset of values with values stored in value-major order.
+void
+spatialdata::spatialdb::TestSimpleGridDB::testQueryValueMajor(void) {
+    CPPUNIT_ASSERT(_data);
+
+    const size_t spaceDim = _data->spaceDim;
+    const size_t numValues = _data->numValues;
+    const size_t numQueries = _data->numQueries;
+    const size_t locSize = spaceDim + numValues;
+    spatialdata::geocoords::CSCart csCart;
+    csCart.setSpaceDim(spaceDim);
+    const double tolerance = 1.0e-12;
+
+    std::vector<double> coords(numQueries*spaceDim);
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coords[iQuery*spaceDim+iDim] = _data->queryLinear[iQuery*locSize+iDim];
+        } // for
+    } // for
+
+    // Expected values from querying all values with interleaved values.
+    SimpleGridDB dbE;
+    _setupDB(&dbE);
+    dbE.setQueryType(SimpleGridDB::LINEAR);
+    dbE.setQueryValues(_data->names, numValues);
+    CPPUNIT_ASSERT_MESSAGE("Expected interleaved values.", !dbE._valueMajor);
+    std::vector<double> valuesE(numQueries*numValues);
+    std::vector<int> errE(numQueries);
+    dbE.multiquery(&valuesE[0], numQueries, numValues, &errE[0], numQueries, &coords[0], numQueries, spaceDim, &csCart);
+
+    const SimpleGridDB::LayoutEnum layouts[2] = { SimpleGridDB::FLAT, SimpleGridDB::BRICK };
+    for (size_t iLayout = 0; iLayout < 2; ++iLayout) {
+        SimpleGridDB db;
+        _setupDB(&db);
+        db.setLayout(layouts[iLayout]);
+        db._arrangeData();
+        db.setQueryType(SimpleGridDB::LINEAR);
+
+        // Query each value by itself with query() and multiquery().
+        for (size_t iVal = 0; iVal < numValues; ++iVal) {
+            db.setQueryValues(&_data->names[iVal], 1);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value-major order.", numValues > 1, db._valueMajor);
+
+            std::vector<double> values(numQueries);
+            std::vector<int> err(numQueries);
+            db.multiquery(&values[0], numQueries, 1, &err[0], numQueries, &coords[0], numQueries, spaceDim, &csCart);
+            for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+                double value = 0.0;
+                const int errQuery = db.query(&value, 1, &coords[iQuery*spaceDim], spaceDim, &csCart);
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", errE[iQuery], errQuery);
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in multiquery error flag.", errE[iQuery], err[iQuery]);
+                if (!errQuery) {
+                    const double valueE = valuesE[iQuery*numValues+iVal];
+                    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in value.", valueE, value, tolerance);
+                    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in multiquery value.", valueE, values[iQuery], tolerance);
+                } // if
+            } // for
+        } // for
+
+        // Querying all values restores interleaved values.
+        db.setQueryType(SimpleGridDB::NEAREST);
+        _checkQuery(db, _data->names, _data->queryNearest, 0, numQueries, spaceDim, numValues);
+        CPPUNIT_ASSERT_MESSAGE("Expected interleaved values.", !db._valueMajor);
+    } // for
+} // testQueryValueMajor
+
+
+// ----------------------------------------------------------------------
+// Test queries with compressed values.
+void
+spatialdata::spatialdb::TestSimpleGridDB::testQueryCompressed(void) {
+    CPPUNIT_ASSERT(_data);
+
+    const size_t numQueries = _data->numQueries;
+    const size_t spaceDim = _data->spaceDim;
+    const size_t numValues = _data->numValues;
+
+    const SimpleGridDB::CompressionEnum compressions[2] = { SimpleGridDB::LOSSLESS, SimpleGridDB::LOSSY };
+    for (size_t iCompression = 0; iCompression < 2; ++iCompression) {
+        SimpleGridDB db;
+        _setupDB(&db);
+        db.setCompression(compressions[iCompression]);
+        db.setCompressionTolerance(1.0e-8);
+        db._arrangeData();
+        CPPUNIT_ASSERT_MESSAGE("Expected compressed values.", db._compressed);
+        CPPUNIT_ASSERT_MESSAGE("Expected cache of decompressed blocks.", db._cache);
+        CPPUNIT_ASSERT_MESSAGE("Expected no uncompressed values.", !db._data && !db._dataF);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected brick layout only for 3-D grids.", 3 == _data->dataDim, !db._brickX.empty());
+        CPPUNIT_ASSERT(db.getCompressedSize() > 0);
+        CPPUNIT_ASSERT(!db.isThreadSafe());
+
+        db.setQueryType(SimpleGridDB::NEAREST);
+        _checkQuery(db, _data->names, _data->queryNearest, 0, numQueries, spaceDim, numValues);
+        _checkMultiquery(db, _data->queryNearest);
+
+        db.setQueryType(SimpleGridDB::LINEAR);
+        _checkQuery(db, _data->names, _data->queryLinear, _data->errFlags, numQueries, spaceDim, numValues);
+        _checkMultiquery(db, _data->queryLinear);
+
+        // Subset of values keeps interleaved values in blocks.
+        db.setQueryValues(&_data->names[numValues-1], 1);
+        CPPUNIT_ASSERT(!db._valueMajor);
+
+        CPPUNIT_ASSERT_THROW(db.setData(NULL, 0, spaceDim, NULL, 0, numValues), std::logic_error);
+    } // for
+
+    // Compressed values in single precision.
+    SimpleGridDB dbF;
+    _setupDB(&dbF);
+    dbF.setPrecision(SimpleGridDB::SINGLE);
+    dbF.setCompression(SimpleGridDB::LOSSLESS);
+    dbF._arrangeData();
+    CPPUNIT_ASSERT(dbF._compressed);
+    dbF.setQueryType(SimpleGridDB::LINEAR);
+    _checkQuery(dbF, _data->names, _data->queryLinear, _data->errFlags, numQueries, spaceDim, numValues);
+} // testQueryCompressed
+
+
 // ----------------------------------------------------------------------
 // Test read().
 void
@@ -260,6 +592,98 @@ spatialdata::spatialdb::TestSimpleGridDB::testRead(void) {
 } // testRead
 
 
+// ----------------------------------------------------------------------
+// Test sharing coordinates and values among processes in shared memory.
+void
+spatialdata::spatialdb::TestSimpleGridDB::testSharedMemory(void) {
+    CPPUNIT_ASSERT(_data);
+
+    const size_t spaceDim = _data->spaceDim;
+    const size_t numValues = _data->numValues;
+    const size_t numQueries = _data->numQueries;
+    const size_t locSize = spaceDim + numValues;
+    spatialdata::geocoords::CSCart csCart;
+    csCart.setSpaceDim(spaceDim);
+
+    std::vector<double> coords(numQueries*spaceDim);
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coords[iQuery*spaceDim+iDim] = _data->queryLinear[iQuery*locSize+iDim];
+        } // for
+    } // for
+
+    // Expected values from database read by this process alone.
+    SimpleGridDB dbE;
+    dbE.setFilename(_data->filename);
+    dbE.open();
+    dbE.setQueryType(SimpleGridDB::LINEAR);
+    std::vector<double> valuesE(numQueries*numValues);
+    std::vector<int> errE(numQueries);
+    dbE.multiquery(&valuesE[0], numQueries, numValues, &errE[0], numQueries, &coords[0], numQueries, spaceDim, &csCart);
+    CPPUNIT_ASSERT_MESSAGE("Expected database not to use shared memory by default.", !dbE._shared);
+
+    SimpleGridDB db;
+    db.setFilename(_data->filename);
+    db.setSharedMemory(true);
+    db.open();
+    CPPUNIT_ASSERT_MESSAGE("Expected values in shared memory.", db._shared);
+    CPPUNIT_ASSERT_MESSAGE("Expected values not to be mapped from file.", !db._mapping);
+    db.setQueryType(SimpleGridDB::LINEAR);
+    std::vector<double> values(numQueries*numValues);
+    std::vector<int> err(numQueries);
+    db.multiquery(&values[0], numQueries, numValues, &err[0], numQueries, &coords[0], numQueries, spaceDim, &csCart);
+    for (size_t i = 0; i < values.size(); ++i) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value from shared memory.", valuesE[i], values[i]);
+    } // for
+
+    // Child processes attach to segment created by this process and
+    // report mismatches through their exit status.
+    const size_t numProcesses = 4;
+    std::vector<pid_t> pids;
+    for (size_t iProcess = 0; iProcess < numProcesses; ++iProcess) {
+        const pid_t pid = fork();
+        CPPUNIT_ASSERT_MESSAGE("Could not start process.", pid >= 0);
+        if (!pid) {
+            int status = 0;
+            try {
+                SimpleGridDB dbChild;
+                dbChild.setFilename(_data->filename);
+                dbChild.setSharedMemory(true);
+                dbChild.open();
+                dbChild.setQueryType(SimpleGridDB::LINEAR);
+                std::vector<double> valuesChild(numQueries*numValues);
+                std::vector<int> errChild(numQueries);
+                dbChild.multiquery(&valuesChild[0], numQueries, numValues, &errChild[0], numQueries, &coords[0], numQueries,
+                                   spaceDim, &csCart);
+                status = (!dbChild._shared || valuesChild != valuesE || errChild != errE) ? 1 : 0;
+                dbChild.close();
+            } catch (...) {
+                status = 2;
+            } // try/catch
+            _exit(status);
+        } // if
+        pids.push_back(pid);
+    } // for
+
+    // Subset of values is queried without reordering shared values.
+    db.setQueryValues(&_data->names[numValues-1], 1);
+    CPPUNIT_ASSERT_MESSAGE("Expected interleaved values in shared memory.", !db._valueMajor);
+    CPPUNIT_ASSERT_THROW(db.setData(&coords[0], 1, spaceDim, &values[0], 1, numValues), std::logic_error);
+
+    for (size_t iProcess = 0; iProcess < numProcesses; ++iProcess) {
+        int status = 0;
+        CPPUNIT_ASSERT_EQUAL(pids[iProcess], waitpid(pids[iProcess], &status, 0));
+        CPPUNIT_ASSERT_MESSAGE("Process exited abnormally.", WIFEXITED(status));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in values in process.", 0, WEXITSTATUS(status));
+    } // for
+
+    // Last process to close database removes segment.
+    const std::string name = db._shared->getName();
+    db.close();
+    CPPUNIT_ASSERT_MESSAGE("Expected shared memory segment to be removed.", shm_open(name.c_str(), O_RDONLY, 0) < 0);
+} // testSharedMemory
+
+
 // ----------------------------------------------------------------------
 // Populate database with data.
 void
@@ -351,6 +775,7 @@ spatialdata::spatialdb::TestSimpleGridDB::_checkQuery(SimpleGridDB& db,
     db.setQueryValues(valNames, numValues);
 
     double* vals = (0 < numValues) ? new double[numValues] : NULL;
+    float* valsF = (0 < numValues) ? new float[numValues] : NULL;
     const double tolerance = 1.0e-06;
 
     const size_t locSize = spaceDim + numValues;
@@ -372,11 +797,89 @@ spatialdata::spatialdb::TestSimpleGridDB::_checkQuery(SimpleGridDB& db,
                 } // if/else
             } // for
         } // if/else
+
+        // Single precision query (through SpatialDB interface) matches
+        // double precision query.
+        float coordsF[3];
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coordsF[iDim] = coords[iDim];
+        } // for
+        const int errF = static_cast<SpatialDB&>(db).query(valsF, numValues, coordsF, spaceDim, &csCart);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag for single precision query.", err, errF);
+        for (size_t iVal = 0; !err && iVal < numValues; ++iVal) {
+            const double toleranceF = 1.0e-5 * std::max(1.0, fabs(vals[iVal]));
+            CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in single precision value.", vals[iVal], valsF[iVal], toleranceF);
+        } // for
     } // for
+    delete[] valsF;valsF = NULL;
     delete[] vals;vals = NULL;
 } // _checkQuery
 
 
+// ----------------------------------------------------------------------
+// Check that multiquery() matches query() at each location.
+void
+spatialdata::spatialdb::TestSimpleGridDB::_checkMultiquery(SimpleGridDB& db,
+                                                           const double* queryData) {
+    CPPUNIT_ASSERT(_data);
+    CPPUNIT_ASSERT(queryData);
+
+    const size_t numValues = _data->numValues;
+    const size_t spaceDim = _data->spaceDim;
+    const size_t numQueries = _data->numQueries;
+    const size_t locSize = spaceDim + numValues;
+
+    db.setQueryValues(_data->names, numValues);
+
+    std::vector<double> coords(numQueries*spaceDim);
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            coords[iQuery*spaceDim+iDim] = queryData[iQuery*locSize+iDim];
+        } // for
+    } // for
+
+    spatialdata::geocoords::CSCart csCart;
+    csCart.setSpaceDim(spaceDim);
+    std::vector<double> vals(numQueries*numValues);
+    std::vector<int> err(numQueries);
+    db.multiquery(&vals[0], numQueries, numValues, &err[0], numQueries, &coords[0], numQueries, spaceDim, &csCart);
+
+    std::vector<double> valsE(numValues);
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        const int errE = db.query(&valsE[0], numValues, &coords[iQuery*spaceDim], spaceDim, &csCart);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag.", errE, err[iQuery]);
+        if (!errE) {
+            for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value.", valsE[iVal], vals[iQuery*numValues+iVal]);
+            } // for
+        } // if
+    } // for
+
+    // Replicate locations so multiquery() splits them among several threads.
+    const size_t numCopies = 2048 / numQueries + 1;
+    const size_t numLocs = numCopies*numQueries;
+    std::vector<double> coordsT(numLocs*spaceDim);
+    for (size_t iCopy = 0; iCopy < numCopies; ++iCopy) {
+        for (size_t i = 0; i < numQueries*spaceDim; ++i) {
+            coordsT[iCopy*numQueries*spaceDim+i] = coords[i];
+        } // for
+    } // for
+    const size_t numThreads = 4;
+    std::vector<double> valsT(numLocs*numValues);
+    std::vector<int> errT(numLocs);
+    db.multiquery(&valsT[0], numLocs, numValues, &errT[0], numLocs, &coordsT[0], numLocs, spaceDim, &csCart, numThreads);
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        const size_t iQuery = iLoc % numQueries;
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in error flag with multiple threads.", err[iQuery], errT[iLoc]);
+        if (!err[iQuery]) {
+            for (size_t iVal = 0; iVal < numValues; ++iVal) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value with multiple threads.", vals[iQuery*numValues+iVal], valsT[iLoc*numValues+iVal]);
+            } // for
+        } // if
+    } // for
+} // _checkMultiquery
+
+
 // ----------------------------------------------------------------------
 spatialdata::spatialdb::TestSimpleGridDB_Data::TestSimpleGridDB_Data(void) :
     numX(0),
@@ -43,11 +43,19 @@ class spatialdata::spatialdb::TestSimpleGridDB : public CppUnit::TestFixture {
     CPPUNIT_TEST(testConstructor);
     CPPUNIT_TEST(testAccessors);
     CPPUNIT_TEST(testSearch);
+    CPPUNIT_TEST(testSearchLookup);
     CPPUNIT_TEST(testDataIndex);
+    CPPUNIT_TEST(testSetData);
     CPPUNIT_TEST(testGetNamesDBValues);
     CPPUNIT_TEST(testQueryNearest);
     CPPUNIT_TEST(testQueryLinear);
+    CPPUNIT_TEST(testMultiquery);
+    CPPUNIT_TEST(testQuerySingle);
+    CPPUNIT_TEST(testQueryBrick);
+    CPPUNIT_TEST(testQueryValueMajor);
+    CPPUNIT_TEST(testQueryCompressed);
     CPPUNIT_TEST(testRead);
+    CPPUNIT_TEST(testSharedMemory);
 
     CPPUNIT_TEST_SUITE_END_ABSTRACT();
 
@@ -69,9 +77,15 @@ public:
     /// Test _search()
     void testSearch(void);
 
+    /// Test _search() with lookup table.
+    void testSearchLookup(void);
+
     /// Test _dataIndex()
     void testDataIndex(void);
 
+    /// Test setData() with locations in and out of grid order.
+    void testSetData(void);
+
     /// Test getNamesDBValues().
     void testGetNamesDBValues(void);
 
@@ -81,9 +95,27 @@ public:
     /// Test query() using linear interpolation.
     void testQueryLinear(void);
 
+    /// Test multiquery() and queryBatch().
+    void testMultiquery(void);
+
+    /// Test queries with values stored in single precision.
+    void testQuerySingle(void);
+
+    /// Test queries with values stored in brick layout.
+    void testQueryBrick(void);
+
+    /// Test queries of a subset of values with values stored in value-major order.
+    void testQueryValueMajor(void);
+
+    /// Test queries with compressed values.
+    void testQueryCompressed(void);
+
     /// Test read().
     void testRead(void);
 
+    /// Test sharing coordinates and values among processes in shared memory.
+    void testSharedMemory(void);
+
     // PRIVATE METHODS ////////////////////////////////////////////////////
 private:
 
@@ -112,6 +144,15 @@ private:
                      const size_t spaceDim,
                      const size_t numVals);
 
+    /** Check that multiquery() matches query() at each location using
+     * one and several threads.
+     *
+     * @param db Database
+     * @param queryData Query locations and expected values
+     */
+    void _checkMultiquery(SimpleGridDB& db,
+                          const double* queryData);
+
 protected:
 
     // PROTECTED MEMBERS //////////////////////////////////////////////////
@@ -180,6 +180,24 @@ spatialdata::spatialdb::TestSimpleIOAscii::testReadComments(void) {
     } // for
 
     delete csIn;csIn = NULL;
+
+    // Reading with several threads gives the same data.
+    dbIO.setNumReaderThreads(4);
+    SimpleDBData dataThreads;
+    dbIO.read(&dataThreads, &csIn);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of points with threads.", numLocs, dataThreads.getNumLocs());
+    for (size_t iLoc = 0; iLoc < numLocs; ++iLoc) {
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in point coordinates with threads.",
+                                         dataIn.getCoordinates(iLoc)[iDim], dataThreads.getCoordinates(iLoc)[iDim]);
+        } // for
+        for (size_t iVal = 0; iVal < numVals; ++iVal) {
+            CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in point values with threads.",
+                                         dataIn.getData(iLoc)[iVal], dataThreads.getData(iLoc)[iVal]);
+        } // for
+    } // for
+
+    delete csIn;csIn = NULL;
 } // testReadComments
 
 
@@ -37,6 +37,7 @@ class spatialdata::spatialdb::TestTimeHistory : public CppUnit::TestFixture {
     CPPUNIT_TEST(testAccessors);
     CPPUNIT_TEST(testOpenClose);
     CPPUNIT_TEST(testQuery);
+    CPPUNIT_TEST(testQueryHint);
 
     CPPUNIT_TEST_SUITE_END();
 
@@ -52,6 +53,9 @@ public:
     /// Test query().
     void testQuery(void);
 
+    /// Test query() with caller-owned search hint.
+    void testQueryHint(void);
+
 }; // class TestTimeHistory
 CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestTimeHistory);
 
@@ -148,4 +152,52 @@ spatialdata::spatialdb::TestTimeHistory::testQuery(void) {
 } // testQuery
 
 
+// ----------------------------------------------------------------------
+// Test query() with caller-owned search hint.
+void
+spatialdata::spatialdb::TestTimeHistory::testQueryHint(void) {
+    const char* filename = "data/timehistory.timedb";
+    const size_t nqueries = 7;
+    const double timeQ[nqueries] = {
+        0.5, 0.0, 0.6, 2.0, 5.0, 20.0, 8.0
+    };
+    const double amplitudeE[nqueries] = {
+        1.0, 0.0, 1.2, 4.0, 2.5, 0.0, 1.0
+    };
+    const int errE[nqueries] = {
+        0, 0, 0, 0, 0, 1, 0
+    };
+
+    TimeHistory th;
+    th.setFilename(filename);
+
+    th.open();
+
+    // Independent hints interleaved in opposite directions.
+    const double tolerance = 1.0e-06;
+    size_t ilowerA = 0;
+    size_t ilowerB = 1000; // Out of range hint is reset.
+    for (size_t i = 0; i < nqueries; ++i) {
+        const size_t iA = i;
+        const size_t iB = nqueries-1-i;
+        double amplitude = 0.0;
+
+        int err = th.query(&amplitude, timeQ[iA], &ilowerA);
+        CPPUNIT_ASSERT_EQUAL(errE[iA], err);
+        if (0 == errE[iA]) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(amplitudeE[iA], amplitude, tolerance);
+        } // if
+
+        err = th.query(&amplitude, timeQ[iB], &ilowerB);
+        CPPUNIT_ASSERT_EQUAL(errE[iB], err);
+        if (0 == errE[iB]) {
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(amplitudeE[iB], amplitude, tolerance);
+        } // if
+    } // for
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Time history search state modified by query with hint.", size_t(0), th._ilower);
+
+    th.close();
+} // testQueryHint
+
+
 // End of file
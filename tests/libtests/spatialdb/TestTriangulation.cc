@@ -0,0 +1,367 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/spatialdb/Triangulation.hh" // USES Triangulation
+
+#include <vector> // USES std::vector
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace spatialdb {
+        class TestTriangulation;
+    } // spatialdb
+} // spatialdata
+
+class spatialdata::spatialdb::TestTriangulation : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestTriangulation);
+
+    CPPUNIT_TEST(testBuildEmpty);
+    CPPUNIT_TEST(testBuild2D);
+    CPPUNIT_TEST(testDelaunay2D);
+    CPPUNIT_TEST(testDelaunay3D);
+    CPPUNIT_TEST(testDelaunayGrid3D);
+    CPPUNIT_TEST(testFindSimplex2D);
+    CPPUNIT_TEST(testFindSimplex3D);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Setup testing data.
+    void setUp(void);
+
+    /// Test build() with too few points or unsupported dimension.
+    void testBuildEmpty(void);
+
+    /// Test build() with 2-D points.
+    void testBuild2D(void);
+
+    /// Test build() generates Delaunay triangulation for 2-D points.
+    void testDelaunay2D(void);
+
+    /// Test build() generates Delaunay tetrahedralization for 3-D points.
+    void testDelaunay3D(void);
+
+    /// Test build() generates Delaunay tetrahedralization for points on 3-D grid.
+    void testDelaunayGrid3D(void);
+
+    /// Test findSimplex() with 2-D points.
+    void testFindSimplex2D(void);
+
+    /// Test findSimplex() with 3-D points.
+    void testFindSimplex3D(void);
+
+    // PRIVATE METHODS ////////////////////////////////////////////////////
+private:
+
+    /** Generate random points in unit square or cube.
+     *
+     * @param numLocs Number of points.
+     * @param spaceDim Spatial dimension of points.
+     */
+    void _generatePoints(const size_t numLocs,
+                         const size_t spaceDim);
+
+    /** Check that triangulation is valid and satisfies the Delaunay property.
+     *
+     * @param triangulation Triangulation of points.
+     */
+    void _checkDelaunay(const Triangulation& triangulation);
+
+    /** Check findSimplex() interpolates linear function exactly.
+     *
+     * @param triangulation Triangulation of points.
+     * @param spaceDim Spatial dimension of points.
+     */
+    void _checkFindSimplex(const Triangulation& triangulation,
+                           const size_t spaceDim);
+
+    /** Generate pseudo-random number in [0,1).
+     *
+     * @returns Pseudo-random number.
+     */
+    double _random(void);
+
+    // PRIVATE MEMBERS ////////////////////////////////////////////////////
+private:
+
+    std::vector<double> _coordinates; ///< Coordinates of points.
+    unsigned long _seed; ///< State of pseudo-random number generator.
+
+}; // class TestTriangulation
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::spatialdb::TestTriangulation);
+
+// ----------------------------------------------------------------------
+// Setup testing data.
+void
+spatialdata::spatialdb::TestTriangulation::setUp(void) {
+    _seed = 4321;
+    _coordinates.clear();
+} // setUp
+
+
+// ----------------------------------------------------------------------
+// Test build() with too few points or unsupported dimension.
+void
+spatialdata::spatialdb::TestTriangulation::testBuildEmpty(void) {
+    Triangulation triangulation;
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of cells for default.", size_t(0), triangulation.getNumCells());
+
+    _generatePoints(10, 1);
+    triangulation.build(&_coordinates[0], 10, 1);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of cells for 1-D.", size_t(0), triangulation.getNumCells());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in dimension for 1-D.", size_t(0), triangulation.getDimension());
+
+    _generatePoints(3, 3);
+    triangulation.build(&_coordinates[0], 3, 3);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of cells for too few points.", size_t(0), triangulation.getNumCells());
+
+    size_t vertices[4];
+    double weights[4];
+    const double pt[3] = { 0.5, 0.5, 0.5 };
+    CPPUNIT_ASSERT_MESSAGE("Found simplex in empty triangulation.", !triangulation.findSimplex(vertices, weights, pt, 0));
+} // testBuildEmpty
+
+
+// ----------------------------------------------------------------------
+// Test build() with 2-D points.
+void
+spatialdata::spatialdb::TestTriangulation::testBuild2D(void) {
+    // Unit square with duplicate corner.
+    const size_t numLocs = 5;
+    const double coordinates[numLocs*2] = {
+        0.0, 0.0,
+        1.0, 0.0,
+        1.0, 1.0,
+        0.0, 1.0,
+        1.0, 1.0,
+    };
+    Triangulation triangulation;
+    triangulation.build(coordinates, numLocs, 2);
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in dimension.", size_t(2), triangulation.getDimension());
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of cells.", size_t(2), triangulation.getNumCells());
+
+    // Search starting at duplicate point.
+    size_t vertices[3];
+    double weights[3];
+    const double pt[3] = { 0.5, 0.25, 0.0 };
+    CPPUNIT_ASSERT(triangulation.findSimplex(vertices, weights, pt, 4));
+    double wtSum = 0.0;
+    for (size_t i = 0; i < 3; ++i) {
+        CPPUNIT_ASSERT(vertices[i] < 4);
+        wtSum += weights[i];
+    } // for
+    const double tolerance = 1.0e-6;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in sum of weights.", 1.0, wtSum, tolerance);
+} // testBuild2D
+
+
+// ----------------------------------------------------------------------
+// Test build() generates Delaunay triangulation for 2-D points.
+void
+spatialdata::spatialdb::TestTriangulation::testDelaunay2D(void) {
+    const size_t numLocs = 400;
+    _generatePoints(numLocs, 2);
+
+    Triangulation triangulation;
+    triangulation.build(&_coordinates[0], numLocs, 2);
+    _checkDelaunay(triangulation);
+} // testDelaunay2D
+
+
+// ----------------------------------------------------------------------
+// Test build() generates Delaunay tetrahedralization for 3-D points.
+void
+spatialdata::spatialdb::TestTriangulation::testDelaunay3D(void) {
+    const size_t numLocs = 400;
+    _generatePoints(numLocs, 3);
+
+    Triangulation triangulation;
+    triangulation.build(&_coordinates[0], numLocs, 3);
+    _checkDelaunay(triangulation);
+} // testDelaunay3D
+
+
+// ----------------------------------------------------------------------
+// Test build() generates Delaunay tetrahedralization for points on 3-D grid.
+void
+spatialdata::spatialdb::TestTriangulation::testDelaunayGrid3D(void) {
+    const size_t numX = 6;
+    const size_t numLocs = numX*numX*numX;
+    _coordinates.resize(numLocs*3);
+    for (size_t iX = 0, iLoc = 0; iX < numX; ++iX) {
+        for (size_t iY = 0; iY < numX; ++iY) {
+            for (size_t iZ = 0; iZ < numX; ++iZ, ++iLoc) {
+                _coordinates[iLoc*3+0] = 2.0*iX;
+                _coordinates[iLoc*3+1] = 2.0*iY;
+                _coordinates[iLoc*3+2] = 2.0*iZ;
+            } // for
+        } // for
+    } // for
+
+    Triangulation triangulation;
+    triangulation.build(&_coordinates[0], numLocs, 3);
+    _checkDelaunay(triangulation);
+
+    // Tetrahedra must fill grid.
+    double volume = 0.0;
+    const size_t numCells = triangulation.getNumCells();
+    for (size_t iCell = 0; iCell < numCells; ++iCell) {
+        volume += triangulation._orient(iCell, -1, NULL) / 6.0;
+    } // for
+    const double volumeE = 10.0*10.0*10.0;
+    const double tolerance = 1.0e-6;
+    CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in volume of tetrahedralization.", 1.0, volume/volumeE, tolerance);
+} // testDelaunayGrid3D
+
+
+// ----------------------------------------------------------------------
+// Test findSimplex() with 2-D points.
+void
+spatialdata::spatialdb::TestTriangulation::testFindSimplex2D(void) {
+    const size_t numLocs = 400;
+    _generatePoints(numLocs, 2);
+
+    Triangulation triangulation;
+    triangulation.build(&_coordinates[0], numLocs, 2);
+    _checkFindSimplex(triangulation, 2);
+} // testFindSimplex2D
+
+
+// ----------------------------------------------------------------------
+// Test findSimplex() with 3-D points.
+void
+spatialdata::spatialdb::TestTriangulation::testFindSimplex3D(void) {
+    const size_t numLocs = 400;
+    _generatePoints(numLocs, 3);
+
+    Triangulation triangulation;
+    triangulation.build(&_coordinates[0], numLocs, 3);
+    _checkFindSimplex(triangulation, 3);
+} // testFindSimplex3D
+
+
+// ----------------------------------------------------------------------
+// Generate random points in unit square or cube.
+void
+spatialdata::spatialdb::TestTriangulation::_generatePoints(const size_t numLocs,
+                                                           const size_t spaceDim) {
+    _coordinates.resize(numLocs*spaceDim);
+    for (size_t i = 0; i < _coordinates.size(); ++i) {
+        _coordinates[i] = _random();
+    } // for
+} // _generatePoints
+
+
+// ----------------------------------------------------------------------
+// Check that triangulation is valid and satisfies the Delaunay property.
+void
+spatialdata::spatialdb::TestTriangulation::_checkDelaunay(const Triangulation& triangulation) {
+    const size_t numCorners = triangulation.getDimension() + 1;
+    const size_t numCells = triangulation.getNumCells();
+    CPPUNIT_ASSERT(numCells > 0);
+
+    for (size_t iCell = 0; iCell < numCells; ++iCell) {
+        CPPUNIT_ASSERT_MESSAGE("Cell with nonpositive orientation.", triangulation._orient(iCell, -1, NULL) > 0.0);
+
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            const int neighbor = triangulation._neighbors[iCell*numCorners+iCorner];
+            if (neighbor < 0) {
+                continue;
+            } // if
+
+            // Neighbor must point back to cell.
+            bool found = false;
+            for (size_t jCorner = 0; jCorner < numCorners; ++jCorner) {
+                found = found || triangulation._neighbors[neighbor*numCorners+jCorner] == int(iCell);
+            } // for
+            CPPUNIT_ASSERT_MESSAGE("Neighbor of cell does not point back to cell.", found);
+
+            // Vertex of neighbor opposite shared face must be outside circumsphere.
+            for (size_t jCorner = 0; jCorner < numCorners; ++jCorner) {
+                const int vertex = triangulation._cells[neighbor*numCorners+jCorner];
+                bool shared = false;
+                for (size_t kCorner = 0; kCorner < numCorners; ++kCorner) {
+                    shared = shared || triangulation._cells[iCell*numCorners+kCorner] == vertex;
+                } // for
+                if (!shared) {
+                    CPPUNIT_ASSERT_MESSAGE("Triangulation is not Delaunay.",
+                                           !triangulation._inCircumsphere(iCell, &triangulation._points[3*vertex]));
+                } // if
+            } // for
+        } // for
+    } // for
+} // _checkDelaunay
+
+
+// ----------------------------------------------------------------------
+// Check findSimplex() interpolates linear function exactly.
+void
+spatialdata::spatialdb::TestTriangulation::_checkFindSimplex(const Triangulation& triangulation,
+                                                             const size_t spaceDim) {
+    const double tolerance = 1.0e-6;
+    const size_t numCorners = spaceDim + 1;
+    const size_t numQueries = 100;
+    for (size_t iQuery = 0; iQuery < numQueries; ++iQuery) {
+        double pt[3] = { 0.0, 0.0, 0.0 };
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            pt[iDim] = 0.2 + 0.6*_random();
+        } // for
+
+        size_t vertices[4];
+        double weights[4];
+        const size_t startLoc = iQuery % 10;
+        CPPUNIT_ASSERT_MESSAGE("Could not find simplex for location inside convex hull.",
+                               triangulation.findSimplex(vertices, weights, pt, startLoc));
+
+        double value = 0.0;
+        double valueE = 0.0;
+        for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+            valueE += (iDim+1)*pt[iDim];
+        } // for
+        for (size_t iCorner = 0; iCorner < numCorners; ++iCorner) {
+            CPPUNIT_ASSERT(weights[iCorner] >= -tolerance);
+            for (size_t iDim = 0; iDim < spaceDim; ++iDim) {
+                value += weights[iCorner] * (iDim+1)*_coordinates[vertices[iCorner]*spaceDim+iDim];
+            } // for
+        } // for
+        CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE("Mismatch in interpolated value.", valueE, value, tolerance);
+    } // for
+
+    const double ptOutside[3] = { 2.0, 2.0, (3 == spaceDim) ? 2.0 : 0.0 };
+    size_t vertices[4];
+    double weights[4];
+    CPPUNIT_ASSERT_MESSAGE("Found simplex for location outside convex hull.",
+                           !triangulation.findSimplex(vertices, weights, ptOutside, 0));
+} // _checkFindSimplex
+
+
+// ----------------------------------------------------------------------
+// Generate pseudo-random number in [0,1).
+double
+spatialdata::spatialdb::TestTriangulation::_random(void) {
+    _seed = (1103515245*_seed + 12345) % 2147483648UL;
+    return double(_seed) / 2147483648.0;
+} // _random
+
+
+// End of file
@@ -72,6 +72,20 @@ spatialdata::spatialdb::TestUserFunctionDB::testCoordsys(void) {
 } // testCoordsys
 
 
+// ----------------------------------------------------------------------
+// Test setThreadSafe() and isThreadSafe().
+void
+spatialdata::spatialdb::TestUserFunctionDB::testThreadSafe(void) {
+    CPPUNIT_ASSERT_MESSAGE("Expected user functions not to be thread safe by default.", !_db->isThreadSafe());
+
+    _db->setThreadSafe(true);
+    CPPUNIT_ASSERT_MESSAGE("Expected thread safe queries.", _db->isThreadSafe());
+
+    _db->setThreadSafe(false);
+    CPPUNIT_ASSERT_MESSAGE("Expected queries not to be thread safe.", !_db->isThreadSafe());
+} // testThreadSafe
+
+
 // ----------------------------------------------------------------------
 // Test addValue()
 void
@@ -44,6 +44,7 @@ class spatialdata::spatialdb::TestUserFunctionDB : public CppUnit::TestFixture {
 
     CPPUNIT_TEST(testConstructor);
     CPPUNIT_TEST(testLabel);
+    CPPUNIT_TEST(testThreadSafe);
     CPPUNIT_TEST(testAddValue);
     CPPUNIT_TEST(testCoordsys);
     CPPUNIT_TEST(testOpenClose);
@@ -68,6 +69,9 @@ public:
     /// Test label()
     void testLabel(void);
 
+    /// Test setThreadSafe() and isThreadSafe().
+    void testThreadSafe(void);
+
     /// Test addValue()
     void testAddValue(void);
 
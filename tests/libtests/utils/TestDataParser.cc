@@ -0,0 +1,229 @@
+// -*- C++ -*-
+//
+// ----------------------------------------------------------------------
+//
+// Brad T. Aagaard, U.S. Geological Survey
+//
+// This code was developed as part of the Computational Infrastructure
+// for Geodynamics (http://geodynamics.org).
+//
+// Copyright (c) 2010-2017 University of California, Davis
+//
+// See COPYING for license information.
+//
+// ----------------------------------------------------------------------
+//
+
+#include <portinfo>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "spatialdata/utils/DataParser.hh" // USES DataParser
+
+#include <sstream> // USES std::istringstream, std::ostringstream
+#include <iomanip> // USES std::setprecision()
+#include <vector> // USES std::vector
+#include <cstdlib> // USES strtod()
+
+// ----------------------------------------------------------------------
+namespace spatialdata {
+    namespace utils {
+        class TestDataParser;
+    } // utils
+} // spatialdata
+
+class spatialdata::utils::TestDataParser : public CppUnit::TestFixture {
+    // CPPUNIT TEST SUITE /////////////////////////////////////////////////
+    CPPUNIT_TEST_SUITE(TestDataParser);
+
+    CPPUNIT_TEST(testParse);
+    CPPUNIT_TEST(testParseNumber);
+    CPPUNIT_TEST(testErrors);
+    CPPUNIT_TEST(testEndOfLine);
+    CPPUNIT_TEST(testThreads);
+
+    CPPUNIT_TEST_SUITE_END();
+
+    // PUBLIC METHODS /////////////////////////////////////////////////////
+public:
+
+    /// Test parse() with comments and blank lines.
+    void testParse(void);
+
+    /// Test _parseNumber().
+    void testParseNumber(void);
+
+    /// Test parse() with errors.
+    void testErrors(void);
+
+    /// Test hasEndOfLine().
+    void testEndOfLine(void);
+
+    /// Test parse() with lines split among threads.
+    void testThreads(void);
+
+}; // class TestDataParser
+CPPUNIT_TEST_SUITE_REGISTRATION(spatialdata::utils::TestDataParser);
+
+// ----------------------------------------------------------------------
+// Test parse() with comments and blank lines.
+void
+spatialdata::utils::TestDataParser::testParse(void) {
+    std::istringstream sin("  1.0 2.0 3.0\n"
+                           "\n"
+                           "// comment\n"
+                           "   // indented comment\n"
+                           "\t4.0  -5.5e+1 6 // trailing comment\n"
+                           "7.0 8.0 9.0 10.0\n"
+                           "not data\n");
+    DataParser parser(sin, "//", 3, 3);
+
+    const size_t numLines = parser.parse();
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of lines.", size_t(3), numLines);
+    CPPUNIT_ASSERT(!parser.hasError());
+    CPPUNIT_ASSERT(parser.hasEndOfLine());
+
+    const double valuesE[9] = { 1.0, 2.0, 3.0, 4.0, -55.0, 6.0, 7.0, 8.0, 9.0 };
+    const double* values = parser.getValues();
+    CPPUNIT_ASSERT(values);
+    for (size_t i = 0; i < 9; ++i) {
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value.", valuesE[i], values[i]);
+    } // for
+
+    // Lines after last line are not parsed.
+    CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected no more lines.", size_t(0), parser.parse());
+    CPPUNIT_ASSERT(!parser.hasError());
+} // testParse
+
+
+// ----------------------------------------------------------------------
+// Test _parseNumber().
+void
+spatialdata::utils::TestDataParser::testParseNumber(void) {
+    const char* numbers[] = {
+        "0", "-0.0", "+12", "1.5", ".25", "3.", "-1.25e-3", "6.02214076E+23", "1.0e-310", "9007199254740993",
+        "0.1", "0.30000000000000004", "123456789012345678901234567890", "2.2250738585072014e-308", "1.7976931348623157e308",
+    };
+    const size_t numNumbers = sizeof(numbers) / sizeof(const char*);
+    for (size_t i = 0; i < numNumbers; ++i) {
+        const std::string number(numbers[i]);
+        const char* pos = number.c_str();
+        double value = 0.0;
+        CPPUNIT_ASSERT_MESSAGE(std::string("Could not parse number '") + number + "'.",
+                               DataParser::_parseNumber(&pos, number.c_str() + number.length(), &value));
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(std::string("Mismatch in value of '") + number + "'.", strtod(numbers[i], NULL), value);
+        CPPUNIT_ASSERT_MESSAGE("Expected position at end of number.", pos == number.c_str() + number.length());
+    } // for
+
+    const char* invalid[] = { "", "  ", "abc", "-", ".", "1.0x", "1,5", "nan", "1e400" };
+    const size_t numInvalid = sizeof(invalid) / sizeof(const char*);
+    for (size_t i = 0; i < numInvalid; ++i) {
+        const std::string number(invalid[i]);
+        const char* pos = number.c_str();
+        double value = 0.0;
+        CPPUNIT_ASSERT_MESSAGE(std::string("Expected error parsing '") + number + "'.",
+                               !DataParser::_parseNumber(&pos, number.c_str() + number.length(), &value));
+    } // for
+} // testParseNumber
+
+
+// ----------------------------------------------------------------------
+// Test parse() with errors.
+void
+spatialdata::utils::TestDataParser::testErrors(void) {
+    { // Too few values.
+        std::istringstream sin("1.0 2.0 3.0\n"
+                               "  4.0 5.0 // comment\n"
+                               "7.0 8.0 9.0\n");
+        DataParser parser(sin, "//", 3, 3);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of lines before error.", size_t(1), parser.parse());
+        CPPUNIT_ASSERT(parser.hasError());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in line with error.", std::string("4.0 5.0 "), parser.getErrorLine());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of values.", size_t(2), parser.getErrorNumValues());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected parsing to stop.", size_t(0), parser.parse());
+    } // Too few values
+
+    { // Malformed value.
+        std::istringstream sin("1.0 abc 3.0\n");
+        DataParser parser(sin, "//", 3, 1);
+        CPPUNIT_ASSERT_EQUAL(size_t(0), parser.parse());
+        CPPUNIT_ASSERT(parser.hasError());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in line with error.", std::string("1.0 abc 3.0"), parser.getErrorLine());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of values.", size_t(1), parser.getErrorNumValues());
+    } // Malformed value
+
+    { // Too few lines.
+        std::istringstream sin("1.0 2.0\n"
+                               "3.0 4.0\n"
+                               "// comment\n");
+        DataParser parser(sin, "//", 2, 3);
+        CPPUNIT_ASSERT_EQUAL(size_t(2), parser.parse());
+        CPPUNIT_ASSERT(!parser.hasError());
+        CPPUNIT_ASSERT_EQUAL(size_t(0), parser.parse());
+        CPPUNIT_ASSERT(parser.hasError());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Expected empty line with error.", std::string(""), parser.getErrorLine());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of values.", size_t(0), parser.getErrorNumValues());
+    } // Too few lines
+} // testErrors
+
+
+// ----------------------------------------------------------------------
+// Test hasEndOfLine().
+void
+spatialdata::utils::TestDataParser::testEndOfLine(void) {
+    std::istringstream sinMissing("1.0 2.0\n"
+                                  "3.0 4.0");
+    DataParser parserMissing(sinMissing, "//", 2, 2);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), parserMissing.parse());
+    CPPUNIT_ASSERT(!parserMissing.hasError());
+    CPPUNIT_ASSERT_MESSAGE("Expected missing end-of-line.", !parserMissing.hasEndOfLine());
+    CPPUNIT_ASSERT_EQUAL(4.0, parserMissing.getValues()[3]);
+
+    // Missing end-of-line after last line parsed is ok.
+    std::istringstream sin("1.0 2.0\n"
+                           "3.0 4.0\n"
+                           "5.0 6.0");
+    DataParser parser(sin, "//", 2, 2);
+    CPPUNIT_ASSERT_EQUAL(size_t(2), parser.parse());
+    CPPUNIT_ASSERT_MESSAGE("Expected end-of-line.", parser.hasEndOfLine());
+} // testEndOfLine
+
+
+// ----------------------------------------------------------------------
+// Test parse() with lines split among threads.
+void
+spatialdata::utils::TestDataParser::testThreads(void) {
+    // Enough lines for several blocks and chunks.
+    const size_t numLines = 600000;
+    const size_t numValues = 4;
+    std::ostringstream sout;
+    sout << std::setprecision(17);
+    for (size_t iLine = 0; iLine < numLines; ++iLine) {
+        if (0 == iLine % 1000) {
+            sout << "// comment\n\n";
+        } // if
+        sout << iLine << "  " << 0.1*iLine << " " << -1.0e+6/(iLine+1) << " " << 3.0e-3*iLine << "\n";
+    } // for
+    sout << "trailing line is not parsed\n";
+    const std::string text = sout.str();
+
+    for (size_t numThreads = 1; numThreads <= 4; numThreads += 3) {
+        std::istringstream sin(text);
+        DataParser parser(sin, "//", numValues, numLines, numThreads);
+        size_t count = 0;
+        for (size_t numBlockLines = parser.parse(); numBlockLines > 0; numBlockLines = parser.parse()) {
+            const double* values = parser.getValues();
+            for (size_t iLine = 0; iLine < numBlockLines; ++iLine, ++count) {
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value 0.", double(count), values[iLine*numValues+0]);
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value 1.", 0.1*count, values[iLine*numValues+1]);
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value 2.", -1.0e+6/(count+1), values[iLine*numValues+2]);
+                CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in value 3.", 3.0e-3*count, values[iLine*numValues+3]);
+            } // for
+        } // for
+        CPPUNIT_ASSERT(!parser.hasError());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE("Mismatch in number of lines.", numLines, count);
+    } // for
+} // testThreads
+
+
+// End of file
@@ -88,6 +88,29 @@ class TestSimpleDB(unittest.TestCase):
         for vE, v in zip(numpy.reshape(dataE, -1), numpy.reshape(data, -1)):
             self.assertAlmostEqual(vE, v, 6)
 
+    def test_databasemulti_threads(self):
+        locs = numpy.array([[1.0, 2.0, 3.0],
+                            [5.6, 4.2, 8.6]] * 2000,
+                           numpy.float64)
+        cs = CSCart()
+        cs._configure()
+        queryVals = ["two", "one"]
+
+        db = self._db
+        db.open()
+        db.setQueryValues(queryVals)
+        dataE = numpy.zeros((locs.shape[0], 2), dtype=numpy.float64)
+        errE = numpy.zeros((locs.shape[0],), dtype=numpy.int32)
+        db.multiquery(dataE, errE, locs, cs)
+        data = numpy.zeros(dataE.shape, dtype=numpy.float64)
+        err = numpy.zeros(errE.shape, dtype=numpy.int32)
+        numThreads = 4
+        db.multiquery(data, err, locs, cs, numThreads)
+        db.close()
+
+        self.assertTrue(numpy.array_equal(errE, err))
+        self.assertTrue(numpy.array_equal(dataE, data))
+
 
 # ----------------------------------------------------------------------------------------------------------------------
 if __name__ == '__main__':